@@ -58,16 +58,27 @@ void ConstantAlgorithm::findConstantWeightsEdges( InputData* pData,
    //fill(halfWeightsPerClass.begin(), halfWeightsPerClass.end(), 0);
    //fill(halfEdges.begin(), halfEdges.end(), 0);
 
-   for (int i = 0; i < numExamples; ++i)
+   if ( pData->hasCompactLabels() )
    {
-      vector<Label>& labels = pData->getLabels(i);
-      vector<Label>::iterator lIt;
-
-      int l = 0;
-      for (lIt = labels.begin(); lIt != labels.end(); ++lIt, l )
+      const LabelMatrix& labelMatrix = pData->getLabelMatrix();
+      for (int i = 0; i < numExamples; ++i)
+         labelMatrix.addWeightsEdges( pData->getRawIndex(i), &halfWeightsPerClass[0], &halfEdges[0],
+                                      pData->getLabelOverlayRow(i) );
+   }
+   else
+   {
+      for (int i = 0; i < numExamples; ++i)
       {
-         halfWeightsPerClass[ lIt->idx ] += lIt->weight;
-         halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
+         vector<Label>& labels = pData->getLabels(i);
+         vector<Label>::iterator lIt;
+
+         int l = 0;
+         for (lIt = labels.begin(); lIt != labels.end(); ++lIt, l )
+         {
+            const AlphaReal w = pData->getLabelWeight(i, *lIt);
+            halfWeightsPerClass[ lIt->idx ] += w;
+            halfEdges[ lIt->idx ] += w * pData->getLabelY(i, *lIt);
+         }
       }
    }
 
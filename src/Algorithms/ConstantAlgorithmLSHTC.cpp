@@ -67,8 +67,9 @@ void ConstantAlgorithmLSHTC::findConstantWeightsEdges( InputData* pData,
       int l = 0;
       for (lIt = labels.begin(); lIt != labels.end(); ++lIt, l )
       {
-         halfWeightsPerClass[ lIt->idx ] += lIt->weight;
-         halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
+         const AlphaReal w = pData->getLabelWeight(i, *lIt);
+         halfWeightsPerClass[ lIt->idx ] += w;
+         halfEdges[ lIt->idx ] += w * pData->getLabelY(i, *lIt);
       }
    }
 
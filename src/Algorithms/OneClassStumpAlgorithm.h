@@ -127,7 +127,7 @@ namespace MultiBoost {
 			// recompute halfEdges at the next point
 			////// Bottleneck BEGIN
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				this->_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				this->_halfEdges[ lIt->idx ] -= pData->getLabelWeight(previousSplitPos->first, *lIt) * pData->getLabelY(previousSplitPos->first, *lIt);
 			////// Bottleneck END
 			
 			// points with the same value of data: to skip because we cannot find a cutting point here!
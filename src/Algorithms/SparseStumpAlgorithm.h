@@ -238,7 +238,7 @@ namespace MultiBoost {
 			// recompute edges at the next point
 			////// Bottleneck BEGIN
 			for (lIt = labels1.begin(); lIt != labels1.end(); ++lIt )
-				_edges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_edges[ lIt->idx ] -= pData->getLabelWeight(previousSplitPos1->first, *lIt) * pData->getLabelY(previousSplitPos1->first, *lIt);
 			////// Bottleneck END
 
 			copy(_edges.begin(), _edges.end(), tmpEdges.begin());
@@ -256,7 +256,7 @@ namespace MultiBoost {
 					// recompute edges at the next point
 					////// Bottleneck BEGIN
 					for (lIt = labels2.begin(); lIt != labels2.end(); ++lIt )
-						tmpEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+						tmpEdges[ lIt->idx ] -= pData->getLabelWeight(previousSplitPos2->first, *lIt) * pData->getLabelY(previousSplitPos2->first, *lIt);
 					////// Bottleneck END
 
 					if ( previousSplitPos2->second != currentSplitPos2->second ) 
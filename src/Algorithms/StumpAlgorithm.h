@@ -82,6 +82,8 @@ namespace MultiBoost {
 			_constantHalfEdges.resize(numClasses);
 			_bestHalfEdges.resize(numClasses);
 			_halfWeightsPerClass.resize(numClasses);   
+			_bestAbsHalfEdges.resize(numClasses);
+			_bestSplitIdxs.resize(numClasses);
 		}
 
 		/**
@@ -141,6 +143,31 @@ namespace MultiBoost {
 			AlphaReal halfTheta,
 			vector<sRates>* pMu = NULL, vector<AlphaReal>* pV = NULL);
 
+		/**
+		* Same as findSingleThresholdWithInit, but the data does not need to be sorted.
+		* The range of the values is split into \a numBins bins of the same width, 
+		* the edges of the examples are accumulated bin by bin in a single pass,
+		* and the threshold is searched between the bins only. The threshold is
+		* halfway between the largest value of a bin and the smallest value of 
+		* the next non-empty one, so it separates the examples exactly as the bins do.
+		* \param dataBegin The iterator to the beginning of the data.
+		* \param dataEnd The iterator to the end of the data.
+		* \param pData The pointer to the original data class. Used to obtain the label of
+		* the example from its index.
+		* \param halfTheta The half of the edge offset.
+		* \param numBins The number of bins.
+		* \param pMu The The class-wise rates to update. (if provided)
+		* \param pV The alignment vector to update. (if provided)
+		* \see findSingleThresholdWithInit
+		* \return The threshold found, NaN if all the values fall in the same bin.
+		* \date 18/10/2026
+		*/
+		FeatureReal findSingleThresholdHistogramWithInit(const vpIterator& dataBegin,
+			const vpIterator& dataEnd,
+			InputData* pData,
+			AlphaReal halfTheta, int numBins,
+			vector<sRates>* pMu = NULL, vector<AlphaReal>* pV = NULL);
+
 		/**
 		* Find the optimal thresholds (one for each class) that maximizes
 		* the edge (or minimizes the error) on the given data weighted data.
@@ -194,8 +221,38 @@ namespace MultiBoost {
 		vector<AlphaReal> _constantHalfEdges; //!< half of the class-wise edges of the constant classifier
 		vector<AlphaReal> _bestHalfEdges; //!< half of the edges of the best found threshold.
 		vector<AlphaReal> _halfWeightsPerClass; //!< The half of the total weights per class.
-		vector<vpIterator> _bestSplitPoss; // the iterator of the best split
-		vector<vpIterator> _bestPreviousSplitPoss; // the iterator of the example before the best split
+		vector<AlphaReal> _binHalfEdges; //!< The half edges of the examples of each bin (see findSingleThresholdHistogramWithInit).
+		vector<T> _binMin; //!< The smallest value of each bin.
+		vector<T> _binMax; //!< The largest value of each bin.
+		vector<int> _binCount; //!< The number of examples of each bin.
+		vector<AlphaReal> _bestAbsHalfEdges; //!< The absolute values of _bestHalfEdges (see updateBestSplits).
+		vector<int> _bestSplitIdxs; //!< The position of the best split of each class, -1 for the constant cut.
+
+		/**
+		* The per-class step of findMultiThresholdsWithInit: the split at position
+		* \a splitIdx becomes the best one of the classes whose absolute edge is larger
+		* than their best so far. The loop has no branch and no dependency between the 
+		* classes, so that the compiler can vectorize it over the class dimension.
+		* \param halfEdges The current half edges.
+		* \param bestHalfEdges The half edges of the best splits, updated.
+		* \param bestAbsHalfEdges The absolute values of \a bestHalfEdges, updated.
+		* \param bestSplitIdxs The positions of the best splits, updated.
+		* \param splitIdx The position of the current split.
+		* \param numClasses The number of classes.
+		* \date 19/10/2026
+		*/
+		static inline void updateBestSplits(const AlphaReal* halfEdges, AlphaReal* bestHalfEdges, 
+			AlphaReal* bestAbsHalfEdges, int* bestSplitIdxs, int splitIdx, int numClasses)
+		{
+			for (int l = 0; l < numClasses; ++l)
+			{
+				const AlphaReal absHalfEdge = halfEdges[l] > 0 ? halfEdges[l] : -halfEdges[l];
+				const bool isBetter = absHalfEdge > bestAbsHalfEdges[l];
+				bestAbsHalfEdges[l] = isBetter ? absHalfEdge : bestAbsHalfEdges[l];
+				bestHalfEdges[l] = isBetter ? halfEdges[l] : bestHalfEdges[l];
+				bestSplitIdxs[l] = isBetter ? splitIdx : bestSplitIdxs[l];
+			}
+		}
         
 	};
 
@@ -246,6 +303,9 @@ namespace MultiBoost {
 		AlphaReal bestHalfEdge = -numeric_limits<AlphaReal>::max();
 		vector<Label>::const_iterator lIt;
 
+		const bool compactLabels = pData->hasCompactLabels();
+		const LabelMatrix& labelMatrix = pData->getLabelMatrix();
+
 		// find the best threshold (cutting point)
 		// at the first split we have
 		// first split: x | x x x x x x x x ..
@@ -254,12 +314,17 @@ namespace MultiBoost {
 			currentSplitPos != dataEnd; 
 			previousSplitPos = currentSplitPos, ++currentSplitPos)
 		{
-			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
-
 			// recompute halfEdges at the next point
 			////// Bottleneck BEGIN
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+			if ( compactLabels )
+				labelMatrix.addEdges( pData->getRawIndex(previousSplitPos->first), &_halfEdges[0], -1, 
+									  pData->getLabelOverlayRow(previousSplitPos->first) );
+			else
+			{
+				vector<Label>& labels = pData->getLabels(previousSplitPos->first);
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					_halfEdges[ lIt->idx ] -= pData->getLabelWeight(previousSplitPos->first, *lIt) * pData->getLabelY(previousSplitPos->first, *lIt);
+			}
 			////// Bottleneck END
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
@@ -340,6 +405,145 @@ namespace MultiBoost {
 
 	//////////////////////////////////////////////////////////////////////////
 
+	template <typename T> 
+	FeatureReal StumpAlgorithm<T>::findSingleThresholdHistogramWithInit
+		(const vpIterator& dataBegin,const vpIterator& dataEnd,
+		InputData* pData, AlphaReal halfTheta, int numBins, 
+		vector<sRates>* pMu, vector<AlphaReal>* pV)
+	{ 
+		const int numClasses = pData->getNumClasses();
+
+		if (dataBegin == dataEnd)
+			return numeric_limits<FeatureReal>::signaling_NaN();
+
+		vpIterator it;
+
+		// the range of the values
+		T minVal = dataBegin->second;
+		T maxVal = dataBegin->second;
+		for (it = dataBegin; it != dataEnd; ++it)
+		{
+			if (it->second < minVal) minVal = it->second;
+			if (it->second > maxVal) maxVal = it->second;
+		}
+
+		if ( !(minVal < maxVal) )
+			return numeric_limits<FeatureReal>::signaling_NaN();
+
+		_binHalfEdges.assign(numBins * numClasses, 0);
+		_binMin.resize(numBins);
+		_binMax.resize(numBins);
+		_binCount.assign(numBins, 0);
+
+		const bool compactLabels = pData->hasCompactLabels();
+		const LabelMatrix& labelMatrix = pData->getLabelMatrix();
+		vector<Label>::const_iterator lIt;
+
+		// accumulate the examples in the bins
+		const double binScale = numBins / ( static_cast<double>(maxVal) - static_cast<double>(minVal) );
+		for (it = dataBegin; it != dataEnd; ++it)
+		{
+			int b = static_cast<int>( (static_cast<double>(it->second) - minVal) * binScale );
+			if (b >= numBins) 
+				b = numBins - 1;
+
+			AlphaReal* binHalfEdges = &_binHalfEdges[b * numClasses];
+			if ( compactLabels )
+				labelMatrix.addEdges( pData->getRawIndex(it->first), binHalfEdges, +1, pData->getLabelOverlayRow(it->first) );
+			else
+			{
+				vector<Label>& labels = pData->getLabels(it->first);
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					binHalfEdges[ lIt->idx ] += pData->getLabelWeight(it->first, *lIt) * pData->getLabelY(it->first, *lIt);
+			}
+
+			if ( _binCount[b] == 0 || it->second < _binMin[b] ) _binMin[b] = it->second;
+			if ( _binCount[b] == 0 || it->second > _binMax[b] ) _binMax[b] = it->second;
+			++_binCount[b];
+		}
+
+		// initialize halfEdges to the constant classifier's half edges 
+		copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _halfEdges.begin());
+
+		AlphaReal currHalfEdge = 0;
+		AlphaReal bestHalfEdge = -numeric_limits<AlphaReal>::max();
+		FeatureReal threshold = 0;
+
+		// the cuts are between two non-empty bins; halfEdges holds the edges of
+		// the cut after the bins before it
+		int previousBin = -1;
+		for (int b = 0; b < numBins; ++b)
+		{
+			if ( _binCount[b] == 0 )
+				continue;
+
+			if ( previousBin >= 0 )
+			{
+				currHalfEdge = 0;
+
+				if ( nor_utils::is_zero(halfTheta) ) {
+					for (int l = 0; l < numClasses; ++l) { 
+						if ( _halfEdges[l] > 0 )
+							currHalfEdge += _halfEdges[l];
+						else
+							currHalfEdge -= _halfEdges[l];
+					}
+				}
+				else {
+					for (int l = 0; l < numClasses; ++l) { 
+						if ( _halfEdges[l] > halfTheta )
+							currHalfEdge += _halfEdges[l];
+						else if ( _halfEdges[l] < -halfTheta )
+							currHalfEdge -= _halfEdges[l];
+					}
+				}
+
+				// the current edge is the new maximum
+				if (currHalfEdge > bestHalfEdge)
+				{
+					bestHalfEdge = currHalfEdge;
+					threshold = static_cast<FeatureReal>( _binMax[previousBin] + _binMin[b] ) / 2;
+
+					for (int l = 0; l < numClasses; ++l)
+						_bestHalfEdges[l] = _halfEdges[l];
+				}
+			}
+
+			const AlphaReal* binHalfEdges = &_binHalfEdges[b * numClasses];
+			for (int l = 0; l < numClasses; ++l)
+				_halfEdges[l] -= binHalfEdges[l];
+
+			previousBin = b;
+		}
+
+		// a single bin: no cut
+		if ( bestHalfEdge == -numeric_limits<AlphaReal>::max() )
+			return numeric_limits<FeatureReal>::signaling_NaN();
+
+		// Fill the mus if present.
+		if ( pMu ) 
+		{
+			for (int l = 0; l < numClasses; ++l)
+			{
+				if (_bestHalfEdges[l] > 0)
+					(*pV)[l] = +1;
+				else
+					(*pV)[l] = -1;
+
+				(*pMu)[l].classIdx = l;
+
+				(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * _bestHalfEdges[l];
+				(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * _bestHalfEdges[l];
+				(*pMu)[l].rZero = (*pMu)[l].rPls + (*pMu)[l].rMin; // == weightsPerClass[l]
+			}
+		}
+
+		return threshold;
+
+	} // end of findSingleThresholdHistogramWithInit
+
+	//////////////////////////////////////////////////////////////////////////
+
 	template <typename T> 
 	void StumpAlgorithm<T>::findMultiThresholds(const vpIterator& dataBegin,
 		const vpIterator& dataEnd,
@@ -370,10 +574,13 @@ namespace MultiBoost {
 		// Initializing halfEdges to the constant classifier's half edges 
 		copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _halfEdges.begin());
 
-		// Initializing bestHalfEdges, thresholds, and pV to the constant classifier 
+		// Initializing bestHalfEdges to the constant classifier 
 		copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _bestHalfEdges.begin());
 		for (int l = 0; l < numClasses; ++l)
-			thresholds[l] = -numeric_limits<FeatureReal>::max(); // constant cut
+		{
+			_bestAbsHalfEdges[l] = _bestHalfEdges[l] > 0 ? _bestHalfEdges[l] : -_bestHalfEdges[l];
+			_bestSplitIdxs[l] = -1; // constant cut
+		}
 
 		bool alignAlloc = false;
 		if (pV == NULL)
@@ -382,61 +589,52 @@ namespace MultiBoost {
 			alignAlloc = true;
 		}
 
-		for (int l = 0; l < numClasses; ++l)
-		{
-			if (_halfEdges[l] > 0) // constant cut
-				(*pV)[l] = 1;
-			else
-				(*pV)[l] = -1;
-		}
-
-
 		vector<Label>::const_iterator lIt;
 
+		const bool compactLabels = pData->hasCompactLabels();
+		const LabelMatrix& labelMatrix = pData->getLabelMatrix();
+
 		// find the best threshold (cutting point)
 		// at the first split we have
 		// first split: x | x x x x x x x x ..
 		//    previous -^   ^- current
+		int splitIdx = 1;
 		for( currentSplitPos = previousSplitPos = dataBegin, ++currentSplitPos;
 			currentSplitPos != dataEnd; 
-			previousSplitPos = currentSplitPos, ++currentSplitPos)
+			previousSplitPos = currentSplitPos, ++currentSplitPos, ++splitIdx)
 		{
 			// recompute halfEdges at the next point
-			// this is the bottleneck
-			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
-
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+			if ( compactLabels )
+				labelMatrix.addEdges( pData->getRawIndex(previousSplitPos->first), &_halfEdges[0], -1, 
+									  pData->getLabelOverlayRow(previousSplitPos->first) );
+			else
+			{
+				vector<Label>& labels = pData->getLabels(previousSplitPos->first);
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					_halfEdges[ lIt->idx ] -= pData->getLabelWeight(previousSplitPos->first, *lIt) * pData->getLabelY(previousSplitPos->first, *lIt);
+			}
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
+			// the classes whose (flipped) edge is a new maximum remember the position,
+			// the thresholds are only computed at the end
 			if ( previousSplitPos->second != currentSplitPos->second ) 
+				updateBestSplits( &_halfEdges[0], &_bestHalfEdges[0], &_bestAbsHalfEdges[0], 
+								  &_bestSplitIdxs[0], splitIdx, numClasses );
+		}
+
+		// the alignments and the thresholds of the best splits
+		for (int l = 0; l < numClasses; ++l)
+		{
+			(*pV)[l] = _bestHalfEdges[l] > 0 ? 1 : -1;
+
+			if ( _bestSplitIdxs[l] < 0 )
+				thresholds[l] = -numeric_limits<FeatureReal>::max(); // constant cut
+			else
 			{
-				for (int l = 0; l < numClasses; ++l)
-				{ 
-					if (_halfEdges[l] > 0)
-					{
-						// the current edge is the new maximum
-						if (_halfEdges[l] > _bestHalfEdges[l] * (*pV)[l]) 
-						{
-							(*pV)[l] = 1;
-							_bestHalfEdges[l] = _halfEdges[l];
-							thresholds[l] = static_cast<FeatureReal>( previousSplitPos->second +
-								currentSplitPos->second ) / 2;
-						}
-					}
-					else
-					{
-						// the current edge is the new maximum
-						if (-_halfEdges[l] > _bestHalfEdges[l] * (*pV)[l]) 
-						{
-							(*pV)[l] = -1;
-							_bestHalfEdges[l] = _halfEdges[l];
-							thresholds[l] = static_cast<FeatureReal>( previousSplitPos->second +
-								currentSplitPos->second ) / 2;
-						}
-					}
-				}
+				const vpIterator bestSplitPos = dataBegin + _bestSplitIdxs[l];
+				thresholds[l] = static_cast<FeatureReal>( (bestSplitPos - 1)->second +
+					bestSplitPos->second ) / 2;
 			}
 		}
 
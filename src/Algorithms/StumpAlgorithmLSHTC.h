@@ -83,6 +83,13 @@ namespace MultiBoost {
 			//_bestHalfEdgesNegative.resize(numClasses);
 			_halfWeightsPerClass.resize(numClasses);   
 			//_edgeOfZeroElements.resize(numClasses);
+			
+			_classEpochs.resize(numClasses, 0);
+			_activeClasses.reserve(numClasses);
+			_bestActiveHalfEdges.resize(numClasses);
+			_epoch = 0;
+			_hasSparseLabels = false;
+			_isConstantSumValid = false;
 		}
 
 		/**
@@ -125,6 +132,11 @@ namespace MultiBoost {
 		* in each iteration. However, it can only be used if
 		* the data points and their weights do not change between initSearchLoop and subsequent
 		* calls to findSingleThreshold. See SingleStumpLearner::run for an example.
+		* With sparse labels, only the classes of the examples of the column are visited
+		* (the active classes): the other ones keep the edges of the constant classifier, 
+		* and the edge of the split is updated with the changes of the active classes. The 
+		* cost is linear in the number of labels of the column, the rates in \a pMu are 
+		* filled once at the end.
 		* \param dataBegin The iterator to the beginning of the data.
 		* \param dataEnd The iterator to the end of the data.
 		* \param pData The pointer to the original data class. Used to obtain the label of
@@ -191,6 +203,112 @@ namespace MultiBoost {
 
 	private:
 
+		/**
+		* The part of the edge of a split that comes from a class.
+		* \param halfEdge The half of the class-wise edge.
+		* \param halfTheta The half of the edge offset theta.
+		* \date 19/10/2026
+		*/
+		AlphaReal getClassHalfEdge( AlphaReal halfEdge, AlphaReal halfTheta ) const
+		{
+			if ( nor_utils::is_zero(halfTheta) )
+				return halfEdge < 0 ? -halfEdge : halfEdge;
+			else if ( halfEdge < halfTheta )
+				return halfEdge;
+			else if ( halfEdge < -halfTheta )
+				return -halfEdge;
+			else
+				return 0;
+		}
+
+		/**
+		* Start the scan of a column: no class is active anymore. The epoch stamps make 
+		* it O(1) instead of a reset of the class-wise edges.
+		* \date 19/10/2026
+		*/
+		void newEpoch()
+		{
+			if ( ++_epoch == 0 ) { // wrapped around, the old stamps are ambiguous
+				fill( _classEpochs.begin(), _classEpochs.end(), 0 );
+				_epoch = 1;
+			}
+			_activeClasses.clear();
+		}
+
+		/**
+		* Activate a class in the current column: its half edge starts from the constant
+		* classifier's one.
+		* \date 19/10/2026
+		*/
+		void activateClass( int l )
+		{
+			_classEpochs[l] = _epoch;
+			_activeClasses.push_back( l );
+			_halfEdges[l] = -_constantHalfEdges[l]; // minus constant edges because the reverse iteration
+		}
+
+		/**
+		* Add the labels of the example \a idx to the half edges. With sparse labels, the 
+		* classes are activated on the fly and \a sumHalfEdge follows the changes of their edges.
+		* \date 19/10/2026
+		*/
+		void addLabels( InputData* pData, int idx, AlphaReal halfTheta, AlphaReal& sumHalfEdge )
+		{
+			const vector<Label>& labels = pData->getLabels(idx);
+			vector<Label>::const_iterator lIt;
+			if ( _hasSparseLabels ) {
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+				{
+					const int l = lIt->idx;
+					if ( _classEpochs[l] != _epoch )
+						activateClass( l );
+					sumHalfEdge -= getClassHalfEdge( _halfEdges[l], halfTheta );
+					_halfEdges[l] += pData->getLabelWeight(idx, *lIt) * pData->getLabelY(idx, *lIt);
+					sumHalfEdge += getClassHalfEdge( _halfEdges[l], halfTheta );
+				}
+			}
+			else {
+				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+					_halfEdges[ lIt->idx ] += pData->getLabelWeight(idx, *lIt) * pData->getLabelY(idx, *lIt);
+			}
+		}
+
+		/**
+		* The edge of the current split: \a sumHalfEdge with sparse labels, the sum over
+		* all the classes otherwise.
+		* \date 19/10/2026
+		*/
+		AlphaReal getSplitHalfEdge( AlphaReal halfTheta, AlphaReal sumHalfEdge ) const
+		{
+			if ( _hasSparseLabels )
+				return sumHalfEdge;
+
+			AlphaReal currHalfEdge = 0;
+			const int numClasses = (int)_halfEdges.size();
+			for (int l = 0; l < numClasses; ++l)
+				currHalfEdge += getClassHalfEdge( _halfEdges[l], halfTheta );
+			return currHalfEdge;
+		}
+
+		/**
+		* Fill the rates and the vote of a class from its half edge.
+		* \date 19/10/2026
+		*/
+		void fillRates( int l, AlphaReal halfEdge, vector<sRates>* pMu, vector<AlphaReal>* pV ) const
+		{
+			// **here
+			if (halfEdge > 0)
+				(*pV)[l] = +1;
+			else
+				(*pV)[l] = -1;
+
+			(*pMu)[l].classIdx = l;
+
+			(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * halfEdge;
+			(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * halfEdge;
+			(*pMu)[l].rZero = (*pMu)[l].rPls + (*pMu)[l].rMin; // == weightsPerClass[l]
+		}
+
 		vector<AlphaReal> _halfEdges; //!< half of the class-wise edges
 		vector<AlphaReal> _constantHalfEdges; //!< half of the class-wise edges of the constant classifier
 		vector<AlphaReal> _bestHalfEdges; //!< half of the edges of the best found threshold.
@@ -199,6 +317,17 @@ namespace MultiBoost {
 		vector<vpReverseIterator> _bestSplitPoss; // the iterator of the best split
 		vector<vpReverseIterator> _bestPreviousSplitPoss; // the iterator of the example before the best split
 
+		vector<unsigned int> _classEpochs; //!< The epoch in which each class was activated, _halfEdges is valid for the current one only.
+		unsigned int _epoch; //!< The epoch of the current column.
+		vector<int> _activeClasses; //!< The classes activated in the current column, in the order of activation.
+		vector<AlphaReal> _bestActiveHalfEdges; //!< The half edges of the best split, aligned with _activeClasses.
+		int _bestNumActive; //!< The number of active classes at the best split.
+		bool _hasSparseLabels; //!< True if the classes are activated by the labels of the column (see initSearchLoop()).
+		
+		AlphaReal _constantHalfEdgeSum; //!< The half edge of a split when no class is active.
+		AlphaReal _constantSumHalfTheta; //!< The halfTheta of _constantHalfEdgeSum.
+		bool _isConstantSumValid; //!< False until _constantHalfEdgeSum is computed for the current weights.
+
 	};
 
 	//////////////////////////////////////////////////////////////////////////
@@ -210,6 +339,15 @@ namespace MultiBoost {
 	{
 		ConstantAlgorithmLSHTC cAlgo;
 		cAlgo.findConstantWeightsEdges(pData,_halfWeightsPerClass,_constantHalfEdges);
+		_isConstantSumValid = false;
+
+		// the scan follows the active classes only if the examples have at most
+		// half of the classes on average, otherwise the dense sums are cheaper
+		const int numExamples = pData->getNumExamples();
+		double numLabels = 0;
+		for (int i = 0; i < numExamples; ++i)
+			numLabels += pData->getLabels(i).size();
+		_hasSparseLabels = 2 * numLabels <= (double)numExamples * pData->getNumClasses();
 	} // end of initSearchLoop
 
 	//////////////////////////////////////////////////////////////////////////
@@ -266,13 +404,29 @@ namespace MultiBoost {
 		vpReverseIterator bestSplitPos; // the iterator of the best split
 		vpReverseIterator bestPreviousSplitPos; // the iterator of the example before the best split
 
-		// initialize halfEdges to the constant classifier's half edges 
-		//copy(_constantHalfEdges.begin(), _constantHalfEdges.end(), _halfEdges.begin());
-		for( int i=0 ; i < _constantHalfEdges.size(); i++ ) _halfEdges[i] = -_constantHalfEdges[i]; // minus constant edges because the reverse iteration
+		// the classes start with the constant classifier's half edges (with a minus because
+		// of the reverse iteration), they are copied to _halfEdges when they become active
+		newEpoch();
+
+		AlphaReal sumHalfEdge = 0; // the sum of getClassHalfEdge() over the classes, with sparse labels
+		if ( _hasSparseLabels ) {
+			if ( !_isConstantSumValid || _constantSumHalfTheta != halfTheta ) {
+				_constantHalfEdgeSum = 0;
+				for (int l = 0; l < numClasses; ++l)
+					_constantHalfEdgeSum += getClassHalfEdge( -_constantHalfEdges[l], halfTheta );
+				_constantSumHalfTheta = halfTheta;
+				_isConstantSumValid = true;
+			}
+			sumHalfEdge = _constantHalfEdgeSum;
+		}
+		else {
+			// every example has all the classes: they are all active from the start
+			for (int l = 0; l < numClasses; ++l)
+				activateClass( l );
+		}
 
 		AlphaReal currHalfEdge = 0;
 		AlphaReal bestHalfEdge = -numeric_limits<AlphaReal>::max();
-		vector<Label>::const_iterator lIt;
 		
 		int currentDataIndex = 0;
 		FeatureReal currentDataValue = 0.0;
@@ -287,42 +441,17 @@ namespace MultiBoost {
 			previousSplitPos = currentSplitPos, currentDataIndex = currentSplitPos->first, currentDataValue = currentSplitPos->second, ++currentSplitPos, i++ )
 		{
 			//cout << previousSplitPos->second << " " << currentSplitPos->second << endl;
-			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
-
 			// recompute halfEdges at the next point
 			////// Bottleneck BEGIN
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
+			addLabels( pData, previousSplitPos->first, halfTheta, sumHalfEdge );
 			////// Bottleneck END
 
 			// same value of data: to skip because we cannot find a cutting point here!
 			if ( previousSplitPos->second != currentSplitPos->second ) 
 			{
-
-				currHalfEdge = 0;
-
-				////// Bottleneck BEGIN
-				if ( nor_utils::is_zero(halfTheta) ) { // we save an "if" in the loop, 20% faster
-					for (int l = 0; l < numClasses; ++l) { 
-						// flip the class-wise edge if it is negative
-						// but store the flipping bit only at the end (below**)
-						if ( _halfEdges[l] < 0 )
-							currHalfEdge -= _halfEdges[l];
-						else
-							currHalfEdge += _halfEdges[l];
-					}
-				}
-				else {
-					for (int l = 0; l < numClasses; ++l) { 
-						// flip the class-wise edge if it is negative
-						// but store the flipping bit only at the end (below**)
-						if ( _halfEdges[l] < halfTheta )
-							currHalfEdge += _halfEdges[l];
-						else if ( _halfEdges[l] < -halfTheta )
-							currHalfEdge -= _halfEdges[l];
-					}
-				}
-				////// Bottleneck END
+				// flip the class-wise edge if it is negative
+				// but store the flipping bit only at the end (below**)
+				currHalfEdge = getSplitHalfEdge( halfTheta, sumHalfEdge );
 
 				// the current edge is the new maximum
 				if (currHalfEdge > bestHalfEdge)
@@ -331,12 +460,9 @@ namespace MultiBoost {
 					bestSplitPos = currentSplitPos; 
 					bestPreviousSplitPos = previousSplitPos; 
 
-					for (int l = 0; l < numClasses; ++l)
-						_bestHalfEdges[l] = _halfEdges[l];
-					
-					FeatureReal threshold = ( previousSplitPos->second + currentSplitPos->second ) / 2;
-					//cout << "Current threshold: " << threshold;
-					//cout << endl;
+					_bestNumActive = (int)_activeClasses.size();
+					for (int k = 0; k < _bestNumActive; ++k)
+						_bestActiveHalfEdges[k] = _halfEdges[ _activeClasses[k] ];
 				}
 			}
 		}
@@ -359,38 +485,17 @@ namespace MultiBoost {
 
 		// dataEnd will contain the smallest value wich isn't equal to zero
 		// the edge of this element will be extracted
-		vector<Label>& labelsLast = pData->getLabels( currentDataIndex );
-
 		// recompute halfEdges at the next point
 		////// Bottleneck BEGIN
-		for (lIt = labelsLast.begin(); lIt != labelsLast.end(); ++lIt )
-			_halfEdges[ lIt->idx ] += lIt->weight * lIt->y;
+		addLabels( pData, currentDataIndex, halfTheta, sumHalfEdge );
 		////// Bottleneck END
 
-		currHalfEdge = 0;
-
-		////// Bottleneck BEGIN
-		if ( nor_utils::is_zero(halfTheta) ) { // we save an "if" in the loop, 20% faster
-			for (int l = 0; l < numClasses; ++l) { 
-				// flip the class-wise edge if it is negative
-				// but store the flipping bit only at the end (below**)
-				if ( _halfEdges[l] > 0 )
-					currHalfEdge -= _halfEdges[l];
-				else
-					currHalfEdge += _halfEdges[l];
-			}
-		}
-		else {
-			for (int l = 0; l < numClasses; ++l) { 
-				// flip the class-wise edge if it is negative
-				// but store the flipping bit only at the end (below**)
-				if ( _halfEdges[l] < halfTheta )
-					currHalfEdge += _halfEdges[l];
-				else if ( _halfEdges[l] < -halfTheta )
-					currHalfEdge -= _halfEdges[l];
-			}
-		}
-		////// Bottleneck END
+		// the split between the non-zero elements and the zeros is counted with
+		// the opposite sign when there is no offset
+		if ( nor_utils::is_zero(halfTheta) )
+			currHalfEdge = -getSplitHalfEdge( halfTheta, sumHalfEdge );
+		else
+			currHalfEdge = getSplitHalfEdge( halfTheta, sumHalfEdge );
 
 		// the current edge is the new maximum
 		if (currHalfEdge > bestHalfEdge)
@@ -399,8 +504,9 @@ namespace MultiBoost {
 			bestPreviousSplitPosFloat = currentDataValue;
 			bestSplitPosFloat = 0.0; 
 			
-			for (int l = 0; l < numClasses; ++l)
-				_bestHalfEdges[l] = _halfEdges[l];
+			_bestNumActive = (int)_activeClasses.size();
+			for (int k = 0; k < _bestNumActive; ++k)
+				_bestActiveHalfEdges[k] = _halfEdges[ _activeClasses[k] ];
 		}
 		//end of the investigation of the last non-zero elements		
 
@@ -413,20 +519,11 @@ namespace MultiBoost {
 			// but here is done just once
 			if ( pMu ) 
 			{
+				// the classes that were not active at the best split have the constant edges
 				for (int l = 0; l < numClasses; ++l)
-				{
-					// **here
-					if (_bestHalfEdges[l] > 0)
-						(*pV)[l] = +1;
-					else
-						(*pV)[l] = -1;
-
-					(*pMu)[l].classIdx = l;
-
-					(*pMu)[l].rPls  = _halfWeightsPerClass[l] + (*pV)[l] * _bestHalfEdges[l];
-					(*pMu)[l].rMin  = _halfWeightsPerClass[l] - (*pV)[l] * _bestHalfEdges[l];
-					(*pMu)[l].rZero = (*pMu)[l].rPls + (*pMu)[l].rMin; // == weightsPerClass[l]
-				}
+					fillRates( l, -_constantHalfEdges[l], pMu, pV );
+				for (int k = 0; k < _bestNumActive; ++k)
+					fillRates( _activeClasses[k], _bestActiveHalfEdges[k], pMu, pV );
 			}
 			//cout << 2 * bestHalfEdge << endl << flush;
 			return threshold;
@@ -504,7 +601,7 @@ namespace MultiBoost {
 			vector<Label>& labels = pData->getLabels(previousSplitPos->first);
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				_halfEdges[ lIt->idx ] -= lIt->weight * lIt->y;
+				_halfEdges[ lIt->idx ] -= pData->getLabelWeight(previousSplitPos->first, *lIt) * pData->getLabelY(previousSplitPos->first, *lIt);
 
 			// points with the same value of data: to skip because we cannot find a cutting point here!
 			// so we only do the cutting if there is a "hole":
@@ -163,5 +163,21 @@ void Exp3::receiveReward( int armNum, AlphaReal reward )
 	updateithValue( armNum );		
 }
 
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+void Exp3::receiveRewards( const vector<int>& arms, const vector<AlphaReal>& rewards )
+{
+	if ( arms.empty() ) return;
+
+	for( int i = 0; i < (int)arms.size(); i++ )
+	{
+		_T[ arms[i] ]++;
+		AlphaReal xHat = rewards[i] / _pHat[ arms[i] ];
+		_X[ arms[i] ] += ( ( _gamma  * xHat )/ _numOfArms );
+		incIter();
+	}
+	updateithValue( arms[0] );		
+}
+
 
 } // end namespace MultiBoost
@@ -153,6 +153,13 @@ public:
 
 	virtual void receiveReward( int armNum, AlphaReal reward );
 
+	/**
+	 * Receive the rewards of a batch round. The rewards are weighted by the
+	 * probabilities the arms were drawn with, which are updated once.
+	 * \date 18/10/2026
+	 */
+	virtual void receiveRewards( const vector<int>& arms, const vector<AlphaReal>& rewards );
+
 	virtual void initialize( vector< AlphaReal >& vals );
 
 	virtual int getNextAction();
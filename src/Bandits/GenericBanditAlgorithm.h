@@ -175,6 +175,36 @@ namespace MultiBoost {
 			}	
 		}
 		
+		/**
+		 * Propose the arms of a batch round: the k arms are pulled together (they can be
+		 * evaluated concurrently) and their rewards are given back in one step with
+		 * receiveRewards(). By default these are the k best arms, k is at most the number
+		 * of arms.
+		 * \param k The number of arms to be pulled in the round.
+		 * \param arms The indices of the arms to be pulled.
+		 * \see receiveRewards
+		 * \date 18/10/2026
+		 */
+		virtual void getKNextActions( const int k, vector<int>& arms )
+		{
+			getKBestAction( min( k, _numOfArms ), arms );
+		}
+
+		/**
+		 * Receive the rewards of a batch round. By default the rewards are received one by
+		 * one, in the order of the arms. The subclasses whose update touches all the arms
+		 * (sorting, normalization) do it once for the whole batch.
+		 * \param arms The indices of the arms pulled in the round.
+		 * \param rewards The rewards of the arms, in the same order.
+		 * \see getKNextActions
+		 * \date 18/10/2026
+		 */
+		virtual void receiveRewards( const vector<int>& arms, const vector<AlphaReal>& rewards )
+		{
+			for( int i = 0; i < (int)arms.size(); i++ )
+				receiveReward( arms[i], rewards[i] );
+		}
+
 		/**
 		 * Get the best action.
 		 * \return The index of arm which then will be pulled.
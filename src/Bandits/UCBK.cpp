@@ -100,10 +100,18 @@ void UCBK::initialize( vector< AlphaReal >& vals )
 //----------------------------------------------------------------
 //----------------------------------------------------------------
 
+AlphaReal UCBK::getUpperBound( int i )
+{
+	return _X[i] / (AlphaReal) _T[i] + sqrt( ( 2 * log( (AlphaReal)getIterNum() ) ) / _T[i] );
+}
+
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+
 void UCBK::updateithValue( int i )
 {
 	//update the value
-	_valueRecord[i]->first = _X[i] / (AlphaReal) _T[i] + sqrt( ( 2 * log( (AlphaReal)getIterNum() ) ) / _T[i] );
+	_valueRecord[i]->first = getUpperBound( i );
 	//sort them according to the values the arms
 	_valuesList.sort( nor_utils::comparePairP< 1, AlphaReal, int, greater<AlphaReal> >() );
 }
@@ -111,6 +119,25 @@ void UCBK::updateithValue( int i )
 //----------------------------------------------------------------
 //----------------------------------------------------------------
 
+void UCBK::receiveRewards( const vector<int>& arms, const vector<AlphaReal>& rewards )
+{
+	for( int i = 0; i < (int)arms.size(); i++ )
+	{
+		_T[ arms[i] ]++;
+		_X[ arms[i] ] += rewards[i];
+		incIter();
+	}
+
+	//update the values of the pulled arms, then sort them once
+	for( int i = 0; i < (int)arms.size(); i++ )
+		_valueRecord[ arms[i] ]->first = getUpperBound( arms[i] );
+
+	_valuesList.sort( nor_utils::comparePairP< 1, AlphaReal, int, greater<AlphaReal> >() );
+}
+
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+
 
 } // end namespace MultiBoost
 
@@ -111,9 +111,8 @@ void UCBKV::initialize( vector< AlphaReal >& vals )
 //----------------------------------------------------------------
 //----------------------------------------------------------------
 
-void UCBKV::updateithValue( int i )
+AlphaReal UCBKV::getUpperBound( int i )
 {
-	//update the value
 	AlphaReal mean = _X[i] / (AlphaReal) _T[i];
 	AlphaReal variance = 0.0;
 
@@ -123,8 +122,17 @@ void UCBKV::updateithValue( int i )
 	}
 	variance /= _T[i];
 
-	_valueRecord[i]->first = mean + sqrt( ( 2.0 * _kszi * variance * log( (AlphaReal)getIterNum() ) ) / _T[i] ) + 
-									_c * ( ( 3 * _b * _kszi *  log( (AlphaReal)getIterNum() ) )/ _T[i]) ;
+	return mean + sqrt( ( 2.0 * _kszi * variance * log( (AlphaReal)getIterNum() ) ) / _T[i] ) + 
+				_c * ( ( 3 * _b * _kszi *  log( (AlphaReal)getIterNum() ) )/ _T[i]) ;
+}
+
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+
+void UCBKV::updateithValue( int i )
+{
+	//update the value
+	_valueRecord[i]->first = getUpperBound( i );
 	
 	//sort them according to the values the arms
 	_valuesList.sort( nor_utils::comparePairP< 1, AlphaReal, int, greater<AlphaReal> >() );
@@ -145,5 +153,25 @@ void UCBKV::receiveReward( int armNum, AlphaReal reward )
 //----------------------------------------------------------------
 //----------------------------------------------------------------
 
+void UCBKV::receiveRewards( const vector<int>& arms, const vector<AlphaReal>& rewards )
+{
+	for( int i = 0; i < (int)arms.size(); i++ )
+	{
+		_T[ arms[i] ]++;
+		_X[ arms[i] ] += rewards[i];
+		_table[ arms[i] ].push_back( rewards[i] );
+		incIter();
+	}
+
+	//update the values of the pulled arms, then sort them once
+	for( int i = 0; i < (int)arms.size(); i++ )
+		_valueRecord[ arms[i] ]->first = getUpperBound( arms[i] );
+
+	_valuesList.sort( nor_utils::comparePairP< 1, AlphaReal, int, greater<AlphaReal> >() );
+}
+
+//----------------------------------------------------------------
+//----------------------------------------------------------------
+
 
 } // end namespace MultiBoost
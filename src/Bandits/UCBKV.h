@@ -89,9 +89,21 @@ public:
 	virtual void getKBestAction( const int k, vector<int>& bestArms );
 	virtual int getNextAction();
 
+	/**
+	 * Receive the rewards of a batch round, the arms are sorted once.
+	 * \date 18/10/2026
+	 */
+	virtual void receiveRewards( const vector<int>& arms, const vector<AlphaReal>& rewards );
+
 	virtual void initLearningOptions(const nor_utils::Args& args) {}
 protected:
 	virtual void updateithValue( int i );	
+
+	/**
+	 * Return the upper confidence bound of the ith arm (empirical Bernstein bound).
+	 * \date 18/10/2026
+	 */
+	AlphaReal getUpperBound( int i );
 };
 
 } // end of namespace MultiBoost
@@ -38,12 +38,15 @@
 #include "IO/OutputInfo.h"
 #include "Classifiers/AdaBoostMHClassifier.h"
 #include "Classifiers/ExampleResults.h"
+#include "Utils/ClassHierarchy.h"
 
 #include "WeakLearners/SingleStumpLearner.h" // for saveSingleStumpFeatureData
 
 #include <iomanip> // for setw
 #include <cmath> // for setw
 #include <functional>
+#include <limits> // for numeric_limits
+#include <algorithm> // for partial_sort
 
 namespace MultiBoost {
 
@@ -51,11 +54,24 @@ namespace MultiBoost {
 	// -------------------------------------------------------------------------
 
 	AdaBoostMHClassifier::AdaBoostMHClassifier(const nor_utils::Args &args, int verbose)
-		: _verbose(verbose), _args(args)
+		: _verbose(verbose), _args(args), _beamSize(0)
 	{
 		// The file with the step-by-step information
 		if ( args.hasArgument("outputinfo") )
 			args.getValue("outputinfo", 0, _outputInfoFile);
+
+		// --hierarchy <filename> <beam>
+		if ( args.hasArgument("hierarchy") )
+		{
+			args.getValue("hierarchy", 0, _hierarchyFileName);
+			args.getValue("hierarchy", 1, _beamSize);
+
+			if ( _beamSize < 1 )
+			{
+				cerr << "ERROR: the beam size of --hierarchy must be at least 1!" << endl;
+				exit(1);
+			}
+		}
 	}
 
 	// -------------------------------------------------------------------------
@@ -377,29 +393,30 @@ namespace MultiBoost {
 		const int numClasses = pData->getNumClasses();
 		const int numExamples = pData->getNumExamples();
 
-		ofstream outFile(outFileName.c_str());
-		string exampleName;
+		// the posteriors of each period are formatted and written by a background
+		// thread, while the next period is being computed
+		AsyncWriter outFile(outFileName);
+		if ( !outFile.is_open() )
+		{
+			cerr << "ERROR: cannot open the output stream (<" 
+				<< outFileName << ">) for the posteriors!" << endl;
+			exit(1);
+		}
+
+		// the names are shared by all the snapshots
+		vector<string> exampleNames(numExamples);
+		for (int i = 0; i < numExamples; ++i)
+			exampleNames[i] = pData->getExampleName(i);
 
 		if (_verbose > 0)
 			cout << "Output posteriors..." << flush;
 
-		if (period<numIterations)
-			outFile << period << endl;
-
+		PosteriorsJob* pJob = new PosteriorsJob( &exampleNames, 
+			period<numIterations ? nor_utils::int2string(period) : "" );
+		pJob->getPosteriors().resize(numExamples);
 		for (int i = 0; i < numExamples; ++i)
-		{
-			// output the name if it exists, otherwise the number
-			// of the example
-			exampleName = pData->getExampleName(i);
-			if ( !exampleName.empty() )
-				outFile << exampleName << ',';
-
-			// output the posteriors
-			outFile << results[i]->getVotesVector()[0];
-			for (int l = 1; l < numClasses; ++l)
-				outFile << ',' << results[i]->getVotesVector()[l];
-			outFile << '\n';
-		}
+			pJob->getPosteriors()[i] = results[i]->getVotesVector();
+		outFile.post( pJob, numExamples * numClasses * sizeof(AlphaReal) );
 
 		
 		for (int p=period; p<numIterations; p+=period )
@@ -410,24 +427,17 @@ namespace MultiBoost {
 			if ( _verbose > 0) {
 				cout << "Write out the posterios for iteration " << p << endl;
 			}
-			outFile << p+period << endl;
-			for (int i = 0; i < numExamples; ++i)
-			{
-				// output the name if it exists, otherwise the number
-				// of the example
-				exampleName = pData->getExampleName(i);
-				if ( !exampleName.empty() )
-					outFile << exampleName << ',';
-				
-				// output the posteriors
-				outFile << results[i]->getVotesVector()[0];
-				for (int l = 1; l < numClasses; ++l)
-					outFile << ',' << results[i]->getVotesVector()[l];
-				outFile << '\n';
-			}
 			
+			pJob = new PosteriorsJob( &exampleNames, nor_utils::int2string(p+period) );
+			pJob->getPosteriors().resize(numExamples);
+			for (int i = 0; i < numExamples; ++i)
+				pJob->getPosteriors()[i] = results[i]->getVotesVector();
+			outFile.post( pJob, numExamples * numClasses * sizeof(AlphaReal) );
 		}
 		
+		// wait for the writer before releasing the names
+		outFile.close();
+		
 		if (_verbose > 0)
 			cout << "Done!" << endl;
 
@@ -771,6 +781,23 @@ namespace MultiBoost {
 		const int numClasses = pData->getNumClasses();
 		const int numExamples = pData->getNumExamples();
 
+		// Creating the results structures. See file Structures.h for the
+		// PointResults structure
+		results.clear();
+		results.reserve(numExamples);
+		for (int i = 0; i < numExamples; ++i)
+			results.push_back( new ExampleResults(i, numClasses) );
+
+		// the votes of the hierarchy are not computed iteration by iteration
+		if ( !_hierarchyFileName.empty() )
+		{
+			if ( !_outputInfoFile.empty() )
+				cerr << "Warning: --outputinfo is ignored with --hierarchy!" << endl;
+
+			computeHierarchicalVotes( pData, weakHypotheses, results, numIterations );
+			return;
+		}
+
 		// Initialize the output info
 		OutputInfo* pOutInfo = NULL;
         
@@ -787,14 +814,6 @@ namespace MultiBoost {
             
 		}
         
-
-		// Creating the results structures. See file Structures.h for the
-		// PointResults structure
-		results.clear();
-		results.reserve(numExamples);
-		for (int i = 0; i < numExamples; ++i)
-			results.push_back( new ExampleResults(i, numClasses) );
-
 		// iterator over all the weak hypotheses
 		vector<BaseLearner*>::const_iterator whyIt;
 		int t;
@@ -854,6 +873,92 @@ namespace MultiBoost {
 	
 	// -------------------------------------------------------------------------
 	
+	void AdaBoostMHClassifier::computeHierarchicalVotes(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
+		vector< ExampleResults* >& results, int numIterations)
+	{
+		ClassHierarchy hierarchy;
+		hierarchy.load( _hierarchyFileName );
+
+		map<int,int> categoryToClass;
+		hierarchy.getClassIndices( pData->getClassMap(), categoryToClass );
+
+		if ( categoryToClass.empty() )
+		{
+			cerr << "ERROR: none of the classes is a category of the hierarchy <"
+				<< _hierarchyFileName << ">!" << endl;
+			exit(1);
+		}
+
+		const int numExamples = pData->getNumExamples();
+		const int numHypotheses = min( numIterations, (int)weakHypotheses.size() );
+
+		vector<AlphaReal> alphas(numHypotheses);
+		for (int t = 0; t < numHypotheses; ++t)
+			alphas[t] = weakHypotheses[t]->getAlpha();
+
+		// the class children of each expanded node, listed once per node
+		map< InnerNode*, vector<InnerNode*> > classChildren;
+		vector<InnerNode*>& topLevel = classChildren[ hierarchy.getRoot() ];
+		hierarchy.getClassChildren( hierarchy.getRoot(), categoryToClass, topLevel );
+
+		vector<InnerNode*> level;
+		// (-vote, position in the level): the best votes first, the ties in the order of the level
+		vector< pair<AlphaReal, int> > scores;
+
+		for (int i = 0; i < numExamples; ++i)
+		{
+			vector<AlphaReal>& currVotesVector = results[i]->getVotesVector();
+			fill( currVotesVector.begin(), currVotesVector.end(), -numeric_limits<AlphaReal>::max() );
+
+			level = topLevel;
+
+			while ( !level.empty() )
+			{
+				scores.resize( level.size() );
+
+				for (int n = 0; n < (int)level.size(); ++n)
+				{
+					const int l = categoryToClass[ level[n]->getCategory() ];
+
+					AlphaReal vote = 0;
+					for (int t = 0; t < numHypotheses; ++t)
+						vote += alphas[t] * weakHypotheses[t]->classify(pData, i, l);
+
+					currVotesVector[l] = vote;
+					scores[n] = make_pair( -vote, n );
+				}
+
+				// keep the best classes of the level
+				if ( (int)scores.size() > _beamSize )
+				{
+					partial_sort( scores.begin(), scores.begin() + _beamSize, scores.end() );
+					scores.resize( _beamSize );
+				}
+
+				// and go down to their children
+				vector<InnerNode*> nextLevel;
+				for (int n = 0; n < (int)scores.size(); ++n)
+				{
+					InnerNode* pNode = level[ scores[n].second ];
+					if ( pNode->isLeaf() ) continue;
+
+					map< InnerNode*, vector<InnerNode*> >::iterator cIt = classChildren.find(pNode);
+					if ( cIt == classChildren.end() )
+					{
+						cIt = classChildren.insert( make_pair( pNode, vector<InnerNode*>() ) ).first;
+						hierarchy.getClassChildren( pNode, categoryToClass, cIt->second );
+					}
+
+					nextLevel.insert( nextLevel.end(), cIt->second.begin(), cIt->second.end() );
+				}
+
+				level.swap( nextLevel );
+			}
+		}
+	}
+
+	// -------------------------------------------------------------------------
+
 	// Continue returns the results into ptRes for savePosteriors
 	// must be called the computeResult first!!!
 	void AdaBoostMHClassifier::continueComputingResults(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
@@ -861,6 +966,13 @@ namespace MultiBoost {
 	{
 		assert( !weakHypotheses.empty() );
 		
+		// the beam depends on all the votes, so they are computed again
+		if ( !_hierarchyFileName.empty() )
+		{
+			computeHierarchicalVotes( pData, weakHypotheses, results, toIteration );
+			return;
+		}
+		
 		const int numClasses = pData->getNumClasses();
 		const int numExamples = pData->getNumExamples();
 		
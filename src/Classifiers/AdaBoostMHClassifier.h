@@ -232,6 +232,25 @@ namespace MultiBoost {
 		virtual void continueComputingResults(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
 											  vector< ExampleResults* >& results, int fromIteration, int toIteration);
 		
+		/**
+		 * Compute the votes top-down along the class hierarchy (option --hierarchy).
+		 * The classes of the first level of the hierarchy are scored first, then only the 
+		 * children of the \a _beamSize best scored classes of a level are scored, and so on
+		 * down to the leaves. The classes of the pruned subtrees are not scored at all, so
+		 * the cost per example depends on the beam size and not on the number of classes.
+		 * Their votes are set to the lowest value, and the classes which are not in the 
+		 * hierarchy are not scored either. A node of the hierarchy which is not a class
+		 * is replaced by its children.
+		 * \param pData A pointer to the data to be classified.
+		 * \param weakHypotheses The list of weak hypotheses.
+		 * \param results The results of the examples, their votes are overwritten.
+		 * \param numIterations The number of weak hypotheses used.
+		 * \see AdaBoostMHLearner::restrictToHierarchy
+		 * \date 19/10/2026
+		 */
+		void computeHierarchicalVotes(InputData* pData, vector<BaseLearner*>& weakHypotheses, 
+									  vector< ExampleResults* >& results, int numIterations);
+		
 		/**
 		 * Compute the overall error on the data.
 		 * \param pData A pointer to the data. Needed to get the actual class of 
@@ -273,6 +292,9 @@ namespace MultiBoost {
 		const nor_utils::Args&  _args;  //!< The arguments defined by the user.
 		string   _outputInfoFile; //!< The filename of the step-by-step information file that will be updated 
 		
+		string   _hierarchyFileName; //!< The class hierarchy of --hierarchy, empty for the flat classification.
+		int      _beamSize; //!< The number of classes expanded at each level of the hierarchy.
+		
 	private:
 		
 		/**
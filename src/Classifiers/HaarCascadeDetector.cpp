@@ -0,0 +1,624 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+/**
+ * \file HaarCascadeDetector.cpp Runs a cascade of Haar-like features over whole images.
+ * \date 18/10/2026
+ */
+
+#include "HaarCascadeDetector.h"
+
+#include "WeakLearners/BaseLearner.h"
+#include "WeakLearners/SingleStumpLearner.h"
+#include "WeakLearners/Haar/HaarLearner.h"
+#include "WeakLearners/Haar/HaarFeatures.h"
+#include "IO/InputData.h"
+#include "IO/HaarData.h"
+#include "IO/Serialization.h"
+
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+#include "tbb/tick_count.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+
+using namespace tbb;
+
+namespace MultiBoost {
+	
+	// -------------------------------------------------------------------------
+	// -------------------------------------------------------------------------
+	
+	/**
+	 * Slides the windows over a range of rows (of any scale) of an image. Used 
+	 * as the body of tbb::parallel_reduce; the detections are joined in the
+	 * order of the rows.
+	 * \date 18/10/2026
+	 */
+	class HaarCascadeSearch
+	{
+	public:
+		
+		HaarCascadeSearch(const HaarCascadeDetector& detector, 
+						  const vector<HaarCascadeDetector::Scale>& scales,
+						  const vector< pair<int, int> >& rows,
+						  const vector<long long>& intImage, int imageWidth)
+		: _numWindows(0), _numEvaluated(0), _detector(detector), _scales(scales), 
+		  _rows(rows), _intImage(intImage), _imageWidth(imageWidth) {}
+		
+		HaarCascadeSearch(HaarCascadeSearch& other, split)
+		: _numWindows(0), _numEvaluated(0), _detector(other._detector), 
+		  _scales(other._scales), _rows(other._rows), _intImage(other._intImage), 
+		  _imageWidth(other._imageWidth) {}
+		
+		void operator()(const blocked_range<size_t>& range)
+		{
+			const int stride = _imageWidth + 1;
+			
+			for (size_t r = range.begin(); r != range.end(); ++r)
+			{
+				const HaarCascadeDetector::Scale& scale = _scales[ _rows[r].first ];
+				const int y = _rows[r].second;
+				const long long* pRow = &_intImage[y * stride];
+				
+				for (int x = 0; x + scale.width <= _imageWidth; x += scale.step)
+				{
+					AlphaReal score;
+					int numEvaluated;
+					
+					++_numWindows;
+					if ( _detector.evaluateWindow(scale, pRow + x, score, numEvaluated) )
+					{
+						HaarCascadeDetector::Detection detection;
+						detection.x = x;
+						detection.y = y;
+						detection.width = scale.width;
+						detection.height = scale.height;
+						detection.score = score;
+						_detections.push_back(detection);
+					}
+					_numEvaluated += numEvaluated;
+				}
+			}
+		}
+		
+		void join(const HaarCascadeSearch& rhs)
+		{
+			_detections.insert(_detections.end(), rhs._detections.begin(), rhs._detections.end());
+			_numWindows += rhs._numWindows;
+			_numEvaluated += rhs._numEvaluated;
+		}
+		
+		vector<HaarCascadeDetector::Detection> _detections; //!< The accepted windows.
+		long long _numWindows; //!< The number of evaluated windows.
+		long long _numEvaluated; //!< The number of evaluated stumps.
+		
+	private:
+		
+		const HaarCascadeDetector&                  _detector;
+		const vector<HaarCascadeDetector::Scale>&   _scales;
+		const vector< pair<int, int> >&             _rows; //!< (scale, y) of each row.
+		const vector<long long>&                    _intImage;
+		const int                                   _imageWidth;
+		
+		HaarCascadeSearch& operator=( const HaarCascadeSearch& ) {return *this;}
+	};
+	
+	// -------------------------------------------------------------------------
+	// -------------------------------------------------------------------------
+	
+	HaarCascadeDetector::HaarCascadeDetector(const nor_utils::Args& args, int verbose)
+	: _verbose(verbose), _args(args), _scaleFactor(1.25), _step(1), _maxOverlap(0.3), 
+	  _resetStages(false)
+	{
+		if ( args.hasArgument("positivelabel") )
+		{
+			args.getValue("positivelabel", 0, _positiveLabelName);
+		} else {
+			cerr << "ERROR: The name of positive label has to be given (--positivelabel)!" << endl;
+			exit(1);
+		}
+		
+		if ( args.hasArgument("detectscale") )
+			args.getValue("detectscale", 0, _scaleFactor);
+		if ( args.hasArgument("detectstep") )
+			args.getValue("detectstep", 0, _step);
+		if ( args.hasArgument("detectoverlap") )
+			args.getValue("detectoverlap", 0, _maxOverlap);
+		
+		if (_scaleFactor <= 1.0 || _step < 1)
+		{
+			cerr << "ERROR: The scale factor must be larger than 1 and the step must be at least 1!" << endl;
+			exit(1);
+		}
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void HaarCascadeDetector::run(const string& dataFileName, const string& imageFileName, 
+								  const string& shypFileName, const string& outFileName)
+	{
+		// get the input data of the weak learner, for the names of the classes and 
+		// the size of the windows
+		string baseLearnerName = UnSerialization::getWeakLearnerName(shypFileName);
+		if ( !BaseLearner::RegisteredLearners().hasLearner(baseLearnerName) )
+		{
+			cerr << "ERROR: Weak learner <" << baseLearnerName << "> not registered!!" << endl;
+			exit(1);
+		}
+		
+		BaseLearner* pBaseLearner = BaseLearner::RegisteredLearners().getLearner(baseLearnerName);
+		pBaseLearner->initLearningOptions(_args);
+		InputData* pData = pBaseLearner->createInputData();
+		pData->initOptions(_args);
+		pData->load(dataFileName, IT_TEST, _verbose);
+		
+		if (_verbose > 0)
+			cout << "Loading strong hypothesis..." << flush;
+		
+		loadCascade(shypFileName, pData);
+		
+		if (_verbose > 0)
+			cout << "Done! (" << _stumps.size() << " weak hypotheses in " 
+			     << _stageEnds.size() << " stages)" << endl;
+		
+		// the images to scan
+		vector<string> imageFileNames;
+		vector<long long> intImage;
+		int imageWidth, imageHeight;
+		
+		if ( loadIntegralImage(imageFileName, intImage, imageWidth, imageHeight) )
+			imageFileNames.push_back(imageFileName);
+		else
+		{
+			// not an image: a list of images
+			ifstream listFile(imageFileName.c_str());
+			if (!listFile.is_open())
+			{
+				cerr << "ERROR: Cannot open image file <" << imageFileName << ">!" << endl;
+				exit(1);
+			}
+			
+			string line;
+			while ( getline(listFile, line) )
+			{
+				line = nor_utils::trim(line);
+				if ( !line.empty() )
+					imageFileNames.push_back(line);
+			}
+		}
+		
+		ofstream outFile(outFileName.c_str());
+		if (!outFile.is_open())
+		{
+			cerr << "ERROR: Cannot open output file <" << outFileName << ">!" << endl;
+			exit(1);
+		}
+		
+		long long totNumWindows = 0;
+		long long totNumEvaluated = 0;
+		double totSeconds = 0;
+		
+		for (size_t i = 0; i < imageFileNames.size(); ++i)
+		{
+			if ( (i > 0 || intImage.empty()) && 
+				!loadIntegralImage(imageFileNames[i], intImage, imageWidth, imageHeight) )
+			{
+				cerr << "ERROR: <" << imageFileNames[i] << "> is not a PGM image!" << endl;
+				exit(1);
+			}
+			
+			tick_count startTick = tick_count::now();
+			
+			vector<Scale> scales;
+			buildScales(imageWidth, imageHeight, scales);
+			
+			// the rows of all the scales are scanned in parallel
+			vector< pair<int, int> > rows;
+			for (int s = 0; s < (int)scales.size(); ++s)
+				for (int y = 0; y + scales[s].height <= imageHeight; y += scales[s].step)
+					rows.push_back( make_pair(s, y) );
+			
+			HaarCascadeSearch search(*this, scales, rows, intImage, imageWidth);
+			parallel_reduce( blocked_range<size_t>(0, rows.size()), search );
+			
+			const double seconds = (tick_count::now() - startTick).seconds();
+			
+			const int numAccepted = (int)search._detections.size();
+			suppressNonMaxima(search._detections);
+			
+			vector<Detection>::const_iterator dIt;
+			for (dIt = search._detections.begin(); dIt != search._detections.end(); ++dIt)
+			{
+				outFile << imageFileNames[i] << " " << dIt->x << " " << dIt->y << " " 
+				        << dIt->width << " " << dIt->height << " " << dIt->score << endl;
+			}
+			
+			if (_verbose > 1)
+			{
+				cout << imageFileNames[i] << ": " << imageWidth << "x" << imageHeight
+				     << ", " << scales.size() << " scales, " << search._numWindows << " windows, "
+				     << numAccepted << " accepted, " << search._detections.size() 
+				     << " detections" << endl;
+			}
+			
+			totNumWindows += search._numWindows;
+			totNumEvaluated += search._numEvaluated;
+			totSeconds += seconds;
+		}
+		
+		if (_verbose > 0)
+		{
+			cout << "Windows evaluated: " << totNumWindows << " (" 
+			     << (totSeconds > 0 ? totNumWindows / totSeconds : 0) << " windows/sec)" << endl;
+			cout << "Mean number of features per window: " 
+			     << (totNumWindows > 0 ? (double)totNumEvaluated / totNumWindows : 0) << endl;
+		}
+		
+		delete pData;
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void HaarCascadeDetector::loadCascade(const string& shypFileName, InputData* pData)
+	{
+		const int positiveLabelIndex = pData->getClassMap().getIdxFromName( _positiveLabelName );
+		
+		// the type of strong hypothesis is given by its tags
+		ifstream inFile(shypFileName.c_str());
+		string shypContent( (istreambuf_iterator<char>(inFile)), istreambuf_iterator<char>() );
+		inFile.close();
+		
+		UnSerialization us;
+		vector<BaseLearner*> weakHypotheses;
+		
+		_stageEnds.clear();
+		_stageThresholds.clear();
+		
+		if ( shypContent.find("<cascade>") != string::npos )
+		{
+			// VJcascade: the output is compared to the threshold at the end of each stage
+			vector<vector<BaseLearner*> > stages;
+			vector<AlphaReal> thresholds;
+			us.loadCascadeHypotheses(shypFileName, stages, thresholds, pData, _verbose);
+			
+			for (size_t s = 0; s < stages.size(); ++s)
+			{
+				weakHypotheses.insert(weakHypotheses.end(), stages[s].begin(), stages[s].end());
+				_stageEnds.push_back( (int)weakHypotheses.size() );
+				_stageThresholds.push_back( thresholds[s] );
+			}
+			_resetStages = true;
+		}
+		else if ( shypContent.find("<rejecthresh>") != string::npos )
+		{
+			// SoftCascade: the cumulated output is compared to the threshold after
+			// each weak hypothesis
+			vector<AlphaReal> rejectionThresholds;
+			us.loadHypothesesWithThresholds(shypFileName, weakHypotheses, rejectionThresholds, pData, _verbose);
+			
+			for (size_t s = 0; s < weakHypotheses.size(); ++s)
+			{
+				_stageEnds.push_back( (int)s + 1 );
+				_stageThresholds.push_back( rejectionThresholds[s] );
+			}
+			_resetStages = false;
+		}
+		else
+		{
+			// AdaBoost: a single stage, positive if the output is not negative
+			us.loadHypotheses(shypFileName, weakHypotheses, pData, _verbose);
+			
+			_stageEnds.push_back( (int)weakHypotheses.size() );
+			_stageThresholds.push_back( 0 );
+			_resetStages = false;
+		}
+		
+		_stumps.resize( weakHypotheses.size() );
+		for (size_t i = 0; i < weakHypotheses.size(); ++i)
+		{
+			HaarLearner* pHaarLearner = dynamic_cast<HaarLearner*>( weakHypotheses[i] );
+			SingleStumpLearner* pStumpLearner = dynamic_cast<SingleStumpLearner*>( weakHypotheses[i] );
+			
+			if ( !pHaarLearner || !pStumpLearner )
+			{
+				cerr << "ERROR: The detection needs weak hypotheses with a single threshold " 
+				     << "on a Haar-like feature (HaarSingleStumpLearner or UCBVHaarSingleStumpLearner)!" << endl;
+				exit(1);
+			}
+			
+			_stumps[i].pFeature = pHaarLearner->getSelectedFeature();
+			_stumps[i].config = pHaarLearner->getSelectedConfig();
+			_stumps[i].threshold = static_cast<FeatureReal>( pStumpLearner->getThreshold() );
+			_stumps[i].vote = weakHypotheses[i]->getAlpha() * pStumpLearner->_v[positiveLabelIndex];
+			
+			delete weakHypotheses[i];
+		}
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	/**
+	 * Reads the next number of the header of a PGM file, skipping the comments.
+	 * \date 18/10/2026
+	 */
+	static bool readPGMHeaderValue(istream& in, int& val)
+	{
+		int c = in.get();
+		while ( in.good() && (isspace(c) || c == '#') )
+		{
+			if (c == '#')
+			{
+				while ( in.good() && c != '\n' )
+					c = in.get();
+			}
+			c = in.get();
+		}
+		
+		if ( !in.good() || !isdigit(c) )
+			return false;
+		
+		in.putback( static_cast<char>(c) );
+		return !(in >> val).fail();
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	bool HaarCascadeDetector::loadIntegralImage(const string& imageFileName, vector<long long>& intImage,
+												int& width, int& height)
+	{
+		ifstream in(imageFileName.c_str(), ios::binary);
+		if (!in.is_open())
+		{
+			cerr << "ERROR: Cannot open image file <" << imageFileName << ">!" << endl;
+			exit(1);
+		}
+		
+		char magic[2];
+		if ( !in.read(magic, 2) || magic[0] != 'P' || (magic[1] != '2' && magic[1] != '5') )
+			return false;
+		
+		const bool isBinary = (magic[1] == '5');
+		int maxVal;
+		
+		if ( !readPGMHeaderValue(in, width) || !readPGMHeaderValue(in, height) ||
+			 !readPGMHeaderValue(in, maxVal) || width <= 0 || height <= 0 || 
+			 maxVal <= 0 || maxVal > 65535 )
+		{
+			cerr << "ERROR: Invalid PGM header in <" << imageFileName << ">!" << endl;
+			exit(1);
+		}
+		
+		// a single whitespace separates the header from the binary pixels
+		if (isBinary)
+			in.get();
+		
+		const int stride = width + 1;
+		const int bytesPerPixel = (maxVal > 255) ? 2 : 1;
+		
+		intImage.assign( (size_t)stride * (height + 1), 0 );
+		vector<unsigned char> rowBytes( (size_t)width * bytesPerPixel );
+		
+		for (int y = 0; y < height; ++y)
+		{
+			if ( isBinary && !in.read(reinterpret_cast<char*>(&rowBytes[0]), rowBytes.size()) )
+			{
+				cerr << "ERROR: Truncated PGM image <" << imageFileName << ">!" << endl;
+				exit(1);
+			}
+			
+			const long long* pAbove = &intImage[y * stride];
+			long long* pRow = &intImage[(y + 1) * stride];
+			long long rowSum = 0;
+			
+			for (int x = 0; x < width; ++x)
+			{
+				int pixel;
+				if (isBinary)
+				{
+					if (bytesPerPixel == 1)
+						pixel = rowBytes[x];
+					else // 16 bits pixels are big endian
+						pixel = (rowBytes[2 * x] << 8) | rowBytes[2 * x + 1];
+				}
+				else if ( !(in >> pixel) )
+				{
+					cerr << "ERROR: Truncated PGM image <" << imageFileName << ">!" << endl;
+					exit(1);
+				}
+				
+				rowSum += pixel;
+				pRow[x + 1] = pAbove[x + 1] + rowSum;
+			}
+		}
+		
+		return true;
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void HaarCascadeDetector::buildScales(int imageWidth, int imageHeight, vector<Scale>& scales)
+	{
+		const int baseWidth = HaarData::areaWidth();
+		const int baseHeight = HaarData::areaHeight();
+		const int stride = imageWidth + 1;
+		
+		scales.clear();
+		
+		for (double factor = 1.0; ; factor *= _scaleFactor)
+		{
+			Scale scale;
+			scale.width = static_cast<int>( floor(baseWidth * factor + 0.5) );
+			scale.height = static_cast<int>( floor(baseHeight * factor + 0.5) );
+			if (scale.width > imageWidth || scale.height > imageHeight)
+				break;
+			
+			scale.step = max( 1, static_cast<int>( floor(_step * factor + 0.5) ) );
+			
+			for (size_t i = 0; i < _stumps.size(); ++i)
+			{
+				HaarCorners corners;
+				_stumps[i].pFeature->getCorners(_stumps[i].config, corners);
+				
+				scale.firstBlock.push_back( (int)scale.blocks.size() );
+				
+				const int numBlocks = corners.numWhite + corners.numBlack;
+				for (int b = 0; b < numBlocks; ++b)
+				{
+					const bool isWhite = (b < corners.numWhite);
+					const int* pCorners = isWhite ? corners.white[b] : corners.black[b - corners.numWhite];
+					
+					int left, top, right, bottom;
+					HaarFeature::getBlockEdges(pCorners, left, top, right, bottom);
+					
+					// the edges are rounded, so the sum is normalized by the actual area
+					const int sLeft = static_cast<int>( floor(left * factor + 0.5) );
+					const int sTop = static_cast<int>( floor(top * factor + 0.5) );
+					const int sRight = static_cast<int>( floor(right * factor + 0.5) );
+					const int sBottom = static_cast<int>( floor(bottom * factor + 0.5) );
+					
+					const int area = (right - left) * (bottom - top);
+					const int scaledArea = (sRight - sLeft) * (sBottom - sTop);
+					
+					ScaledBlock block;
+					block.topLeft = sTop * stride + sLeft;
+					block.topRight = sTop * stride + sRight;
+					block.bottomLeft = sBottom * stride + sLeft;
+					block.bottomRight = sBottom * stride + sRight;
+					block.weight = (scaledArea > 0) ? (double)area / scaledArea : 0;
+					if (isWhite)
+						block.weight = -block.weight;
+					
+					scale.blocks.push_back(block);
+				}
+			}
+			scale.firstBlock.push_back( (int)scale.blocks.size() );
+			
+			scales.push_back(scale);
+		}
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	bool HaarCascadeDetector::evaluateWindow(const Scale& scale, const long long* pOrigin, 
+											 AlphaReal& score, int& numEvaluated) const
+	{
+		AlphaReal posterior = 0;
+		int s = 0;
+		
+		for (size_t stage = 0; stage < _stageEnds.size(); ++stage)
+		{
+			if (_resetStages)
+				posterior = 0;
+			
+			for ( ; s < _stageEnds[stage]; ++s)
+			{
+				double val = 0;
+				for (int b = scale.firstBlock[s]; b < scale.firstBlock[s + 1]; ++b)
+				{
+					const ScaledBlock& block = scale.blocks[b];
+					val += block.weight * static_cast<double>( (pOrigin[block.bottomRight] + pOrigin[block.topLeft]) -
+															  (pOrigin[block.topRight] + pOrigin[block.bottomLeft]) );
+				}
+				
+				if (static_cast<FeatureReal>(val) > _stumps[s].threshold)
+					posterior += _stumps[s].vote;
+				else
+					posterior -= _stumps[s].vote;
+			}
+			
+			if (posterior < _stageThresholds[stage])
+			{
+				score = posterior;
+				numEvaluated = s;
+				return false;
+			}
+		}
+		
+		score = posterior;
+		numEvaluated = s;
+		return true;
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	/**
+	 * Orders the detections by decreasing score.
+	 * \date 18/10/2026
+	 */
+	template <typename T>
+	static bool higherScore(const T& a, const T& b)
+	{ return a.score > b.score; }
+	
+	void HaarCascadeDetector::suppressNonMaxima(vector<Detection>& detections)
+	{
+		stable_sort( detections.begin(), detections.end(), higherScore<Detection> );
+		
+		vector<Detection> kept;
+		vector<Detection>::const_iterator dIt, kIt;
+		
+		for (dIt = detections.begin(); dIt != detections.end(); ++dIt)
+		{
+			bool isMaximum = true;
+			for (kIt = kept.begin(); kIt != kept.end(); ++kIt)
+			{
+				const int interWidth = min(dIt->x + dIt->width, kIt->x + kIt->width) - max(dIt->x, kIt->x);
+				const int interHeight = min(dIt->y + dIt->height, kIt->y + kIt->height) - max(dIt->y, kIt->y);
+				if (interWidth <= 0 || interHeight <= 0)
+					continue;
+				
+				const double intersection = (double)interWidth * interHeight;
+				const double unionArea = (double)dIt->width * dIt->height + 
+				                         (double)kIt->width * kIt->height - intersection;
+				if (intersection / unionArea > _maxOverlap)
+				{
+					isMaximum = false;
+					break;
+				}
+			}
+			
+			if (isMaximum)
+				kept.push_back(*dIt);
+		}
+		
+		detections.swap(kept);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+} // end of namespace MultiBoost
@@ -0,0 +1,228 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+/**
+ * \file HaarCascadeDetector.h Runs a cascade of Haar-like features over whole images.
+ * \date 18/10/2026
+ */
+#pragma warning( disable : 4786 )
+
+#ifndef __HAAR_CASCADE_DETECTOR_H
+#define __HAAR_CASCADE_DETECTOR_H
+
+#include "Utils/Args.h"
+#include "Utils/Utils.h" // for Rect
+#include "Defaults.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace MultiBoost {
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	// Forward declarations.
+	class InputData;
+	class HaarFeature;
+	class HaarCascadeSearch;
+	
+	/**
+	 * Detects objects in whole images with a strong hypothesis trained on
+	 * Haar-like features (VJcascade, SoftCascade or plain AdaBoost with 
+	 * HaarSingleStumpLearner or UCBVHaarSingleStumpLearner).
+	 * The integral image of each input image (PGM) is computed once, and
+	 * windows are slid across all the positions and scales. The image is never
+	 * rescaled: the blocks of the features are scaled instead, and their sums
+	 * are normalized by the ratio of the areas. Each window is evaluated with 
+	 * early rejection: it is dropped at the first stage (or, for a SoftCascade, 
+	 * at the first weak hypothesis) whose threshold it does not reach. The rows
+	 * of all the scales are processed in parallel, and the accepted windows are 
+	 * finally merged by a greedy non-maximum suppression.
+	 * \date 18/10/2026
+	 */
+	class HaarCascadeDetector
+	{
+	public:
+		
+		/**
+		 * The constructor. It initializes the variable and set them using the
+		 * information provided by the arguments passed.
+		 * \param args The arguments defined by the user in the command line.
+		 * \param verbose The level of verbosity
+		 * \date 18/10/2026
+		 */
+		HaarCascadeDetector(const nor_utils::Args& args, int verbose = 1);
+		
+		/**
+		 * Starts the detection. 
+		 * \param dataFileName A file in the format of the training data. It is only
+		 * used to get the names of the classes and the size of the windows.
+		 * \param imageFileName A PGM image, or a text file with the name of a PGM
+		 * image on each line.
+		 * \param shypFileName The strong hypothesis filename.
+		 * \param outFileName The name of the file in which the detections will be 
+		 * saved, one per line:
+		 * \verbatim
+		 imageFile x y width height score
+		 ...\endverbatim
+		 * \date 18/10/2026
+		 */
+		void run(const string& dataFileName, const string& imageFileName, 
+				 const string& shypFileName, const string& outFileName);
+		
+	protected:
+		
+		friend class HaarCascadeSearch;
+		
+		/**
+		 * A weak hypothesis of the cascade.
+		 * \date 18/10/2026
+		 */
+		struct CascadeStump
+		{
+			HaarFeature*    pFeature; //!< The type of the feature.
+			nor_utils::Rect config; //!< The configuration of the feature.
+			FeatureReal     threshold; //!< The threshold of the stump.
+			AlphaReal       vote; //!< alpha * v[positive label].
+		};
+		
+		/**
+		 * A block of a feature mapped onto the windows of a scale. The corners
+		 * are offsets from the origin of the window in the integral image.
+		 * \date 18/10/2026
+		 */
+		struct ScaledBlock
+		{
+			int    topLeft, topRight, bottomLeft, bottomRight;
+			double weight; //!< +/- the ratio between the original and the scaled area.
+		};
+		
+		/**
+		 * The windows of a scale.
+		 * \date 18/10/2026
+		 */
+		struct Scale
+		{
+			int width, height; //!< The size of the windows.
+			int step; //!< The step between two windows.
+			vector<ScaledBlock> blocks; //!< The blocks of all the stumps.
+			vector<int> firstBlock; //!< The first block of each stump (and the end).
+		};
+		
+		/**
+		 * An accepted window.
+		 * \date 18/10/2026
+		 */
+		struct Detection
+		{
+			int       x, y, width, height;
+			AlphaReal score; //!< The output of the last stage.
+		};
+		
+		/**
+		 * Loads the strong hypothesis into \a _stumps, \a _stageEnds and \a _stageThresholds.
+		 * \date 18/10/2026
+		 */
+		void loadCascade(const string& shypFileName, InputData* pData);
+		
+		/**
+		 * Reads a PGM image (P2 or P5) and computes its integral image, with a
+		 * leading row and column of zeros.
+		 * \return false if the file is not a PGM image.
+		 * \date 18/10/2026
+		 */
+		bool loadIntegralImage(const string& imageFileName, vector<long long>& intImage,
+							   int& width, int& height);
+		
+		/**
+		 * Maps the blocks of the stumps onto the windows of each scale.
+		 * \date 18/10/2026
+		 */
+		void buildScales(int imageWidth, int imageHeight, vector<Scale>& scales);
+		
+		/**
+		 * Evaluates the cascade on a window.
+		 * \param scale The scale of the window.
+		 * \param pOrigin The integral image at the top left corner of the window.
+		 * \param score The returned output of the last evaluated stage.
+		 * \param numEvaluated The returned number of evaluated stumps.
+		 * \return true if the window passes all the stages.
+		 * \date 18/10/2026
+		 */
+		bool evaluateWindow(const Scale& scale, const long long* pOrigin, 
+							AlphaReal& score, int& numEvaluated) const;
+		
+		/**
+		 * Greedy non-maximum suppression: the detections are visited by decreasing
+		 * score, and a detection is dropped if its overlap (intersection over union)
+		 * with a kept one is larger than \a _maxOverlap.
+		 * \date 18/10/2026
+		 */
+		void suppressNonMaxima(vector<Detection>& detections);
+		
+		/**
+		 * Defines the level of verbosity:
+		 * - 0 = no messages
+		 * - 1 = basic messages
+		 * - 2 = show all messages
+		 */
+		int      _verbose;
+		
+		const nor_utils::Args&  _args;  //!< The arguments defined by the user.
+		string   _positiveLabelName;
+		
+		double   _scaleFactor; //!< The ratio between two consecutive scales.
+		int      _step; //!< The step between two windows at the first scale.
+		double   _maxOverlap; //!< The maximum overlap between two detections.
+		
+		vector<CascadeStump> _stumps; //!< The weak hypotheses of all the stages.
+		vector<int>          _stageEnds; //!< The index of the stump after the last one of each stage.
+		vector<AlphaReal>    _stageThresholds; //!< The rejection threshold of each stage.
+		bool                 _resetStages; //!< If true, the output is reset at each stage (VJcascade).
+		
+	private:
+		
+		/**
+		 * Fake assignment operator to avoid warning.
+		 * \date 18/10/2026
+		 */
+		HaarCascadeDetector& operator=( const HaarCascadeDetector& ) {return *this;}
+		
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __HAAR_CASCADE_DETECTOR_H
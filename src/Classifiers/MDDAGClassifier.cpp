@@ -377,30 +377,31 @@ namespace MultiBoost {
 		const int numClasses = pData->getNumClasses();
 		const int numExamples = pData->getNumExamples();
 		
-		ofstream outFile(outFileName.c_str());
-		string exampleName;
-		
+		// the posteriors of each period are formatted and written by a background
+		// thread, while the next period is being computed
+		AsyncWriter outFile(outFileName);
+		if ( !outFile.is_open() )
+		{
+			cerr << "ERROR: cannot open the output stream (<" 
+				<< outFileName << ">) for the posteriors!" << endl;
+			exit(1);
+		}
+
+		// the names are shared by all the snapshots
+		vector<string> exampleNames(numExamples);
+		for (int i = 0; i < numExamples; ++i)
+			exampleNames[i] = pData->getExampleName(i);
+
 		if (_verbose > 0)
 			cout << "Output posteriors..." << flush;
-		
-		if (period<numIterations)
-			outFile << period << endl;
-		
+
+		PosteriorsJob* pJob = new PosteriorsJob( &exampleNames, 
+			period<numIterations ? nor_utils::int2string(period) : "" );
+		pJob->getPosteriors().resize(numExamples);
 		for (int i = 0; i < numExamples; ++i)
-		{
-			// output the name if it exists, otherwise the number
-			// of the example
-			exampleName = pData->getExampleName(i);
-			if ( !exampleName.empty() )
-				outFile << exampleName << ',';
-			
-			// output the posteriors
-			outFile << results[i]->getVotesVector()[0];
-			for (int l = 1; l < numClasses; ++l)
-				outFile << ',' << results[i]->getVotesVector()[l];
-			outFile << '\n';
-		}
-		
+			pJob->getPosteriors()[i] = results[i]->getVotesVector();
+		outFile.post( pJob, numExamples * numClasses * sizeof(AlphaReal) );
+
 		
 		for (int p=period; p<numIterations; p+=period )
 		{
@@ -410,24 +411,17 @@ namespace MultiBoost {
 			if ( _verbose > 0) {
 				cout << "Write out the posterios for iteration " << p << endl;
 			}
-			outFile << p+period << endl;
-			for (int i = 0; i < numExamples; ++i)
-			{
-				// output the name if it exists, otherwise the number
-				// of the example
-				exampleName = pData->getExampleName(i);
-				if ( !exampleName.empty() )
-					outFile << exampleName << ',';
-				
-				// output the posteriors
-				outFile << results[i]->getVotesVector()[0];
-				for (int l = 1; l < numClasses; ++l)
-					outFile << ',' << results[i]->getVotesVector()[l];
-				outFile << '\n';
-			}
 			
+			pJob = new PosteriorsJob( &exampleNames, nor_utils::int2string(p+period) );
+			pJob->getPosteriors().resize(numExamples);
+			for (int i = 0; i < numExamples; ++i)
+				pJob->getPosteriors()[i] = results[i]->getVotesVector();
+			outFile.post( pJob, numExamples * numClasses * sizeof(AlphaReal) );
 		}
 		
+		// wait for the writer before releasing the names
+		outFile.close();
+		
 		if (_verbose > 0)
 			cout << "Done!" << endl;
 		
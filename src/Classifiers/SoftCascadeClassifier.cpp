@@ -204,6 +204,10 @@ namespace MultiBoost {
 		cout << setw(10) << namemap.getNameFromIdx(1-positiveLabelIndex) << setw(10) << confMatrix[0][0] << setw(10) << confMatrix[0][1] << endl;
 		cout << setw(10) << namemap.getNameFromIdx(positiveLabelIndex) << setw(10) << confMatrix[1][0] << setw(10) << confMatrix[1][1] << endl;		
         
+        if (pOutInfo) {
+            delete pOutInfo;
+        }
+        
         if (pData) {
             delete pData;
         }
@@ -99,6 +99,35 @@ typedef float AlphaReal;
 */ 
 #define MB_DEBUG 0
 
+/**
+* The size of the file buffer of the asynchronous writer (see AsyncWriter), and the
+* amount of data that can wait in its queue before the producer is blocked.
+* \date 18/10/2026
+*/
+#define ASYNC_WRITER_BUFFER_SIZE (1 << 20)
+#define ASYNC_WRITER_MAX_QUEUED (64 << 20)
+
+/**
+* The number of Haar configurations drawn at once and evaluated in parallel by
+* HaarSingleStumpLearner. With time-based sampling the budget is checked between batches.
+* \date 18/10/2026
+*/
+#define HAAR_CONFIG_BATCH_SIZE 256
+
+/**
+* The number of images on which a Haar configuration is evaluated at once
+* (see HaarImageBlock).
+* \date 18/10/2026
+*/
+#define HAAR_BATCH_WIDTH 16
+
+/**
+* The maximum number of downsampled levels of the pyramid of the Haar integral
+* images (see HaarData::getPyramidBlock). Level l is downsampled by 2^l.
+* \date 19/10/2026
+*/
+#define HAAR_PYRAMID_MAX_LEVELS 3
+
 #define OUTPUT_SEPARATOR "\t" 
 #define HEADER_FIELD_LENGTH  "\t"
 //#define HEADER_FIELD_LENGTH  setiosflags(ios::left) << setw(7) 
@@ -151,7 +151,8 @@ namespace MultiBoost {
 		 25, 23,  1,  0, {Iris-versicolor 1, Iris-virginica -1}
 		 0,  1, 10, 12, {Iris-setosa +2, Iris-versicolor -1, Iris-virginica -3}
 		 \endverbatim
-		 * The sign is used to set the value of y[l], and the magnitude to initialize the weights.
+		 * The sign is used to set the value of y[l], and the magnitude to initialize the weights,
+		 * which are appended to \a weights.
 		 * In this case the labels the the example will respectively be:
 		 \verbatim
 		 -1, 0, 0
@@ -161,7 +162,8 @@ namespace MultiBoost {
 		 * \remark Internally this type of label is stored as sparse. This will have
 		 * a small hit in terms of memory, but nothing in terms of performance.
 		 */
-		void readExtendedLabels(istringstream& ss, vector<Label>& labels, NameMap& classMap);
+		void readExtendedLabels(istringstream& ss, vector<Label>& labels, vector<AlphaReal>& weights, 
+		                        NameMap& classMap);
 		
 		enum eTokenType
 		{
@@ -333,7 +333,7 @@ namespace MultiBoost {
 				ssSparse.clear();
 				ssSparse.str(tmpLine);
 
-				readExtendedLabels(ssSparse, currExample.getLabels(), classMap);
+				readExtendedLabels(ssSparse, currExample.getLabels(), currExample.getWeights(), classMap);
 			}
 			else // dense!
 			{
@@ -352,6 +352,10 @@ namespace MultiBoost {
 
 				readSimpleLabels(ssDense, currExample.getLabels(), classMap);
 			}
+
+			// the values can be moved elsewhere before the next example is read
+			if ( _pListener )
+				_pListener->exampleRead( static_cast<int>(i), currExample );
 		}
 
 		cout << "Done!" << endl;
@@ -395,7 +399,7 @@ namespace MultiBoost {
 
 	// ------------------------------------------------------------------------
 
-	void ArffParserBzip2::readExtendedLabels( istringstream& ss, vector<Label>& labels,
+	void ArffParserBzip2::readExtendedLabels( istringstream& ss, vector<Label>& labels, vector<AlphaReal>& weights,
 		NameMap& classMap )
 	{
 		string strLabel;
@@ -413,7 +417,7 @@ namespace MultiBoost {
 			ss >> weight;
 
 			tmpLabel.y = nor_utils::sign(weight);
-			tmpLabel.weight = abs(weight); // this will be used later in RawData to set the weights
+			weights.push_back( abs(weight) ); // this will be used later in RawData to set the weights
 
 			strLabel = nor_utils::trim(strLabel);
 			tmpLabel.idx = classMap.getIdxFromName(strLabel);
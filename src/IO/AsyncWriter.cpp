@@ -0,0 +1,223 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+#include <ctime>
+#include <chrono>
+
+#include "AsyncWriter.h"
+
+namespace MultiBoost {
+	
+	// -------------------------------------------------------------------------
+	
+	AsyncWriter::AsyncWriter(const string& fileName, size_t bufferSize)
+	: _isOpen(false), _queuedBytes(0), _closing(false)
+	{
+		// the buffer must be installed before opening the file
+		_streamBuffer.resize(bufferSize);
+		_outStream.rdbuf()->pubsetbuf(&_streamBuffer[0], _streamBuffer.size());
+		
+		_outStream.open(fileName.c_str());
+		_isOpen = _outStream.is_open();
+		
+		if (_isOpen)
+			_writerThread = thread(&AsyncWriter::writerLoop, this);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void AsyncWriter::write(string& str)
+	{
+		if (str.empty())
+			return;
+		
+		Item item;
+		item.str.swap(str);
+		item.size = item.str.size();
+		push(item);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void AsyncWriter::post(Job* pJob, size_t size)
+	{
+		Item item;
+		item.pJob = pJob;
+		item.size = size;
+		push(item);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void AsyncWriter::push(Item& item)
+	{
+		if (!_isOpen)
+		{
+			delete item.pJob;
+			return;
+		}
+		
+		unique_lock<mutex> lock(_mutex);
+		
+		// a single item larger than the bound is accepted once the queue is empty
+		while (!_queue.empty() && _queuedBytes + item.size > ASYNC_WRITER_MAX_QUEUED)
+			_queueNotFull.wait(lock);
+		
+		_queue.push_back(Item());
+		_queue.back().str.swap(item.str);
+		_queue.back().pJob = item.pJob;
+		_queue.back().size = item.size;
+		_queuedBytes += item.size;
+		
+		lock.unlock();
+		_queueNotEmpty.notify_one();
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void AsyncWriter::close()
+	{
+		if (!_writerThread.joinable())
+			return;
+		
+		{
+			lock_guard<mutex> lock(_mutex);
+			_closing = true;
+		}
+		_queueNotEmpty.notify_one();
+		_writerThread.join();
+		
+		_outStream.close();
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void AsyncWriter::writerLoop()
+	{
+		time_t lastFlush = time(NULL);
+		bool dirty = false;
+		
+		unique_lock<mutex> lock(_mutex);
+		
+		for (;;)
+		{
+			while (_queue.empty() && !_closing)
+			{
+				if (!dirty)
+				{
+					_queueNotEmpty.wait(lock);
+				}
+				else if (_queueNotEmpty.wait_for(lock, chrono::seconds(1)) == cv_status::timeout)
+				{
+					// idle for a while: let the data reach the disk
+					lock.unlock();
+					_outStream.flush();
+					lock.lock();
+					
+					dirty = false;
+					lastFlush = time(NULL);
+				}
+			}
+			
+			if (_queue.empty())
+				break; // closing and nothing left
+			
+			Item item;
+			item.str.swap(_queue.front().str);
+			item.pJob = _queue.front().pJob;
+			_queuedBytes -= _queue.front().size;
+			_queue.pop_front();
+			
+			lock.unlock();
+			_queueNotFull.notify_all();
+			
+			if (item.pJob)
+			{
+				item.pJob->format(_outStream);
+				delete item.pJob;
+			}
+			else
+			{
+				_outStream.write(item.str.data(), item.str.size());
+			}
+			dirty = true;
+			
+			// a busy producer must not delay the data forever
+			const time_t now = time(NULL);
+			if (now - lastFlush >= 1)
+			{
+				_outStream.flush();
+				dirty = false;
+				lastFlush = now;
+			}
+			
+			lock.lock();
+		}
+		
+		lock.unlock();
+		_outStream.flush();
+	}
+	
+	// -------------------------------------------------------------------------
+	// -------------------------------------------------------------------------
+	
+	void PosteriorsJob::format(ostream& outStream)
+	{
+		if (!_header.empty())
+			outStream << _header << '\n';
+		
+		const int numExamples = (int)_posteriors.size();
+		for (int i = 0; i < numExamples; ++i)
+		{
+			// output the name if it exists
+			if ( _pExampleNames && !(*_pExampleNames)[i].empty() )
+				outStream << (*_pExampleNames)[i] << ',';
+			
+			const vector<AlphaReal>& votes = _posteriors[i];
+			if (votes.empty())
+			{
+				outStream << '\n';
+				continue;
+			}
+			
+			outStream << votes[0];
+			for (int l = 1; l < (int)votes.size(); ++l)
+				outStream << ',' << votes[l];
+			outStream << '\n';
+		}
+	}
+	
+	// -------------------------------------------------------------------------
+	
+} // end of namespace MultiBoost
@@ -0,0 +1,208 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+/**
+ * \file AsyncWriter.h Buffered output file written by a background thread.
+ */
+
+#ifndef __ASYNC_WRITER_H
+#define __ASYNC_WRITER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Defaults.h"
+
+using namespace std;
+
+namespace MultiBoost {
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * An output file whose formatting and disk writes are done by a background thread.
+	 * The producer (the training or the classification loop) either hands over
+	 * already formatted chunks of text with write(), or posts a Job holding a snapshot
+	 * of the data to be formatted. The writer thread streams everything, in order,
+	 * into an ofstream with a large buffer. The buffer is flushed to the disk when
+	 * it is full, and otherwise at most once per second when the
+	 * queue is idle, so the file can still be followed during a long run.
+	 *
+	 * The queue is bounded (see ASYNC_WRITER_MAX_QUEUED): if the writer cannot keep up,
+	 * write() and post() block until there is room again.
+	 * \remark The file is complete only after close() (or the destructor) returns.
+	 * \date 18/10/2026
+	 */
+	class AsyncWriter
+	{
+	public:
+		
+		/**
+		 * A formatting task executed on the writer thread.
+		 * Subclasses must own (a copy of) all the data they format, since the
+		 * producer keeps on changing its own structures in the meantime.
+		 */
+		class Job
+		{
+		public:
+			virtual ~Job() {}
+			
+			/**
+			 * Format the snapshot into the stream.
+			 * \param outStream The (buffered) output file.
+			 */
+			virtual void format(ostream& outStream) = 0;
+		};
+		
+		/**
+		 * The constructor. Opens the file and starts the writer thread.
+		 * \param fileName The name of the output file.
+		 * \param bufferSize The size of the buffer of the output file.
+		 * \remark Use is_open() to check whether the file could be opened.
+		 */
+		explicit AsyncWriter(const string& fileName, size_t bufferSize = ASYNC_WRITER_BUFFER_SIZE);
+		
+		/**
+		 * The destructor. Writes what is left in the queue and stops the thread.
+		 */
+		~AsyncWriter() { close(); }
+		
+		/**
+		 * \return true if the output file is open.
+		 */
+		bool is_open() const { return _isOpen; }
+		
+		/**
+		 * Append a formatted chunk to the file. The string is swapped into the
+		 * queue, so it is empty when the method returns.
+		 * \param str The text to be written.
+		 */
+		void write(string& str);
+		
+		/**
+		 * Queue a formatting job. The writer takes the ownership of the job.
+		 * \param pJob The job to be formatted and deleted by the writer thread.
+		 * \param size The approximate size of the snapshot in bytes, used for the bound of the queue.
+		 */
+		void post(Job* pJob, size_t size = 0);
+		
+		/**
+		 * Write what is left in the queue, flush the file and stop the writer thread.
+		 * Can be called several times.
+		 */
+		void close();
+		
+	protected:
+		
+		/**
+		 * An element of the queue: either a chunk of text or a job.
+		 */
+		struct Item
+		{
+			Item() : pJob(NULL), size(0) {}
+			
+			string	str;
+			Job*	pJob;
+			size_t	size;
+		};
+		
+		/**
+		 * Add an item to the queue, waiting if the queue is full.
+		 */
+		void push(Item& item);
+		
+		/**
+		 * The loop of the writer thread.
+		 */
+		void writerLoop();
+		
+		ofstream				_outStream; //!< The output file.
+		vector<char>			_streamBuffer; //!< The buffer of the output file.
+		bool					_isOpen; //!< Whether the file could be opened.
+		
+		deque<Item>				_queue; //!< The chunks and jobs waiting to be written.
+		size_t					_queuedBytes; //!< The (approximate) size of the queue.
+		bool					_closing; //!< Set by close() to stop the writer thread.
+		
+		mutex					_mutex; //!< Protects the queue.
+		condition_variable		_queueNotEmpty; //!< Signaled when an item is added or on close().
+		condition_variable		_queueNotFull; //!< Signaled when the writer thread takes an item.
+		
+		thread					_writerThread; //!< The background thread.
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * Formats a snapshot of the posteriors of a dataset, one example per line,
+	 * the votes being separated by commas. It is the format of the --posteriors output.
+	 * \date 18/10/2026
+	 */
+	class PosteriorsJob : public AsyncWriter::Job
+	{
+	public:
+		
+		/**
+		 * The constructor.
+		 * \param pExampleNames The names of the examples (an empty name is not printed),
+		 * or NULL. The vector is not copied, it must outlive the writer.
+		 * \param header A line printed before the table (e.g. the iteration), or an empty string.
+		 */
+		PosteriorsJob(const vector<string>* pExampleNames, const string& header = "")
+		: _pExampleNames(pExampleNames), _header(header) {}
+		
+		/**
+		 * \return The table to be filled with the posteriors (example x class).
+		 */
+		vector< vector<AlphaReal> >& getPosteriors() { return _posteriors; }
+		
+		void format(ostream& outStream);
+		
+	protected:
+		
+		vector< vector<AlphaReal> >	_posteriors; //!< The snapshot of the posteriors.
+		const vector<string>*		_pExampleNames; //!< The names of the examples.
+		string						_header; //!< The line before the table.
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __ASYNC_WRITER_H
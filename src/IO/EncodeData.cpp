@@ -42,6 +42,11 @@ namespace MultiBoost {
 void EncodeData::resetData()
 { 
 	_pData->clearRawData();
+
+	// the examples in use follow the raw data
+	_numExamples = 0;
+	_indirectIndices.clear();
+	_rawIndices.clear();
 }
 
 
@@ -50,6 +55,10 @@ void EncodeData::resetData()
 void EncodeData::addExample(Example example)
 { 
 	_pData->addExample( example );
+
+	_indirectIndices.push_back( _numExamples );
+	_rawIndices.push_back( _numExamples );
+	++_numExamples;
 }
 
 } // end of namespace MultiBoost
@@ -63,7 +63,7 @@ namespace MultiBoost
 		 */
 		GenericParser(const string& fileName, const string& headerFileName)
 		: _fileName(fileName), _headerFileName(headerFileName), 
-		_dataRep(DR_DENSE), _labelRep(LR_DENSE), _hasWeigthInit(false) {}
+		_dataRep(DR_DENSE), _labelRep(LR_DENSE), _hasWeigthInit(false), _pListener(NULL) {}
 		
 		/**
 		 * Abstract function for reading data.
@@ -108,6 +108,14 @@ namespace MultiBoost
 		 */
 		bool  hasWeightInitialized()    const { return _hasWeigthInit; }
 		
+		/**
+		 * Set the object which receives each example once it is read by readData.
+		 * \param pListener The listener, or NULL.
+		 * \see ExampleListener
+		 * \date 19/10/2026
+		 */
+		void  setExampleListener(ExampleListener* pListener) { _pListener = pListener; }
+		
 	protected:
 		/**
 		 * The data file name.
@@ -140,6 +148,13 @@ namespace MultiBoost
 		 */
 		bool          _hasWeigthInit;
 		
+		/**
+		 * Receives each example once it is read, if not NULL.
+		 * \see ExampleListener
+		 * \date 19/10/2026
+		 */
+		ExampleListener* _pListener;
+		
 	};
 	
 	////////////////////////////////////////////////////////////////
@@ -49,6 +49,10 @@ namespace MultiBoost {
 	
 	HaarData::~HaarData()
 	{
+		// keep the outputs of the most selected configurations for the next trainings
+		if ( _responseCache.isEnabled() )
+			_responseCache.saveTopK(_loadedFeatures);
+		
 		// delete data
 		vector<int*>::iterator it;
 		//for (it = _intImages.begin(); it != _intImages.end(); ++it)
@@ -89,6 +93,30 @@ namespace MultiBoost {
 			_loadedFeatures.push_back( hf );
 		}
 		
+		if ( args.hasArgument("haarcache") )
+		{
+			const int cacheSize = args.getValue<int>("haarcache", 0);
+			_responseCache.setMaxMemory( static_cast<size_t>(cacheSize) << 20 );
+		}
+		
+		if ( args.hasArgument("haartopk") )
+		{
+			const int topK = args.getValue<int>("haartopk", 0);
+			_responseCache.setTopK( topK, args.getValue<string>("haartopk", 1) );
+		}
+		
+		// the bootstrapped examples are copied from the loaded values
+		_keepValues = args.hasArgument("bootstrap");
+		
+		if ( args.hasArgument("haarcompact") )
+		{
+			// the bootstrapped examples are copied from the loaded values
+			if ( args.hasArgument("bootstrap") )
+				cerr << "Warning: --haarcompact is ignored with --bootstrap!" << endl;
+			else
+				_compactImages = true;
+		}
+		
 		string tmpVal = args.getValue<string>("iisize", 0);
 		
 		size_t divPos = tmpVal.find('x');
@@ -105,6 +133,16 @@ namespace MultiBoost {
 		
 		ss.getline(val, 10);
 		_height = static_cast<short>( atoi(val) );
+		
+		if ( args.hasArgument("haarpyramid") )
+		{
+			_pyramidLevels = min( args.getValue<int>("haarpyramid", 0), HAAR_PYRAMID_MAX_LEVELS );
+			
+			// the coarsest level must keep at least one pixel
+			while ( _pyramidLevels > 0 && 
+				   ( (_width >> _pyramidLevels) == 0 || (_height >> _pyramidLevels) == 0 ) )
+				--_pyramidLevels;
+		}
 	}
 	
 	// ------------------------------------------------------------------------
@@ -225,7 +263,27 @@ namespace MultiBoost {
 		//// Initialize weights
 		//initWeights();
 		
+		// the integral images are moved into the block while they are read, with
+		// the smallest type, which is widened if an image needs it
+		_imageBlock.reset( _width * _height, _compactImages ? HVT_UINT16 : HVT_REAL );
+		_rawColumns.clear();
+		_imageBlockIndices.clear();
+		_maxPixel = 0;
+		_maxValue = 0;
+		if (_compactImages)
+			_maxBlockArea = HaarFeature::getMaxBlockArea();
+		
+		_pData->setExampleListener(this);
 		InputData::load(fileName, inputType, verboseLevel);
+		_pData->setExampleListener(NULL);
+		
+		updateImages();
+		
+		if ( verboseLevel > 0 && _imageBlock.getValueType() != HVT_REAL )
+		{
+			cout << "Compact integral images: " << (_imageBlock.getValueType() == HVT_UINT16 ? 16 : 32) 
+			     << " bits, " << (_imageBlock.getMemory() >> 10) << " KB.." << flush;
+		}
 		
 		// Test does not need sorting
 		if (inputType == IT_TEST)
@@ -248,6 +306,14 @@ namespace MultiBoost {
 		//if (verboseLevel > 0)
 		//   cout << endl;
 		
+		// the levels of the pyramid are built once, with the block of the images
+		if (_pyramidLevels > 0)
+		{
+			if (verboseLevel > 0)
+				cout << "Build the pyramid (" << _pyramidLevels << " levels).." << flush;
+			getImageBlock();
+		}
+		
 		//if (verboseLevel > 1)
 		//{
 		//   cout << "Num Columns = " << _numColumns << endl;  
@@ -265,6 +331,176 @@ namespace MultiBoost {
 	}
 	
 	// ------------------------------------------------------------------------
+	
+	void HaarData::exampleRead( int rawIdx, Example& example )
+	{
+		addImage( rawIdx, example.getValues() );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarData::addExample( Example example )
+	{
+		InputData::addExample(example);
+		updateImages();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarData::addImage(int rawIdx, vector<FeatureReal>& intImage)
+	{
+		if ( static_cast<int>(intImage.size()) < _width * _height )
+		{
+			cerr << "ERROR: the integral images are smaller than " << _width << "x" << _height << "!" << endl;
+			exit(1);
+		}
+		
+		if ( _imageBlock.getValueType() != HVT_REAL )
+			checkCompactImage(intImage);
+		
+		if ( rawIdx >= static_cast<int>(_rawColumns.size()) )
+			_rawColumns.resize(rawIdx + 1, -1);
+		
+		_rawColumns[rawIdx] = _imageBlock.getNumColumns();
+		_imageBlock.addImage(intImage);
+		
+		// the images in use have to be placed again
+		_imageBlockIndices.clear();
+		
+		// the block is the only copy of the image
+		if ( !_keepValues )
+			vector<FeatureReal>().swap(intImage);
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarData::updateImages()
+	{
+		const int numRawExamples = _pData->getNumExample();
+		for (int rawIdx = 0; rawIdx < numRawExamples; ++rawIdx)
+		{
+			if ( rawIdx >= static_cast<int>(_rawColumns.size()) || _rawColumns[rawIdx] < 0 )
+				addImage( rawIdx, _pData->getValues(rawIdx) );
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	const HaarImageBlock& HaarData::getImageBlock()
+	{
+		const vector<int>::iterator indicesEnd = _indirectIndices.begin() + _numExamples;
+		
+		if ( static_cast<int>(_imageBlockIndices.size()) == _numExamples &&
+			equal(_imageBlockIndices.begin(), _imageBlockIndices.end(), _indirectIndices.begin()) )
+			return _imageBlock;
+		
+		_imageBlockIndices.assign(_indirectIndices.begin(), indicesEnd);
+		
+		// the examples in use come first, in their order, followed by the others
+		const int numRawExamples = static_cast<int>( _rawColumns.size() );
+		vector<char> isUsed(numRawExamples, 0);
+		vector<int> rawIndices( _imageBlockIndices );
+		for (int i = 0; i < _numExamples; ++i)
+			isUsed[ _imageBlockIndices[i] ] = 1;
+		
+		for (int rawIdx = 0; rawIdx < numRawExamples; ++rawIdx)
+		{
+			if ( !isUsed[rawIdx] )
+				rawIndices.push_back(rawIdx);
+		}
+		
+		vector<int> order( rawIndices.size() );
+		for (size_t c = 0; c < rawIndices.size(); ++c)
+			order[c] = _rawColumns[ rawIndices[c] ];
+		
+		_imageBlock.reorder(order, _numExamples);
+		
+		for (size_t c = 0; c < rawIndices.size(); ++c)
+			_rawColumns[ rawIndices[c] ] = static_cast<int>(c);
+		
+		// the levels of the pyramid follow the block
+		for (int l = 1; l <= _pyramidLevels; ++l)
+			_pyramidBlocks[l - 1].downsample(_imageBlock, _width, _height, 1 << l);
+		
+		// the cached outputs were computed on the previous examples
+		if ( _responseCache.isEnabled() )
+			_responseCache.attach(_imageBlock);
+		
+		return _imageBlock;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	HaarResponseCache* HaarData::getResponseCache()
+	{
+		if ( !_responseCache.isEnabled() )
+			return NULL;
+		
+		// make sure that the cache is attached to the current examples
+		getImageBlock();
+		return &_responseCache;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarData::checkCompactImage(const vector<FeatureReal>& intImage)
+	{
+		// find the largest pixel and the largest value of the integral image,
+		// checking that the pixels are non-negative integers
+		FeatureReal maxPixel = _maxPixel;
+		FeatureReal maxValue = _maxValue;
+		bool isInteger = true;
+		
+		for (int y = 0; y < _height && isInteger; ++y)
+		{
+			for (int x = 0; x < _width; ++x)
+			{
+				const FeatureReal ii = intImage[y * _width + x];
+				const FeatureReal left = (x > 0) ? intImage[y * _width + x - 1] : 0;
+				const FeatureReal up = (y > 0) ? intImage[(y - 1) * _width + x] : 0;
+				const FeatureReal upLeft = (x > 0 && y > 0) ? intImage[(y - 1) * _width + x - 1] : 0;
+				
+				const FeatureReal pixel = ii - left - up + upLeft;
+				if ( pixel < 0 || ii != floor(ii) || pixel != floor(pixel) )
+				{
+					isInteger = false;
+					break;
+				}
+				
+				maxPixel = max(maxPixel, pixel);
+				maxValue = max(maxValue, ii);
+			}
+		}
+		
+		eHaarValueType valueType = _imageBlock.getValueType();
+		if ( !isInteger )
+		{
+			cerr << "Warning: the images do not have non-negative integer pixels, "
+			     << "--haarcompact is ignored!" << endl;
+			valueType = HVT_REAL;
+		}
+		else
+		{
+			_maxPixel = maxPixel;
+			_maxValue = maxValue;
+			
+			// the block sums are exact modulo 2^16 if the largest block cannot reach it
+			if ( valueType == HVT_UINT16 && static_cast<double>(_maxPixel) * _maxBlockArea >= 65536.0 )
+				valueType = HVT_UINT32;
+			
+			if ( valueType == HVT_UINT32 && static_cast<double>(_maxValue) >= 4294967296.0 )
+			{
+				cerr << "Warning: the integral images do not fit in 32 bits, --haarcompact is ignored!" << endl;
+				valueType = HVT_REAL;
+			}
+		}
+		
+		if ( valueType != _imageBlock.getValueType() )
+			_imageBlock.widen(valueType, _width);
+	}
+	
+	// ------------------------------------------------------------------------
+	
 	bool HaarData::checkInput(const string& line, int numColumns)
 	{
 		istringstream ss(line);
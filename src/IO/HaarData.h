@@ -45,6 +45,7 @@
 
 #include "IO/InputData.h"
 #include "WeakLearners/Haar/HaarFeatures.h"
+#include "WeakLearners/Haar/HaarResponseCache.h"
 #include "Utils/Utils.h" // for Rect
 
 #include <string>
@@ -91,10 +92,17 @@ namespace MultiBoost {
 	 \endcode
 	 * \date 17/12/2005
 	 */
-	class HaarData : public InputData
+	class HaarData : public InputData, public ExampleListener
 	{
 	public:
 		
+		/**
+		 * The constructor.
+		 * \date 18/10/2026
+		 */
+		HaarData() : _compactImages(false), _keepValues(false), _maxPixel(0), _maxValue(0), 
+		             _maxBlockArea(0), _pyramidLevels(0) {}
+		
 		/**
 		 * The destructor. Erases the integral image data.
 		 * \date 17/12/2005
@@ -114,16 +122,37 @@ namespace MultiBoost {
 		virtual void initOptions(const nor_utils::Args& args);
 		
 		/**
-		 * Overloading of the load function to read integral images files.
+		 * Overloading of the load function to read integral images files. The
+		 * integral images are moved into a HaarImageBlock while they are read,
+		 * and the block is their only copy (unless --bootstrap is used).
 		 * \param fileName The name of the file to be loaded.
 		 * \param inputType The type of input.
 		 * \param verboseLevel The level of verbosity.
 		 * \see InputData::load()
+		 * \see getImageBlock
 		 * \date 21/11/2005
 		 */
 		virtual void load(const string& fileName, 
 						  eInputType inputType = IT_TRAIN, int verboseLevel = 1);
 		
+		/**
+		 * Move the integral image of an example into the block, while the file
+		 * is read.
+		 * \param rawIdx The raw index of the example.
+		 * \param example The example.
+		 * \see ExampleListener
+		 * \date 19/10/2026
+		 */
+		virtual void exampleRead( int rawIdx, Example& example );
+		
+		/**
+		 * Overloading of InputData::addExample: the integral image of the new
+		 * example is added to the block.
+		 * \param example The example.
+		 * \date 19/10/2026
+		 */
+		virtual void addExample( Example example );
+		
 		/**
 		 * Overload the standard method for getting data and returns an error if called.
 		 * This function cannot be overloaded for the integral image type, as it is
@@ -154,6 +183,57 @@ namespace MultiBoost {
 		 */
 		vector<HaarFeature*>& getLoadedFeatures() { return _loadedFeatures; }
 		
+		/**
+		 * Get the block of the integral images, with the examples in use first,
+		 * in the current order (see HaarImageBlock::getNumImages). The columns
+		 * are permuted only when the set of examples has changed.
+		 * \see HaarImageBlock
+		 * \see HaarFeature::fillHaarData
+		 * \date 18/10/2026
+		 */
+		const HaarImageBlock& getImageBlock();
+		
+		/**
+		 * Get the cache of the outputs of the configurations on the current
+		 * examples (see getImageBlock).
+		 * \return The cache, or NULL if it has not been requested by the user.
+		 * \see HaarResponseCache
+		 * \date 18/10/2026
+		 */
+		HaarResponseCache* getResponseCache();
+		
+		/**
+		 * Get a downsampled level of the pyramid of the integral images of the 
+		 * examples (see getImageBlock). The levels are built with the block.
+		 * \param level The level, from 1 (2x) to getPyramidLevels() (2^level x).
+		 * \see HaarImageBlock::downsample
+		 * \date 19/10/2026
+		 */
+		const HaarImageBlock& getPyramidBlock(int level)
+		{
+			getImageBlock();
+			return _pyramidBlocks[level - 1];
+		}
+		
+		/**
+		 * Get the number of downsampled levels of the pyramid (see --haarpyramid),
+		 * 0 if there is no pyramid.
+		 * \date 19/10/2026
+		 */
+		int getPyramidLevels() const { return _pyramidLevels; }
+		
+		/**
+		 * Get the output of a feature on example \a idx, from its column of
+		 * the block of the integral images.
+		 * \param idx The index of the example.
+		 * \param pFeature The type of the feature.
+		 * \param config The configuration of the feature.
+		 * \see HaarFeature::getValue
+		 * \date 18/10/2026
+		 */
+		FeatureReal getHaarValue(int idx, HaarFeature* pFeature, const nor_utils::Rect& config)
+		{ return pFeature->getValue( _imageBlock, _rawColumns[ _indirectIndices[idx] ], config ); }
+		
 		//////////////////////////////////////////////////////////////////////////
 		
 		/**
@@ -171,6 +251,34 @@ namespace MultiBoost {
 	protected:
 		bool checkInput(const string& line, int numColumns);
 		
+		/**
+		 * Copy the integral image of an example into a new column of the block,
+		 * and release the loaded values unless they are kept.
+		 * \param rawIdx The raw index of the example.
+		 * \param intImage The integral image.
+		 * \date 19/10/2026
+		 */
+		void addImage(int rawIdx, vector<FeatureReal>& intImage);
+		
+		/**
+		 * Add to the block the integral images of the examples which are not
+		 * there yet: the ones which have not been given to exampleRead, and the
+		 * ones added after the loading.
+		 * \date 19/10/2026
+		 */
+		void updateImages();
+		
+		/**
+		 * With the integer types, check the pixels of a new integral image, and
+		 * widen the type of the block if it does not keep the sums of all the 
+		 * blocks exact anymore (see HaarImageBlock::widen). The block turns to 
+		 * HVT_REAL if the images do not have non-negative integer pixels, or if 
+		 * the integral images do not fit in 32 bits.
+		 * \param intImage The integral image.
+		 * \date 18/10/2026
+		 */
+		void checkCompactImage(const vector<FeatureReal>& intImage);
+		
 		//vector< int* >   _intImages;       //!< the data of the examples.
 		
 		static short   _width;  //!< The width of the integral image.
@@ -180,6 +288,20 @@ namespace MultiBoost {
 		 * The list of features that have been requested by the user.
 		 */
 		vector<HaarFeature*> _loadedFeatures; //!< 
+		
+		HaarImageBlock	_imageBlock; //!< The integral images of all the examples.
+		vector<int>		_rawColumns; //!< The column of each raw example in _imageBlock (-1 if not there).
+		vector<int>		_imageBlockIndices; //!< The raw indices of the images in use of _imageBlock.
+		HaarResponseCache	_responseCache; //!< The outputs of the configurations on _imageBlock.
+		
+		bool			_compactImages; //!< Store the integral images as integers (--haarcompact).
+		bool			_keepValues; //!< Keep the loaded values, which are copied by --bootstrap.
+		FeatureReal		_maxPixel; //!< The largest pixel of the integral images with the integer types.
+		FeatureReal		_maxValue; //!< The largest value of the integral images with the integer types.
+		int				_maxBlockArea; //!< The largest area of a block (see HaarFeature::getMaxBlockArea).
+		
+		int				_pyramidLevels; //!< The number of downsampled levels of the pyramid.
+		HaarImageBlock	_pyramidBlocks[HAAR_PYRAMID_MAX_LEVELS]; //!< The levels of the pyramid of _imageBlock.
 	};
 	
 } // end of namespace Multiboost
@@ -0,0 +1,105 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+
+#include "IO/IndexView.h"
+#include "IO/InputData.h"
+
+#include <algorithm> // for sort, unique
+
+namespace MultiBoost {
+	
+	// ------------------------------------------------------------------------
+	
+	void IndexView::addRawIndex( int rawIdx, const vector<Label>& labels )
+	{
+		if ( ! _indices.empty() && _indices.back() >= rawIdx )
+			_isSorted = false;
+		
+		_indices.push_back( rawIdx );
+		
+		vector<Label>::const_iterator lIt;
+		for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+		{
+			if ( lIt->y > 0 )
+			{
+				if ( lIt->idx >= (int)_nExamplesPerClass.size() )
+					_nExamplesPerClass.resize( lIt->idx + 1, 0 );
+				_nExamplesPerClass[lIt->idx]++;
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void IndexView::addExample( InputData* pData, int idx )
+	{
+		addRawIndex( pData->getRawIndex(idx), pData->getLabels(idx) );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void IndexView::sort( InputData* pData )
+	{
+		if ( _isSorted ) return;
+		
+		std::sort( _indices.begin(), _indices.end() );
+		_isSorted = true;
+		
+		vector<int>::iterator last = unique( _indices.begin(), _indices.end() );
+		if ( last == _indices.end() ) return;
+		
+		// the duplicates were counted twice
+		_indices.erase( last, _indices.end() );
+		_nExamplesPerClass.clear();
+		
+		vector<int> indices;
+		indices.swap( _indices );
+		for ( vector<int>::iterator it = indices.begin(); it != indices.end(); ++it )
+			addRawIndex( *it, pData->getRawLabels(*it) );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void IndexView::swap( IndexView& other )
+	{
+		_indices.swap( other._indices );
+		_nExamplesPerClass.swap( other._nExamplesPerClass );
+		std::swap( _isSorted, other._isSorted );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+} // end of namespace MultiBoost
@@ -0,0 +1,135 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+/**
+ * \file IndexView.h A sorted subset of the examples of a dataset.
+ */
+
+#ifndef __INDEX_VIEW_H
+#define __INDEX_VIEW_H
+
+#include <vector>
+
+#include "Others/Example.h" // for Label
+
+using namespace std;
+
+namespace MultiBoost {
+	
+	class InputData;
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * A subset of the examples of a dataset, given by the raw indices of the examples
+	 * in increasing order together with the number of positive examples per class.
+	 * It replaces the set<int> that was used to filter an InputData: a view is built
+	 * in O(k) by appending the examples one by one, and a view can be built from the
+	 * examples of the view currently loaded into an InputData (e.g. the children of
+	 * a tree node are built from the view of the node itself).
+	 * \see InputData::loadIndexView()
+	 * \see InputData::getIndexView()
+	 * \date 18/10/2026
+	 */
+	class IndexView
+	{
+	public:
+		
+		/**
+		 * The constructor. It creates an empty view.
+		 */
+		IndexView() : _isSorted(true) {}
+		
+		/**
+		 * Add an example to the view.
+		 * \param rawIdx The raw index of the example.
+		 * \param labels The labels of the example, used to update the class counts.
+		 * \remark If the examples are not added in increasing order, the view is sorted
+		 * when it is loaded.
+		 */
+		void addRawIndex( int rawIdx, const vector<Label>& labels );
+		
+		/**
+		 * Add an example of the subset currently used by \a pData to the view.
+		 * \param pData The dataset.
+		 * \param idx The index of the example in the current subset of \a pData.
+		 * \remark Looping on the examples of \a pData in order keeps the view sorted.
+		 */
+		void addExample( InputData* pData, int idx );
+		
+		/**
+		 * Sort the raw indices in increasing order (and remove the duplicates).
+		 * \param pData The dataset used to recount the examples per class if 
+		 * duplicates were removed.
+		 */
+		void sort( InputData* pData );
+		
+		/**
+		 * Remove all the examples from the view.
+		 */
+		void clear() { _indices.clear(); _nExamplesPerClass.clear(); _isSorted = true; }
+		
+		/**
+		 * Exchange the content of two views in constant time.
+		 */
+		void swap( IndexView& other );
+		
+		int  size() const { return (int)_indices.size(); } //!< The number of examples in the view.
+		bool empty() const { return _indices.empty(); } //!< True if there is no example in the view.
+		bool isSorted() const { return _isSorted; } //!< True if the raw indices are increasing.
+		
+		int  getRawIndex( int i ) const { return _indices[i]; } //!< The raw index of the i-th example.
+		const vector<int>& getRawIndices() const { return _indices; } //!< The raw indices of the view.
+		
+		/**
+		 * Get the number of positive examples of a class in the view.
+		 * \param classIdx The index of the class.
+		 */
+		int  getNumExamplesPerClass( int classIdx ) const
+		{ return classIdx < (int)_nExamplesPerClass.size() ? _nExamplesPerClass[classIdx] : 0; }
+		
+		const vector<int>& getExamplesPerClass() const { return _nExamplesPerClass; } //!< The class counts.
+		
+	protected:
+		
+		vector<int>	_indices; //!< The raw indices of the examples.
+		vector<int>	_nExamplesPerClass; //!< The number of positive examples per class.
+		bool		_isSorted; //!< True if _indices is increasing.
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __INDEX_VIEW_H
@@ -70,6 +70,10 @@ namespace MultiBoost {
         }
         
         this->_indirectIndices.push_back(exampleIndex);
+		// when a subset is in use the tail of _indirectIndices is not meaningful:
+		// the new example has to follow the examples of the subset
+		if ( this->_numExamples < (int)this->_indirectIndices.size() - 1 )
+			swap( this->_indirectIndices[this->_numExamples], this->_indirectIndices.back() );
 		this->_rawIndices.push_back(this->_numExamples);
         //this->_rawIndices[exampleIndex] = this->_numExamples;
         
@@ -83,53 +87,104 @@ namespace MultiBoost {
 	
     // ------------------------------------------------------------------------
 	
-	int	InputData::loadIndexSet( set< int > ind ) {
-		int i = 0;
-		//upload the indirection
-		for (int j = 0; j < this->_rawIndices.size(); j++) this->_rawIndices[j] = -1;
-
-		map<int, int> tmpPointsPerClass;
+	int	InputData::loadIndexSet( const set< int >& ind ) {
+		IndexView view;
+		for( set< int >::const_iterator it = ind.begin(); it != ind.end(); it++ )
+			view.addRawIndex( *it, _pData->getLabels( *it ) );
 		
-		for( set< int >::iterator it = ind.begin(); it != ind.end(); it++ ) {
-			this->_indirectIndices[i] = *it;
-			this->_rawIndices[*it] = i;
-			
-			i++;
-			
-			const vector<Label>& labels = _pData->getLabels( *it );
-			vector<Label>::const_iterator lIt;
-			
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-			{
-				switch ( this->_pData->getLabelRep() ) {
-					case LR_DENSE:
-						if ( lIt->y > 0 )
-							tmpPointsPerClass[lIt->idx]++;
-						break;
-					case LR_SPARSE:
-						if ( lIt->y > 0 )
-							tmpPointsPerClass[lIt->idx]++;
-						break;
-				}
-			}
+		return loadIndexView( view );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	int	InputData::loadIndexView( const IndexView& view ) {
+		if ( ! view.isSorted() ) {
+			IndexView sortedView( view );
+			sortedView.sort( this );
+			return loadIndexView( sortedView );
 		}
 		
-		_nExamplesPerClass.clear();
-		for (int l = 0; l < this->_pData->getNumClasses(); ++l)
-			_nExamplesPerClass.push_back( tmpPointsPerClass[l] );
+		// only the entries of the previous subset are set
+		for (int i = 0; i < this->_numExamples; i++) this->_rawIndices[ this->_indirectIndices[i] ] = -1;
 		
+		const vector<int>& ind = view.getRawIndices();
+		for (int i = 0; i < (int)ind.size(); i++) {
+			this->_indirectIndices[i] = ind[i];
+			this->_rawIndices[ ind[i] ] = i;
+		}
+		
+		_nExamplesPerClass = view.getExamplesPerClass();
+		_nExamplesPerClass.resize( this->_pData->getNumClasses(), 0 );
 		
-		this->_numExamples = (int)ind.size();
+		this->_numExamples = view.size();
         
         _subsetAlreadyComputed = false;
         
 		return 0;
 	}
 	
+	// ------------------------------------------------------------------------
+	
+	void InputData::getIndexView( IndexView& view ) {
+		view.clear();
+		for (int i = 0; i < this->_numExamples; i++)
+			view.addRawIndex( this->_indirectIndices[i], _pData->getLabels( this->_indirectIndices[i] ) );
+	}
+	
+	
+	// ------------------------------------------------------------------------
+	
+	void InputData::initView( const InputData& other ) {
+		if ( _pData && !_isView ) delete _pData;
+		_pData = other._pData;
+		_isView = true;
+		
+		_hasExampleName = other._hasExampleName;
+		_classInLastColumn = other._classInLastColumn;
+		_indirectIndices = other._indirectIndices;
+		_rawIndices = other._rawIndices;
+		_numExamples = other._numExamples;
+		_nExamplesPerClass = other._nExamplesPerClass;
+		_subsetAlreadyComputed = false;
+		
+		_pLabelOverlay = other._pLabelOverlay;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void InputData::beginLabelOverlay() {
+		if ( _pLabelOverlay ) {
+			cerr << "ERROR: the labels of the data are already replaced (nested ProductLearner?)!" << endl;
+			exit(1);
+		}
+		
+		const int numClasses = _pData->getNumClasses();
+		const size_t overlaySize = static_cast<size_t>( _pData->getNumExample() ) * numClasses;
+		if ( _labelOverlay.size() != overlaySize )
+			_labelOverlay.resize( overlaySize );
+		_pLabelOverlay = &_labelOverlay[0];
+		
+		// only the examples in use are copied
+		for ( int i = 0; i < _numExamples; ++i ) {
+			const int rawIdx = _indirectIndices[i];
+			const vector<Label>& labels = _pData->getLabels( rawIdx );
+			signed char* overlayRow = _pLabelOverlay + rawIdx * numClasses;
+			
+			for ( vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt )
+				overlayRow[ lIt->idx ] = lIt->y;
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void InputData::endLabelOverlay() {
+		_pLabelOverlay = NULL;
+	}
 	
 	// ------------------------------------------------------------------------
 	
 	void InputData::clearIndexSet( void ) {
+		if ( ! this->isFiltered() ) return;
 		
 		for( int i = 0; i < this->_pData->getNumExample(); i++ ) {
 			this->_indirectIndices[ i ] = i;
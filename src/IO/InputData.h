@@ -54,6 +54,7 @@
 #include "NameMap.h"
 #include "Others/Example.h"
 #include "RawData.h"
+#include "IndexView.h"
 
 //#include "Parser.h"
 #include <cassert>
@@ -99,7 +100,18 @@ namespace MultiBoost {
 		 * The constructor. It does noting but initializing some variables.
 		 * \date 12/11/2005
 		 */
-		InputData() : _hasExampleName(false), _subsetAlreadyComputed(false), _classInLastColumn(false), _numExamples(0) { _pData = new RawData(); }
+		InputData() : _hasExampleName(false), _classInLastColumn(false), _subsetAlreadyComputed(false), _isView(false),
+					  _pLabelOverlay(NULL), _numExamples(0) { _pData = new RawData(); }
+		
+		/**
+		 * Create a view of the data: an object that shares the examples (and their weights)
+		 * with this one, but has its own subset of examples in use. Several threads can
+		 * then train learners on different subsets at the same time (see TreeLearner).
+		 * The view starts with the subset in use, and it must be destroyed before this object.
+		 * \return The view, or NULL if the type of the data has no views.
+		 * \date 19/10/2026
+		 */
+		virtual InputData* createView() { return NULL; }
 		
 		
 		virtual int getOrderBasedOnRawIndex( int rawIndex ) {
@@ -165,8 +177,123 @@ namespace MultiBoost {
 		 * \return The labels of the example [idx].
 		 * \date 10/11/2005
 		 */
-		inline const vector<Label>& getLabels(const int idx) const { return _pData->getLabels( _indirectIndices[idx] ); }
-		inline       vector<Label>& getLabels(const int idx)       { return _pData->getLabels( _indirectIndices[idx] ); }
+		inline const vector<Label>& getLabels(const int idx) const 
+		{ return _pData->getLabels( _indirectIndices[idx] ); }
+		inline       vector<Label>& getLabels(const int idx)       
+		{ return _pData->getLabels( _indirectIndices[idx] ); }
+		
+		/**
+		 * Gets the labels of the example with a given raw index, regardless of the
+		 * subset in use.
+		 * \param rawIdx The raw index of the example.
+		 * \date 18/10/2026
+		 */
+		inline const vector<Label>& getRawLabels(const int rawIdx) const 
+		{ return _pData->getLabels( rawIdx ); }
+		
+		/**
+		 * Gets the value (+1, -1 or 0) of a label of the given example, which is
+		 * the one of the overlay if there is one (see beginLabelOverlay()). The learners
+		 * must read the labels with this method rather than from the Label objects.
+		 * \param idx The index of the example.
+		 * \param label A label of the example, from getLabels( \a idx ).
+		 * \date 19/10/2026
+		 */
+		inline char getLabelY(const int idx, const Label& label) const
+		{ return _pLabelOverlay ? _pLabelOverlay[ _indirectIndices[idx] * getNumClasses() + label.idx ] : label.y; }
+		
+		/**
+		 * Gets the values of the labels of the overlay (see beginLabelOverlay()) for
+		 * the given example, indexed by class.
+		 * \param idx The index of the example.
+		 * \return NULL if the labels are not overlaid.
+		 * \date 19/10/2026
+		 */
+		inline const signed char* getLabelOverlayRow(const int idx) const
+		{ return _pLabelOverlay ? _pLabelOverlay + _indirectIndices[idx] * getNumClasses() : NULL; }
+		
+		/**
+		 * Gets the current weight of a label of the given example. The weights are 
+		 * owned by the example, or by the LabelMatrix with the compact labels, so 
+		 * the learners must read the weights with this method.
+		 * \param idx The index of the example.
+		 * \param label A label of the example, from getLabels( \a idx ) (not a copy).
+		 * \date 19/10/2026
+		 */
+		inline AlphaReal getLabelWeight(const int idx, const Label& label) const
+		{ return _pData->getLabelWeight( _indirectIndices[idx], label ); }
+		
+		/**
+		 * Sets the current weight of a label of the given example.
+		 * \param idx The index of the example.
+		 * \param label A label of the example, from getLabels( \a idx ) (not a copy).
+		 * \param w The new weight.
+		 * \see syncCompactLabels()
+		 * \date 19/10/2026
+		 */
+		inline void setLabelWeight(const int idx, const Label& label, AlphaReal w)
+		{ _pData->setLabelWeight( _indirectIndices[idx], label, w ); }
+		
+#ifndef NOTIWEIGHT
+		/**
+		 * Gets the initial weight of a label of the given example. With the compact
+		 * labels they are kept only if an output of --outputinfo needs them
+		 * (see OutputInfo::needsInitialWeights()).
+		 * \param idx The index of the example.
+		 * \param label A label of the example, from getLabels( \a idx ) (not a copy).
+		 * \date 19/10/2026
+		 */
+		inline AlphaReal getLabelInitialWeight(const int idx, const Label& label) const
+		{ return _pData->getLabelInitialWeight( _indirectIndices[idx], label ); }
+#endif
+		
+		/**
+		 * True if the labels and the weights are available in the compact LabelMatrix.
+		 * Its rows are indexed by the raw index of the examples (see getRawIndex()).
+		 * With a label overlay, the values of the labels must be taken from 
+		 * getLabelOverlayRow().
+		 * \see LabelMatrix
+		 */
+		inline bool hasCompactLabels() const { return _pData->hasCompactLabels(); }
+		inline       LabelMatrix& getLabelMatrix()       { return _pData->getLabelMatrix(); }
+		inline const LabelMatrix& getLabelMatrix() const { return _pData->getLabelMatrix(); }
+		
+		/**
+		 * Refresh the labels of the compact LabelMatrix from the Label objects, and
+		 * the aggregated weights of the sparse labels. Call it after modifying the 
+		 * labels through getLabels() or setting the weights with setLabelWeight().
+		 * With a label overlay, change the labels with setOverlayLabel() instead.
+		 */
+		inline void syncCompactLabels() { _pData->syncCompactLabels(); }
+		
+		/**
+		 * Replace the values of the labels of the examples in use, so that a learner
+		 * can train its base learners on modified labels (see ProductLearner) without
+		 * touching the Label objects, which are shared with the other learners and views.
+		 * Only the values are overlaid, in an (example x class) array that is allocated
+		 * at the first call and kept for the next ones; the weights are still the ones
+		 * of the shared labels. Until endLabelOverlay(), getLabelY() and 
+		 * getLabelOverlayRow() return the overlaid values, and the views created by
+		 * createView() share them. The overlay starts with the shared values.
+		 * \date 19/10/2026
+		 */
+		void beginLabelOverlay();
+		
+		/**
+		 * Change a label of the overlay (see beginLabelOverlay()).
+		 * \param idx The index of the example.
+		 * \param labelIdx The class of the label.
+		 * \param y The new label (+1, -1 or 0).
+		 * \date 19/10/2026
+		 */
+		inline void setOverlayLabel( const int idx, const int labelIdx, const char y )
+		{ _pLabelOverlay[ _indirectIndices[idx] * getNumClasses() + labelIdx ] = y; }
+		
+		/**
+		 * Go back to the shared labels (see beginLabelOverlay()).
+		 * \date 19/10/2026
+		 */
+		void endLabelOverlay();
 		
 		inline const bool  hasLabel(const int idx, const int labelIdx) const 
 		{ return _pData->hasLabel( _indirectIndices[idx], labelIdx); }
@@ -175,15 +302,28 @@ namespace MultiBoost {
 		{ return _pData->hasPositiveLabel( _indirectIndices[idx], labelIdx); }
 		
 		/**
-		 * Get the values of the example \a idx
+		 * Get the values of the (dense) example \a idx.
+		 * \param idx The index of the example.
+		 * \date 19/10/2026
+		 */   
+		inline const FeatureReal* getValueRow(int idx) const 
+		{ return _pData->getValueRow( _indirectIndices[idx] ); }
+		
+		/**
+		 * Get the values of the example \a idx, to modify them.
 		 * \param idx The index of the example.
 		 * \date 11/11/2005
 		 */   
-		inline const vector<FeatureReal>& getValues(int idx) const 
-		{ return _pData->getValues( _indirectIndices[idx] ); }
 		inline       vector<FeatureReal>& getValues(int idx) 
 		{ return _pData->getValues( _indirectIndices[idx] ); }
 		
+		/**
+		 * Copy the values shared through a value matrix back into the examples,
+		 * before they are used or modified (see RawData::restoreValues()).
+		 * \date 19/10/2026
+		 */
+		void restoreValues() { _pData->restoreValues(); }
+		
 		//////////////////////////////////////////////////////////////////////////
 		//////////////////////////////////////////////////////////////////////////
 		// IMPORTANT: This is a temporary version that assumes all the data
@@ -208,8 +348,8 @@ namespace MultiBoost {
                 
 			  if ( ! _subsetAlreadyComputed ) {
 			    _subset.clear();
-			    for(int i = 0; i < _rawIndices.size(); i++) {
-			      if (_rawIndices[i] > -1) _subset.push_back( this->getExample(_rawIndices[i]) );
+			    for(int i = 0; i < _numExamples; i++) {
+			      _subset.push_back( this->getExample(i) );
 			    }                    
 			  }
                 
@@ -269,23 +409,37 @@ namespace MultiBoost {
 		 * \param the set which contains the indices
 		 * \data 12/10/2009
 		 */
-		virtual int		loadIndexSet( set< int > ind );	
+		virtual int		loadIndexSet( const set< int >& ind );	
 		//TODO: comment		
 		virtual void getIndexSet( set< int >& ind )
 		{
-		  // XXX fradav small caution here : we have to extract the set from the _rawIndices
 		  ind.clear();
-		  for (int i = 0; i < _rawIndices.size(); i++) {
-		    if (_rawIndices[i] > -1) ind.insert(i);
-		  }
+		  for (int i = 0; i < _numExamples; i++) ind.insert( ind.end(), _indirectIndices[i] );
 		}
 		
+		/**
+		 * Set the subset we use from a view. Only the examples of the previous subset
+		 * and of the new one are touched, and the class counts are taken from the view,
+		 * so the cost is linear in the size of the subsets, not in the size of the dataset.
+		 * \param view The subset of examples, given by their raw indices.
+		 * \see IndexView
+		 * \date 18/10/2026
+		 */
+		virtual int		loadIndexView( const IndexView& view );
+		
+		/**
+		 * Get the subset in use as a view.
+		 * \param view The view that receives the raw indices of the examples in use.
+		 * \date 18/10/2026
+		 */
+		virtual void	getIndexView( IndexView& view );
+		
 		
 		/**
 		 * Clear the indices of subset we use, the whole dataset containing _pData will be used 
 		 * 	* \data 12/10/2009
 		 */
-		void	clearIndexSet( void );
+		virtual void	clearIndexSet( void );
 		
 		//TODO: comment				
 		void clearRawData() { _pData->clearRawData(); } 		
@@ -299,9 +453,8 @@ namespace MultiBoost {
 		FeatureReal getFeaturewiseMax( int idx ) {
 			FeatureReal max = numeric_limits<FeatureReal>::min();
 			for( int i = 0; i < this->getNumExamples(); i++ ) {
-				Example e = getExample( i );
-				vector<FeatureReal> v = e.getValues();
-				if ( max > v[idx] ) max = v[idx];
+				const FeatureReal v = getValue( i, idx );
+				if ( max > v ) max = v;
 			}
 			return max;
 		}
@@ -310,23 +463,37 @@ namespace MultiBoost {
 		FeatureReal getFeaturewiseMin( int idx ) {
 			FeatureReal min = numeric_limits<FeatureReal>::max();
 			for( int i = 0; i < this->getNumExamples(); i++ ) {
-				Example e = getExample( i );
-				vector<FeatureReal> v = e.getValues();
-				if ( min < v[idx] ) min = v[idx];
+				const FeatureReal v = getValue( i, idx );
+				if ( min < v ) min = v;
 			}
 			return min;
 		}
 		//TODO: comment        
-		void addExample( Example example );
+		virtual void addExample( Example example );
 		
 		void setInitWeighting( eWeightInitType weightInitType ) {_pData->setInitWeighting( weightInitType); }
 		
 		virtual ~InputData()
 		{
-			if (_pData) delete _pData;
+			endLabelOverlay();
+			if (_pData && !_isView) delete _pData;
 		}
 		
 	protected:
+		
+		/**
+		 * Make this object a view of \a other (see createView()): the raw data is shared 
+		 * and the subset in use is copied.
+		 * \param other The data to be viewed.
+		 * \date 19/10/2026
+		 */
+		void initView( const InputData& other );
+		
+		bool			_isView; //!< True if _pData belongs to another object (see createView()).
+		
+		vector<signed char>	_labelOverlay; //!< The values of the overlaid labels, by raw index and class (see beginLabelOverlay()).
+		signed char*		_pLabelOverlay; //!< The overlay in use (which belongs to the viewed data for a view), NULL for the shared labels.
+		
 		int           _numExamples;  //!<  The number of examples.
 		vector<int>   _nExamplesPerClass;   //!< The number of examples per class.
 		
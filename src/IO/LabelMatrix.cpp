@@ -0,0 +1,243 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+#include "IO/LabelMatrix.h"
+
+namespace MultiBoost {
+	
+	// ------------------------------------------------------------------------
+	
+	void LabelMatrix::build( const vector<Example>& data, int numClasses, eLabelRep labelRep, bool keepInitialWeights,
+							 bool floatWeights )
+	{
+		clear();
+		
+		_numRows = static_cast<int>( data.size() );
+		_numClasses = numClasses;
+		
+		// the dense layout needs exactly one label per class, stored at the position
+		// of its index. If it is not the case, fall back on the sparse layout.
+		_isDense = ( labelRep == LR_DENSE );
+		
+		vector<Example>::const_iterator eIt;
+		vector<Label>::const_iterator lIt;
+		int numLabels = 0;
+		
+		for ( eIt = data.begin(); eIt != data.end(); ++eIt )
+		{
+			const vector<Label>& labels = eIt->getLabels();
+			numLabels += static_cast<int>( labels.size() );
+			
+			if ( _isDense )
+			{
+				if ( static_cast<int>( labels.size() ) != _numClasses )
+					_isDense = false;
+				else
+				{
+					int l = 0;
+					for ( lIt = labels.begin(); lIt != labels.end(); ++lIt, ++l )
+					{
+						if ( lIt->idx != l )
+						{
+							_isDense = false;
+							break;
+						}
+					}
+				}
+			}
+		}
+		
+		_hasFloatWeights = floatWeights;
+		if ( _hasFloatWeights )
+			_floatWeights.resize( numLabels );
+		else
+			_weights.resize( numLabels );
+		_ys.resize( numLabels );
+		
+#ifndef NOTIWEIGHT
+		_hasInitialWeights = keepInitialWeights;
+		if ( _hasInitialWeights )
+			_initialWeights.resize( numLabels );
+#endif
+		
+		if ( !_isDense )
+		{
+			_rowOffsets.resize( _numRows + 1 );
+			_classIdxs.resize( numLabels );
+			_negWeights.resize( _numRows );
+			
+			int pos = 0;
+			int row = 0;
+			for ( eIt = data.begin(); eIt != data.end(); ++eIt, ++row )
+			{
+				_rowOffsets[row] = pos;
+				const vector<Label>& labels = eIt->getLabels();
+				for ( lIt = labels.begin(); lIt != labels.end(); ++lIt, ++pos )
+					_classIdxs[pos] = lIt->idx;
+			}
+			_rowOffsets[_numRows] = pos;
+		}
+		
+		// the weights given by the data file, if any, the initial ones are set later
+		int pos = 0;
+		for ( eIt = data.begin(); eIt != data.end(); ++eIt )
+		{
+			const vector<AlphaReal>& weights = eIt->getWeights();
+			const int numRowLabels = static_cast<int>( eIt->getLabels().size() );
+			for ( int l = 0; l < numRowLabels; ++l, ++pos )
+				setWeight( pos, weights.empty() ? 1 : weights[l] );
+		}
+		
+		updateValues( data );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void LabelMatrix::storeInitialWeights()
+	{
+#ifndef NOTIWEIGHT
+		if ( !_hasInitialWeights )
+			return;
+		
+		const int numLabels = static_cast<int>( _ys.size() );
+		for ( int pos = 0; pos < numLabels; ++pos )
+			_initialWeights[pos] = getWeight(pos);
+#endif
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void LabelMatrix::updateValues( const vector<Example>& data )
+	{
+		vector<Example>::const_iterator eIt;
+		vector<Label>::const_iterator lIt;
+		
+		int pos = 0;
+		int row = 0;
+		for ( eIt = data.begin(); eIt != data.end(); ++eIt, ++row )
+		{
+			const vector<Label>& labels = eIt->getLabels();
+			AlphaReal negWeight = 0;
+			
+			for ( lIt = labels.begin(); lIt != labels.end(); ++lIt, ++pos )
+			{
+				_ys[pos] = lIt->y;
+				if ( lIt->y < 0 )
+					negWeight += getWeight(pos);
+			}
+			
+			if ( !_isDense )
+				_negWeights[row] = negWeight;
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void LabelMatrix::copyWeightsTo( vector<Example>& data ) const
+	{
+		vector<Example>::iterator eIt;
+		
+		int pos = 0;
+		for ( eIt = data.begin(); eIt != data.end(); ++eIt )
+		{
+			const int numRowLabels = static_cast<int>( eIt->getLabels().size() );
+			vector<AlphaReal>& weights = eIt->getWeights();
+			weights.resize( numRowLabels );
+#ifndef NOTIWEIGHT
+			vector<AlphaReal>& initialWeights = eIt->getInitialWeights();
+			if ( _hasInitialWeights )
+				initialWeights.resize( numRowLabels );
+#endif
+			for ( int l = 0; l < numRowLabels; ++l, ++pos )
+			{
+				weights[l] = getWeight(pos);
+#ifndef NOTIWEIGHT
+				if ( _hasInitialWeights )
+					initialWeights[l] = _initialWeights[pos];
+#endif
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void LabelMatrix::clear()
+	{
+		_numRows = 0;
+		_hasInitialWeights = false;
+		_hasFloatWeights = false;
+		
+		// swap with empty vectors to actually free the memory
+		vector<AlphaReal>().swap( _weights );
+		vector<float>().swap( _floatWeights );
+		vector<signed char>().swap( _ys );
+		vector<AlphaReal>().swap( _initialWeights );
+		vector<int>().swap( _rowOffsets );
+		vector<int>().swap( _classIdxs );
+		vector<AlphaReal>().swap( _negWeights );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	AlphaReal LabelMatrix::getNegativeWeight( int row ) const
+	{
+		if ( !_isDense )
+			return _negWeights[row];
+		
+		AlphaReal negWeight = 0;
+		const int end = getRowEnd(row);
+		for (int pos = getRowBegin(row); pos < end; ++pos)
+		{
+			if ( _ys[pos] < 0 )
+				negWeight += getWeight(pos);
+		}
+		return negWeight;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	size_t LabelMatrix::getMemoryUsage() const
+	{
+		return _weights.capacity() * sizeof(AlphaReal) +
+		_floatWeights.capacity() * sizeof(float) +
+		_ys.capacity() * sizeof(signed char) +
+		_initialWeights.capacity() * sizeof(AlphaReal) +
+		_rowOffsets.capacity() * sizeof(int) +
+		_classIdxs.capacity() * sizeof(int) +
+		_negWeights.capacity() * sizeof(AlphaReal);
+	}
+	
+	// ------------------------------------------------------------------------
+	
+} // end of namespace MultiBoost
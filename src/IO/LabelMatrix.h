@@ -0,0 +1,268 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+/**
+ * \file LabelMatrix.h Compact storage of the labels and of the weights.
+ */
+
+#ifndef __LABEL_MATRIX_H
+#define __LABEL_MATRIX_H
+
+#include <vector>
+
+#include "Defaults.h"
+#include "Others/Example.h"
+
+using namespace std;
+
+namespace MultiBoost {
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * Holds the labels and the weights of all the examples in contiguous blocks.
+	 * Each Example holds 24 bytes per class (index and label, weight and initial
+	 * weight), and every access goes through the heap blocks of the example. Here the
+	 * Examples keep only the index and the label, and the weights are stored in a single
+	 * row-major (example x class) matrix, the labels as int8 in a parallel matrix, and
+	 * the initial weights (which are needed only by some outputs) in a separate,
+	 * optional matrix.
+	 *
+	 * With sparse labels (LR_SPARSE) only the labels listed in the data file are stored
+	 * (CSR-like, in the same order as in the Example), together with the aggregated weight
+	 * of the negative labels of each example.
+	 *
+	 * The rows are indexed by the raw index of the example (see InputData::getRawIndex()),
+	 * and positions inside a row follow the order of Example::getLabels(), so a label
+	 * position can be computed as getRowBegin(row) + (lIt - labels.begin()).
+	 *
+	 * The matrix is the owner of the weights: the Examples keep only the labels, and
+	 * the weights must be read and written with InputData::getLabelWeight() and
+	 * InputData::setLabelWeight(). The weights can be stored in single precision
+	 * to halve the size of the matrix.
+	 * \remark The code that modifies the Label objects in place, or that sets the
+	 * weights of sparse labels, must call InputData::syncCompactLabels() afterwards.
+	 * \see RawData::hasCompactLabels()
+	 */
+	class LabelMatrix
+	{
+	public:
+		
+		/**
+		 * The constructor. It does nothing but initializing some variables.
+		 */
+		LabelMatrix() : _numRows(0), _numClasses(0), _isDense(true), _hasInitialWeights(false), _hasFloatWeights(false) {}
+		
+		/**
+		 * Build the matrices from the labels of the examples. The weights are the ones
+		 * of the examples (1 if they have none), the initial weights are set by
+		 * storeInitialWeights().
+		 * \param data The examples.
+		 * \param numClasses The number of classes.
+		 * \param labelRep The label representation of the data.
+		 * \param keepInitialWeights If true, the initial weights are stored as well.
+		 * \param floatWeights If true, the weights are stored as float instead of AlphaReal.
+		 */
+		void build( const vector<Example>& data, int numClasses, eLabelRep labelRep, bool keepInitialWeights,
+				    bool floatWeights = false );
+		
+		/**
+		 * Copy the current labels of the examples into the matrix, and update the
+		 * aggregated negative weights. The layout (number of labels per example) must
+		 * not have changed since build().
+		 * \param data The examples.
+		 */
+		void updateValues( const vector<Example>& data );
+		
+		/**
+		 * Keep the current weights as the initial ones, if they are stored.
+		 */
+		void storeInitialWeights();
+		
+		/**
+		 * Copy the weights (and the initial weights if they are stored) back into
+		 * the examples.
+		 * \param data The examples.
+		 */
+		void copyWeightsTo( vector<Example>& data ) const;
+		
+		/**
+		 * Release the memory.
+		 */
+		void clear();
+		
+		bool empty() const { return _numRows == 0; }
+		bool isDense() const { return _isDense; }
+		bool hasInitialWeights() const { return _hasInitialWeights; }
+		bool hasFloatWeights() const { return _hasFloatWeights; }
+		int  getNumRows() const { return _numRows; }
+		int  getNumClasses() const { return _numClasses; }
+		
+		/**
+		 * The position of the first label of an example.
+		 * \param row The raw index of the example.
+		 */
+		inline int getRowBegin( int row ) const 
+		{ return _isDense ? row * _numClasses : _rowOffsets[row]; }
+		
+		/**
+		 * The position after the last label of an example.
+		 * \param row The raw index of the example.
+		 */
+		inline int getRowEnd( int row ) const 
+		{ return _isDense ? (row + 1) * _numClasses : _rowOffsets[row + 1]; }
+		
+		/**
+		 * The class index of the label stored at position \a pos of row \a row.
+		 */
+		inline int getClassIdx( int row, int pos ) const 
+		{ return _isDense ? pos - row * _numClasses : _classIdxs[pos]; }
+		
+		inline AlphaReal   getWeight( int pos ) const 
+		{ return _hasFloatWeights ? _floatWeights[pos] : _weights[pos]; }
+		inline void        setWeight( int pos, AlphaReal w ) 
+		{ if ( _hasFloatWeights ) _floatWeights[pos] = static_cast<float>(w); else _weights[pos] = w; }
+		
+		inline signed char getY( int pos ) const { return _ys[pos]; }
+		inline AlphaReal   getInitialWeight( int pos ) const { return _initialWeights[pos]; }
+		
+		/**
+		 * The summed weight of the negative labels of an example. With dense labels
+		 * this is computed on the fly.
+		 */
+		AlphaReal getNegativeWeight( int row ) const;
+		
+		/**
+		 * Set the aggregated negative weight of the example. Only meaningful with sparse
+		 * labels, it is ignored otherwise.
+		 */
+		inline void setNegativeWeight( int row, AlphaReal w ) 
+		{ if ( !_isDense ) _negWeights[row] = w; }
+		
+		/**
+		 * Add \a sign * w_l * y_l to halfEdges[l] for every label of the example.
+		 * This is the inner loop of the stump algorithms.
+		 * \param row The raw index of the example.
+		 * \param halfEdges The class-wise edges to update.
+		 * \param sign +1 or -1.
+		 * \param overlayYs The values of the labels to use instead of the stored ones,
+		 * indexed by class (see InputData::getLabelOverlayRow()), or NULL.
+		 */
+		inline void addEdges( int row, AlphaReal* halfEdges, AlphaReal sign, const signed char* overlayYs = NULL ) const
+		{
+			if ( _hasFloatWeights )
+				addEdges( &_floatWeights[0], row, halfEdges, sign, overlayYs );
+			else
+				addEdges( &_weights[0], row, halfEdges, sign, overlayYs );
+		}
+		
+		/**
+		 * Add the weights and w_l * y_l of the labels of an example to the class-wise sums.
+		 * \param row The raw index of the example.
+		 * \param weightsPerClass The class-wise weights to update.
+		 * \param edges The class-wise edges to update.
+		 * \param overlayYs The values of the labels to use instead of the stored ones,
+		 * indexed by class (see InputData::getLabelOverlayRow()), or NULL.
+		 */
+		inline void addWeightsEdges( int row, AlphaReal* weightsPerClass, AlphaReal* edges, 
+									 const signed char* overlayYs = NULL ) const
+		{
+			const int begin = getRowBegin(row);
+			const int end = getRowEnd(row);
+			
+			for (int pos = begin; pos < end; ++pos)
+			{
+				const int l = getClassIdx(row, pos);
+				const AlphaReal w = getWeight(pos);
+				weightsPerClass[l] += w;
+				edges[l] += w * ( overlayYs ? overlayYs[l] : _ys[pos] );
+			}
+		}
+		
+		/**
+		 * The memory used by the matrices, in bytes.
+		 */
+		size_t getMemoryUsage() const;
+		
+	private:
+		/**
+		 * The inner loop of addEdges(), for both precisions of the weights.
+		 */
+		template <typename T>
+		inline void addEdges( const T* w, int row, AlphaReal* halfEdges, AlphaReal sign, 
+							  const signed char* overlayYs ) const
+		{
+			const int begin = getRowBegin(row);
+			const int end = getRowEnd(row);
+			
+			if ( _isDense )
+			{
+				const signed char* y = overlayYs ? overlayYs : &_ys[begin];
+				for (int pos = begin, l = 0; pos < end; ++pos, ++l)
+					halfEdges[l] += sign * w[pos] * y[l];
+			}
+			else if ( overlayYs )
+			{
+				for (int pos = begin; pos < end; ++pos)
+					halfEdges[ _classIdxs[pos] ] += sign * w[pos] * overlayYs[ _classIdxs[pos] ];
+			}
+			else
+			{
+				const signed char* y = &_ys[0];
+				for (int pos = begin; pos < end; ++pos)
+					halfEdges[ _classIdxs[pos] ] += sign * w[pos] * y[pos];
+			}
+		}
+		
+		int  _numRows; //!< The number of examples.
+		int  _numClasses; //!< The number of classes.
+		bool _isDense; //!< True if every example has a label for every class.
+		bool _hasInitialWeights; //!< True if _initialWeights is filled.
+		bool _hasFloatWeights; //!< True if the weights are in _floatWeights instead of _weights.
+		
+		vector<AlphaReal>   _weights; //!< The current weights, row-major.
+		vector<float>       _floatWeights; //!< The current weights in single precision, row-major.
+		vector<signed char> _ys; //!< The labels (+1/-1/0), same layout as _weights.
+		vector<AlphaReal>   _initialWeights; //!< The initial weights (optional).
+		
+		// sparse labels only
+		vector<int>         _rowOffsets; //!< The beginning of each row, plus the end of the last one.
+		vector<int>         _classIdxs; //!< The class index of each stored label.
+		vector<AlphaReal>   _negWeights; //!< The aggregated weight of the negative labels of each row.
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __LABEL_MATRIX_H
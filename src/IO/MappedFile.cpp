@@ -0,0 +1,129 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+
+#include "MappedFile.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio> // for rename, remove
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace MultiBoost {
+	
+	// -------------------------------------------------------------------------
+	
+	bool MappedFile::open( const string& fileName )
+	{
+		close();
+		
+#ifndef _WIN32
+		int fd = ::open( fileName.c_str(), O_RDONLY );
+		if ( fd < 0 )
+			return false;
+		
+		struct stat fileStat;
+		if ( fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0 )
+		{
+			::close(fd);
+			return false;
+		}
+		
+		void* pMap = mmap( NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+		// the mapping stays valid once the descriptor is closed
+		::close(fd);
+		
+		if ( pMap == MAP_FAILED )
+			return false;
+		
+		_pData = static_cast<const char*>(pMap);
+		_size = fileStat.st_size;
+		return true;
+#else
+		return false;
+#endif
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void MappedFile::close()
+	{
+#ifndef _WIN32
+		if ( _pData )
+			munmap( const_cast<char*>(_pData), _size );
+#endif
+		_pData = NULL;
+		_size = 0;
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	bool MappedFile::writeAtomically( const string& fileName, 
+									  const vector< pair<const char*, size_t> >& chunks )
+	{
+		stringstream tmpName;
+		tmpName << fileName << ".tmp";
+#ifndef _WIN32
+		tmpName << getpid();
+#endif
+		
+		ofstream outFile( tmpName.str().c_str(), ios::binary );
+		if ( !outFile.is_open() )
+			return false;
+		
+		vector< pair<const char*, size_t> >::const_iterator cIt;
+		for ( cIt = chunks.begin(); cIt != chunks.end(); ++cIt )
+			outFile.write( cIt->first, cIt->second );
+		
+		outFile.close();
+		
+		if ( outFile.fail() || rename( tmpName.str().c_str(), fileName.c_str() ) != 0 )
+		{
+			remove( tmpName.str().c_str() );
+			return false;
+		}
+		
+		return true;
+	}
+	
+	// -------------------------------------------------------------------------
+	
+} // end of namespace MultiBoost
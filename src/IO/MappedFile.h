@@ -0,0 +1,113 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+/**
+ * \file MappedFile.h A file mapped read-only in memory.
+ */
+
+#ifndef __MAPPED_FILE_H
+#define __MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+#include <utility> // for pair
+#include <cstddef> // for size_t
+
+using namespace std;
+
+namespace MultiBoost {
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * A file mapped read-only in the address space of the process.
+	 * The mapping is shared: the pages of the file are held only once in the
+	 * page cache, whatever the number of processes mapping the same file.
+	 * \remark On systems without mmap the file cannot be opened.
+	 * \date 18/10/2026
+	 */
+	class MappedFile
+	{
+	public:
+		
+		/**
+		 * The constructor. No file is mapped.
+		 */
+		MappedFile() : _pData(NULL), _size(0) {}
+		
+		/**
+		 * The destructor. Unmaps the file.
+		 */
+		~MappedFile() { close(); }
+		
+		/**
+		 * Map a file.
+		 * \param fileName The name of the file.
+		 * \return False if the file cannot be opened or mapped, or if it is empty.
+		 */
+		bool open( const string& fileName );
+		
+		/**
+		 * Unmap the file.
+		 */
+		void close();
+		
+		/**
+		 * Write a file so that other processes never see it partially written:
+		 * the content goes to a temporary file which is then renamed.
+		 * \param fileName The name of the file.
+		 * \param chunks The content of the file, as (first byte, size) pairs.
+		 * \return False if the file cannot be written.
+		 */
+		static bool writeAtomically( const string& fileName, 
+									 const vector< pair<const char*, size_t> >& chunks );
+		
+		bool        is_open() const { return _pData != NULL; } //!< True if a file is mapped.
+		const char* data() const { return _pData; } //!< The first byte of the file.
+		size_t      size() const { return _size; } //!< The size of the file in bytes.
+		
+	private:
+		
+		MappedFile( const MappedFile& ); //!< Not copyable.
+		MappedFile& operator=( const MappedFile& ); //!< Not copyable.
+		
+		const char*	_pData; //!< The mapped memory.
+		size_t		_size; //!< The size of the mapping.
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __MAPPED_FILE_H
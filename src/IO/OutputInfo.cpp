@@ -32,6 +32,8 @@
 
 
 #include <limits>
+#include <algorithm>
+#include <iterator>
 
 #include <math.h>
 
@@ -43,31 +45,44 @@
 
 namespace MultiBoost {
 	
+	/**
+	 * The maximum number of runs merged by AUCOutput::updateRanking(),
+	 * a full sort is done above.
+	 */
+	static const int AUC_MAX_RUNS = 8;
+	
+	/**
+	 * Orders the examples by decreasing score.
+	 */
+	struct ScoreGreater
+	{
+		explicit ScoreGreater(const vector<AlphaReal>& scores) : _scores(scores) {}
+		
+		bool operator()(int i, int j) const { return _scores[i] > _scores[j]; }
+		
+		const vector<AlphaReal>& _scores;
+	};
+	
 	// -------------------------------------------------------------------------
 	
 	OutputInfo::OutputInfo(const string& outputInfoFile, bool customUpdate)
+	: _pWriter(NULL), _outputPeriod(1)
 	{
         //some intializations
         _customTablesUpdate = customUpdate;
         
 		// open the stream
-		_outStream.open(outputInfoFile.c_str());
-		
-		// is it really open?
-		if ( !_outStream.is_open() )
-		{
-			cerr << "ERROR: cannot open the output steam (<" 
-			<< outputInfoFile << ">) for the step-by-step info!" << endl;
-			exit(1);
-		}
+		openOutput(outputInfoFile);
         
         _outputListString = defaultOutput;
         _outputList.push_back(BaseOutputInfoType::createOutput(defaultOutput));
+        _outputNames.push_back(defaultOutput);
 	}
 
     // -------------------------------------------------------------------------
 	
 	OutputInfo::OutputInfo(const string& outputInfoFile, const string & outList, bool customUpdate)
+	: _pWriter(NULL), _outputPeriod(1)
 	{
         //internal intializations
         _customTablesUpdate = customUpdate;
@@ -76,29 +91,24 @@ namespace MultiBoost {
         getOutputListFromString(outList);
         
         // open the stream
-		_outStream.open(outputInfoFile.c_str());
-		
-		// is it really open?
-		if ( !_outStream.is_open() )
-		{
-			cerr << "ERROR: cannot open the output steam (<" 
-			<< outputInfoFile << ">) for the step-by-step info!" << endl;
-			exit(1);
-		}
+		openOutput(outputInfoFile);
         
     }
     
     // -------------------------------------------------------------------------
 	
 	OutputInfo::OutputInfo(const nor_utils::Args& args, bool customUpdate, const string & clArg)
+	: _pWriter(NULL), _outputPeriod(1)
 	{
         _customTablesUpdate = customUpdate;
         
-        string outputInfoFile;
+        // the default file name if the option is not given
+        string outputInfoFile = OUTPUT_NAME;
         
-        args.getValue(clArg, 0, outputInfoFile);
+        if ( args.hasArgument(clArg) )
+            args.getValue(clArg, 0, outputInfoFile);
         
-        if ( args.getNumValues(clArg) > 1)
+        if ( args.hasArgument(clArg) && args.getNumValues(clArg) > 1)
         {
             string outList;
             args.getValue(clArg, 1, outList);
@@ -108,21 +118,81 @@ namespace MultiBoost {
         else
         {
             _outputList.push_back(BaseOutputInfoType::createOutput(defaultOutput));
+            _outputNames.push_back(defaultOutput);
+        }
+        
+        if ( args.hasArgument("outputinfoperiod") )
+        {
+            int period;
+            args.getValue("outputinfoperiod", 0, period);
+            
+            string periodicOutputs;
+            if ( args.getNumValues("outputinfoperiod") > 1 )
+                args.getValue("outputinfoperiod", 1, periodicOutputs);
+            
+            setOutputPeriod(period, periodicOutputs);
         }
 
         // open the stream
-		_outStream.open(outputInfoFile.c_str());
+		openOutput(outputInfoFile);
+        
+    }
+
+	// -------------------------------------------------------------------------
+	
+	OutputInfo::~OutputInfo()
+	{
+		if (_pWriter)
+		{
+			// a line that has not been ended
+			flushLine();
+			
+			_pWriter->close();
+			delete _pWriter;
+		}
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void OutputInfo::openOutput(const string& outputInfoFile)
+	{
+		_pWriter = new AsyncWriter(outputInfoFile);
 		
 		// is it really open?
-		if ( !_outStream.is_open() )
+		if ( !_pWriter->is_open() )
 		{
 			cerr << "ERROR: cannot open the output steam (<" 
 			<< outputInfoFile << ">) for the step-by-step info!" << endl;
 			exit(1);
 		}
-        
-    }
-
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void OutputInfo::flushLine()
+	{
+		string line = _outStream.str();
+		_outStream.str("");
+		
+		_pWriter->write(line);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void OutputInfo::invalidateOutputs(InputData* pData)
+	{
+		for (OutInfIt outputIt = _outputList.begin(); outputIt != _outputList.end(); ++outputIt)
+			(*outputIt)->invalidate(pData);
+	}
+	
+	// -------------------------------------------------------------------------
+	
+	void OutputInfo::endLine()
+	{
+		_outStream << '\n';
+		flushLine();
+	}
+	
 	// -------------------------------------------------------------------------
 	
     void OutputInfo::setOutputList(const string& list, bool append, const nor_utils::Args* args)
@@ -141,20 +211,80 @@ namespace MultiBoost {
     void OutputInfo::getOutputListFromString(const string& outList,  const nor_utils::Args* args)
     {
         _outputList.clear();
+        _outputNames.clear();
         for (int i = 0; i < outList.size(); i+=3) 
         {
             BaseOutputInfoType* t = BaseOutputInfoType::createOutput(outList.substr(i, 3), args);
-            if ( t )  _outputList.push_back(t);
+            if ( t )
+            {
+                _outputList.push_back(t);
+                _outputNames.push_back(outList.substr(i, 3));
+            }
         }
         
         if ( _outputList.size() == 0 )
+        {
             _outputList.push_back(BaseOutputInfoType::createOutput(defaultOutput));
+            _outputNames.push_back(defaultOutput);
+        }
+        
+        _lastOutputs.clear();
 
 
     }
     
     // -------------------------------------------------------------------------
     
+    bool OutputInfo::needsInitialWeights(const nor_utils::Args& args, const string & clArg)
+    {
+        // the default output (e01) does not use them
+        if ( !args.hasArgument(clArg) || args.getNumValues(clArg) < 2 )
+            return false;
+        
+        string outList;
+        args.getValue(clArg, 1, outList);
+        
+        for (int i = 0; i < (int)outList.size(); i+=3) 
+        {
+            const string type = outList.substr(i, 3);
+            if ( type == "w01" || type == "wha" || type == "wer" || type == "mar" )
+                return true;
+        }
+        
+        return false;
+    }
+    
+    // -------------------------------------------------------------------------
+    
+    void OutputInfo::setOutputPeriod(int period, const string& list)
+    {
+        if (period < 1)
+        {
+            cerr << "ERROR: the period of the outputs must be at least 1!" << endl;
+            exit(1);
+        }
+        
+        _outputPeriod = period;
+        _periodicOutputs = list;
+    }
+    
+    // -------------------------------------------------------------------------
+    
+    int OutputInfo::getOutputPeriod(int i) const
+    {
+        if ( _periodicOutputs.empty() )
+            return _outputPeriod;
+        
+        for (int j = 0; j + 3 <= (int)_periodicOutputs.size(); j += 3)
+        {
+            if ( _periodicOutputs.compare(j, 3, _outputNames[i]) == 0 )
+                return _outputPeriod;
+        }
+        
+        return 1;
+    }
+    
+    // -------------------------------------------------------------------------
     
 	void OutputInfo::outputHeader(const NameMap& namemap, bool outputIterations, bool outputTime, bool endline)
 	{ 
@@ -185,7 +315,7 @@ namespace MultiBoost {
         }
         
         if (endline) {
-            _outStream << endl;
+            endLine();
         }
 
 	}
@@ -197,15 +327,43 @@ namespace MultiBoost {
         if (! _customTablesUpdate) {
             updateTables(pData, pWeakHypothesis);
         }
+        else {
+            // the tables are updated by the learner
+            invalidateOutputs(pData);
+        }
         
         _outStream << setiosflags(ios::fixed) << setprecision(6);
         
-        OutInfIt outputIt;
-        for (outputIt = _outputList.begin(); outputIt != _outputList.end(); ++outputIt) {
-            (*outputIt)->computeAndOutput(_outStream, pData, _gTableMap, _margins, _alphaSums, pWeakHypothesis);
-            if ((outputIt+1) != _outputList.end()) _outStream << OUTPUT_SEPARATOR;
+        // the number of the current call for this dataset
+        const int numCalls = _numOutputCalls[pData]++;
+        
+        vector<string>& lastOutputs = _lastOutputs[pData];
+        lastOutputs.resize(_outputList.size());
+        
+        for (int i = 0; i < (int)_outputList.size(); ++i) {
+            const int period = getOutputPeriod(i);
+            
+            if (period == 1) {
+                _outputList[i]->computeAndOutput(_outStream, pData, _gTableMap, _margins, _alphaSums, pWeakHypothesis);
+            }
+            else {
+                // the value is computed at the first call and then every period calls,
+                // otherwise the last one is repeated
+                if (numCalls % period == 0 || lastOutputs[i].empty()) {
+                    ostringstream metricStream;
+                    metricStream << setiosflags(ios::fixed) << setprecision(6);
+                    _outputList[i]->computeAndOutput(metricStream, pData, _gTableMap, _margins, _alphaSums, pWeakHypothesis);
+                    lastOutputs[i] = metricStream.str();
+                }
+                _outStream << lastOutputs[i];
+            }
+            
+            if (i + 1 != (int)_outputList.size()) _outStream << OUTPUT_SEPARATOR;
         } 
         
+        // do not keep large outputs (eg. the posteriors) in memory
+        if (_outStream.tellp() > ASYNC_WRITER_BUFFER_SIZE)
+            flushLine();
     }
     
 	// -------------------------------------------------------------------------
@@ -218,11 +376,23 @@ namespace MultiBoost {
         
 		vector<Label>::const_iterator lIt;
 		
+		// the outputs that follow the changes example by example
+		vector<BaseOutputInfoType*> incrementalOutputs;
+		for (OutInfIt outputIt = _outputList.begin(); outputIt != _outputList.end(); ++outputIt)
+		{
+			if ( (*outputIt)->isIncremental() )
+				incrementalOutputs.push_back(*outputIt);
+		}
+		vector<AlphaReal> oldScores;
+		
 		// Building the strong learner (discriminant function)
 		for (int i = 0; i < numExamples; ++i)
 		{
 			const vector<Label>& labels = pData->getLabels(i);
 			
+			if ( !incrementalOutputs.empty() )
+				oldScores = g[i];
+			
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
                 // update the posteriors table
@@ -233,6 +403,12 @@ namespace MultiBoost {
                 // FIXME: redundancy 
                 margins[i][lIt->idx] += g[i][lIt->idx] * lIt->y ;
 			}
+			
+			if ( !incrementalOutputs.empty() && oldScores != g[i] )
+			{
+				for (int o = 0; o < (int)incrementalOutputs.size(); ++o)
+					incrementalOutputs[o]->updateRow(pData, i, oldScores, g[i]);
+			}
 		}
         
         // update the sum of alphas
@@ -309,6 +485,9 @@ namespace MultiBoost {
         }
         
         _alphaSums[pData] = 0;
+        _numOutputCalls[pData] = 0;
+        
+        invalidateOutputs(pData);
 
 	}
 	
@@ -400,44 +579,81 @@ namespace MultiBoost {
     {
         const int numExamples = pData->getNumExamples();
         
-        table& g = gTableMap[pData];
-        
-        vector<Label>::const_iterator lIt;
-        
-        int numErrors = 0;   
+        ErrorState& state = _states[pData];
         
-        for (int i = 0; i < numExamples; ++i)
+        // (re)build the error flags if the table has been changed from outside
+        if ( !state.isValid || (int)state.isError.size() != numExamples )
         {
-            const vector<Label>& labels = pData->getLabels(i);
+            table& g = gTableMap[pData];
             
-            // the vote of the winning negative class
-            AlphaReal maxNegClass = -numeric_limits<AlphaReal>::max();
-            // the vote of the winning positive class
-            AlphaReal maxPosClass = -numeric_limits<AlphaReal>::max();
+            state.isError.resize(numExamples);
+            state.numErrors = 0;
             
-            for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+            for (int i = 0; i < numExamples; ++i)
             {
-                // get the negative winner class
-                if ( lIt->y < 0 && g[i][lIt->idx] > maxNegClass )
-                    maxNegClass = g[i][lIt->idx];
-                
-                // get the positive winner class
-                if ( lIt->y > 0 && g[i][lIt->idx] > maxPosClass )
-                    maxPosClass = g[i][lIt->idx];
+                state.isError[i] = isError(pData->getLabels(i), g[i]);
+                state.numErrors += state.isError[i];
             }
             
-            // if the vote for the worst positive label is lower than the
-            // vote for the highest negative label -> error
-            if (maxPosClass <= maxNegClass)
-                ++numErrors;
+            state.isValid = true;
         }
         
-        
         // The error is normalized by the number of points
-        outStream  << (AlphaReal)(numErrors)/(AlphaReal)(numExamples);
+        outStream  << (AlphaReal)(state.numErrors)/(AlphaReal)(numExamples);
         
     }
-		
+    
+    // -------------------------------------------------------------------------
+    
+    void ZeroOneErrorOutput::updateRow(InputData* pData, int i, 
+                                       const vector<AlphaReal>&, 
+                                       const vector<AlphaReal>& newScores)
+    {
+        ErrorState& state = _states[pData];
+        if ( !state.isValid || i >= (int)state.isError.size() )
+        {
+            state.isValid = false;
+            return;
+        }
+        
+        const char error = isError(pData->getLabels(i), newScores);
+        
+        // only the examples whose status has changed modify the count
+        if ( error != state.isError[i] )
+        {
+            state.numErrors += error ? 1 : -1;
+            state.isError[i] = error;
+        }
+    }
+    
+    // -------------------------------------------------------------------------
+    
+    bool ZeroOneErrorOutput::isError(const vector<Label>& labels, const vector<AlphaReal>& scores)
+    {
+        vector<Label>::const_iterator lIt;
+        
+        // the vote of the winning negative class
+        AlphaReal maxNegClass = -numeric_limits<AlphaReal>::max();
+        // the vote of the winning positive class
+        AlphaReal maxPosClass = -numeric_limits<AlphaReal>::max();
+        
+        for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+        {
+            // get the negative winner class
+            if ( lIt->y < 0 && scores[lIt->idx] > maxNegClass )
+                maxNegClass = scores[lIt->idx];
+            
+            // get the positive winner class
+            if ( lIt->y > 0 && scores[lIt->idx] > maxPosClass )
+                maxPosClass = scores[lIt->idx];
+        }
+        
+        // if the vote for the worst positive label is lower than the
+        // vote for the highest negative label -> error
+        return (maxPosClass <= maxNegClass);
+    }
+	
+
     // -------------------------------------------------------------------------	
 	// -------------------------------------------------------------------------	
 	
@@ -479,7 +695,7 @@ namespace MultiBoost {
                 if ( lIt->y > 0 && g[i][lIt->idx] > maxPosClass )
                     maxPosClass = g[i][lIt->idx];
 				
-				if ( lIt->y > 0 ) sumPerInstanceWeight += (lIt->initialWeight>0.0) ? lIt->initialWeight : -lIt->initialWeight;
+				if ( lIt->y > 0 ) sumPerInstanceWeight += fabs( pData->getLabelInitialWeight(i, *lIt) );
             }
             
             // if the vote for the worst positive label is lower than the
@@ -508,25 +724,55 @@ namespace MultiBoost {
         const int numExamples = pData->getNumExamples();
 		const int numClasses = pData->getNumClasses();
         
-        table& g = gTableMap[pData];
-        
-        vector<Label>::const_iterator lIt;
-        
-        int numErrors = 0;   
+        map<InputData*, int>::iterator errIt = _numErrors.find(pData);
         
-        for (int i = 0; i < numExamples; ++i)
+        // (re)count the errors if the table has been changed from outside
+        if ( errIt == _numErrors.end() )
         {
-            const vector<Label>& labels = pData->getLabels(i);
+            table& g = gTableMap[pData];
             
-            for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+            vector<Label>::const_iterator lIt;
+            
+            int numErrors = 0;   
+            
+            for (int i = 0; i < numExamples; ++i)
             {
-				if ( g[i][lIt->idx] * lIt->y < 0 ) numErrors++;
-            }            
-        }        
+                const vector<Label>& labels = pData->getLabels(i);
+                
+                for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+                {
+                    if ( g[i][lIt->idx] * lIt->y < 0 ) numErrors++;
+                }            
+            }        
+            
+            errIt = _numErrors.insert( make_pair(pData, numErrors) ).first;
+        }
         
         // The error is normalized by the number of points
-        outStream  << (AlphaReal)(numErrors)/(AlphaReal)(numExamples*numClasses);
+        outStream  << (AlphaReal)(errIt->second)/(AlphaReal)(numExamples*numClasses);
+    }
+    
+    // -------------------------------------------------------------------------
+    
+    void HammingErrorOutput::updateRow(InputData* pData, int i, 
+                                       const vector<AlphaReal>& oldScores, 
+                                       const vector<AlphaReal>& newScores)
+    {
+        map<InputData*, int>::iterator errIt = _numErrors.find(pData);
+        if ( errIt == _numErrors.end() )
+            return;
+        
+        const vector<Label>& labels = pData->getLabels(i);
+        vector<Label>::const_iterator lIt;
+        
+        for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+        {
+            if ( oldScores[lIt->idx] * lIt->y < 0 ) errIt->second--;
+            if ( newScores[lIt->idx] * lIt->y < 0 ) errIt->second++;
+        }
     }
+    
+
     // -------------------------------------------------------------------------	
 	// -------------------------------------------------------------------------	
 	
@@ -552,9 +798,9 @@ namespace MultiBoost {
             for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
             {
 				if ( g[i][lIt->idx] * lIt->y < 0 ) {
-					negWeights += lIt->initialWeight;
+					negWeights += pData->getLabelInitialWeight(i, *lIt);
 				}
-				sumWeights += lIt->initialWeight;
+				sumWeights += pData->getLabelInitialWeight(i, *lIt);
             }            
         }
         
@@ -606,7 +852,7 @@ namespace MultiBoost {
 				if ( lIt->y > 0 && g[i][lIt->idx] < minPosClass )
 					minPosClass = g[i][lIt->idx];
 
-				sumPerInstanceWeight += (lIt->initialWeight>0.0) ? lIt->initialWeight : -lIt->initialWeight;
+				sumPerInstanceWeight += fabs( pData->getLabelInitialWeight(i, *lIt) );
 			}
 			
 			// if the vote for the worst positive label is lower than the
@@ -636,52 +882,35 @@ namespace MultiBoost {
         int numClasses = pData->getNumClasses();
         const int numExamples = pData->getNumExamples();
         
-        vector< int > tp( numClasses );   
-        fill( tp.begin(), tp.end(), 0 );
+        BalancedState& state = _states[pData];
         
-        vector< int > tn( numClasses );   
-        fill( tn.begin(), tn.end(), 0 );
-        
-        vector< AlphaReal > bacPerClass( numClasses );   
-        fill( bacPerClass.begin(), bacPerClass.end(), 0.0 );
-        
-        table& g = gTableMap[pData];
-        vector<Label>::const_iterator lIt;
-        
-        for (int i = 0; i < numExamples; ++i)
+        // (re)build the counts if the table has been changed from outside
+        if ( !state.isValid || (int)state.isCorrect.size() != numExamples )
         {
-            const vector<Label>& labels = pData->getLabels(i);
+            table& g = gTableMap[pData];
             
-            // the vote of the winning negative class
-            AlphaReal maxNegClass = -numeric_limits<AlphaReal>::max();
-            // the vote of the winning positive class
-            AlphaReal minPosClass = numeric_limits<AlphaReal>::max();
+            state.tp.assign( numClasses, 0 );
+            state.tn.assign( numClasses, 0 );
+            state.isCorrect.resize( numExamples );
             
-            for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+            for (int i = 0; i < numExamples; ++i)
             {
-                // get the negative winner class
-                if ( lIt->y < 0 && g[i][lIt->idx] > maxNegClass )
-                    maxNegClass = g[i][lIt->idx];
-                    
-                    // get the positive winner class
-                    if ( lIt->y > 0 && g[i][lIt->idx] < minPosClass )
-                        minPosClass = g[i][lIt->idx];
-            }
-            
-            // if the vote for the worst positive label is higher than the
-            // vote for the highest negative label -> good label
-            if (minPosClass > maxNegClass){
-                for ( lIt = labels.begin(); lIt != labels.end(); ++lIt ) {
-                    if ( lIt->y > 0  ) {
-                        tp[ lIt->idx]++;
-                    } else { 
-                        tn[ lIt->idx]++;
-                    }
-                }
+                const vector<Label>& labels = pData->getLabels(i);
+                
+                state.isCorrect[i] = isCorrect(labels, g[i]);
+                if ( state.isCorrect[i] )
+                    addExample(state, labels, 1);
             }
             
+            state.isValid = true;
         }
         
+        vector<int>& tp = state.tp;
+        vector<int>& tn = state.tn;
+        
+        vector< AlphaReal > bacPerClass( numClasses );   
+        fill( bacPerClass.begin(), bacPerClass.end(), 0.0 );
+        
         AlphaReal bACC = 0.0;
         
         for( int i = 0; i < numClasses; i++ ) {
@@ -700,6 +929,72 @@ namespace MultiBoost {
         }
     }
     
+    // -------------------------------------------------------------------------
+    
+    void BalancedErrorOutput::updateRow(InputData* pData, int i, 
+                                        const vector<AlphaReal>&, 
+                                        const vector<AlphaReal>& newScores)
+    {
+        BalancedState& state = _states[pData];
+        if ( !state.isValid || i >= (int)state.isCorrect.size() )
+        {
+            state.isValid = false;
+            return;
+        }
+        
+        const vector<Label>& labels = pData->getLabels(i);
+        const char correct = isCorrect(labels, newScores);
+        
+        // only the examples whose status has changed modify the counts
+        if ( correct != state.isCorrect[i] )
+        {
+            addExample(state, labels, correct ? 1 : -1);
+            state.isCorrect[i] = correct;
+        }
+    }
+    
+    // -------------------------------------------------------------------------
+    
+    bool BalancedErrorOutput::isCorrect(const vector<Label>& labels, const vector<AlphaReal>& scores)
+    {
+        vector<Label>::const_iterator lIt;
+        
+        // the vote of the winning negative class
+        AlphaReal maxNegClass = -numeric_limits<AlphaReal>::max();
+        // the vote of the winning positive class
+        AlphaReal minPosClass = numeric_limits<AlphaReal>::max();
+        
+        for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+        {
+            // get the negative winner class
+            if ( lIt->y < 0 && scores[lIt->idx] > maxNegClass )
+                maxNegClass = scores[lIt->idx];
+            
+            // get the positive winner class
+            if ( lIt->y > 0 && scores[lIt->idx] < minPosClass )
+                minPosClass = scores[lIt->idx];
+        }
+        
+        // if the vote for the worst positive label is higher than the
+        // vote for the highest negative label -> good label
+        return (minPosClass > maxNegClass);
+    }
+    
+    // -------------------------------------------------------------------------
+    
+    void BalancedErrorOutput::addExample(BalancedState& state, const vector<Label>& labels, int sign)
+    {
+        vector<Label>::const_iterator lIt;
+        for ( lIt = labels.begin(); lIt != labels.end(); ++lIt ) {
+            if ( lIt->y > 0  ) {
+                state.tp[ lIt->idx] += sign;
+            } else { 
+                state.tn[ lIt->idx] += sign;
+            }
+        }
+    }
+    
+
     // -------------------------------------------------------------------------	
     // -------------------------------------------------------------------------	
 
@@ -783,10 +1078,10 @@ namespace MultiBoost {
 				// gets the margin below zero
 #ifdef NOTIWEIGHT
 				if ( margins[i][lIt->idx] < 0 )
-					belowZeroMargin += lIt->weight;
+					belowZeroMargin += pData->getLabelWeight(i, *lIt);
 #else
 				if ( margins[i][lIt->idx] < 0 )
-					belowZeroMargin += lIt->initialWeight;
+					belowZeroMargin += pData->getLabelInitialWeight(i, *lIt);
 #endif
 				
 				// get the minimum margin among classes and examples
@@ -821,7 +1116,7 @@ namespace MultiBoost {
 			{
 				AlphaReal hy = pWeakHypothesis->classify(pData, i, lIt->idx) * // h_l(x_i)
 				lIt->y;
-				gamma += lIt->weight * hy;
+				gamma += pData->getLabelWeight(i, *lIt) * hy;
 			}
 		}
 		
@@ -841,13 +1136,28 @@ namespace MultiBoost {
 		const int numClasses = pData->getNumClasses();
 		const int numExamples = pData->getNumExamples();
 		
-		vector< int > fp( numClasses );   
-		fill( fp.begin(), fp.end(), 0 );
-		
 		table& g = gTableMap[pData];
-		vector<Label>::const_iterator lIt;
+		RankState& state = _ranks[pData];
 		
-		vector< pair< int, AlphaReal > > data( numExamples );
+		// a new dataset (or a new index set): start from the natural order
+		if ( (int)state.order.size() != numClasses || (int)state.order[0].size() != numExamples )
+		{
+			state.order.assign( numClasses, vector<int>(numExamples) );
+			state.scores.assign( numClasses, vector<AlphaReal>(numExamples, 0.0) );
+			state.isPositive.assign( numClasses, vector<char>(numExamples, 0) );
+			
+			for( int i = 0; i < numClasses; i++ ) {
+				for( int j = 0; j < numExamples; j++ ) {
+					state.order[i][j] = j;
+					state.scores[i][j] = g[j][i];
+					
+					if ( pData->hasPositiveLabel( j, i ) )
+						state.isPositive[i][j] = 1;
+				}
+				
+				sort( state.order[i].begin(), state.order[i].end(), ScoreGreater( state.scores[i] ) );
+			}
+		}
 		
 		vector< double > ROCscores( numClasses );
 		fill( ROCscores.begin(), ROCscores.end(), 0.0 );
@@ -855,32 +1165,14 @@ namespace MultiBoost {
 		
 		for( int i=0; i < numClasses; i++ ) {
 			if ( 0 < pData->getNumExamplesPerClass( i ) ) {
+				updateRanking( state, g, i );
 				
-				//fill( labels.begin(), labels.end(), 0 );
-				AlphaReal mn = numeric_limits< AlphaReal >::max();
-				AlphaReal mx = numeric_limits< AlphaReal >::min();
-				
-				
-				
-				for( int j = 0; j < numExamples; j++ ) {
-					data[j].second = g[j][i];
-					
-					if ( mn > data[j].second ) mn = data[j].second;
-					if ( mx < data[j].second ) mx = data[j].second;					
-					
-					if ( pData->hasPositiveLabel( j, i ) ) data[j].first = 1;
-					else data[j].first = 0;
-				}
-				
-				mx -= mn;
-				if ( mx > numeric_limits<AlphaReal>::epsilon() ) {
-					for( int j = 0; j < numExamples; j++ ) {
-						data[j].second -= mn;
-						data[j].second /= mx; 
-					}
+				ROCscores[i] = getAUC( state, i );
+				if ( ROCscores[i] < 0 ) {
+					// the merged runs were not sorted (rounding), sort them again
+					sort( state.order[i].begin(), state.order[i].end(), ScoreGreater( state.scores[i] ) );
+					ROCscores[i] = getAUC( state, i );
 				}
-				
-				ROCscores[i] = nor_utils::getROC( data );
 			} else {
 				ROCscores[i] = 0.0;
 			}
@@ -896,6 +1188,110 @@ namespace MultiBoost {
 		
 	}
 	
+    // -------------------------------------------------------------------------
+	
+	void AUCOutput::updateRanking(RankState& state, table& g, int classIdx)
+	{
+		vector<int>& order = state.order[classIdx];
+		vector<AlphaReal>& scores = state.scores[classIdx];
+		const int numExamples = (int)order.size();
+		
+		// split the previous ranking into runs of examples that moved by the same amount
+		vector<AlphaReal> moves;
+		vector< vector<int> > runs;
+		bool tooManyRuns = false;
+		
+		for (int j = 0; j < numExamples && !tooManyRuns; ++j)
+		{
+			const int idx = order[j];
+			const AlphaReal move = g[idx][classIdx] - scores[idx];
+			
+			int r = 0;
+			while ( r < (int)moves.size() && moves[r] != move ) ++r;
+			
+			if ( r == (int)moves.size() )
+			{
+				if ( moves.size() == AUC_MAX_RUNS )
+				{
+					tooManyRuns = true;
+					break;
+				}
+				moves.push_back(move);
+				runs.push_back( vector<int>() );
+				runs.back().reserve(numExamples);
+			}
+			runs[r].push_back(idx);
+		}
+		
+		for (int j = 0; j < numExamples; ++j)
+			scores[j] = g[j][classIdx];
+		
+		if ( tooManyRuns )
+		{
+			sort( order.begin(), order.end(), ScoreGreater(scores) );
+			return;
+		}
+		
+		if ( runs.size() < 2 )
+			return; // the order is unchanged
+		
+		// the runs are sorted with the new scores, merge them
+		vector<int> merged;
+		merged.reserve(numExamples);
+		order.swap(runs[0]);
+		
+		for (int r = 1; r < (int)runs.size(); ++r)
+		{
+			merged.clear();
+			merge( order.begin(), order.end(), runs[r].begin(), runs[r].end(), 
+				   back_inserter(merged), ScoreGreater(scores) );
+			order.swap(merged);
+		}
+	}
+	
+    // -------------------------------------------------------------------------
+	
+	AlphaReal AUCOutput::getAUC(const RankState& state, int classIdx)
+	{
+		const vector<int>& order = state.order[classIdx];
+		const vector<AlphaReal>& scores = state.scores[classIdx];
+		const vector<char>& isPositive = state.isPositive[classIdx];
+		
+		const int numExamples = (int)order.size();
+		
+		for (int j = 1; j < numExamples; ++j)
+		{
+			if ( scores[order[j]] > scores[order[j-1]] )
+				return -1.0; // not sorted
+		}
+		
+		// the scores are scaled to [0,1] as before nor_utils::getROC, which keeps the order
+		AlphaReal mn = numeric_limits< AlphaReal >::max();
+		AlphaReal mx = numeric_limits< AlphaReal >::min();
+		for (int j = 0; j < numExamples; ++j)
+		{
+			if ( mn > scores[j] ) mn = scores[j];
+			if ( mx < scores[j] ) mx = scores[j];
+		}
+		mx -= mn;
+		
+		vector< pair< int, AlphaReal > > data( numExamples );
+		for (int j = 0; j < numExamples; ++j)
+		{
+			const int idx = order[j];
+			data[j].first = isPositive[idx];
+			data[j].second = scores[idx];
+			
+			if ( mx > numeric_limits<AlphaReal>::epsilon() ) {
+				data[j].second -= mn;
+				data[j].second /= mx; 
+			}
+		}
+		
+		return nor_utils::getSortedROC( data );
+	}
+	
+
     // -------------------------------------------------------------------------	
     // -------------------------------------------------------------------------	
 
@@ -909,66 +1305,53 @@ namespace MultiBoost {
 		int numClasses = pData->getNumClasses();
 		const int numExamples = pData->getNumExamples();
 		
-		table& g = gTableMap[pData];
-		
-		vector<int> origLabels(numExamples);
-		vector<int> forecastedLabels(numExamples);
+		ForecastState& state = _states[pData];
 		
-		for (int i = 0; i < numExamples; ++i)
+		// (re)build the counts if the table has been changed from outside
+		if ( !state.isValid || (int)state.forecastedLabels.size() != numExamples )
 		{
-			const vector<Label>& labels = pData->getLabels(i);
+			table& g = gTableMap[pData];
 			
-			vector<Label>::const_iterator lIt;
+			state.origLabels.resize(numExamples);
+			state.forecastedLabels.resize(numExamples);
 			
-			// the vote of the winning negative class
-			AlphaReal maxClass = -numeric_limits<AlphaReal>::max();
+			state.classDistr.assign( numClasses, 0 );
+			state.TP.assign( numClasses, 0 );
+			state.FP.assign( numClasses, 0 );
 			
-			for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+			for (int i = 0; i < numExamples; ++i)
 			{
-				// get the negative winner class
-				if ( g[i][lIt->idx] > maxClass )
-				{
-					forecastedLabels[i]=lIt->idx;
-					maxClass = g[i][lIt->idx];
-				}
+				const vector<Label>& labels = pData->getLabels(i);
 				
-				// get the positive winner class
-				if ( lIt->y > 0 )
+				vector<Label>::const_iterator lIt;
+				for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
 				{
-					origLabels[i]=lIt->idx;
+					// get the positive winner class
+					if ( lIt->y > 0 )
+						state.origLabels[i] = lIt->idx;
 				}
-			}						
+				
+				state.forecastedLabels[i] = getForecast(labels, g[i]);
+				
+				state.classDistr[state.origLabels[i]]++;
+				
+				if (state.origLabels[i]==state.forecastedLabels[i]) // True positive
+					state.TP[state.origLabels[i]]++;
+				else
+					state.FP[state.forecastedLabels[i]]++;
+			}
+			
+			state.isValid = true;
 		}
 		
 		vector<double> TPR(numClasses);
 		vector<double> FPR(numClasses);
 		
-		vector<int> TP(numClasses);
-		vector<int> FP(numClasses);
-		
-		vector<int> classDistr(numClasses);
-		
-		fill( classDistr.begin(), classDistr.end(), 0 );
-		fill( TP.begin(), TP.end(), 0 );
-		fill( FP.begin(), FP.end(), 0 );
-		
-		for (int i = 0; i < numExamples; ++i)
-		{
-			classDistr[origLabels[i]]++;
-			
-			if (origLabels[i]==forecastedLabels[i]) // True positive
-			{
-				TP[origLabels[i]]++;
-			} else {
-				FP[forecastedLabels[i]]++;
-			}			
-		}		
-		
 		double avgTPR = 0.0, avgFPR = 0.0;
 		// print
 		for( int l=0; l<numClasses; ++l ) {
-			TPR[l] = TP[l]/((double)classDistr[l]);
-			FPR[l] = FP[l]/((double)(numExamples-classDistr[l]));
+			TPR[l] = state.TP[l]/((double)state.classDistr[l]);
+			FPR[l] = state.FP[l]/((double)(numExamples-state.classDistr[l]));
 			
 			avgTPR += TPR[l];
 			avgFPR += FPR[l];
@@ -987,6 +1370,59 @@ namespace MultiBoost {
 			outStream << OUTPUT_SEPARATOR << FPR[i];
 		}				
 	}
+	
+    // -------------------------------------------------------------------------
+	
+	void TPRFPROutput::updateRow(InputData* pData, int i, 
+								 const vector<AlphaReal>&, 
+								 const vector<AlphaReal>& newScores)
+	{
+		ForecastState& state = _states[pData];
+		if ( !state.isValid || i >= (int)state.forecastedLabels.size() )
+		{
+			state.isValid = false;
+			return;
+		}
+		
+		const int forecast = getForecast(pData->getLabels(i), newScores);
+		const int oldForecast = state.forecastedLabels[i];
+		
+		// only the examples whose winning class has changed modify the counts
+		if ( forecast != oldForecast )
+		{
+			const int orig = state.origLabels[i];
+			
+			if ( orig == oldForecast ) state.TP[orig]--;
+			else state.FP[oldForecast]--;
+			
+			if ( orig == forecast ) state.TP[orig]++;
+			else state.FP[forecast]++;
+			
+			state.forecastedLabels[i] = forecast;
+		}
+	}
+	
+    // -------------------------------------------------------------------------
+	
+	int TPRFPROutput::getForecast(const vector<Label>& labels, const vector<AlphaReal>& scores)
+	{
+		vector<Label>::const_iterator lIt;
+		
+		int forecast = 0;
+		AlphaReal maxClass = -numeric_limits<AlphaReal>::max();
+		
+		for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
+		{
+			if ( scores[lIt->idx] > maxClass )
+			{
+				forecast = lIt->idx;
+				maxClass = scores[lIt->idx];
+			}
+		}
+		
+		return forecast;
+	}
+	
 
     // -------------------------------------------------------------------------	
     // -------------------------------------------------------------------------	
@@ -996,8 +1432,8 @@ namespace MultiBoost {
                           map<InputData*, table>& marginsTableMap, 
                           map<InputData*, AlphaReal>& alphaSums,
                                            BaseLearner* pWeakHypothesis) {
-        set<int> indices ;
-        pData->getIndexSet(indices);
+        IndexView indices ;
+        pData->getIndexView(indices);
         pData->clearIndexSet();
         
 //        outStream << setprecision(4);
@@ -1115,7 +1551,7 @@ namespace MultiBoost {
         outStream << OUTPUT_SEPARATOR << tpRate;
         outStream << OUTPUT_SEPARATOR << eval;
         
-        pData->loadIndexSet(indices);
+        pData->loadIndexView(indices);
         
     }
     
@@ -1140,7 +1576,7 @@ namespace MultiBoost {
             }
             
             if (j != idxV.size()) {
-                outStream << endl;
+                outStream << '\n';
             }
             
         }
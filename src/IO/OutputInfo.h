@@ -39,11 +39,13 @@
 #define __OUTPUT_INFO_H
 
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <map>
 
 #include "IO/InputData.h"
+#include "IO/AsyncWriter.h"
 #include "Defaults.h" //for the default output
 
 using namespace std;
@@ -91,6 +93,9 @@ namespace MultiBoost {
 	 * \warning Don't forget to begin the list of information
 	 * printed with outputIteration(), and close it with
 	 * a call to endLine()!
+	 * \remark The lines are built in memory and handed over to an AsyncWriter,
+	 * so the file is written by a background thread, and it is complete only
+	 * once the object is destroyed.
 	 * \date 16/11/2005
 	 */
 	class OutputInfo
@@ -121,6 +126,21 @@ namespace MultiBoost {
 		 */
         explicit OutputInfo(const nor_utils::Args& args, bool customUpdate = false, const string & clArg = "outputinfo");
         
+        /**
+         * The destructor. Hands over what is left and waits for the file to be written.
+         * \date 18/10/2026
+         */
+        ~OutputInfo();
+        
+        /**
+         * True if one of the outputs asked with \a clArg uses the initial weights
+         * of the labels (w01, wha, wer, mar), which the compact labels then have to keep.
+         * \param args The arguments passed through command line
+         * \param clArg The command line argument that gives the output list
+         * \date 19/10/2026
+         */
+        static bool needsInitialWeights(const nor_utils::Args& args, const string & clArg = "outputinfo");
+        
         
         /**
          * Forces the choice of the output information 
@@ -129,6 +149,16 @@ namespace MultiBoost {
          */
         void setOutputList(const string& list, bool append = false, const nor_utils::Args* args = NULL);
         
+        /**
+         * Compute some of the outputs only every \a period calls of outputCustom()
+         * (that is, every \a period iterations). In between, the last computed value
+         * is repeated, so the columns of the file are unchanged.
+         * \param period The sampling period (1 = compute at each iteration).
+         * \param list The outputs concerned (eg. "aucber"). All of them if empty.
+         * \date 18/10/2026
+         */
+        void setOutputPeriod(int period, const string& list = "");
+        
 		/**
 		 * Just output the iteration number.
 		 * \param t The iteration number.
@@ -169,7 +199,7 @@ namespace MultiBoost {
 		 * Call it when all the needed information has been outputted.
 		 * \date 16/11/2005
 		 */
-		void endLine() { _outStream << endl; }
+		void endLine();
 
 		
         /**
@@ -210,6 +240,8 @@ namespace MultiBoost {
 
 			for( int i=0; i<g.size(); i++ )
 				copy( tmpTable[i].begin(), tmpTable[i].end(), g[i].begin() ); 
+			
+			invalidateOutputs(pData);
 		}
 		
 		table& getMargins( InputData* pData )
@@ -240,7 +272,26 @@ namespace MultiBoost {
 	protected:
 		
 		
-		ofstream                _outStream; //!< The output stream 
+		/**
+		 * The line being built. It is handed over to the writer by endLine(),
+		 * or by outputCustom() when it gets large.
+		 * \date 18/10/2026
+		 */
+		ostringstream           _outStream;
+		
+		AsyncWriter*            _pWriter; //!< Writes the output file in the background.
+		
+		/**
+		 * Open the output file.
+		 * \date 18/10/2026
+		 */
+		void openOutput(const string& outputInfoFile);
+		
+		/**
+		 * Hand over the current content of _outStream to the writer.
+		 * \date 18/10/2026
+		 */
+		void flushLine();
 		
 		time_t				   _beginingTime;
         
@@ -291,6 +342,31 @@ namespace MultiBoost {
         
         string _outputListString;
         
+        vector<string> _outputNames; //!< The abbreviations of the outputs of _outputList.
+        
+        int _outputPeriod; //!< The sampling period of the periodic outputs.
+        string _periodicOutputs; //!< The outputs sampled with _outputPeriod (all if empty).
+        
+        /**
+         * The number of calls of outputCustom() for each dataset,
+         * and the last value printed by each periodic output.
+         * \date 18/10/2026
+         */
+        map<InputData*, int> _numOutputCalls;
+        map<InputData*, vector<string> > _lastOutputs;
+        
+        /**
+         * \return The sampling period of the i-th output of _outputList.
+         * \date 18/10/2026
+         */
+        int getOutputPeriod(int i) const;
+        
+        /**
+         * The table of the data has been replaced: tell it to the incremental outputs.
+         * \date 18/10/2026
+         */
+        void invalidateOutputs(InputData* pData);
+        
         /**
          * Creates the OutputInfoType instances
          * from a string
@@ -353,6 +429,32 @@ namespace MultiBoost {
          */
         virtual void outputHeader(ostream& outStream, const NameMap& namemap) = 0;
         
+        /**
+         * Tells whether the output keeps statistics that are updated example by example
+         * (see updateRow()), instead of scanning the whole table at each iteration.
+         * \date 18/10/2026
+         */
+        virtual bool isIncremental() { return false; }
+        
+        /**
+         * Called by OutputInfo::updateTables() for each example whose scores have changed.
+         * \param pData The input data.
+         * \param i The index of the example.
+         * \param oldScores The previous row of the table of the posteriors.
+         * \param newScores The updated row.
+         * \date 18/10/2026
+         */
+        virtual void updateRow(InputData*, int, 
+                               const vector<AlphaReal>&, 
+                               const vector<AlphaReal>&) {}
+        
+        /**
+         * The table of the posteriors of the data has been changed from outside: the
+         * incremental statistics must be rebuilt at the next call of computeAndOutput().
+         * \date 18/10/2026
+         */
+        virtual void invalidate(InputData*) {}
+        
         /* 
          * The creation method of the factory
          */
@@ -430,6 +532,8 @@ namespace MultiBoost {
     
     /**
      * The 0-1 error. 
+     * The error flag of each example is kept, and the count is updated only
+     * for the examples whose scores have changed.
      * \date 19/07/2011
      */
     class ZeroOneErrorOutput : public BaseOutputInfoType {
@@ -445,6 +549,35 @@ namespace MultiBoost {
                               map<InputData*, table>& marginsTableMap, 
                               map<InputData*, AlphaReal>& alphaSums,
                               BaseLearner* pWeakHypothesis = 0);
+        
+        bool isIncremental() { return true; }
+        
+        void updateRow(InputData* pData, int i, 
+                       const vector<AlphaReal>& oldScores, 
+                       const vector<AlphaReal>& newScores);
+        
+        void invalidate(InputData* pData) { _states[pData].isValid = false; }
+        
+    protected:
+        
+        /**
+         * The incremental statistics of a dataset.
+         */
+        struct ErrorState
+        {
+            ErrorState() : numErrors(0), isValid(false) {}
+            
+            vector<char>    isError; //!< The error flag of each example.
+            int             numErrors; //!< The number of errors.
+            bool            isValid; //!< False if the statistics must be rebuilt.
+        };
+        
+        map<InputData*, ErrorState> _states;
+        
+        /**
+         * \return true if the winning positive class does not beat the winning negative one.
+         */
+        static bool isError(const vector<Label>& labels, const vector<AlphaReal>& scores);
     };
 	
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -489,6 +622,18 @@ namespace MultiBoost {
                               map<InputData*, table>& marginsTableMap, 
                               map<InputData*, AlphaReal>& alphaSums,
                               BaseLearner* pWeakHypothesis = 0);
+        
+        bool isIncremental() { return true; }
+        
+        void updateRow(InputData* pData, int i, 
+                       const vector<AlphaReal>& oldScores, 
+                       const vector<AlphaReal>& newScores);
+        
+        void invalidate(InputData* pData) { _numErrors.erase(pData); }
+        
+    protected:
+        
+        map<InputData*, int> _numErrors; //!< The number of wrong signs, for the up to date datasets.
     };
 	//////////////////////////////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -564,6 +709,41 @@ namespace MultiBoost {
                               map<InputData*, table>& marginsTableMap, 
                               map<InputData*, AlphaReal>& alphaSums,
                               BaseLearner* pWeakHypothesis = 0);
+        
+        bool isIncremental() { return true; }
+        
+        void updateRow(InputData* pData, int i, 
+                       const vector<AlphaReal>& oldScores, 
+                       const vector<AlphaReal>& newScores);
+        
+        void invalidate(InputData* pData) { _states[pData].isValid = false; }
+        
+    protected:
+        
+        /**
+         * The incremental statistics of a dataset.
+         */
+        struct BalancedState
+        {
+            BalancedState() : isValid(false) {}
+            
+            vector<char>    isCorrect; //!< Whether each example is well classified.
+            vector<int>     tp; //!< The true positives per class.
+            vector<int>     tn; //!< The true negatives per class.
+            bool            isValid; //!< False if the statistics must be rebuilt.
+        };
+        
+        map<InputData*, BalancedState> _states;
+        
+        /**
+         * \return true if the worst positive class beats the best negative one.
+         */
+        static bool isCorrect(const vector<Label>& labels, const vector<AlphaReal>& scores);
+        
+        /**
+         * Add (or remove, with sign=-1) a well classified example to the per class counts.
+         */
+        static void addExample(BalancedState& state, const vector<Label>& labels, int sign);
     };
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -681,6 +861,37 @@ namespace MultiBoost {
                               map<InputData*, table>& marginsTableMap, 
                               map<InputData*, AlphaReal>& alphaSums,
                               BaseLearner* pWeakHypothesis = 0);
+        
+    protected:
+        
+        /**
+         * The ranking of the examples for each class, kept from call to call.
+         * Between two calls the scores of a class move by only a few distinct
+         * amounts (one per output of the weak hypothesis), so the previous ranking
+         * splits into a few runs that are still sorted, and they are merged in linear time.
+         * A full sort is done only when there are too many distinct moves.
+         */
+        struct RankState
+        {
+            vector< vector<int> >       order; //!< The examples by decreasing score, per class.
+            vector< vector<AlphaReal> > scores; //!< The scores at the time of the ranking, per class.
+            vector< vector<char> >      isPositive; //!< The labels, per class.
+        };
+        
+        map<InputData*, RankState> _ranks;
+        
+        /**
+         * Bring the ranking of a class up to date with the table.
+         */
+        void updateRanking(RankState& state, table& g, int classIdx);
+        
+        /**
+         * Computes the area under the ROC curve from the ranking of a class,
+         * as nor_utils::getROC does but without sorting the examples again.
+         * \return A negative value if the ranking is not sorted.
+         * \see nor_utils::getSortedROC
+         */
+        static AlphaReal getAUC(const RankState& state, int classIdx);
     };
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -716,6 +927,38 @@ namespace MultiBoost {
                               map<InputData*, table>& marginsTableMap, 
                               map<InputData*, AlphaReal>& alphaSums,
                               BaseLearner* pWeakHypothesis = 0);
+        
+        bool isIncremental() { return true; }
+        
+        void updateRow(InputData* pData, int i, 
+                       const vector<AlphaReal>& oldScores, 
+                       const vector<AlphaReal>& newScores);
+        
+        void invalidate(InputData* pData) { _states[pData].isValid = false; }
+        
+    protected:
+        
+        /**
+         * The incremental statistics of a dataset.
+         */
+        struct ForecastState
+        {
+            ForecastState() : isValid(false) {}
+            
+            vector<int>     origLabels; //!< The (last) positive class of each example.
+            vector<int>     forecastedLabels; //!< The winning class of each example.
+            vector<int>     TP; //!< The true positives per class.
+            vector<int>     FP; //!< The false positives per class.
+            vector<int>     classDistr; //!< The number of examples per class.
+            bool            isValid; //!< False if the statistics must be rebuilt.
+        };
+        
+        map<InputData*, ForecastState> _states;
+        
+        /**
+         * \return The class with the highest score among the labels of the example.
+         */
+        static int getForecast(const vector<Label>& labels, const vector<AlphaReal>& scores);
     };
     
     
@@ -47,6 +47,7 @@
 
 #include "Utils/Utils.h" // for white_tabs
 #include "IO/RawData.h"
+#include "IO/OutputInfo.h" // for needsInitialWeights
 
 
 namespace MultiBoost {			
@@ -81,6 +82,7 @@ namespace MultiBoost {
 		if (verboseLevel > 0)
 			cout << "Loading file " << fileName << ":" << endl;
 		
+		pParser->setExampleListener( _pListener );
 		pParser->readData( _data, _classMap, _enumMaps, _attributeNameMap, _attributeTypes );
 		
 		_numClasses = _classMap.getNumNames();
@@ -137,6 +139,21 @@ namespace MultiBoost {
 		for (int l = 0; l < _numClasses; ++l)
 			_nExamplesPerClass.push_back( tmpPointsPerClass[l] );
 		
+		// the compact label store is needed only by the learners. It is built before
+		// the weights are initialized, so that the examples never hold them
+		if ( _compactLabels && inputType == IT_TRAIN )
+		{
+			_labelMatrix.build( _data, _numClasses, _labelRep, _compactInitialWeights, _compactFloatWeights );
+			
+			// the weights given by the data file are now in the store
+			vector<Example>::iterator eIt;
+			for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				vector<AlphaReal>().swap( eIt->getWeights() );
+			
+			if (verboseLevel > 1)
+				cout << "Compact labels: " << _labelMatrix.getMemoryUsage() / 1024 << " KB" << endl;
+		}
+		
 		// set the initial weight of instances
 		initWeights();
 		
@@ -211,6 +228,28 @@ namespace MultiBoost {
 			_headerFile = headerFile;
 		}	
 		
+		// store the labels and the weights in contiguous blocks
+		if ( args.hasArgument("compactlabels") )
+		{
+			_compactLabels = true;
+			
+			// without value the precision is empty
+			string precision = args.getValue<string>("compactlabels", 0);
+			if ( !precision.empty() )
+			{
+				if ( precision == "float" )
+					_compactFloatWeights = true;
+				else if ( precision != "double" )
+				{
+					cerr << "ERROR: Invalid value (" << precision << ") for option --compactlabels!" << endl;
+					exit(1);
+				}
+			}
+			
+			// the initial weights take as much memory as the weights
+			_compactInitialWeights = OutputInfo::needsInitialWeights(args);
+		}
+		
 		_weightInitType = WIT_SHARE_POINT; // default
 		if ( args.hasArgument("weightpolicy") )
 		{
@@ -236,19 +275,29 @@ namespace MultiBoost {
 	
 	void RawData::initWeights()
 	{
-		vector<Example>::iterator eIt;
 		vector<Label>::iterator lIt;
 		AlphaReal sumWeight; // sum of the weight for each example
 		
+		// without weights in the data file, all the weights start at 1
+		if ( !hasCompactLabels() )
+		{
+			vector<Example>::iterator eIt;
+			for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+			{
+				if ( eIt->getWeights().empty() )
+					eIt->getWeights().assign( eIt->getLabels().size(), 1 );
+			}
+		}
+		
 		switch ( _weightInitType )
 		{
 			case WIT_SHARE_POINT:
 			{
 				AlphaReal oneDiv2n;
 				// for each example
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				for ( int i = 0; i < _numExamples; ++i )
 				{
-					vector<Label>& labels = eIt->getLabels();
+					vector<Label>& labels = _data[i].getLabels();
 					
 					AlphaReal sumPos = 0;
 					AlphaReal sumNeg = 0;
@@ -257,9 +306,9 @@ namespace MultiBoost {
 					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 					{
 						if ( lIt->y > 0 )
-							sumPos += lIt->weight;
+							sumPos += getLabelWeight( i, *lIt );
 						else if ( lIt->y < 0 )
-							sumNeg += lIt->weight;
+							sumNeg += getLabelWeight( i, *lIt );
 					}
 					
 					if ( nor_utils::is_zero(sumPos) || nor_utils::is_zero(sumNeg) )
@@ -273,11 +322,11 @@ namespace MultiBoost {
 						// clearly this can be optimized, but the current format is
 						// just for clarity
 						if ( lIt->y > 0 )
-							lIt->weight = oneDiv2n * ( lIt->weight / sumPos );
+							setLabelWeight( i, *lIt, oneDiv2n * ( getLabelWeight( i, *lIt ) / sumPos ) );
 						else if ( lIt->y < 0 )
-							lIt->weight = oneDiv2n * ( lIt->weight / sumNeg );
+							setLabelWeight( i, *lIt, oneDiv2n * ( getLabelWeight( i, *lIt ) / sumNeg ) );
 						else
-							lIt->weight = 0; // should never happen!
+							setLabelWeight( i, *lIt, 0 ); // should never happen!
 					}
 				}
 			}
@@ -287,18 +336,18 @@ namespace MultiBoost {
 			case WIT_SHARE_LABEL:
 				
 				// for each example
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				for ( int i = 0; i < _numExamples; ++i )
 				{
-					vector<Label>& labels = eIt->getLabels();
+					vector<Label>& labels = _data[i].getLabels();
 					sumWeight = 0;
 					
 					// first find the sum of the weights
 					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-						sumWeight += lIt->weight;
+						sumWeight += getLabelWeight( i, *lIt );
 					
 					// now set the weights
 					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-						lIt->weight /= (sumWeight * _numExamples);
+						setLabelWeight( i, *lIt, getLabelWeight( i, *lIt ) / (sumWeight * _numExamples) );
 				}
 				
 				break;
@@ -308,21 +357,21 @@ namespace MultiBoost {
 				sumWeight = 0;
 				
 				// first compute the whole sum of weights-examples
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				for ( int i = 0; i < _numExamples; ++i )
 				{
-					vector<Label>& labels = eIt->getLabels();
+					vector<Label>& labels = _data[i].getLabels();
 					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-						sumWeight += lIt->weight;
+						sumWeight += getLabelWeight( i, *lIt );
 				}
 				
 				// now re-weight 
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				for ( int i = 0; i < _numExamples; ++i )
 				{
-					vector<Label>& labels = eIt->getLabels();
+					vector<Label>& labels = _data[i].getLabels();
 					
 					// now set the weights
 					for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-						lIt->weight /= sumWeight;
+						setLabelWeight( i, *lIt, getLabelWeight( i, *lIt ) / sumWeight );
 				}
 				
 				break;
@@ -347,18 +396,16 @@ namespace MultiBoost {
 				
 				//this->_nExamplesPerClass
 				// for each example
-				for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				for ( int i = 0; i < _numExamples; ++i )
 				{
-					vector<Label>& labels = eIt->getLabels();
+					vector<Label>& labels = _data[i].getLabels();
 					
-					// first find the sum of the weights					
-					int i = 0;
-					for ( lIt = labels.begin(); lIt != labels.end(); ++lIt, i++ )
+					for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
 					{
 						if ( lIt->y > 0 )
-							lIt->weight = wi[lIt->idx];
+							setLabelWeight( i, *lIt, wi[lIt->idx] );
 						else if ( lIt->y < 0 )
-							lIt->weight = wic[lIt->idx];
+							setLabelWeight( i, *lIt, wic[lIt->idx] );
 					}
 					
 				}
@@ -370,14 +417,14 @@ namespace MultiBoost {
 		
 		// check for the sum of weights!
 		sumWeight = 0;
-		for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+		for ( int i = 0; i < _numExamples; ++i )
 		{
-			vector<Label>& labels = eIt->getLabels();
+			vector<Label>& labels = _data[i].getLabels();
 			vector<Label>::iterator lIt;
 			
 			// first find the sum of the weights
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				sumWeight += lIt->weight;
+				sumWeight += getLabelWeight( i, *lIt );
 		}
 		
 		if ( !nor_utils::is_zero(sumWeight-1.0, 1E-3 ) )
@@ -387,20 +434,49 @@ namespace MultiBoost {
 			//exit(1);
 		}
 		
+		// the aggregated weights of the sparse labels
+		syncCompactLabels();
+		
 		// set the initial weights needed to calculate the initial weighted error (11)
-		for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
-		{
-			vector<Label>& labels = eIt->getLabels();
 #ifndef NOTIWEIGHT
-			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				lIt->initialWeight = lIt->weight;
+		if ( hasCompactLabels() )
+			_labelMatrix.storeInitialWeights();
+		else
+		{
+			vector<Example>::iterator eIt;
+			for ( eIt = _data.begin(); eIt != _data.end(); ++eIt )
+				eIt->getInitialWeights() = eIt->getWeights();
+		}
 #endif
+		
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	vector<FeatureReal>& RawData::getValues(int idx)
+	{
+		if ( hasValueMatrix() )
+		{
+			cerr << "ERROR: The values of the examples are in the value matrix, they must be restored first." << endl;
+			exit(1);
 		}
 		
+		return _data[idx].getValues();
 	}
 	
 	// ------------------------------------------------------------------------
 	
+	void RawData::copyValueMatrix()
+	{
+		const FeatureReal* pRow = _pValueMatrix;
+		_pValueMatrix = NULL;
+
+		for ( int i = 0; i < _numExamples; ++i, pRow += _numAttributes )
+			_data[i].getValues().assign( pRow, pRow + _numAttributes );
+	}
+
+	// ------------------------------------------------------------------------
+
 	void RawData::outputData()
 	{
 		ofstream out( "tmpsvm.data" );
@@ -410,6 +486,13 @@ namespace MultiBoost {
 		{
 			Example e = this->getExample(i);
 			
+			if ( hasValueMatrix() )
+			{
+				const FeatureReal* pRow = getValueRow(i);
+				for ( int j = 0; j < _numAttributes; ++j )
+					out << pRow[j] << " ";
+			}
+			
 			vector<FeatureReal> vals = e.getValues();						
 			vector<FeatureReal>::iterator itV;
 			for ( itV = vals.begin(); itV != vals.end(); ++itV )
@@ -49,6 +49,7 @@
 //#include "GenericParser.h"
 #include "NameMap.h"
 #include "Others/Example.h"
+#include "LabelMatrix.h"
 
 //#include "Parser.h"
 #include <cassert>
@@ -88,6 +89,27 @@ namespace MultiBoost {
 	};
 	
 	
+	/**
+	 * Receives the examples one at a time while they are read by the parser
+	 * (see RawData::setExampleListener), so that their values can be moved
+	 * into another storage before the next example is read, and the values
+	 * of all the examples are never held at the same time.
+	 * \date 19/10/2026
+	 */
+	class ExampleListener {
+	public:
+		virtual ~ExampleListener() {}
+		
+		/**
+		 * Called when an example has been read. The example can be modified.
+		 * \param rawIdx The raw index of the example.
+		 * \param example The example.
+		 * \date 19/10/2026
+		 */
+		virtual void exampleRead( int rawIdx, Example& example ) = 0;
+	};
+	
+	
 	class RawData {
 		// these will be moved soon
 	protected:
@@ -102,7 +124,8 @@ namespace MultiBoost {
 		 * \date 12/11/2005
 		 */
 		RawData() : _hasExampleName(false), _classInLastColumn(false), _sepChars(" \t\n"),
-		_numAttributes(0), _numExamples(0), _fileFormat(FF_SIMPLE), _headerFile(""), _dataRep(DR_DENSE) {  }
+		_numAttributes(0), _numExamples(0), _fileFormat(FF_SIMPLE), _headerFile(""), _dataRep(DR_DENSE),
+		_compactLabels(false), _compactFloatWeights(false), _compactInitialWeights(false), _pListener(NULL), _pValueMatrix(NULL) {  }
 		
 		
 		/**
@@ -130,6 +153,14 @@ namespace MultiBoost {
 							  eInputType inputType = IT_TRAIN, 
 							  int verboseLevel = 1);
 		
+		/**
+		 * Set the object which receives the examples while they are read by load.
+		 * \param pListener The listener, or NULL.
+		 * \see ExampleListener
+		 * \date 19/10/2026
+		 */
+		void setExampleListener( ExampleListener* pListener ) { _pListener = pListener; }
+		
 		
 		
 		/**
@@ -148,14 +179,22 @@ namespace MultiBoost {
 		{ return _data[idx].hasPositiveLabel(labelIdx); }
 		
 		/**
-		 * Get the values of the example \a idx
+		 * Get the values of the (dense) example \a idx, from the value matrix if
+		 * there is one.
+		 * \param idx The index of the example.
+		 * \return The first of the getNumAttributes() values of the example.
+		 * \date 19/10/2026
+		 */   
+		inline const FeatureReal* getValueRow(int idx) const 
+		{ return hasValueMatrix() ? _pValueMatrix + (size_t)idx * _numAttributes : &_data[idx].getValues()[0]; }
+		
+		/**
+		 * Get the values of the example \a idx, to modify them.
 		 * \param idx The index of the example.
+		 * \remark The values must be in the Examples (see restoreValues()).
 		 * \date 11/11/2005
 		 */   
-		inline const vector<FeatureReal>& getValues(int idx) const 
-		{ return _data[idx].getValues(); }
-		inline       vector<FeatureReal>& getValues(int idx) 
-		{ return _data[idx].getValues(); }
+		vector<FeatureReal>& getValues(int idx);
 		
 		//////////////////////////////////////////////////////////////////////////
 		//////////////////////////////////////////////////////////////////////////
@@ -167,7 +206,9 @@ namespace MultiBoost {
 		
 		
 		inline FeatureReal getValue(int idx, int columnIdx) const { 
-			if ( _dataRep == DR_DENSE )	return _data[idx].getValues()[columnIdx]; 
+			if ( _dataRep == DR_DENSE )	
+				return hasValueMatrix() ? _pValueMatrix[ (size_t)idx * _numAttributes + columnIdx ] :
+										  _data[idx].getValues()[columnIdx]; 
 			else {
 				map<int,int>::iterator it = ((Example &)_data[idx]).getValuesIndexesMap().find( columnIdx );
 				if ( it == ((Example &)_data[idx]).getValuesIndexesMap().end() ) return 0;
@@ -180,10 +221,29 @@ namespace MultiBoost {
 		
 		/**
 		 */
-		void clearRawData() { _data.clear(); _numExamples = 0; } 
+		void clearRawData() { _data.clear(); _numExamples = 0; _labelMatrix.clear(); _pValueMatrix = NULL; } 
 		
 		void addExample( Example example ) { 
+			restoreValues();
+			
+			// the layout of the compact labels is fixed, fall back on the weights of the examples
+			if ( hasCompactLabels() )
+			{
+				_labelMatrix.copyWeightsTo( _data );
+				_labelMatrix.clear();
+			}
+			
 			_data.push_back( example ); 
+			
+			// an example that was not loaded has the default weights
+			const int numLabels = static_cast<int>( example.getLabels().size() );
+			if ( _data.back().getWeights().empty() )
+				_data.back().getWeights().assign( numLabels, 1 );
+#ifndef NOTIWEIGHT
+			if ( _data.back().getInitialWeights().empty() )
+				_data.back().getInitialWeights().assign( numLabels, 1 );
+#endif
+
 			_numExamples++; 
             
             const vector<Label> & labels = example.getLabels();
@@ -197,6 +257,10 @@ namespace MultiBoost {
 		} 
         
 		
+		/**
+		 * Get the examples. With a value matrix their values are empty, they are 
+		 * read with getValue() and getValueRow().
+		 */
 		inline const Example& getExample(int idx)
 		{ return _data[idx]; }
 
@@ -243,12 +307,103 @@ namespace MultiBoost {
 		
 		const string getSepChars() { return _sepChars; }
 		const eDataRep getDataRep() { return _dataRep; }
-		vector<Example>::iterator rawBegin() {return _data.begin(); }
+		vector<Example>::iterator rawBegin() { return _data.begin(); }
 		vector<Example>::iterator rawEnd() {return _data.end();}
 		void setInitWeighting( eWeightInitType weightInitType ) { _weightInitType = weightInitType; }
 		
 		vector< int >&	getExamplesPerClass() { return _nExamplesPerClass; }
 		
+		/**
+		 * True if the labels and weights are stored in the compact LabelMatrix
+		 * (option --compactlabels, training data only), which then owns the weights.
+		 */
+		bool hasCompactLabels() const { return !_labelMatrix.empty(); }
+		
+		inline       LabelMatrix& getLabelMatrix()       { return _labelMatrix; }
+		inline const LabelMatrix& getLabelMatrix() const { return _labelMatrix; }
+		
+		/**
+		 * Gets the current weight of a label, from the compact store if there is one.
+		 * \param rawIdx The raw index of the example.
+		 * \param label A label of the example, from getLabels( \a rawIdx ).
+		 */
+		inline AlphaReal getLabelWeight( int rawIdx, const Label& label ) const
+		{
+			if ( !hasCompactLabels() )
+				return _data[rawIdx].getWeights()[ getLabelPosition(rawIdx, label) ];
+			
+			// the position of the label in the row is its index in the vector
+			const int pos = _labelMatrix.isDense() ? label.idx : getLabelPosition(rawIdx, label);
+			return _labelMatrix.getWeight( _labelMatrix.getRowBegin(rawIdx) + pos );
+		}
+		
+		/**
+		 * Sets the current weight of a label, in the compact store if there is one.
+		 * \param rawIdx The raw index of the example.
+		 * \param label A label of the example, from getLabels( \a rawIdx ).
+		 * \param w The new weight.
+		 */
+		inline void setLabelWeight( int rawIdx, const Label& label, AlphaReal w )
+		{
+			if ( !hasCompactLabels() )
+			{
+				_data[rawIdx].getWeights()[ getLabelPosition(rawIdx, label) ] = w;
+				return;
+			}
+			
+			const int pos = _labelMatrix.isDense() ? label.idx : getLabelPosition(rawIdx, label);
+			_labelMatrix.setWeight( _labelMatrix.getRowBegin(rawIdx) + pos, w );
+		}
+		
+#ifndef NOTIWEIGHT
+		/**
+		 * Gets the initial weight of a label, from the compact store if there is one.
+		 * \param rawIdx The raw index of the example.
+		 * \param label A label of the example, from getLabels( \a rawIdx ).
+		 */
+		inline AlphaReal getLabelInitialWeight( int rawIdx, const Label& label ) const
+		{
+			const int pos = getLabelPosition(rawIdx, label);
+			if ( !hasCompactLabels() )
+				return _data[rawIdx].getInitialWeights()[pos];
+			
+			assert( _labelMatrix.hasInitialWeights() );
+			return _labelMatrix.getInitialWeight( _labelMatrix.getRowBegin(rawIdx) + pos );
+		}
+#endif
+		
+		/**
+		 * Copy the labels of the Label objects into the compact store, with the
+		 * aggregated weights of the sparse labels. It must be called by the code that
+		 * modifies the labels in place or sets the weights with setLabelWeight().
+		 */
+		void syncCompactLabels() { if ( hasCompactLabels() ) _labelMatrix.updateValues( _data ); }
+		
+		/**
+		 * True if the values of the (dense) examples are read from a value matrix
+		 * instead of the Examples, whose values are then empty.
+		 */
+		bool hasValueMatrix() const { return _pValueMatrix != NULL; }
+		
+		/**
+		 * Read the values of the examples from a matrix of getNumExample() rows of
+		 * getNumAttributes() values, which stays owned by the caller (see SortedData).
+		 * The values of the Examples must have been released by the caller.
+		 * \param pValueMatrix The first value of the matrix.
+		 * \remark The values of the Examples stay empty until restoreValues() is called.
+		 * \date 19/10/2026
+		 */
+		void setValueMatrix( const FeatureReal* pValueMatrix ) 
+		{ assert( _dataRep == DR_DENSE ); _pValueMatrix = pValueMatrix; }
+		
+		/**
+		 * Copy the values of the value matrix, if any, back into the Examples and
+		 * drop the matrix, before the values of the Examples are used or modified
+		 * (see addExample()). It must not be called while other threads read the data.
+		 * \date 19/10/2026
+		 */
+		void restoreValues() { if ( hasValueMatrix() ) copyValueMatrix(); }
+		
 		// for debug
 		void outputData();
 	protected:
@@ -276,6 +431,15 @@ namespace MultiBoost {
 		 * \date 11/11/2005
 		 */
 		virtual void  initWeights();
+		
+		/**
+		 * The position of a label in the labels of its example, which is also the
+		 * position of its weight in Example::getWeights().
+		 * \param rawIdx The raw index of the example.
+		 * \param label A label of the example, from getLabels( \a rawIdx ).
+		 */
+		inline int getLabelPosition( int rawIdx, const Label& label ) const
+		{ return static_cast<int>( &label - &_data[rawIdx].getLabels()[0] ); }
 				
 		// --------------------------------------------------------------------
 		
@@ -292,6 +456,22 @@ namespace MultiBoost {
 		
 		//for LSHTC challenge		
 		string			_headerFile;
+		
+		bool			_compactLabels; //!< Build the compact label store at load time.
+		bool			_compactFloatWeights; //!< Store the weights of the compact labels as float.
+		bool			_compactInitialWeights; //!< Keep the initial weights in the compact label store.
+		LabelMatrix		_labelMatrix; //!< The compact store of the labels and the weights. 
+		
+		ExampleListener*	_pListener; //!< Receives the examples while they are read.
+		
+		/**
+		 * Copy the value matrix into the Examples and drop it (see restoreValues()).
+		 * \date 19/10/2026
+		 */
+		void copyValueMatrix();
+		
+		const FeatureReal*	_pValueMatrix; //!< The values of the examples row after row, if they are not in the Examples.
+
 	};
 	
 }
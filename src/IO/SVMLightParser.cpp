@@ -231,7 +231,7 @@ namespace MultiBoost {
 				AlphaReal tmpWeight;
 				ss >> tmpWeight;
 				
-				_weightOfClasses.insert( make_pair<int, AlphaReal>( i, tmpWeight ) );					
+				_weightOfClasses.insert( make_pair( i, tmpWeight ) );					
 			}
 			
 		}
@@ -320,6 +320,10 @@ namespace MultiBoost {
 			readSparseValues(ss, currExample.getValues(), currExample.getValuesIndexes(), currExample.getValuesIndexesMap(),
 							 enumMaps, attributeTypes, attributeNameMap );
 			
+			// the values can be moved elsewhere before the next example is read
+			if ( _pListener )
+				_pListener->exampleRead( static_cast<int>(currentSize), currExample );
+			
 			currentSize++;
 		}
 		
@@ -337,7 +341,7 @@ namespace MultiBoost {
 		for( int i=0; i<examples.size(); i++ )
 		{
 			Example& currExample = examples[i];
-			allocateSimpleLabels( tmpLabelIdxs[i], currExample.getLabels(), classMap );
+			allocateSimpleLabels( tmpLabelIdxs[i], currExample.getLabels(), currExample.getWeights(), classMap );
 		}
 		
 		cout << "Done!" << endl;
@@ -409,7 +413,7 @@ namespace MultiBoost {
 	// ------------------------------------------------------------------------
 	
 	void SVMLightParser::allocateSimpleLabels( vector<int>& labelIdx, vector<Label>& labels,
-											  NameMap& classMap )
+											  vector<AlphaReal>& weights, NameMap& classMap )
 	{
 		
 		const int numClasses = classMap.getNumNames();
@@ -445,8 +449,9 @@ namespace MultiBoost {
 				labels[i].y = negWeight;
 			}
 			
+			weights.assign( numClasses, 1 );
 			for ( int i = 0; i < labelIdx.size(); ++i )
-				labels[ labelIdx[i] ].weight = _weightOfClasses[ labelIdx[i] ];		
+				weights[ labelIdx[i] ] = _weightOfClasses[ labelIdx[i] ];		
 		}
 	}
 	
@@ -99,7 +99,7 @@ namespace MultiBoost {
 							  const vector<RawData::eAttributeType>& attributeTypes, NameMap& attributeNameMap);
 		
 		void allocateSimpleLabels( vector<int>& labelIdx, vector<Label>& labels,
-								  NameMap& classMap );				
+								  vector<AlphaReal>& weights, NameMap& classMap );				
 		
 		int					 _numAttributes;
 		
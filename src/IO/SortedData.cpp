@@ -33,112 +33,743 @@
 
 #include "SortedData.h"
 
-#include "Defaults.h" // for STABLE_SORT declaration
+#include "Defaults.h"
 #include "Utils/Utils.h" // for comparePairOnSecond
 #include <algorithm> // for sort
 
 #include <limits>
+#include <sstream>
+#include <iomanip> // for setw
+#include <cstring> // for memcpy
+#include <sys/stat.h> // for stat
 
 // ------------------------------------------------------------------------
 namespace MultiBoost {
 	
+	void SortedData::initOptions(const nor_utils::Args& args)
+	{
+		InputData::initOptions(args);
+		
+		if ( args.hasArgument("shareddata") )
+			args.getValue("shareddata", 0, _sharedDataDir);
+	}
+	
+	// ------------------------------------------------------------------------
+	
 	void SortedData::load(const string& fileName, eInputType inputType, int verboseLevel)
 	{
+		// the values of the training data are moved into one matrix while they are
+		// read, so that they can be shared with the sorted columns
+		const bool shareValues = !_sharedDataDir.empty() && inputType != IT_TEST;
+		
+		string sharedName;
+		if ( shareValues )
+		{
+			_numValueColumns = -1;
+			
+			// if the file is already published, its values are compared with the ones
+			// read, which are dropped instead of being stored
+			sharedName = getSharedColumnsName(fileName);
+			if ( !sharedName.empty() )
+				openSharedColumns(sharedName);
+			
+			_pData->setExampleListener(this);
+		}
+		
 		InputData::load(fileName, inputType, verboseLevel);
 		
+		if ( shareValues )
+		{
+			_pData->setExampleListener(NULL);
+			if ( !_pSharedValues )
+				useValueStorage();
+		}
+		
 		// Test does not need sorting
 		if (inputType == IT_TEST)
 			return;
 		
+		if ( _sharedColumns.is_open() )
+		{
+			if ( attachSharedColumns() )
+			{
+				if (verboseLevel > 0)
+					cout << "Sorted data shared from " << sharedName << endl;
+				return;
+			}
+			
+			// the values dropped while the file was read are back in _valueStorage
+			if ( !_pData->hasValueMatrix() )
+				useValueStorage();
+		}
+		
 		if (verboseLevel > 0)
 			cout << "Sorting data..." << flush;
 		
-		// set the number of columns for the stored data
-		_sortedData.resize(_pData->getNumAttributes()); 
-		int i = 0;
+		sortColumns();
+		
+		if (verboseLevel > 0)
+			cout << "Done!" << endl;
 		
-		if ( _pData->getDataRep() == DR_DENSE )
+		if ( !sharedName.empty() )
 		{
-			for ( i = 0; i < _pData->getNumAttributes(); ++i )
-				_sortedData[i].reserve(_numExamples);
+			// once published, this process uses the shared copy too
+			computeDataHash();
+			if ( publishSharedColumns(sharedName) && openSharedColumns(sharedName) && attachSharedColumns() )
+				column().swap(_columnStorage);
+			else
+				cerr << "Warning: the sorted data cannot be shared in <" << sharedName << ">." << endl;
 		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::exampleRead( int rawIdx, Example& example )
+	{
+		if ( _numValueColumns == 0 )
+			return;
+		
+		vector<FeatureReal>& values = example.getValues();
+		
+		if ( _pSharedValues )
+		{
+			const FeatureReal* pSharedRow = _pSharedValues + (size_t)rawIdx * _numValueColumns;
+			
+			// the row is already in the shared file
+			if ( rawIdx < _numSharedRows && (int)values.size() == _numValueColumns && 
+				 example.getValuesIndexes().empty() &&
+				 memcmp( &values[0], pSharedRow, _numValueColumns * sizeof(FeatureReal) ) == 0 )
+			{
+				vector<FeatureReal>().swap( values );
+				return;
+			}
+			
+			// the file does not match the data, the values are stored privately
+			detachSharedColumns( rawIdx );
+		}
+		
+		if ( _numValueColumns < 0 )
+		{
+			// the parsers size the examples before reading them
+			_numValueColumns = (int)values.size();
+			_valueStorage.reserve( _pData->getExamples().size() * values.size() );
+		}
+		
+		// only the rows of dense data form a matrix
+		if ( values.empty() || (int)values.size() != _numValueColumns || 
+			 !example.getValuesIndexes().empty() )
+		{
+			restoreValueStorage();
+			return;
+		}
+		
+		assert( _valueStorage.size() == (size_t)rawIdx * _numValueColumns );
+		
+		_valueStorage.insert( _valueStorage.end(), values.begin(), values.end() );
+		vector<FeatureReal>().swap( values );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::useValueStorage()
+	{
+		if ( _numValueColumns > 0 && !_valueStorage.empty() &&
+			 _pData->getDataRep() == DR_DENSE &&
+			 _numValueColumns == _pData->getNumAttributes() &&
+			 _valueStorage.size() == (size_t)_pData->getNumExample() * _numValueColumns )
+			_pData->setValueMatrix( &_valueStorage[0] );
+		else
+			restoreValueStorage();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::restoreValueStorage()
+	{
+		if ( _numValueColumns > 0 )
+		{
+			const int numRows = (int)( _valueStorage.size() / _numValueColumns );
+			
+			for (int i = 0; i < numRows; ++i)
+			{
+				vector<FeatureReal>::const_iterator rowIt = _valueStorage.begin() + (size_t)i * _numValueColumns;
+				_pData->getExampleReference(i).getValues().assign( rowIt, rowIt + _numValueColumns );
+			}
+		}
+		
+		vector<FeatureReal>().swap( _valueStorage );
+		_numValueColumns = 0;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::sortColumns()
+	{
+		const int numAttributes = _pData->getNumAttributes();
+		const int numExamples = _pData->getNumExample();
 		
 		//////////////////////////////////////////////////////////////////////////
-		// Fill the sorted data vector.
-		// The data is stored column-wise. The index [j] is the column
-		// and the pair represent the index of the example with the value
+		// The columns are stored one after the other in _columnStorage. 
+		// First count the size of each column.
+		vector<size_t> columnBegin(numAttributes + 1, 0);
 		vector<Example>::iterator eIt;
 		
-		i = 0;
-		// for each example
-		for ( eIt = _pData->rawBegin(); eIt != _pData->rawEnd(); ++eIt, ++i )
+		if ( _pData->hasValueMatrix() ) // dense data, whose values are not in the examples
 		{
-			vector<FeatureReal>& values = eIt->getValues();
-			const vector<int>& valIdx = eIt->getValuesIndexes();
-			vector<FeatureReal>::iterator vIt;
-			int j = 0;
-			
-			if ( valIdx.empty() ) // dense data!
+			for (int j = 0; j < numAttributes; ++j )
+				columnBegin[j + 1] = numExamples;
+		}
+		else
+		{
+			for ( eIt = _pData->rawBegin(); eIt != _pData->rawEnd(); ++eIt )
 			{
-				//_sortedData[j].reserve(values.size()); // <-- this should be done before, and only of dense!
-				// for each attribute of the example
-				for (vIt = values.begin(); vIt != values.end(); ++vIt, ++j )
-					_sortedData[j].push_back( make_pair(i, *vIt) ); // store the index of the example and the value
+				const vector<int>& valIdx = eIt->getValuesIndexes();
+				
+				if ( valIdx.empty() ) // dense data!
+				{
+					for (int j = 0; j < (int)eIt->getValues().size(); ++j )
+						columnBegin[j + 1]++;
+				}
+				else // sparse data
+				{
+					for (int j = 0; j < (int)valIdx.size(); ++j )
+						columnBegin[ valIdx[j] + 1 ]++;
+				}
 			}
-			else // sparse data
+		}
+		
+		for (int j = 0; j < numAttributes; ++j)
+			columnBegin[j + 1] += columnBegin[j];
+		
+		//////////////////////////////////////////////////////////////////////////
+		// Fill the sorted data vector.
+		// The data is stored column-wise. The pair represent the index of the 
+		// example with the value
+		_columnStorage.resize( columnBegin[numAttributes] );
+		vector<size_t> columnEnd(columnBegin.begin(), columnBegin.end() - 1);
+		
+		if ( _pData->hasValueMatrix() )
+		{
+			for (int i = 0; i < numExamples; ++i )
 			{
-				// for each attribute of the example
-				for (vIt = values.begin(); vIt != values.end(); ++vIt, ++j )
-					_sortedData[ valIdx[j] ].push_back( make_pair(i, *vIt) ); // store the index of the example and the value
+				for (int j = 0; j < numAttributes; ++j )
+					_columnStorage[ columnEnd[j]++ ] = make_pair(i, _pData->getValue(i, j));
+			}
+		}
+		else
+		{
+			int i = 0;
+			// for each example
+			for ( eIt = _pData->rawBegin(); eIt != _pData->rawEnd(); ++eIt, ++i )
+			{
+				vector<FeatureReal>& values = eIt->getValues();
+				const vector<int>& valIdx = eIt->getValuesIndexes();
+				
+				if ( valIdx.empty() ) // dense data!
+				{
+					// for each attribute of the example
+					for (int j = 0; j < (int)values.size(); ++j )
+						_columnStorage[ columnEnd[j]++ ] = make_pair(i, values[j]); // store the index of the example and the value
+				}
+				else // sparse data
+				{
+					// for each attribute of the example
+					for (int j = 0; j < (int)values.size(); ++j )
+						_columnStorage[ columnEnd[ valIdx[j] ]++ ] = make_pair(i, values[j]); // store the index of the example and the value
+				}
 			}
 		}
 		
 		//////////////////////////////////////////////////////////////////////////
 		// Now sort the data.
 		
+		_sortedData.resize(numAttributes);
+		
+		SortedColumn::const_iterator pStorage = _columnStorage.empty() ? NULL : &_columnStorage[0];
+		
 		// For each column
-		for (int j = 0; j < _pData->getNumAttributes(); ++j)
+		for (int j = 0; j < numAttributes; ++j)
 		{
+			column::iterator colBegin = _columnStorage.begin() + columnBegin[j];
+			column::iterator colEnd = _columnStorage.begin() + columnBegin[j + 1];
 			
-#if STABLE_SORT
-			stable_sort( _sortedData[j].begin(), _sortedData[j].end(), 
-						nor_utils::comparePair<2, int, FeatureReal, less<FeatureReal> >() );
-#else
-			sort( _sortedData[j].begin(), _sortedData[j].end(), 
-				 nor_utils::comparePair< 2, int, FeatureReal, less<FeatureReal> >() );
-#endif
+			// ties are ordered by example index, so that the filtered columns can
+			// be rebuilt by sorting the examples of a subset only
+			sort( colBegin, colEnd, lessValueThenIndex() );
+			
+			_sortedData[j] = SortedColumn( pStorage + columnBegin[j], pStorage + columnBegin[j + 1] );
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	// The layout of the shared file: the header, the offsets of the columns 
+	// (numAttributes+1 values), the pairs of the columns one after the other
+	// and, if valueSize is not zero, the values of the examples row after row.
+	namespace {
+		
+		const char SHARED_COLUMNS_MAGIC[8] = { 'M', 'B', 'S', 'O', 'R', 'T', 'D', '2' };
+		
+		struct SharedColumnsHeader
+		{
+			char				magic[8];
+			int					numExamples;
+			int					numAttributes;
+			int					entrySize;
+			int					valueSize;
+			unsigned long long	dataHash;
+		};
+		
+		// FNV-1a
+		inline void hashBytes( unsigned long long& hash, const void* pData, size_t size )
+		{
+			const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+			for ( size_t b = 0; b < size; ++b )
+			{
+				hash ^= pBytes[b];
+				hash *= 1099511628211ULL;
+			}
 		}
 		
-		if (verboseLevel > 0)
-			cout << "Done!" << endl;
 	}
 	
 	// ------------------------------------------------------------------------
 	
-  // XXX fradav "old" optimized filter function cleaned of its O(log n) set::find()
-  // using the new _rawIndices vector and untouched typo ;-)
-	pair<vpIterator,vpIterator> SortedData::getFileteredBeginEnd(int colIdx) {
+	string SortedData::getSharedColumnsName(const string& fileName)
+	{
+		// the file is identified before it is read: the same file, of the same size
+		// and modified at the same time, has the same content
+		struct stat fileStat;
+		if ( stat( fileName.c_str(), &fileStat ) != 0 )
+			return "";
+		
+		unsigned long long fileHash = 14695981039346656037ULL;
+		const unsigned long long fileIdentity[4] = { 
+			(unsigned long long)fileStat.st_dev, (unsigned long long)fileStat.st_ino,
+			(unsigned long long)fileStat.st_size, (unsigned long long)fileStat.st_mtime };
+		hashBytes( fileHash, fileIdentity, sizeof(fileIdentity) );
+		
+		// the file name without the path
+		string baseName = fileName;
+		size_t slashPos = baseName.find_last_of("/\\");
+		if ( slashPos != string::npos )
+			baseName = baseName.substr(slashPos + 1);
+		
+		stringstream sharedName;
+		sharedName << _sharedDataDir << "/" << baseName << "." 
+				   << hex << setw(16) << setfill('0') << fileHash << ".sorted";
+		
+		return sharedName.str();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::computeDataHash()
+	{
+		_dataHash = 14695981039346656037ULL;
+		
+		if ( _pData->hasValueMatrix() )
+		{
+			// the same hash as the one of dense examples
+			const size_t numValues = _pData->getNumAttributes();
+			const int numExamples = _pData->getNumExample();
+			for ( int i = 0; i < numExamples; ++i )
+			{
+				hashBytes( _dataHash, &numValues, sizeof(numValues) );
+				hashBytes( _dataHash, _pData->getValueRow(i), numValues * sizeof(FeatureReal) );
+			}
+		}
+		else
+		{
+			vector<Example>::const_iterator eIt;
+			for ( eIt = _pData->rawBegin(); eIt != _pData->rawEnd(); ++eIt )
+			{
+				const vector<FeatureReal>& values = eIt->getValues();
+				const vector<int>& valIdx = eIt->getValuesIndexes();
+				
+				const size_t numValues = values.size();
+				hashBytes( _dataHash, &numValues, sizeof(numValues) );
+				if ( !values.empty() )
+					hashBytes( _dataHash, &values[0], values.size() * sizeof(FeatureReal) );
+				if ( !valIdx.empty() )
+					hashBytes( _dataHash, &valIdx[0], valIdx.size() * sizeof(int) );
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	bool SortedData::openSharedColumns(const string& sharedName)
+	{
+		if ( !_sharedColumns.open(sharedName) )
+			return false;
+		
+		SharedColumnsHeader header;
+		bool isValid = _sharedColumns.size() >= sizeof(header);
+		
+		if ( isValid )
+		{
+			memcpy( &header, _sharedColumns.data(), sizeof(header) );
+			isValid = memcmp( header.magic, SHARED_COLUMNS_MAGIC, sizeof(header.magic) ) == 0 &&
+					  header.numExamples >= 0 && header.numAttributes >= 0 &&
+					  header.entrySize == (int)sizeof(column::value_type) &&
+					  ( header.valueSize == 0 || header.valueSize == (int)sizeof(FeatureReal) );
+		}
+		
+		const size_t offsetsSize = isValid ? (header.numAttributes + 1) * sizeof(unsigned long long) : 0;
+		const size_t headerSize = sizeof(header) + offsetsSize;
+		isValid = isValid && _sharedColumns.size() >= headerSize;
+		
+		vector<unsigned long long> columnBegin;
+		if ( isValid )
+		{
+			columnBegin.resize( header.numAttributes + 1 );
+			memcpy( &columnBegin[0], _sharedColumns.data() + sizeof(header), offsetsSize );
+			for (int j = 0; j < header.numAttributes && isValid; ++j)
+				isValid = columnBegin[j] <= columnBegin[j + 1];
+			
+			const size_t valuesSize = (size_t)header.valueSize * header.numExamples * header.numAttributes;
+			isValid = isValid && columnBegin[0] == 0 &&
+					  _sharedColumns.size() == headerSize + columnBegin[header.numAttributes] * sizeof(column::value_type) + valuesSize;
+		}
+		
+		if ( !isValid )
+		{
+			_sharedColumns.close();
+			return false;
+		}
+		
+		if ( header.valueSize > 0 && header.numAttributes > 0 )
+		{
+			_pSharedValues = reinterpret_cast<const FeatureReal*>( _sharedColumns.data() + headerSize + 
+							 columnBegin[header.numAttributes] * sizeof(column::value_type) );
+			_numSharedRows = header.numExamples;
+			_numValueColumns = header.numAttributes;
+		}
+		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	bool SortedData::attachSharedColumns()
+	{
+		SharedColumnsHeader header;
+		memcpy( &header, _sharedColumns.data(), sizeof(header) );
+		
+		const int numAttributes = _pData->getNumAttributes();
+		
+		// the shared values were compared with the data while it was read, the 
+		// other data is compared through its hash
+		bool isValid = header.numExamples == _pData->getNumExample() &&
+					   header.numAttributes == numAttributes;
+		
+		if ( isValid && _pSharedValues )
+			isValid = _pData->getDataRep() == DR_DENSE;
+		else if ( isValid )
+		{
+			computeDataHash();
+			isValid = !_pData->hasValueMatrix() && header.dataHash == _dataHash;
+		}
+		
+		if ( !isValid )
+		{
+			detachSharedColumns( _pData->getNumExample() );
+			return false;
+		}
+		
+		SortedColumn::const_iterator pEntries = 
+			reinterpret_cast<SortedColumn::const_iterator>( _sharedColumns.data() + sizeof(header) + 
+															(numAttributes + 1) * sizeof(unsigned long long) );
+		vector<unsigned long long> columnBegin(numAttributes + 1, 0);
+		memcpy( &columnBegin[0], _sharedColumns.data() + sizeof(header), columnBegin.size() * sizeof(unsigned long long) );
+		
+		_sortedData.resize(numAttributes);
+		for (int j = 0; j < numAttributes; ++j)
+			_sortedData[j] = SortedColumn( pEntries + columnBegin[j], pEntries + columnBegin[j + 1] );
+		
+		if ( _pSharedValues )
+		{
+			_pData->setValueMatrix( _pSharedValues );
+			vector<FeatureReal>().swap( _valueStorage );
+		}
+		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::detachSharedColumns( int numDroppedRows )
+	{
+		// the rows dropped while the file was read are stored as if they had been read,
+		// unless the values are already stored by this process
+		if ( _pSharedValues && !_pData->hasValueMatrix() )
+		{
+			_valueStorage.reserve( _pData->getExamples().size() * _numValueColumns );
+			_valueStorage.assign( _pSharedValues, _pSharedValues + (size_t)numDroppedRows * _numValueColumns );
+			if ( numDroppedRows == 0 )
+				_numValueColumns = -1;
+		}
+		
+		_pSharedValues = NULL;
+		_numSharedRows = 0;
+		_sharedColumns.close();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	bool SortedData::publishSharedColumns(const string& sharedName)
+	{
+		const int numAttributes = _pData->getNumAttributes();
+		
+		SharedColumnsHeader header;
+		memset( &header, 0, sizeof(header) );
+		memcpy( header.magic, SHARED_COLUMNS_MAGIC, sizeof(header.magic) );
+		header.numExamples = _pData->getNumExample();
+		header.numAttributes = numAttributes;
+		header.entrySize = (int)sizeof(column::value_type);
+		header.valueSize = _pData->hasValueMatrix() ? (int)sizeof(FeatureReal) : 0;
+		header.dataHash = _dataHash;
+		
+		vector<unsigned long long> columnBegin(numAttributes + 1, 0);
+		for (int j = 0; j < numAttributes; ++j)
+			columnBegin[j + 1] = columnBegin[j] + _sortedData[j].size();
+		
+		vector< pair<const char*, size_t> > chunks;
+		chunks.push_back( make_pair( reinterpret_cast<const char*>(&header), sizeof(header) ) );
+		chunks.push_back( make_pair( reinterpret_cast<const char*>(&columnBegin[0]), 
+									 columnBegin.size() * sizeof(unsigned long long) ) );
+		if ( !_columnStorage.empty() )
+			chunks.push_back( make_pair( reinterpret_cast<const char*>(&_columnStorage[0]), 
+										 _columnStorage.size() * sizeof(column::value_type) ) );
+		if ( header.valueSize > 0 )
+			chunks.push_back( make_pair( reinterpret_cast<const char*>(&_valueStorage[0]), 
+										 _valueStorage.size() * sizeof(FeatureReal) ) );
+		
+		return MappedFile::writeAtomically( sharedName, chunks );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::filterColumn(int colIdx) {
 		_filteredColumn.clear();
-		for( column::iterator it = _sortedData[colIdx].begin(); it != _sortedData[colIdx].end(); it ++ ) {
+		
+		const int numUsed = this->getNumExamples();
+		const int numRaw = (int)_sortedData[colIdx].size();
+		
+		// a small subset of dense data: sort the values of the subset rather than
+		// scanning the whole column. The order indices are increasing with the raw
+		// indices, so the order is the same as the one of the full scan.
+		int logNumUsed = 1;
+		while ( (1 << logNumUsed) < numUsed ) ++logNumUsed;
+		
+		if ( _pData->getDataRep() == DR_DENSE && numUsed * logNumUsed < numRaw ) {
+			_filteredColumn.reserve( numUsed );
+			for ( int i = 0; i < numUsed; ++i ) {
+				FeatureReal val = this->getValue( i, colIdx );
+				if ( val == val )
+					_filteredColumn.push_back( pair<int, FeatureReal>(i, val) );
+			}
+			sort( _filteredColumn.begin(), _filteredColumn.end(), lessValueThenIndex() );
+			return;
+		}
+		
+		// XXX fradav "old" optimized filter function cleaned of its O(log n) set::find()
+		// using the new _rawIndices vector
+		for( SortedColumn::const_iterator it = _sortedData[colIdx].begin(); it != _sortedData[colIdx].end(); it ++ ) {
 		  if ( this->isUsedIndice( it->first ) && ( it->second == it->second ) ) {
 				int i = this->getOrderBasedOnRawIndex( it->first );
 				_filteredColumn.push_back( pair<int, FeatureReal>(i, it->second) );
 			}
 		}
-		return make_pair(_filteredColumn.begin(),_filteredColumn.end());
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	pair<vpIterator,vpIterator> SortedData::getFileteredBeginEnd(int colIdx) {
+		if ( isPartitionNodeActive() ) {
+			// the column of the node is already filtered
+			const PartitionNode& node = _pPartitionOwner->_partitionNodes[_activePartitionNode];
+			_filteredBegin = _pPartitionOwner->_partitionColumns.begin() + 
+							 (size_t)colIdx * _pPartitionOwner->_partitionStride + node.begin;
+			_filteredEnd = _filteredBegin + node.columnSizes[colIdx];
+		}
+		else {
+			filterColumn( colIdx );
+			_filteredBegin = _filteredColumn.begin();
+			_filteredEnd = _filteredColumn.end();
+		}
+		return make_pair(_filteredBegin, _filteredEnd);
 	}
 	
 	// ------------------------------------------------------------------------
 	
 	pair<vpReverseIterator,vpReverseIterator> SortedData::getFileteredReverseBeginEnd(int colIdx) {
-		_filteredColumn.clear();
-		for( column::iterator it = _sortedData[colIdx].begin(); it != _sortedData[colIdx].end(); it ++ ) {
-		  if ( this->isUsedIndice( it->first ) && ( it->second == it->second ) ) {
-				int i = this->getOrderBasedOnRawIndex( it->first );
-				_filteredColumn.push_back( pair<int, FeatureReal>(i, it->second) );
+		getFileteredBeginEnd( colIdx );
+		return make_pair(vpReverseIterator(_filteredEnd), vpReverseIterator(_filteredBegin));
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	int SortedData::loadIndexView( const IndexView& view ) {
+		_activePartitionNode = -1;
+		return InputData::loadIndexView( view );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::clearIndexSet( void ) {
+		_activePartitionNode = -1;
+		InputData::clearIndexSet();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	InputData* SortedData::createView() {
+		SortedData* pView = new SortedData();
+		pView->initView( *this );
+		
+		// the columns stay in this object
+		pView->_sortedData = _sortedData;
+		pView->_pPartitionOwner = _pPartitionOwner;
+		
+		return pView;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	bool SortedData::initPartition() {
+		clearPartition();
+		
+		if ( _pData->getDataRep() != DR_DENSE )
+			return false;
+		
+		const int numAttributes = this->getNumAttributes();
+		const int numUsed = this->getNumExamples();
+		
+		// the root: the examples in use, and their filtered columns
+		PartitionNode root;
+		root.begin = 0;
+		root.size = numUsed;
+		root.columnSizes.resize( numAttributes );
+		
+		_partitionStride = numUsed;
+		_partitionIndices.resize( numUsed );
+		for ( int i = 0; i < numUsed; ++i )
+			_partitionIndices[i] = this->getRawIndex(i);
+		
+		_partitionColumns.resize( (size_t)numAttributes * numUsed );
+		for ( int j = 0; j < numAttributes; ++j ) {
+			filterColumn( j );
+			copy( _filteredColumn.begin(), _filteredColumn.end(), 
+				  _partitionColumns.begin() + (size_t)j * _partitionStride );
+			root.columnSizes[j] = (int)_filteredColumn.size();
+		}
+		
+		_partitionNodes.push_back( root );
+		_activePartitionNode = 0;
+		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::splitPartitionNode( int nodeIdx, const vector<char>& sides, int& leftIdx, int& rightIdx ) {
+		const int begin = _partitionNodes[nodeIdx].begin;
+		const int size = _partitionNodes[nodeIdx].size;
+		const int numAttributes = (int)_partitionNodes[nodeIdx].columnSizes.size();
+		
+		// the order of each example in its child
+		_partitionRanks.resize( size );
+		int numLeft = 0, numRight = 0;
+		for ( int i = 0; i < size; ++i ) {
+			if ( sides[i] < 0 )
+				_partitionRanks[i] = numLeft++;
+			else if ( sides[i] > 0 )
+				_partitionRanks[i] = numRight++;
+			else
+				_partitionRanks[i] = -1;
+		}
+		
+		PartitionNode left, right;
+		left.begin = begin;
+		left.size = numLeft;
+		left.columnSizes.resize( numAttributes );
+		right.begin = begin + numLeft;
+		right.size = numRight;
+		right.columnSizes.resize( numAttributes );
+		
+		// the raw indices: the left ones are moved to the front in place
+		// (they never overtake the current position), the right ones follow
+		vector<int> rightIndices;
+		rightIndices.reserve( numRight );
+		int* pIndices = &_partitionIndices[begin];
+		int numMoved = 0;
+		for ( int i = 0; i < size; ++i ) {
+			if ( sides[i] < 0 )
+				pIndices[numMoved++] = pIndices[i];
+			else if ( sides[i] > 0 )
+				rightIndices.push_back( pIndices[i] );
+		}
+		copy( rightIndices.begin(), rightIndices.end(), pIndices + numLeft );
+		
+		// the columns, in the same way
+		for ( int j = 0; j < numAttributes; ++j ) {
+			vpIterator colBegin = _partitionColumns.begin() + (size_t)j * _partitionStride + begin;
+			vpIterator colEnd = colBegin + _partitionNodes[nodeIdx].columnSizes[j];
+			
+			_partitionBuffer.clear();
+			vpIterator leftIt = colBegin;
+			for ( vpIterator it = colBegin; it != colEnd; ++it ) {
+				const int i = it->first;
+				if ( sides[i] < 0 ) {
+					leftIt->first = _partitionRanks[i];
+					leftIt->second = it->second;
+					++leftIt;
+				}
+				else if ( sides[i] > 0 )
+					_partitionBuffer.push_back( pair<int, FeatureReal>(_partitionRanks[i], it->second) );
 			}
+			copy( _partitionBuffer.begin(), _partitionBuffer.end(), colBegin + numLeft );
+			
+			left.columnSizes[j] = (int)( leftIt - colBegin );
+			right.columnSizes[j] = (int)_partitionBuffer.size();
 		}
-		return make_pair(_filteredColumn.rbegin(),_filteredColumn.rend());
+		
+		// the node is overwritten by its children
+		_partitionNodes[nodeIdx].size = -1;
+		if ( _activePartitionNode == nodeIdx )
+			_activePartitionNode = -1;
+		
+		leftIdx = (int)_partitionNodes.size();
+		_partitionNodes.push_back( left );
+		rightIdx = (int)_partitionNodes.size();
+		_partitionNodes.push_back( right );
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::loadPartitionNode( int nodeIdx ) {
+		const PartitionNode& node = _pPartitionOwner->_partitionNodes[nodeIdx];
+		const vector<int>& indices = _pPartitionOwner->_partitionIndices;
+		
+		IndexView view;
+		for ( int i = node.begin; i < node.begin + node.size; ++i )
+			view.addRawIndex( indices[i], _pData->getLabels( indices[i] ) );
+		
+		InputData::loadIndexView( view );
+		_activePartitionNode = nodeIdx;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void SortedData::clearPartition() {
+		_partitionNodes.clear();
+		vector<int>().swap( _partitionIndices );
+		column().swap( _partitionColumns );
+		column().swap( _partitionBuffer );
+		_partitionStride = 0;
+		_activePartitionNode = -1;
 	}
 	
 	
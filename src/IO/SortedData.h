@@ -39,8 +39,10 @@
 #define __SORTED_DATA_H
 
 #include "IO/InputData.h"
+#include "IO/MappedFile.h"
 
 #include <vector>
+#include <string>
 #include <utility> // for pair
 
 using namespace std;
@@ -63,16 +65,32 @@ namespace MultiBoost {
 	 * \see StumpLearner::createInputData()
 	 * \date 21/11/2005
 	 */
-	class SortedData : public InputData
+	class SortedData : public InputData, public ExampleListener
 	{
 	public:
 		
+		/**
+		 * The constructor. It does noting but initializing some variables.
+		 * \date 19/10/2026
+		 */
+		SortedData() : _dataHash(0), _numValueColumns(-1), _pSharedValues(NULL), _numSharedRows(0), _partitionStride(0), _activePartitionNode(-1), _pPartitionOwner(this)
+		{ _filteredBegin = _filteredEnd = _filteredColumn.end(); }
+		
 		/**
 		 * The destructor. Must be declared (virtual) for the proper destruction of 
 		 * the object.
 		 */
 		virtual ~SortedData() {}
 		
+		/**
+		 * Get the options of the data. With --shareddata the sorted columns and the
+		 * values of the training data are shared with the other processes that work
+		 * on the same data.
+		 * \param args The arguments given by the command line.
+		 * \date 18/10/2026
+		 */
+		virtual void initOptions(const nor_utils::Args& args);
+		
 		/**
 		 * Overloading of the load function to support sorting.
 		 * \param fileName The name of the file to be loaded.
@@ -81,9 +99,25 @@ namespace MultiBoost {
 		 * \see InputData::load()
 		 * \date 21/11/2005
 		 * \todo Erase the original memory once sorted?
+		 * \remark With --shareddata the columns are mapped from the file published by the
+		 * first process that sorted the same data file, and published if there is no such 
+		 * file. The values of dense data are shared in the same file: if it exists, they are
+		 * compared with the shared ones and dropped while the data file is read, otherwise
+		 * they are moved into a single matrix, which is published. Only the labels and the
+		 * weights stay private.
 		 */
 		virtual void load(const string& fileName, eInputType inputType = IT_TRAIN, int verboseLevel = 1);
 		
+		/**
+		 * Move the values of a dense example into _valueStorage, or drop them if they
+		 * are the ones of the shared file, while the training file is read with --shareddata.
+		 * \param rawIdx The raw index of the example.
+		 * \param example The example.
+		 * \see ExampleListener
+		 * \date 19/10/2026
+		 */
+		virtual void exampleRead( int rawIdx, Example& example );
+		
 		/**
 		 * Check whether a feature/attribute is empty.(This can happen using sparse data representation.)
 		 * \param idx the index of the attribute
@@ -101,7 +135,7 @@ namespace MultiBoost {
 		 * \date 01/07/2011		 
 		 */		
 		virtual bool isFilteredAttributeEmpty() {
-			return _filteredColumn.empty();
+			return _filteredBegin == _filteredEnd;
 		}
 
 		/**
@@ -111,7 +145,7 @@ namespace MultiBoost {
 		 * \date 01/07/2011		 
 		 */				
 		virtual bool isFilteredAttributeHasOneValue() {
-			return ( _filteredColumn[0].second == _filteredColumn[_filteredColumn.size()-1].second );
+			return ( _filteredBegin->second == (_filteredEnd - 1)->second );
 		}
 		
 		
@@ -133,8 +167,100 @@ namespace MultiBoost {
 		 */								
 		
 		virtual pair<vpReverseIterator,vpReverseIterator> getFileteredReverseBeginEnd(int colIdx);
+		
+		/**
+		 * Overloading of InputData::loadIndexView: the node of the partition in use,
+		 * if any, is dropped.
+		 * \see InputData::loadIndexView()
+		 * \date 19/10/2026
+		 */
+		virtual int loadIndexView( const IndexView& view );
+		
+		/**
+		 * Overloading of InputData::clearIndexSet: the node of the partition in use,
+		 * if any, is dropped.
+		 * \date 19/10/2026
+		 */
+		virtual void clearIndexSet( void );
+		
+		/**
+		 * Create a view of the data (see InputData::createView). The view shares the sorted
+		 * columns and the partition of this object: it can load the nodes of the partition
+		 * with loadPartitionNode(), but it cannot split them.
+		 * \date 19/10/2026
+		 */
+		virtual InputData* createView();
+		
+		/**
+		 * Start a partition of the examples in use, for the growth of a tree. The examples
+		 * of each node are a contiguous range of a single index array, and the filtered
+		 * columns of each node are contiguous ranges of a single copy of the columns, so
+		 * that the columns of a node are not filtered again (see loadPartitionNode()).
+		 * The root node (index 0) holds the examples in use.
+		 * \return False if the data cannot be partitioned (only dense data can).
+		 * \see TreeLearner
+		 * \date 19/10/2026
+		 */
+		bool initPartition();
+		
+		/**
+		 * Split a node of the partition in two. The examples and the columns of the node
+		 * are split by stable partitions: the children keep the order of the raw indices
+		 * and of the values, so their columns are exactly the ones a filtering would give.
+		 * The cost is linear in the size of the node.
+		 * \param nodeIdx The index of the node.
+		 * \param sides The side of each example of the node, in the order of the node 
+		 * (the order of the examples in use after loadPartitionNode()): negative for the 
+		 * left child, positive for the right child and zero for none of them.
+		 * \param leftIdx The index of the left child (returned).
+		 * \param rightIdx The index of the right child (returned).
+		 * \date 19/10/2026
+		 */
+		void splitPartitionNode( int nodeIdx, const vector<char>& sides, int& leftIdx, int& rightIdx );
+		
+		/**
+		 * Use the examples of a node of the partition. Until the subset in use changes,
+		 * getFileteredBeginEnd() returns the columns of the node without filtering.
+		 * \param nodeIdx The index of the node.
+		 * \date 19/10/2026
+		 */
+		void loadPartitionNode( int nodeIdx );
+		
+		/**
+		 * Get the number of examples of a node of the partition.
+		 * \param nodeIdx The index of the node.
+		 * \date 19/10/2026
+		 */
+		int getPartitionNodeSize( int nodeIdx ) const { return _pPartitionOwner->_partitionNodes[nodeIdx].size; }
+		
+		/**
+		 * Free the partition. The subset in use is not changed.
+		 * \date 19/10/2026
+		 */
+		void clearPartition();
+		
 	protected:
 		
+		/**
+		 * Fill _filteredColumn with the examples in use of a column, sorted by value.
+		 * When a small subset of a dense dataset is in use, the values of the subset
+		 * are sorted directly instead of scanning the whole sorted column.
+		 * \param colIdx The column index
+		 * \date 18/10/2026
+		 */
+		void filterColumn(int colIdx);
+		
+		/**
+		 * Orders the (index, value) pairs by value, and by index for equal values.
+		 * \date 18/10/2026
+		 */
+		struct lessValueThenIndex
+		{
+			bool operator()(const pair<int, FeatureReal>& a, const pair<int, FeatureReal>& b) const
+			{ return a.second < b.second || ( a.second == b.second && a.first < b.first ); }
+		};
+		
+		
 		/**
 		 * A column of the data.
 		 * The pair represents the index of the example and the value of the column.
@@ -146,9 +272,142 @@ namespace MultiBoost {
 		 */
 		typedef vector< pair<int, FeatureReal> > column;
 		
-		vector<column>    _sortedData; //!< the sorted data.
+		/**
+		 * A sorted column of the data: a range of (example index, value) pairs
+		 * which lies either in _columnStorage or in the shared file.
+		 * \date 18/10/2026
+		 */
+		class SortedColumn
+		{
+		public:
+			typedef const pair<int, FeatureReal>* const_iterator;
+			
+			SortedColumn() : _begin(NULL), _end(NULL) {}
+			SortedColumn(const_iterator begin, const_iterator end) : _begin(begin), _end(end) {}
+			
+			const_iterator begin() const { return _begin; }
+			const_iterator end() const { return _end; }
+			size_t size() const { return _end - _begin; }
+			bool empty() const { return _begin == _end; }
+			
+		private:
+			const_iterator _begin, _end;
+		};
+		
+		/**
+		 * Sort the columns into _columnStorage.
+		 * \date 18/10/2026
+		 */
+		void sortColumns();
+		
+		/**
+		 * Give the values moved into _valueStorage to the raw data, or move them back
+		 * into the examples if they do not form a matrix of the dense data.
+		 * \date 19/10/2026
+		 */
+		void useValueStorage();
+		
+		/**
+		 * Move the rows of _valueStorage back into the examples and stop moving the values.
+		 * \date 19/10/2026
+		 */
+		void restoreValueStorage();
+		
+		/**
+		 * The name of the shared file of the sorted columns. It contains a hash of
+		 * the identity of the data file (device, inode, size and modification time), 
+		 * so that it is known before the data is read.
+		 * \param fileName The name of the data file.
+		 * \return An empty string if the data file cannot be found.
+		 * \date 18/10/2026
+		 */
+		string getSharedColumnsName(const string& fileName);
+		
+		/**
+		 * Compute _dataHash, the hash of the values of the raw data.
+		 * \date 19/10/2026
+		 */
+		void computeDataHash();
+		
+		/**
+		 * Map a shared file and check its layout. If it has the values of the examples,
+		 * they are compared with the ones read (see exampleRead()).
+		 * \param sharedName The name of the shared file.
+		 * \return False if the file does not exist or is not a shared file.
+		 * \date 19/10/2026
+		 */
+		bool openSharedColumns(const string& sharedName);
+		
+		/**
+		 * Use the sorted columns of the open shared file, and its values if it has them.
+		 * \return False if the file does not match the data, it is then closed.
+		 * \date 18/10/2026
+		 */
+		bool attachSharedColumns();
+		
+		/**
+		 * Close the shared file. The rows of values which were dropped because they
+		 * were in the file are copied into _valueStorage.
+		 * \param numDroppedRows The number of rows dropped.
+		 * \date 19/10/2026
+		 */
+		void detachSharedColumns( int numDroppedRows );
+		
+		/**
+		 * Write the sorted columns, and the values of the raw data if they are in 
+		 * _valueStorage, into a shared file.
+		 * \param sharedName The name of the shared file.
+		 * \return False if the file cannot be written.
+		 * \date 18/10/2026
+		 */
+		bool publishSharedColumns(const string& sharedName);
+		
+		vector<SortedColumn>    _sortedData; //!< the sorted data.
+		
+		column			_columnStorage; //!< the sorted columns one after the other, unless they are shared.
+		MappedFile		_sharedColumns; //!< the shared file of the sorted columns.
+		string			_sharedDataDir; //!< the directory of the shared files (--shareddata).
+		unsigned long long	_dataHash; //!< the hash of the values of the data.
+		
+		vector<FeatureReal>	_valueStorage; //!< the values of the examples row after row, while they are not shared.
+		int				_numValueColumns; //!< the size of the rows of _valueStorage, 0 if the values are not moved, -1 before the first row.
+		const FeatureReal*	_pSharedValues; //!< the values in the open shared file, if it has them.
+		int				_numSharedRows; //!< the number of rows of _pSharedValues.
 		
 		column _filteredColumn; //!< the sorted filtered data
+		vpIterator _filteredBegin, _filteredEnd; //!< the last filtered column, in _filteredColumn or in _partitionColumns
+		
+		/**
+		 * A node of the partition (see initPartition()): the range of its examples in 
+		 * _partitionIndices, and the number of (non missing) values of each column.
+		 * The values of column j are at j * _partitionStride + begin in _partitionColumns.
+		 * \date 19/10/2026
+		 */
+		struct PartitionNode
+		{
+			int			begin; //!< The first example of the node in _partitionIndices.
+			int			size; //!< The number of examples of the node.
+			vector<int>	columnSizes; //!< The number of values of each column.
+		};
+		
+		/**
+		 * True if the examples in use are the ones of the node _activePartitionNode.
+		 * \date 19/10/2026
+		 */
+		bool isPartitionNodeActive() 
+		{ 
+			return _activePartitionNode >= 0 && 
+				   _pPartitionOwner->_partitionNodes[_activePartitionNode].size == this->getNumExamples(); 
+		}
+		
+		vector<PartitionNode>	_partitionNodes; //!< The nodes of the partition.
+		vector<int>				_partitionIndices; //!< The raw indices of the examples, node by node.
+		column					_partitionColumns; //!< The filtered columns, node by node. The indices are in the order of the node.
+		int						_partitionStride; //!< The size of a column in _partitionColumns.
+		int						_activePartitionNode; //!< The node in use, -1 if none.
+		SortedData*				_pPartitionOwner; //!< The object that holds the partition: this one, or the viewed data.
+		vector<int>				_partitionRanks; //!< Scratch: the order of the examples of a node in its child.
+		column					_partitionBuffer; //!< Scratch: the right part of a column being split.
 		
 	};
 	
@@ -133,6 +133,10 @@ namespace MultiBoost {
 			}
 			
 			currExample.addBinaryLabel(classIdx);
+			
+			// the values can be moved elsewhere before the next example is read
+			if ( _pListener )
+				_pListener->exampleRead( static_cast<int>(i), currExample );
 		}
 		
 		if ( i != examples.size() )
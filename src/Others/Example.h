@@ -79,21 +79,12 @@ enum eLabelRep
 
 struct Label
 {
-#ifdef NOTIWEIGHT
-   Label() : weight(1) {}   
-#else
-   Label() : weight(1), initialWeight(1) {}
-#endif
-
    // note: for LR_MULTI_DENSE idx is the same value as the actual index in the vector
    int      idx; 
-   AlphaReal   weight;
-
-#ifndef NOTIWEIGHT
-   AlphaReal   initialWeight;
-#endif
+   char   y; // +1/-1 for the moment (next to idx to save the padding)
 
-   char   y; // +1/-1 for the moment
+   // the weights are kept by the example (see Example::getWeights()) or, with
+   // --compactlabels, by the LabelMatrix
 
    bool operator== (const int idx) const
    { return this->idx == idx; }
@@ -121,8 +112,22 @@ public:
 
    //////////////////////////////////////////////////////////////////////////
 
-   //inline const vector< pair<int, AlphaReal> >& getWeights() const { return _weights; }
-   //inline       vector< pair<int, AlphaReal> >& getWeights()       { return _weights; }
+   /**
+   * The weights of the labels, in the same order as getLabels(). Empty if the
+   * weights are not initialized yet (they are then all 1), or if they are owned
+   * by the LabelMatrix of the data (option --compactlabels).
+   */
+   inline const vector<AlphaReal>& getWeights() const { return _weights; }
+   inline       vector<AlphaReal>& getWeights()       { return _weights; }
+
+#ifndef NOTIWEIGHT
+   /**
+   * The initial weights of the labels, needed to calculate the weighted errors.
+   * Same layout as getWeights().
+   */
+   inline const vector<AlphaReal>& getInitialWeights() const { return _initialWeights; }
+   inline       vector<AlphaReal>& getInitialWeights()       { return _initialWeights; }
+#endif
 
    //////////////////////////////////////////////////////////////////////////
    inline void addBinaryLabel(int labelIdx)
@@ -187,7 +192,7 @@ private:
 
    /**
    * The labels (indexes and +1/-1) of the example, which contains the index of the
-   * label and the weight.
+   * label and the weight (stored in _weights).
    * i.e.
    * Single label: where the first class is true:
    * { <0,0.223,+1>, <1,0.113,-1> } 
@@ -200,6 +205,11 @@ private:
    */
    vector<Label>  _labels; //!< The labels (index) of the example.
 
+   vector<AlphaReal> _weights; //!< The weights of the labels.
+#ifndef NOTIWEIGHT
+   vector<AlphaReal> _initialWeights; //!< The initial weights of the labels.
+#endif
+
    vector<FeatureReal> _values; //!< The values of the example.
 
    /**
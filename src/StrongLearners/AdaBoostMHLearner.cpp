@@ -47,6 +47,7 @@
 #include "StrongLearners/AdaBoostMHLearner.h"
 
 #include "Classifiers/AdaBoostMHClassifier.h"
+#include "Utils/ClassHierarchy.h"
 
 namespace MultiBoost {
 
@@ -130,6 +131,10 @@ namespace MultiBoost {
 		if ( args.hasArgument("weights") ) {
 			args.getValue("weights", 0, _weightFile );
 		}
+
+		// --hierarchytrain <filename>
+		if ( args.hasArgument("hierarchytrain") )
+			args.getValue("hierarchytrain", 0, _hierarchyFileName );
 	}
 
 	// -----------------------------------------------------------------------------------
@@ -164,6 +169,10 @@ namespace MultiBoost {
 			pTestData->load(_testFileName, IT_TEST, _verbose);
 		}
 
+		// the weights outside the relevant subtrees stay zero
+		if ( !_hierarchyFileName.empty() )
+			restrictToHierarchy(pTrainingData);
+
 		// The output information object
 		OutputInfo* pOutInfo = NULL;
 
@@ -443,9 +452,10 @@ namespace MultiBoost {
 					hx = pWeakHypothesis->classify(pData, i, lIt->idx );
 					_hy[i][lIt->idx] += alpha * hx; // alpha * h_l(x_i)				
 
-					lIt->weight *= exp( -alpha * hx * lIt->y );
+					const AlphaReal w = pData->getLabelWeight(i, *lIt) * exp( -alpha * hx * lIt->y );
+					pData->setLabelWeight(i, *lIt, w);
 
-					Z += lIt->weight;
+					Z += w;
 					
 					
 				}
@@ -458,7 +468,7 @@ namespace MultiBoost {
 
 				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 				{
-					lIt->weight /= Z;
+					pData->setLabelWeight(i, *lIt, pData->getLabelWeight(i, *lIt) / Z);
 				}
 			}
 
@@ -466,6 +476,8 @@ namespace MultiBoost {
 			//if ( i % 1000 == 0 ) cout << i <<endl;
 		}
 		
+		pData->syncCompactLabels();
+
 		//upload the margins 
 		pOutInfo->setTable( pData, _hy );
 		return 0;
@@ -481,6 +493,10 @@ namespace MultiBoost {
 
 		const AlphaReal alpha = pWeakHypothesis->getAlpha();
 
+		// the compact store owns the weights, it is updated directly
+		if ( pData->hasCompactLabels() )
+			return updateCompactWeights(pData, pWeakHypothesis);
+
 		AlphaReal Z = 0; // The normalization factor
 
 		_hy.resize(numExamples);
@@ -488,8 +504,10 @@ namespace MultiBoost {
 			_hy[i].resize(numClasses);
 			fill( _hy[i].begin(), _hy[i].end(), 0.0 );
 		}
+
 		// recompute weights
 		// computing the normalization factor Z
+		const bool hasBatchVotes = pWeakHypothesis->classifyBatch(pData, _batchVotes);
 
 		// for each example
 		for (int i = 0; i < numExamples; ++i)
@@ -499,9 +517,10 @@ namespace MultiBoost {
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
-				_hy[i][lIt->idx] = pWeakHypothesis->classify(pData, i, lIt->idx) * // h_l(x_i)
+				_hy[i][lIt->idx] = ( hasBatchVotes ? _batchVotes[i * numClasses + lIt->idx] :
+									 pWeakHypothesis->classify(pData, i, lIt->idx) ) * // h_l(x_i)
 					lIt->y;
-				Z += lIt->weight * // w
+				Z += pData->getLabelWeight(i, *lIt) * // w
 					exp( 
 					-alpha * _hy[i][lIt->idx] // -alpha * h_l(x_i) * y_i
 				);
@@ -527,13 +546,13 @@ namespace MultiBoost {
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
-				AlphaReal w = lIt->weight;
+				AlphaReal w = pData->getLabelWeight(i, *lIt);
 				gamma += w * _hy[i][lIt->idx];
 				//if ( gamma < -0.8 ) {
 				//	cout << gamma << endl;
 				//}
 				// The new weight is  w * exp( -alpha * h(x_i) * y_i ) / Z
-				lIt->weight = w * exp( -alpha * _hy[i][lIt->idx] ) / Z;
+				pData->setLabelWeight(i, *lIt, w * exp( -alpha * _hy[i][lIt->idx] ) / Z);
 			}
 		}
 
@@ -576,6 +595,64 @@ namespace MultiBoost {
 	
 	// -------------------------------------------------------------------------
 
+	AlphaReal AdaBoostMHLearner::updateCompactWeights(InputData* pData, BaseLearner* pWeakHypothesis)
+	{
+		const int numExamples = pData->getNumExamples();
+		const AlphaReal alpha = pWeakHypothesis->getAlpha();
+
+		const int numClasses = pData->getNumClasses();
+		LabelMatrix& labelMatrix = pData->getLabelMatrix();
+
+		AlphaReal Z = 0; // The normalization factor
+		AlphaReal gamma = 0;
+
+		// store the weights w * exp( -alpha * h(x_i) * y_i ) before the normalization,
+		// so that h(x_i) * y_i does not have to be kept until Z is known
+		// (and compute the edge at the same time)
+		const bool hasBatchVotes = pWeakHypothesis->classifyBatch(pData, _batchVotes);
+		for (int i = 0; i < numExamples; ++i)
+		{
+			const int row = pData->getRawIndex(i);
+			const int rowEnd = labelMatrix.getRowEnd(row);
+
+			for (int pos = labelMatrix.getRowBegin(row); pos < rowEnd; ++pos)
+			{
+				const int l = labelMatrix.getClassIdx(row, pos);
+				const AlphaReal hy = ( hasBatchVotes ? _batchVotes[i * numClasses + l] :
+									   pWeakHypothesis->classify(pData, i, l) ) * labelMatrix.getY(pos); // h_l(x_i) * y_i
+				const AlphaReal w = labelMatrix.getWeight(pos);
+				gamma += w * hy;
+
+				const AlphaReal newWeight = w * exp( -alpha * hy );
+				labelMatrix.setWeight(pos, newWeight);
+				Z += newWeight;
+			}
+		}
+
+		// Now do the normalization
+		for (int i = 0; i < numExamples; ++i)
+		{
+			const int row = pData->getRawIndex(i);
+			const int rowEnd = labelMatrix.getRowEnd(row);
+			AlphaReal negWeight = 0;
+
+			for (int pos = labelMatrix.getRowBegin(row); pos < rowEnd; ++pos)
+			{
+				const AlphaReal newWeight = labelMatrix.getWeight(pos) / Z;
+				labelMatrix.setWeight(pos, newWeight);
+
+				if ( labelMatrix.getY(pos) < 0 )
+					negWeight += newWeight;
+			}
+
+			labelMatrix.setNegativeWeight(row, negWeight);
+		}
+
+		return gamma;
+	}
+
+	// -------------------------------------------------------------------------
+
 	int AdaBoostMHLearner::resumeWeakLearners(InputData* pTrainingData)
 	{
 		if (_resumeShypFileName.empty())
@@ -748,7 +825,7 @@ namespace MultiBoost {
 
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
-				outStream << lIt->weight << ";";
+				outStream << pData->getLabelWeight(i, *lIt) << ";";
 			}
 			outStream << endl;
 		}
@@ -757,6 +834,113 @@ namespace MultiBoost {
 		outStream.close();
 	}
 
+	// -------------------------------------------------------------------------
+
+	void AdaBoostMHLearner::restrictToHierarchy( InputData* pData )
+	{
+		ClassHierarchy hierarchy;
+		hierarchy.load( _hierarchyFileName );
+
+		map<int,int> categoryToClass;
+		hierarchy.getClassIndices( pData->getClassMap(), categoryToClass );
+
+		if ( categoryToClass.empty() )
+		{
+			cerr << "ERROR: none of the classes is a category of the hierarchy <"
+				<< _hierarchyFileName << ">!" << endl;
+			exit(1);
+		}
+
+		const int numExamples = pData->getNumExamples();
+		const int numClasses = pData->getNumClasses();
+
+		vector<int> classToCategory(numClasses, -1);
+		for (map<int,int>::iterator cIt = categoryToClass.begin(); cIt != categoryToClass.end(); ++cIt)
+			classToCategory[cIt->second] = cIt->first;
+
+		// the classes compared below each node, listed once per node
+		map< InnerNode*, vector<int> > siblingClasses;
+		vector<InnerNode*> classChildren;
+
+		// every example is compared with the classes of the first level
+		vector<int> topClasses;
+		hierarchy.getClassChildren( hierarchy.getRoot(), categoryToClass, classChildren );
+		for (int c = 0; c < (int)classChildren.size(); ++c)
+			topClasses.push_back( categoryToClass[ classChildren[c]->getCategory() ] );
+
+		vector<char> isRelevant(numClasses);
+		AlphaReal sumWeights = 0;
+
+		for (int i = 0; i < numExamples; ++i)
+		{
+			vector<Label>& labels = pData->getLabels(i);
+			vector<Label>::iterator lIt;
+
+			fill( isRelevant.begin(), isRelevant.end(), 0 );
+			for (int c = 0; c < (int)topClasses.size(); ++c)
+				isRelevant[ topClasses[c] ] = 1;
+
+			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+			{
+				if ( lIt->y < 0 ) continue;
+
+				// a class outside the hierarchy is always relevant
+				isRelevant[lIt->idx] = 1;
+				if ( classToCategory[lIt->idx] < 0 ) continue;
+
+				// the classes met on the way down to the positive class
+				InnerNode* pNode = hierarchy.convertCategroyToInnerNode( classToCategory[lIt->idx] );
+				while ( !pNode->getParent()->isRoot() )
+				{
+					pNode = pNode->getParent();
+
+					map< InnerNode*, vector<int> >::iterator sIt = siblingClasses.find(pNode);
+					if ( sIt == siblingClasses.end() )
+					{
+						hierarchy.getClassChildren( pNode, categoryToClass, classChildren );
+
+						vector<int>& siblings = siblingClasses[pNode];
+						for (int c = 0; c < (int)classChildren.size(); ++c)
+							siblings.push_back( categoryToClass[ classChildren[c]->getCategory() ] );
+						sIt = siblingClasses.find(pNode);
+					}
+
+					for (int c = 0; c < (int)sIt->second.size(); ++c)
+						isRelevant[ sIt->second[c] ] = 1;
+				}
+			}
+
+			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+			{
+				if ( !isRelevant[lIt->idx] )
+					pData->setLabelWeight(i, *lIt, 0);
+				sumWeights += pData->getLabelWeight(i, *lIt);
+			}
+		}
+
+		if ( sumWeights <= 0 )
+		{
+			cerr << "ERROR: no label of the training data is in the hierarchy <" 
+				<< _hierarchyFileName << ">!" << endl;
+			exit(1);
+		}
+
+		// renormalize the weights
+		for (int i = 0; i < numExamples; ++i)
+		{
+			vector<Label>& labels = pData->getLabels(i);
+			vector<Label>::iterator lIt;
+
+			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
+				pData->setLabelWeight(i, *lIt, pData->getLabelWeight(i, *lIt) / sumWeights);
+		}
+
+		pData->syncCompactLabels();
+
+		if (_verbose > 0)
+			cout << "Training restricted to the hierarchy <" << _hierarchyFileName << ">." << endl;
+	}
+
 	// -------------------------------------------------------------------------
 	void AdaBoostMHLearner::run( const nor_utils::Args& args, InputData* pTrainingData, const string baseLearnerName, const int numIterations, vector<BaseLearner*>& foundHypotheses )
 	{
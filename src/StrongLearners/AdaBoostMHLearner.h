@@ -72,7 +72,7 @@ namespace MultiBoost {
          */
         AdaBoostMHLearner()
         : _numIterations(0), _maxTime(-1), _theta(0), _verbose(1), _smallVal(1E-10),
-        _resumeShypFileName(""), _outputInfoFile(""), _weightFile(""), _withConstantLearner(false), _fastResumeProcess(true) {}
+        _resumeShypFileName(""), _outputInfoFile(""), _weightFile(""), _hierarchyFileName(""), _withConstantLearner(false), _fastResumeProcess(true) {}
         
         /**
          * Start the learning process.
@@ -177,6 +177,18 @@ namespace MultiBoost {
          */
         void printOutWeights( InputData* pData );
         
+        /**
+         * Restrict the training to the relevant subtrees of the class hierarchy
+         * (option --hierarchytrain). The relevant labels of an example are the ancestors
+         * of its positive classes and their siblings, that is the classes the top-down
+         * classification compares it with. The weights of the other labels are set to
+         * zero, so they are not changed by the re-weightings.
+         * \param pData The training data.
+         * \see AdaBoostMHClassifier::computeHierarchicalVotes
+         * \date 19/10/2026
+         */
+        void restrictToHierarchy( InputData* pData );
+        
     protected:
         
         /**
@@ -234,6 +246,7 @@ namespace MultiBoost {
         string  _resumeShypFileName;
         string  _outputInfoFile; //!< The filename of the step-by-step information file that will be updated
         string  _weightFile; // !< The filename of the weights, if this is empty then it won't output the weights
+        string  _hierarchyFileName; //!< The class hierarchy of --hierarchytrain, empty if the training is not restricted
         
         bool _withConstantLearner; //!< Check or not constant learner in each iteration 
         bool _fastResumeProcess; //Fast resume process (true), it will calculate only the error rate of the last iteration.
@@ -245,11 +258,26 @@ namespace MultiBoost {
          */
         AdaBoostMHLearner& operator=( const AdaBoostMHLearner& ) {return *this;}
         
+        /**
+         * The same as updateWeights(InputData*, BaseLearner*), but it runs on
+         * the compact label store of the data (option --compactlabels), which owns
+         * the weights: the ones of the Label objects are not updated. It does not use _hy.
+         * \see LabelMatrix
+         */
+        AlphaReal updateCompactWeights(InputData* pData, BaseLearner* pWeakHypothesis);
+        
         /**
          * A temporary variable for h(x)*y. Helps saving time during re-weighting.
          */
         vector< vector<AlphaReal> > _hy;
         
+        /**
+         * The outputs h_l(x_i) of the weak hypotheses that classify all the examples
+         * at once, at [i*numClasses + l].
+         * \see BaseLearner::classifyBatch
+         */
+        vector<AlphaReal> _batchVotes;
+        
     };
     
 } // end of namespace MultiBoost
@@ -373,7 +373,7 @@ namespace MultiBoost {
 		const int numExamples = pData->getNumExamples();
 		const int numClasses = pData->getNumClasses();		
 
-		set<int> indexSet;
+		IndexView indexView;
 		if (size<numExamples) // not whole dataset will be used
 		{
 			//random permutation
@@ -397,10 +397,11 @@ namespace MultiBoost {
 			int maxIter = 5 * size;
 			int wholeIter = 0;
 			
-			indexSet.clear();
+			// the whole dataset is in use, so the order indices are the raw indices
+			vector<bool> isSelected( numExamples, false );
 			while (1)
 			{
-				if ( size<=indexSet.size() ) break;
+				if ( size<=indexView.size() ) break;
 				if ( wholeIter > 5 ) rejection = false;
 				if ( numExamples <= iter ) {
 					iter = 0;
@@ -426,42 +427,51 @@ namespace MultiBoost {
 					AlphaReal randNum = (AlphaReal)rand() / RAND_MAX;
 					
 					
-					if ( randNum < qValue ) indexSet.insert( randPerm[iter] );
+					if ( randNum < qValue && ! isSelected[ randPerm[iter] ] ) {
+						isSelected[ randPerm[iter] ] = true;
+						indexView.addExample( pData, randPerm[iter] );
+					}
 				}
 				else
 				{
-					indexSet.insert( randPerm[iter] );
+					if ( ! isSelected[ randPerm[iter] ] ) {
+						isSelected[ randPerm[iter] ] = true;
+						indexView.addExample( pData, randPerm[iter] );
+					}
 				}
 				iter++;
 			}
+			indexView.sort( pData );
+			
 			// normalize the weights of the labels
-			set<int>::iterator sIt;
+			vector<int>::const_iterator sIt;
 			AlphaReal sum = 0.0;
 			// for each example are in use
-			for ( sIt = indexSet.begin(); sIt != indexSet.end(); sIt++ )
+			for ( sIt = indexView.getRawIndices().begin(); sIt != indexView.getRawIndices().end(); sIt++ )
 			{
 				vector<Label>& labels = pData->getLabels(*sIt);
 				vector<Label>::iterator lIt;
 				
 				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 				{
-					lIt->weight = 1 /( 1+exp( _margins[ *sIt ][lIt->idx] ) );
-					sum += lIt->weight;
+					const AlphaReal w = 1 /( 1+exp( _margins[ *sIt ][lIt->idx] ) );
+					pData->setLabelWeight( *sIt, *lIt, w );
+					sum += w;
 				}
 			}
 			
-			for ( sIt = indexSet.begin(); sIt != indexSet.end(); sIt++ )
+			for ( sIt = indexView.getRawIndices().begin(); sIt != indexView.getRawIndices().end(); sIt++ )
 			{
 				vector<Label>& labels = pData->getLabels(*sIt);
 				vector<Label>::iterator lIt;
 				
 				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 				{
-					lIt->weight /= sum;
+					pData->setLabelWeight( *sIt, *lIt, pData->getLabelWeight( *sIt, *lIt ) / sum );
 				}
 			}
 			
-			pData->loadIndexSet( indexSet );
+			pData->loadIndexView( indexView );
 		} else { // the whole dataset is used
 			AlphaReal sum = 0.0;
 			// for each example are in use
@@ -472,8 +482,9 @@ namespace MultiBoost {
 				
 				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 				{
-					lIt->weight = 1 /( 1+exp( _margins[ i ][lIt->idx] ) );
-					sum += lIt->weight;
+					const AlphaReal w = 1 /( 1+exp( _margins[ i ][lIt->idx] ) );
+					pData->setLabelWeight( i, *lIt, w );
+					sum += w;
 				}
 			}
 			
@@ -484,11 +495,13 @@ namespace MultiBoost {
 				
 				for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 				{
-					lIt->weight /= sum;
+					pData->setLabelWeight( i, *lIt, pData->getLabelWeight( i, *lIt ) / sum );
 				}
 			}			
 		}
 
+		pData->syncCompactLabels();
+
 		/*
 		sum = 0.0;
 		for ( int i=0; i < pData->getNumExamples(); i++ )
@@ -520,9 +533,11 @@ namespace MultiBoost {
 			
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
-				lIt->weight = 1 /( 1+exp( _margins[ i ][lIt->idx] ) );
+				pData->setLabelWeight( i, *lIt, 1 /( 1+exp( _margins[ i ][lIt->idx] ) ) );
 			}						
 		}
+
+		pData->syncCompactLabels();
 	}
 	
 	
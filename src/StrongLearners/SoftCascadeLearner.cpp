@@ -311,22 +311,23 @@ namespace MultiBoost {
     
     // -----------------------------------------------------------------------------------
     
-    int SoftCascadeLearner::filterDataset(InputData* pData, const vector<AlphaReal> & posteriors, AlphaReal threshold, set<int> & indices)
+    int SoftCascadeLearner::filterDataset(InputData* pData, const vector<AlphaReal> & posteriors, AlphaReal threshold, IndexView & indices)
     {
         const int numExamples = pData->getNumExamples();
-        pData->getIndexSet(indices);
+        indices.clear();
         
         int numExamplesRemoved = 0;
         
         for (int i = 0; i < numExamples; ++i) {
-            int j = pData->getRawIndex(i);
             if (posteriors[i] < threshold) {
-                indices.erase(j);
                 ++numExamplesRemoved;
             }
+            else {
+                indices.addExample(pData, i);
+            }
         }
         
-        pData->loadIndexSet( indices );
+        pData->loadIndexView( indices );
         int leftNegatives = pData->getNumExamplesPerClass(1-_positiveLabelIndex);
         cout << "[+] Dataset filtering :\t removed : " << numExamplesRemoved << endl;
         cout << "\t\t\t left negatives : " << leftNegatives << endl;
@@ -335,14 +336,15 @@ namespace MultiBoost {
     
     // -----------------------------------------------------------------------------------
 
-    void SoftCascadeLearner::bootstrapTrainingSet(InputData * pData, InputData * pBootData, set<int> & indices)
+    void SoftCascadeLearner::bootstrapTrainingSet(InputData * pData, InputData * pBootData, IndexView & indices)
     {
-        set<int> bootIndices;
-        pBootData->getIndexSet(bootIndices);
-        
         const int numBootEx = pBootData->getNumExamples();
+        vector<bool> isBootstrapped(numBootEx, false);
         const int K = (int)ceil(_bootstrapRate * numBootEx);
         
+        // the examples are copied with their values
+        pBootData->restoreValues();
+        
         cout << "[+] K = " << K << endl;
         
         int exampleCounter = 0;
@@ -366,13 +368,17 @@ namespace MultiBoost {
                 assert(getInstanceLabel(pBootData, i, _positiveLabelIndex) == 0);
                 ++exampleCounter;
                 pData->addExample(pBootData->getExample(i));
-                bootIndices.erase(pBootData->getRawIndex(i));
+                isBootstrapped[i] = true;
             }
         }
         
-        pData->getIndexSet(indices);
+        pData->getIndexView(indices);
         
-        pBootData->loadIndexSet(bootIndices);
+        IndexView bootIndices;
+        for (int i = 0; i < numBootEx; ++i) {
+            if ( ! isBootstrapped[i] ) bootIndices.addExample(pBootData, i);
+        }
+        pBootData->loadIndexView(bootIndices);
         
         //cout << "[+] number of bootstrapped examples : " << exampleCounter << endl;
         // no more bootstrapping
@@ -472,8 +478,6 @@ namespace MultiBoost {
             dynamic_cast<PosteriorsOutput*>( pTestPosteriorsOut->getOutputInfoObject("pos") )->addClassIndex(_positiveLabelIndex );            
         }
         
-        const int numExamples = pTrainingData->getNumExamples();
-
 		vector<BaseLearner*> inWeakHypotheses;
         
         if (_fullRun) {            
@@ -506,10 +510,8 @@ namespace MultiBoost {
         _rejectionThresholds.resize(0);
         
         
-        set<int> trainingIndices;
-        for (int i = 0; i < numExamples; i++) {
-            trainingIndices.insert(pTrainingData->getRawIndex(i) );
-        }
+        IndexView trainingIndices;
+        pTrainingData->getIndexView(trainingIndices);
         
         // init v_t (see the paper)
         initializeRejectionDistributionVector(_numIterations, rejectionDistributionVector);
@@ -625,6 +627,14 @@ namespace MultiBoost {
 		// write the footer of the strong hypothesis file
 		ss.writeFooter();
 
+		// the output files are written in the background, wait for them
+		if (pOutInfo)
+			delete pOutInfo;
+		if (pTrainPosteriorsOut)
+			delete pTrainPosteriorsOut;
+		if (pTestPosteriorsOut)
+			delete pTestPosteriorsOut;
+
 		// Free the two input data objects
 		if (pTrainingData)
 			delete pTrainingData;
@@ -754,8 +764,8 @@ namespace MultiBoost {
 
     void SoftCascadeLearner::outputCascadePerf(InputData* pData, vector< vector< AlphaReal> > & outScores)
     {
-        set<int> indices ;
-        pData->getIndexSet(indices);
+        IndexView indices ;
+        pData->getIndexView(indices);
         pData->clearIndexSet();
         
         const int numExamples = pData->getNumExamples();
@@ -842,7 +852,7 @@ namespace MultiBoost {
         _output << setw(_sepWidth) << tpRate;
         _output << setw(_sepWidth) << eval;
         
-        pData->loadIndexSet(indices);
+        pData->loadIndexView(indices);
     }
     
 	// -------------------------------------------------------------------------
@@ -51,6 +51,7 @@ namespace MultiBoost {
     
     class BaseLearner;
     class InputData;
+    class IndexView;
     class Serialization;
     class OutputInfo;
     
@@ -178,10 +179,10 @@ namespace MultiBoost {
         
         /**
          * Filter the examples that are below the rejection threshold stage-wise.
-         * \param indices The set of example indices that are still used for training
+         * \param indices The view of the examples that are still used for training
          * \date 01/07/2011
          */
-        int filterDataset(InputData* pData, const vector<AlphaReal> & posteriors, AlphaReal threshold, set<int> & indices);
+        int filterDataset(InputData* pData, const vector<AlphaReal> & posteriors, AlphaReal threshold, IndexView & indices);
         
         /**
          * Output the header to the output file 
@@ -203,7 +204,7 @@ namespace MultiBoost {
          * \param pBootData A training set containing only negatives from which false positives are sampled
          * \date 01/07/2011
          */
-        void bootstrapTrainingSet(InputData * pData, InputData * pBootData, set<int> & indices);
+        void bootstrapTrainingSet(InputData * pData, InputData * pBootData, IndexView & indices);
 
         /**
 		 * Print output information if option --outputinfo is specified.
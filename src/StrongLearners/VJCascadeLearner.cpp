@@ -41,6 +41,8 @@
 #include "Defaults.h" // for defaultLearner
 #include "IO/OutputInfo.h"
 #include "IO/InputData.h"
+#include "IO/SortedData.h"
+#include "IO/IndexView.h"
 #include "IO/Serialization.h" // to save the found strong hypothesis
 
 #include "WeakLearners/BaseLearner.h"
@@ -224,14 +226,22 @@ namespace MultiBoost {
 			}					
 		}
 		
-		set<int> trainingIndices;
-		set<int> validationIndices;
+		// the examples still active in the cascade
+		IndexView trainingIndices;
+		IndexView validationIndices;
+		IndexView testIndices;
+		vector<AlphaReal> stagePosteriors;
+		
+		// with sorted data, the columns of the active training examples are gathered once per stage
+		SortedData* pSortedTrainingData = dynamic_cast<SortedData*>(pTrainingData);
 		
 		///////////////////////////////////////////////////////////////////////
 		// Starting the Cascad main loop
 		///////////////////////////////////////////////////////////////////////		
 		for(int stagei=0; stagei < _numIterations; ++stagei )
 		{
+			if (pSortedTrainingData) pSortedTrainingData->initPartition();
+			
 			resetWeights(pTrainingData);
 			vector<AlphaReal> validPosteriors(0);
 			vector<AlphaReal> trainPosteriors(0);
@@ -367,10 +377,8 @@ namespace MultiBoost {
 			
 			
 			
-			// calculate the overall cascade performance
-			pValidationData->clearIndexSet();
-			validPosteriors.resize(pValidationData->getNumExamples());
-			calculatePosteriors( pValidationData, _foundHypotheses[stagei], validPosteriors, _positiveLabelIndex );
+			// calculate the overall cascade performance: the posteriors of the
+			// active examples were updated along with the stage
 			
 			// this update the current forecast stored in activeValidationInstances
 			forecastOverAllCascade( pValidationData, validPosteriors, activeValidationInstances, tunedThreshold );
@@ -386,15 +394,25 @@ namespace MultiBoost {
 			{
 				//_output << "test" << endl;
 				outputCascadeResult( pTestData, activeTestInstances );			
+				
+				// only the test examples not classified yet go on
+				testIndices.clear();
+				for( int i=0; i < pTestData->getNumExamples(); ++i )
+				{
+					if ( activeTestInstances[pTestData->getRawIndex(i)].active )
+						testIndices.addExample( pTestData, i );
+				}
+				pTestData->loadIndexView( testIndices );
 			}
 									
 
-			// filter training dataset data set and generate negative set for the next iteration
+			// filter training dataset data set and generate negative set for the next iteration:
+			// the active examples are the positives and the negatives that pass the stage,
+			// including the ones rejected by the earlier stages
+			if (pSortedTrainingData) pSortedTrainingData->clearPartition();
 			trainingIndices.clear();
-			pTrainingData->clearIndexSet();
-			//cout << pTrainingData->getNumExamples() << endl << flush;
-			trainPosteriors.resize(pTrainingData->getNumExamples());
-			calculatePosteriors( pTrainingData, _foundHypotheses[stagei], trainPosteriors, _positiveLabelIndex );
+			getStagePosteriors( pTrainingData, _foundHypotheses[stagei], trainPosteriors, stagePosteriors );
+			trainPosteriors.swap( stagePosteriors );
 
 			int trainPosNum=0;
 			int trainNegNum=0;
@@ -402,57 +420,58 @@ namespace MultiBoost {
 			int validNegNum=0;
 
 			
-			for( int i=0; i < activeTrainInstances.size(); ++i )
+			for( int i=0; i < pTrainingData->getNumExamples(); ++i )
 			{	
+				const int rawIdx = pTrainingData->getRawIndex(i);
 				vector<Label>& labels = pTrainingData->getLabels(i);				
 				if (labels[_positiveLabelIndex].y>0)
 				{	
 					trainPosNum++;
-					activeTrainInstances[i].active=true; // all positive
-					trainingIndices.insert(i);
+					activeTrainInstances[rawIdx].active=true; // all positive
+					trainingIndices.addExample(pTrainingData, i);
 				} else {
 					if ( trainPosteriors[i] >= tunedThreshold )
 					{
 						trainNegNum++;
-						activeTrainInstances[i].active=true; // all false positive
-						trainingIndices.insert(i);
+						activeTrainInstances[rawIdx].active=true; // all false positive
+						trainingIndices.addExample(pTrainingData, i);
 					} else {
-						activeTrainInstances[i].active=false;
+						activeTrainInstances[rawIdx].active=false;
 					}
 				}
 			}		
 			// filter training			
-			pTrainingData->loadIndexSet( trainingIndices );
+			pTrainingData->loadIndexView( trainingIndices );
 
 			// output the actual training dataset size
 			_output << (trainPosNum+trainNegNum) << "\t" << trainPosNum << "\t" << trainNegNum << "\t";
 			
 				validationIndices.clear();
-				pValidationData->clearIndexSet();
-				validPosteriors.resize(pValidationData->getNumExamples());
-				//calculatePosteriors( pValidationData, _foundHypotheses[stagei], validPosteriors );
-				for( int i=0; i < activeValidationInstances.size(); ++i )
+				getStagePosteriors( pValidationData, _foundHypotheses[stagei], validPosteriors, stagePosteriors );
+				validPosteriors.swap( stagePosteriors );
+				for( int i=0; i < pValidationData->getNumExamples(); ++i )
 				{	
+					const int rawIdx = pValidationData->getRawIndex(i);
 					vector<Label>& labels = pValidationData->getLabels(i);				
 					if (labels[_positiveLabelIndex].y>0)
 					{	
 						validPosNum++;
-						activeValidationInstances[i].active=true; // all positive
-						validationIndices.insert(i);
+						activeValidationInstances[rawIdx].active=true; // all positive
+						validationIndices.addExample(pValidationData, i);
 					} else {
 						if ( validPosteriors[i] >= tunedThreshold )
 						{
 							validNegNum++;
-							activeValidationInstances[i].active=true; // all false positive
-							validationIndices.insert(i);
+							activeValidationInstances[rawIdx].active=true; // all false positive
+							validationIndices.addExample(pValidationData, i);
 						} else {
-							activeValidationInstances[i].active=false; // all false positive
+							activeValidationInstances[rawIdx].active=false; // all false positive
 						}
 					}
 				}	
 				
 				// filter validation dataset
-				pValidationData->loadIndexSet(validationIndices);
+				pValidationData->loadIndexView(validationIndices);
 				
 				
 				//cout << "The size of validation dataset: " << (validPosNum+validNegNum) << "(" << trainPosNum << "/" << validNegNum << ")" << endl;				
@@ -564,6 +583,47 @@ namespace MultiBoost {
 	}
 	
 	
+	// -------------------------------------------------------------------------
+	void VJCascadeLearner::getStagePosteriors( InputData* pData, vector<BaseLearner*>& weakHypotheses, 
+											   const vector<AlphaReal>& activePosteriors, vector<AlphaReal>& posteriors )
+	{
+		// the examples in use are the active ones
+		vector<int> activeRawIndices( pData->getNumExamples() );
+		for (int i = 0; i < (int)activeRawIndices.size(); ++i)
+			activeRawIndices[i] = pData->getRawIndex(i);
+		
+		pData->clearIndexSet();
+		const int numRawExamples = pData->getNumExamples();
+		
+		vector<char> isActive( numRawExamples, 0 );
+		posteriors.resize( numRawExamples );
+		for (int i = 0; i < (int)activeRawIndices.size(); ++i)
+		{
+			isActive[ activeRawIndices[i] ] = 1;
+			posteriors[ activeRawIndices[i] ] = activePosteriors[i];
+		}
+		
+		// the other ones were rejected by an earlier stage
+		IndexView rejectedIndices;
+		for (int i = 0; i < numRawExamples; ++i)
+		{
+			if ( !isActive[i] )
+				rejectedIndices.addExample( pData, i );
+		}
+		
+		if ( rejectedIndices.empty() )
+			return;
+		
+		vector<AlphaReal> rejectedPosteriors;
+		pData->loadIndexView( rejectedIndices );
+		calculatePosteriors( pData, weakHypotheses, rejectedPosteriors, _positiveLabelIndex );
+		
+		for (int i = 0; i < pData->getNumExamples(); ++i)
+			posteriors[ pData->getRawIndex(i) ] = rejectedPosteriors[i];
+		
+		pData->clearIndexSet();
+	}
+	
 	// -------------------------------------------------------------------------							 
 	void VJCascadeLearner::classify(const nor_utils::Args& args)
 	{
@@ -652,7 +712,7 @@ namespace MultiBoost {
 			{
 				_hy[i][lIt->idx] = pWeakHypothesis->classify(pData, i, lIt->idx) * // h_l(x_i)
 			    lIt->y;
-				Z += lIt->weight * // w
+				Z += pData->getLabelWeight(i, *lIt) * // w
 				exp( 
 					-alpha * _hy[i][lIt->idx] // -alpha * h_l(x_i) * y_i
 					);
@@ -678,15 +738,16 @@ namespace MultiBoost {
 			
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
-				AlphaReal w = lIt->weight;
+				AlphaReal w = pData->getLabelWeight(i, *lIt);
 				gamma += w * _hy[i][lIt->idx];
 				//if ( gamma < -0.8 ) {
 				//	cout << gamma << endl;
 				//}
 				// The new weight is  w * exp( -alpha * h(x_i) * y_i ) / Z
-				lIt->weight = w * exp( -alpha * _hy[i][lIt->idx] ) / Z;
+				pData->setLabelWeight(i, *lIt, w * exp( -alpha * _hy[i][lIt->idx] ) / Z);
 			}
 		}				
+		pData->syncCompactLabels();
 		return gamma;
 	}
 	
@@ -729,7 +790,7 @@ namespace MultiBoost {
 			
 			// first find the sum of the weights
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				sumWeight += lIt->weight;
+				sumWeight += pData->getLabelWeight(i, *lIt);
 		}
 		
 		cout << "Check weights: " << pData->getNumExamples() << endl << flush;
@@ -786,8 +847,8 @@ namespace MultiBoost {
 			// first find the sum of the weights								
 			for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
 			{
-				if (lIt->y>0) lIt->weight = wi[lIt->idx];
-				else lIt->weight=wic[lIt->idx];
+				if (lIt->y>0) pData->setLabelWeight(i, *lIt, wi[lIt->idx]);
+				else pData->setLabelWeight(i, *lIt, wic[lIt->idx]);
 			}
 			
 		}
@@ -800,7 +861,7 @@ namespace MultiBoost {
 			
 			// first find the sum of the weights
 			for (lIt = labels.begin(); lIt != labels.end(); ++lIt )
-				sumWeight += lIt->weight;
+				sumWeight += pData->getLabelWeight(i, *lIt);
 		}
 		
 		if ( !nor_utils::is_zero(sumWeight-1.0, 1E-6 ) )
@@ -810,7 +871,7 @@ namespace MultiBoost {
 			//exit(1);
 		}
 		
-		
+		pData->syncCompactLabels();
 	}
 	// -------------------------------------------------------------------------
 	void VJCascadeLearner::getTPRandFPR( InputData* pData, vector<AlphaReal>& posteriors, AlphaReal& TPR, AlphaReal& FPR, const FeatureReal threshold )
@@ -872,19 +933,9 @@ namespace MultiBoost {
 		
 		
 		
-		fill(numPerClasses.begin(),numPerClasses.end(), 0 );
-		for (int i = 0; i < numOfExamples; ++i)
-		{
-			vector<Label>& labels = pData->getLabels(i);
-			vector<Label>::iterator lIt;
-			
-			for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
-			{
-				if ( lIt->y > 0 )
-					numPerClasses[lIt->idx]++;
-			}
-			
-		}			
+		// the class counts of the examples in use
+		for (int i = 0; i < (int)numPerClasses.size(); ++i)
+			numPerClasses[i] = pData->getNumExamplesPerClass(i);
 		
 		
 		
@@ -938,6 +989,7 @@ namespace MultiBoost {
 			sumalphas += _foundHypotheses[stagei-1][i]->getAlpha();
 		}
 				
+		// the examples in use are the active ones, the cascade data is indexed by raw index
 		for(int i=0; i<numOfExamples; ++i )
 		{
 			vector<Label>& labels = pData->getLabels(i);
@@ -946,22 +998,23 @@ namespace MultiBoost {
 			else 
 				isPos =false;			
 			
+			CascadeOutputInformation& currentData = cascadeData[pData->getRawIndex(i)];
 			
 			//cout << posteriors[i] << " ";
-			if (cascadeData[i].active) // active: it is not classified yet
+			if (currentData.active) // active: it is not classified yet
 			{
-				cascadeData[i].score=((posteriors[i]/sumalphas)+1)/2;
+				currentData.score=((posteriors[i]/sumalphas)+1)/2;
                 
 				// Here starts the new method
-                cascadeData[i].score += stagei - 1 ;
+                currentData.score += stagei - 1 ;
                 
                 if (posteriors[i]<threshold)
 				{
-					cascadeData[i].active = false; // classified
-					cascadeData[i].forecast=0;
+					currentData.active = false; // classified
+					currentData.forecast=0;
 				} else {
-					cascadeData[i].active = true; // continue
-					cascadeData[i].forecast=1;					
+					currentData.active = true; // continue
+					currentData.forecast=1;					
 				}
                 
                 
@@ -979,8 +1032,8 @@ namespace MultiBoost {
 //					cascadeData[i].score/=((2.0*stagei)+1);
 //				}
 				
-				cascadeData[i].classifiedInStage=stagei;
-				cascadeData[i].numberOfUsedClassifier=sumOfWeakClassifier;								
+				currentData.classifiedInStage=stagei;
+				currentData.numberOfUsedClassifier=sumOfWeakClassifier;								
 			}			
 		}				
 	}
@@ -1022,6 +1075,11 @@ namespace MultiBoost {
 	// -------------------------------------------------------------------------
 	void VJCascadeLearner::outputCascadeResult( InputData* pData, vector<CascadeOutputInformation>& cascadeData )
 	{
+		// the results are computed on the whole dataset
+		IndexView indices;
+		pData->getIndexView(indices);
+		pData->clearIndexSet();
+		
 		const int numOfExamples = pData->getNumExamples();
 		
 		int P=0,N=0;
@@ -1128,6 +1186,7 @@ namespace MultiBoost {
 			
 		}
 		
+		pData->loadIndexView(indices);
 	}
 	
 	// -------------------------------------------------------------------------
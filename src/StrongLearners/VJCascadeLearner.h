@@ -173,6 +173,21 @@ namespace MultiBoost {
 		 */
 		static void updatePosteriors( InputData* pData, BaseLearner* weakhyps, vector<AlphaReal>& posteriors, int positiveLabelIndex );
 		
+		/**
+		 * Get the posteriors of a stage on all the examples of the data, so that the
+		 * negatives rejected by the earlier stages are admitted again if they pass it.
+		 * Only the examples that are not in use are scored: the posteriors of the ones
+		 * in use (the active ones) were updated along with the stage. The data is left
+		 * without subset.
+		 * \params pData The pointer to the data.
+		 * \params weakHypotheses The weak hypotheses of the stage.
+		 * \params activePosteriors The posteriors of the examples in use, in their order.
+		 * \params posteriors The posteriors of all the examples, by raw index (returned).
+		 * \date 19/10/2026
+		 */
+		void getStagePosteriors( InputData* pData, vector<BaseLearner*>& weakHypotheses, 
+								 const vector<AlphaReal>& activePosteriors, vector<AlphaReal>& posteriors );
+		
 		/**
 		 * Get the needed parameters (for the strong learner) from the argumens.
 		 * \param args The arguments provided by the command line.
@@ -219,6 +234,14 @@ namespace MultiBoost {
 		virtual FeatureReal getThresholdBasedOnTPR( InputData* pData, vector<AlphaReal>& posteriors, const AlphaReal expectedTPR, AlphaReal& TPR, AlphaReal& FPR );
 		
 		
+		/**
+		 * Updates the forecast of the examples in use which are still active after a stage.
+		 * \params pData The pointer to the data. Only the active examples are expected to be in use.
+		 * \params posteriors The posteriors of the stage, in the order of the examples in use.
+		 * \params cascadeData The forecasts, indexed by the raw index of the examples.
+		 * \params threshold The threshold of the stage.
+		 * \date 19/10/2026
+		 */
 		virtual void forecastOverAllCascade( InputData* pData, vector<AlphaReal>& posteriors, vector<CascadeOutputInformation>& cascadeData, const FeatureReal threshold );
 		
 		
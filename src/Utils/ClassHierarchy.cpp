@@ -131,6 +131,42 @@ void ClassHierarchy::getCategorySet( set<int>& categories ){
 
 //--------------------------------------------------------------------
 
+void ClassHierarchy::getClassIndices( const NameMap& classMap, map<int,int>& categoryToClass ) {
+	categoryToClass.clear();
+
+	for( int l=0; l < classMap.getNumNames(); l++ ) {
+		istringstream ss( classMap.getNameFromIdx( l ) );
+		int category;
+		char rest;
+
+		// only the names which are exactly a category
+		if ( !( ss >> category ) || ( ss >> rest ) ) continue;
+		if ( existCategory( category ) ) categoryToClass[ category ] = l;
+	}
+}
+
+//--------------------------------------------------------------------
+
+void ClassHierarchy::getClassChildren( InnerNode* node, const map<int,int>& categoryToClass, vector<InnerNode*>& classChildren ) {
+	classChildren.clear();
+
+	vector<InnerNode*> toVisit;
+	for( int i=node->getNumOfChildren()-1; i >= 0; i-- ) toVisit.push_back( node->getithChild( i ) );
+
+	while ( ! toVisit.empty() ) {
+		InnerNode* currNode = toVisit.back();
+		toVisit.pop_back();
+
+		if ( categoryToClass.find( currNode->getCategory() ) != categoryToClass.end() ) {
+			classChildren.push_back( currNode );
+		} else {
+			for( int i=currNode->getNumOfChildren()-1; i >= 0; i-- ) toVisit.push_back( currNode->getithChild( i ) );
+		}
+	}
+}
+
+//--------------------------------------------------------------------
+
 void ClassHierarchy::keepTheChildrenOfACategory( int category ) {
 	//a memoria leakekt ki kell majd kuszobolni
 	InnerNode* currNode = convertCategroyToInnerNode( category );
@@ -175,9 +211,9 @@ void ClassHierarchy::updateMemberVariables( void ){
 void ClassHierarchy::collectCategories( InnerNode* currNode, NameMap& namemap, map<int,int>& idxtocat, map<int,int>& cattoidx, map<int,InnerNode*>& cattonode ) {
 	int curridx = idxtocat.size();
 
-	idxtocat.insert( make_pair<int,int>( curridx, currNode->getCategory() ) );
-	cattoidx.insert( make_pair<int,int>( currNode->getCategory(), curridx ) );
-	cattonode.insert( make_pair<int,InnerNode*>( currNode->getCategory(), currNode ) );
+	idxtocat.insert( make_pair( curridx, currNode->getCategory() ) );
+	cattoidx.insert( make_pair( currNode->getCategory(), curridx ) );
+	cattonode.insert( make_pair( currNode->getCategory(), currNode ) );
 
 	string s = nor_utils::int2string( currNode->getCategory() );
 	namemap.addName( s );
@@ -255,12 +291,12 @@ void ClassHierarchy::addHierarchPath( vector<int>& hierarchyPath ){
 			}
 			addChild( currNode, *it );
 			
-			_mapIdxToCategory.insert( make_pair<int,int>( _numOfCategories, *it ) );
-			_mapCategoryToIdx.insert( make_pair<int,int>( *it, _numOfCategories ) );
+			_mapIdxToCategory.insert( make_pair( _numOfCategories, *it ) );
+			_mapCategoryToIdx.insert( make_pair( *it, _numOfCategories ) );
 			_numOfCategories++;
 
 			currNode = currNode->getChild( *it );
-			_mapCategoryToNode.insert( make_pair<int,InnerNode*>( *it, currNode ) );
+			_mapCategoryToNode.insert( make_pair( *it, currNode ) );
 
 			string s;
 			stringstream ss;
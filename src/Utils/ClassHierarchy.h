@@ -258,6 +258,16 @@ public:
 
 	void getCategorySet( set<int>& categories );
 
+	InnerNode* getRoot( void ) { return &_root; }
+
+	// maps the categories to the indices of the classes named after them, the categories
+	// which are not classes of the data are left out
+	void getClassIndices( const NameMap& classMap, map<int,int>& categoryToClass );
+
+	// the children of the node that are classes; the children which are not classes
+	// are replaced by their own class children
+	void getClassChildren( InnerNode* node, const map<int,int>& categoryToClass, vector<InnerNode*>& classChildren );
+
 	int getNumOfCategories( void ) { return _numOfCategories; }
 protected:
 	void updateMemberVariables( void );
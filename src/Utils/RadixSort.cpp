@@ -0,0 +1,109 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+
+#include "RadixSort.h"
+
+#include <cstring> // for memcpy
+
+namespace nor_utils {
+	
+	// ------------------------------------------------------------------------------
+	
+	static const int RADIX_BITS = 11;
+	static const int RADIX_SIZE = 1 << RADIX_BITS;
+	static const int RADIX_PASSES = 3;
+	
+	/**
+	 * Map a float to an unsigned key with the same order: the sign bit is
+	 * flipped for the positive values, all the bits for the negative ones.
+	 */
+	static inline unsigned int floatKey( float value )
+	{
+		unsigned int bits;
+		memcpy( &bits, &value, sizeof(bits) );
+		return bits ^ ( (bits >> 31) ? 0xFFFFFFFFu : 0x80000000u );
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	void PairRadixSorter::sort( vector< pair<int, float> >& data )
+	{
+		const size_t numElements = data.size();
+		if (numElements < 2)
+			return;
+		
+		_buffer.resize( numElements );
+		_counts.assign( RADIX_PASSES * RADIX_SIZE, 0 );
+		
+		// the histograms of the three digits in a single pass
+		for (size_t i = 0; i < numElements; ++i)
+		{
+			const unsigned int key = floatKey( data[i].second );
+			for (int p = 0; p < RADIX_PASSES; ++p)
+				++_counts[ p * RADIX_SIZE + ( (key >> (p * RADIX_BITS)) & (RADIX_SIZE - 1) ) ];
+		}
+		
+		for (int p = 0; p < RADIX_PASSES; ++p)
+		{
+			unsigned int* counts = &_counts[p * RADIX_SIZE];
+			
+			// all the keys have the same digit: nothing to move
+			const unsigned int firstDigit = ( floatKey( data[0].second ) >> (p * RADIX_BITS) ) & (RADIX_SIZE - 1);
+			if ( counts[firstDigit] == numElements )
+				continue;
+			
+			// the counts become the starting positions
+			unsigned int sum = 0;
+			for (int d = 0; d < RADIX_SIZE; ++d)
+			{
+				const unsigned int count = counts[d];
+				counts[d] = sum;
+				sum += count;
+			}
+			
+			for (size_t i = 0; i < numElements; ++i)
+			{
+				const unsigned int digit = ( floatKey( data[i].second ) >> (p * RADIX_BITS) ) & (RADIX_SIZE - 1);
+				_buffer[ counts[digit]++ ] = data[i];
+			}
+			
+			data.swap( _buffer );
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+} // end of namespace nor_utils
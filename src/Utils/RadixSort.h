@@ -0,0 +1,101 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+
+/**
+ * \file RadixSort.h Radix sort of (index, value) pairs.
+ */
+
+#ifndef __RADIX_SORT_H
+#define __RADIX_SORT_H
+
+#include <vector>
+#include <utility> // for pair
+#include <algorithm> // for stable_sort
+
+#include "Utils/Utils.h" // for comparePair
+
+using namespace std;
+
+namespace nor_utils {
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * Sort (index, value) pairs by increasing value with a LSD radix sort. The
+	 * value is mapped to an unsigned key with the same order, and the pairs are
+	 * moved in three passes of 11 bits. The passes in which all the keys have
+	 * the same digit are skipped. The sort is stable.
+	 * The buffers are kept between the calls, so that sorting many vectors of
+	 * the same size (for instance the outputs of the Haar configurations) does 
+	 * not allocate memory.
+	 * \remark Only float values are radix sorted, double values fall back to a 
+	 * stable comparison sort.
+	 * \code
+	 * vector< pair<int, float> > v;
+	 * nor_utils::PairRadixSorter sorter;
+	 * sorter.sort(v);
+	 * \endcode
+	 * \date 18/10/2026
+	 */
+	class PairRadixSorter
+	{
+	public:
+		
+		/**
+		 * Sort the pairs by increasing value. Equal values keep their order.
+		 * \param data The pairs to sort. Its memory can be exchanged with the 
+		 * one of the internal buffer.
+		 * \date 18/10/2026
+		 */
+		void sort( vector< pair<int, float> >& data );
+		
+		/**
+		 * Sort the pairs by increasing value with a stable comparison sort.
+		 * \param data The pairs to sort.
+		 * \date 18/10/2026
+		 */
+		void sort( vector< pair<int, double> >& data )
+		{ stable_sort( data.begin(), data.end(), comparePair<2, int, double, less<double> >() ); }
+		
+	private:
+		vector< pair<int, float> >	_buffer; //!< The destination of the passes.
+		vector<unsigned int>		_counts; //!< The histograms of the digits.
+	};
+	
+} // end of namespace nor_utils
+
+#endif // __RADIX_SORT_H
@@ -41,6 +41,7 @@
 
 #include <string>
 #include <iterator>
+#include <iostream>
 
 using namespace std;
 
@@ -360,26 +360,27 @@ namespace nor_utils {
 		//[uni_pred, idx] = sort(uni_pred, 'descend');
 		sort( data.begin(), data.end(), nor_utils::comparePair<2, AlphaReal, AlphaReal, greater<AlphaReal> >() );
 		
+		return getSortedROC( data );
+	}
+	
+	// ----------------------------------------------------------------
+	
+	AlphaReal getSortedROC( const vector< pair< int, AlphaReal > > & data ) {
 		
-		vector< AlphaReal > uni_pred(data.size());
-		vector< AlphaReal >::iterator it;
+		vector< AlphaReal > uni_pred;
+		uni_pred.reserve(data.size() + 1);
 		
 		int posNum = 0;
 		int negNum = 0;
 		
+		// the scores are decreasing: the unique ones are the first of each group
 		for( size_t i = 0; i < data.size(); i++ ) {
-			uni_pred[i] = data[i].second;
+			if ( i == 0 || data[i].second != data[i-1].second )
+				uni_pred.push_back( data[i].second );
 			if ( data[i].first == 1 ) posNum++;
 			else negNum++;
 		}
 		
-		//copy( pred.begin(), pred.end(), uni_pred.begin() );
-		sort( uni_pred.begin(), uni_pred.end() );
-		it=unique_copy (uni_pred.begin(),uni_pred.end(),uni_pred.begin()); 
-		uni_pred.resize( it - uni_pred.begin() ); 
-		
-		reverse( uni_pred.begin(), uni_pred.end() );
-		
 		uni_pred.push_back( 0.0 );
 		int l = uni_pred.size();
 		
@@ -447,6 +447,15 @@ namespace nor_utils
 	
 	// ----------------------------------------------------------------	
 	AlphaReal getROC( vector< pair< int, AlphaReal > > & data );	
+	
+	/**
+	 * The same as getROC, for data already sorted by decreasing score (the order
+	 * of the tied scores does not matter).
+	 * \param data The (label, score) pairs, the label is 1 for the positives.
+	 * \see getROC
+	 * \date 19/10/2026
+	 */
+	AlphaReal getSortedROC( const vector< pair< int, AlphaReal > > & data );	
 	// -------------------------------------------------------------------------
 	
 } // end of namespace nor_utils
@@ -37,12 +37,79 @@
 
 #include <math.h>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
 using namespace std;
+using namespace tbb;
 
 namespace MultiBoost {
 	
 	
 	REGISTER_LEARNER(AdaLineLearner)		
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The body of the parallel computation of the inner products of the examples
+	 * of a mini-batch with the weights of the features.
+	 * \date 19/10/2026
+	 */
+	class AdaLineInnerProducts {
+	public:
+		AdaLineInnerProducts(InputData* pData, const int* pIndices, const vector<FeatureReal>& featuresWeight,
+							 vector<AlphaReal>& innerProducts)
+		: _pData(pData), _pIndices(pIndices), _pFeaturesWeight(&featuresWeight), _pInnerProducts(&innerProducts) {}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			const int numColumns = (int)_pFeaturesWeight->size();
+			for( int k = range.begin(); k != range.end(); ++k ) {
+				AlphaReal innerProduct = 0.0;
+				for (int j = 0; j < numColumns; ++j)
+					innerProduct += (*_pFeaturesWeight)[j] * _pData->getValue( _pIndices[k], j );
+				(*_pInnerProducts)[k] = innerProduct;
+			}
+		}
+		
+	private:
+		InputData*						_pData;
+		const int*						_pIndices;
+		const vector<FeatureReal>*		_pFeaturesWeight;
+		vector<AlphaReal>*				_pInnerProducts;
+	};
+	
+	// ------------------------------------------------------------------------------		
+	
+	/**
+	 * The body of the parallel computation of the gradient of the weights of the
+	 * features on a mini-batch: the gradient of column j is the dot product of
+	 * the column with the coefficients of the examples.
+	 * \date 19/10/2026
+	 */
+	class AdaLineColumnGradients {
+	public:
+		AdaLineColumnGradients(InputData* pData, const int* pIndices, const vector<AlphaReal>& coefficients,
+							   vector<AlphaReal>& deltaW)
+		: _pData(pData), _pIndices(pIndices), _pCoefficients(&coefficients), _pDeltaW(&deltaW) {}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			const int batchSize = (int)_pCoefficients->size();
+			for( int j = range.begin(); j != range.end(); ++j ) {
+				AlphaReal gradient = 0.0;
+				for (int k = 0; k < batchSize; ++k)
+					gradient += (*_pCoefficients)[k] * _pData->getValue( _pIndices[k], j );
+				(*_pDeltaW)[j] = gradient;
+			}
+		}
+		
+	private:
+		InputData*						_pData;
+		const int*						_pIndices;
+		const vector<AlphaReal>*		_pCoefficients;
+		vector<AlphaReal>*				_pDeltaW;
+	};
+	
 	// ------------------------------------------------------------------------------		
 	AlphaReal AdaLineLearner::run()
 	{
@@ -88,7 +155,7 @@ namespace MultiBoost {
 				if ((i>0)&&((i%_gammdivperiod)==0)) _gammaDivider += 1.0;
 				
 				int randomTrainingInstanceIdx = randomPermutation[i];
-				vector<Label> labels = _pTrainingData->getLabels(randomTrainingInstanceIdx);
+				const vector<Label>& labels = _pTrainingData->getLabels(randomTrainingInstanceIdx);
 				
 				FeatureReal	innerProduct = 0.0;				
 				for (int j = 0; j < numColumns; ++j)
@@ -99,10 +166,12 @@ namespace MultiBoost {
 				vector<AlphaReal> deltaV(numClasses, 0.0);
 				switch (_tFunction) {
 					case TF_EXPLOSS:
-						for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
+						for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
 						{
-							deltaV[it->idx] = it->weight * exp( - _v[it->idx] * it->y * innerProduct ) *
-							it->y * innerProduct;
+							const char y = _pTrainingData->getLabelY(randomTrainingInstanceIdx, *it);
+							const AlphaReal w = _pTrainingData->getLabelWeight(randomTrainingInstanceIdx, *it);
+							deltaV[it->idx] = w * exp( - _v[it->idx] * y * innerProduct ) *
+							y * innerProduct;
 						}							
 						break;
 					case TF_EDGE:
@@ -123,10 +192,12 @@ namespace MultiBoost {
 					
 					switch (_tFunction) {
 						case TF_EXPLOSS:
-							for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
+							for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
 							{
-								deltaW[j] += (it->weight * exp( - _v[it->idx] * it->y * innerProduct ) *
-											  val * _v[it->idx] * it->y );
+								const char y = _pTrainingData->getLabelY(randomTrainingInstanceIdx, *it);
+								const AlphaReal w = _pTrainingData->getLabelWeight(randomTrainingInstanceIdx, *it);
+								deltaW[j] += (w * exp( - _v[it->idx] * y * innerProduct ) *
+											  val * _v[it->idx] * y );
 							}							
 							break;
 						case TF_EDGE:
@@ -156,6 +227,71 @@ namespace MultiBoost {
 			
 		} else if (_gMethod == OPT_BGD )
 		{
+		} else if (_gMethod == OPT_MBGD )
+		{
+			if ( _tFunction != TF_EXPLOSS )
+			{
+				// has to be implemented
+				cout << "Edge optimization has not implemented yet!" << endl;
+				exit(-1);
+			}
+			
+			vector<int> randomPermutation(numExamples);
+			for (int i = 0; i < numExamples; ++i ) randomPermutation[i]=i;
+			random_shuffle( randomPermutation.begin(), randomPermutation.end() );			
+			
+			vector<AlphaReal> innerProducts;
+			vector<AlphaReal> coefficients;
+			vector<AlphaReal> deltaW(numColumns);
+			vector<AlphaReal> deltaV(numClasses);
+			
+			for (int gradi = 0; gradi < _maxIter; ++gradi)
+			{
+				for (int begin = 0; begin < numExamples; begin += _miniBatchSize)
+				{
+					const int batchSize = min( _miniBatchSize, numExamples - begin );
+					const int* pIndices = &randomPermutation[begin];
+					
+					innerProducts.resize(batchSize);
+					parallel_for( blocked_range<int>( 0, batchSize ), 
+								  AdaLineInnerProducts( _pTrainingData, pIndices, _featuresWeight, innerProducts ) );
+					
+					// the gradient of the weights of the features is a linear combination of the
+					// examples, with one coefficient per example
+					coefficients.resize(batchSize);
+					fill( deltaV.begin(), deltaV.end(), 0.0 );
+					for (int k = 0; k < batchSize; ++k)
+					{
+						const vector<Label>& labels = _pTrainingData->getLabels( pIndices[k] );
+						coefficients[k] = 0.0;
+						for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+						{
+							const char y = _pTrainingData->getLabelY(pIndices[k], *it);
+							const AlphaReal w = _pTrainingData->getLabelWeight(pIndices[k], *it);
+							const AlphaReal expLoss = w * exp( - _v[it->idx] * y * innerProducts[k] );
+							deltaV[it->idx] += expLoss * y * innerProducts[k];
+							coefficients[k] += expLoss * _v[it->idx] * y;
+						}
+					}
+					
+					parallel_for( blocked_range<int>( 0, numColumns, 64 ), 
+								  AdaLineColumnGradients( _pTrainingData, pIndices, coefficients, deltaW ) );
+					
+					// gradient step, the sum over the mini-batch is scaled to the whole training set
+					const AlphaReal gammaScaled = gammat * numExamples / batchSize;
+					for (int j = 0; j < numColumns; ++j)
+					{					
+						_featuresWeight[j] -= static_cast<FeatureReal>(gammaScaled * deltaW[j]);										
+					}
+					nor_utils::normalizeLengthOfVector( _featuresWeight );
+					
+					for (int j = 0; j < numClasses; ++j)
+					{
+						_v[j] -= static_cast<FeatureReal>(gammaScaled * deltaV[j]);										
+					}
+					nor_utils::normalizeLengthOfVector( _v );
+				}
+			}
 		} else {
 			cout << "Unknown optimization method!" << endl;
 			exit(-1);
@@ -170,10 +306,12 @@ namespace MultiBoost {
 		//_pTrainingData->clearIndexSet();
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) 
 		{
-			vector< Label> l = _pTrainingData->getLabels( i );
-			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
+			const vector<Label>& l = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator it = l.begin(); it != l.end(); it++ ) {
+				const char y = _pTrainingData->getLabelY(i, *it);
+				const AlphaReal w = _pTrainingData->getLabelWeight(i, *it);
 				AlphaReal result  = this->classify( _pTrainingData, i, it->idx );
-				result *= (it->y * it->weight);
+				result *= (y * w);
 				if ( result < 0 ) eps_min -= result;
 				if ( result > 0 ) eps_pls += result;
 			}
@@ -270,7 +408,7 @@ namespace MultiBoost {
 		{			
 			if ((_age>0)&&((_age%_gammdivperiod)==0)) _gammaDivider += 1.0;
 			
-			vector<Label> labels = _pTrainingData->getLabels(idx);
+			const vector<Label>& labels = _pTrainingData->getLabels(idx);
 			
 			AlphaReal	innerProduct = 0.0;				
 			for (int j = 0; j < numColumns; ++j)
@@ -281,10 +419,12 @@ namespace MultiBoost {
 			vector<AlphaReal> deltaV(numClasses, 0.0);
 			switch (_tFunction) {
 				case TF_EXPLOSS:
-					for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
+					for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
 					{
-						deltaV[it->idx] = it->weight * exp( - _v[it->idx] * it->y * innerProduct ) *
-						it->y * innerProduct;
+						const char y = _pTrainingData->getLabelY(idx, *it);
+						const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
+						deltaV[it->idx] = w * exp( - _v[it->idx] * y * innerProduct ) *
+						y * innerProduct;
 					}							
 					break;
 				case TF_EDGE:
@@ -303,10 +443,12 @@ namespace MultiBoost {
 				
 				switch (_tFunction) {
 					case TF_EXPLOSS:
-						for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
+						for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
 						{
-							deltaW[j] += (it->weight * exp( - _v[it->idx] * it->y * innerProduct ) *
-										  val * _v[it->idx] * it->y );
+							const char y = _pTrainingData->getLabelY(idx, *it);
+							const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
+							deltaW[j] += (w * exp( - _v[it->idx] * y * innerProduct ) *
+										  val * _v[it->idx] * y );
 						}							
 						break;
 					case TF_EDGE:
@@ -351,11 +493,13 @@ namespace MultiBoost {
 			innerProduct += _featuresWeight[jj] * _pTrainingData->getValue(idx, jj);
 		}
 		
-		vector<Label> labels = _pTrainingData->getLabels(idx);
-		for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
+		const vector<Label>& labels = _pTrainingData->getLabels(idx);
+		for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
 		{
+			const char y = _pTrainingData->getLabelY(idx, *it);
+			const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
 			AlphaReal delta = 0.0;
-			delta = it->weight * it->y * innerProduct * _v[it->idx];
+			delta = w * y * innerProduct * _v[it->idx];
 			
 			_edges[it->idx] += delta;
 			_sumEdges[it->idx] += (delta>0) ? delta : -delta;
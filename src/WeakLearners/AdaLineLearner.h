@@ -114,6 +114,8 @@ namespace MultiBoost {
 		
 		/**
 		 * Run the learner to build the classifier on the given data.
+		 * With the mini-batch gradient method (--gradmethod mbgd) the inner products
+		 * and the gradient of the feature weights of a batch are computed in parallel.
 		 * \param pData The pointer to the data.
 		 * \see BaseLearner::run
 		 * \date 21/05/2007
@@ -41,14 +41,60 @@
 
 #include "Bandits/Exp3G2.h"
 
+#include "WeakLearners/SparseColumnSearch.h"
+
 #include <limits> // for numeric_limits<>
 #include <sstream> // for _id
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 
 	//REGISTER_LEARNER_NAME(SingleStump, BanditSingleSparseStump)
 	REGISTER_LEARNER(BanditSingleSparseStump)
 
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	/**
+	 * The body of the parallel computation of the initial rewards of the arms. A 
+	 * SingleSparseStumpLearner is trained on each column, in a view of the training
+	 * data created for each range, and the reward is computed from its edge.
+	 * \date 19/10/2026
+	 */
+	class BanditSparseInitialValues {
+	public:
+		BanditSparseInitialValues(BanditSingleSparseStump* pLearner, vector<AlphaReal>& initialValues)
+		: _pLearner(pLearner), _pInitialValues(&initialValues),
+		  _pWeakHypothesisSource(BaseLearner::RegisteredLearners().getLearner("SingleSparseStumpLearner"))
+		{}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			InputData* pView = _pLearner->_pTrainingData->createView();
+			
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				SingleSparseStumpLearner* singleStump = dynamic_cast<SingleSparseStumpLearner*>( _pWeakHypothesisSource->create());
+				
+				singleStump->setTrainingData(pView);
+				singleStump->run( i );
+				AlphaReal edge = singleStump->getEdge();
+				(*_pInitialValues)[i] = _pLearner->getRewardFromEdge( (AlphaReal) edge );
+				
+				delete singleStump;
+			}
+			
+			delete pView;
+		}
+		
+	private:
+		BanditSingleSparseStump*	_pLearner;
+		vector<AlphaReal>*			_pInitialValues; //!< The reward of each column.
+		BaseLearner*				_pWeakHypothesisSource;
+	};
+
 		// ------------------------------------------------------------------------------
 
 		void BanditSingleSparseStump::init() {
@@ -62,26 +108,12 @@ namespace MultiBoost {
 				exit( -1 );
 			}
 
-			BaseLearner* pWeakHypothesisSource = 
-				BaseLearner::RegisteredLearners().getLearner("SingleSparseStumpLearner");
-
 			_banditAlgo->setArmNumber( numColumns );
 
 			vector<AlphaReal> initialValues( numColumns );
 
-			for( int i=0; i < numColumns; i++ )
-			{
-				SingleSparseStumpLearner* singleStump = dynamic_cast<SingleSparseStumpLearner*>( pWeakHypothesisSource->create());
-
-				singleStump->setTrainingData(_pTrainingData);
-				AlphaReal energy = singleStump->run( i );
-				AlphaReal edge = singleStump->getEdge();
-				AlphaReal reward = getRewardFromEdge( (AlphaReal) edge );
-
-				initialValues[i] = reward;
-
-				delete singleStump;
-			}
+			// the columns are independent: each one is learnt on its own view of the data
+			parallel_for( blocked_range<int>( 0, numColumns ), BanditSparseInitialValues( this, initialValues ) );
 
 			_banditAlgo->initialize( initialValues );
 
@@ -103,14 +135,7 @@ namespace MultiBoost {
 		// when theta=0.
 		setSmoothingVal( (AlphaReal) 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * (AlphaReal)0.01 );
 
-		vector<sRates> mu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-
-		FeatureReal tmpThreshold;
-		AlphaReal tmpAlpha;
-
 		AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
-		AlphaReal tmpEnergy;
 
 		StumpAlgorithmLSHTC<FeatureReal> sAlgo(numClasses);
 		sAlgo.initSearchLoop(_pTrainingData);
@@ -132,47 +157,27 @@ namespace MultiBoost {
 			cout << "error" << endl;
 		}
 
-		for( int i = 0; i < (int)_armsForPulling.size(); i++ ) {
-			//columnIndices[i] = p.second;			
+		// the arms are pulled in parallel, the selection below is sequential
+		vector<SparseColumnResult> results( _armsForPulling.size() );
+		SparseColumnSearch<BanditSingleSparseStump> search(this, _armsForPulling, sAlgo, halfTheta, &results);
+		parallel_reduce( blocked_range<int>( 0, (int)_armsForPulling.size() ), search );
 
+		for( int i = 0; i < (int)_armsForPulling.size(); i++ ) {
+			const SparseColumnResult& result = results[i];
 
-			const pair<vpReverseIterator,vpReverseIterator> dataBeginEnd = 
-				static_cast<SortedData*>(_pTrainingData)->getFileteredReverseBeginEnd( _armsForPulling[i] );
-
-			/*
-			const pair<vpIterator,vpIterator> dataBeginEnd = 
-			static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd( _armsForPulling[i] );
-			*/
-
-			const vpReverseIterator dataBegin = dataBeginEnd.first;
-			const vpReverseIterator dataEnd = dataBeginEnd.second;
-
-			/*
-			const vpIterator dataBegin = dataBeginEnd.first;
-			const vpIterator dataEnd = dataBeginEnd.second;
-			*/
-
-			// also sets mu, tmpV, and bestHalfEdge
-			tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
-				halfTheta, &mu, &tmpV);
-
-			tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
 			//update the weights in the UCT tree
-
-			AlphaReal edge = 0.0;
-			for ( vector<sRates>::iterator itR = mu.begin(); itR != mu.end(); itR++ ) edge += ( itR->rPls - itR->rMin );
-			AlphaReal reward = this->getRewardFromEdge( edge );
+			AlphaReal reward = this->getRewardFromEdge( result.edge );
 			_rewards[i] = reward;
 
 			if ( _verbose > 3 ) {
 				//cout << "\tK = " <<i << endl;
-				cout << "\tTempAlpha: " << tmpAlpha << endl;
-				cout << "\tTempEnergy: " << tmpEnergy << endl;
+				cout << "\tTempAlpha: " << result.alpha << endl;
+				cout << "\tTempEnergy: " << result.energy << endl;
 				cout << "\tUpdate weight: " << reward << endl;
 			}
 
 
-			if ( (i==0) || (tmpEnergy < bestEnergy && tmpAlpha > 0) )
+			if ( (i==0) || (result.energy < bestEnergy && result.alpha > 0) )
 			{
 				// Store it in the current weak hypothesis.
 				// note: I don't really like having so many temp variables
@@ -181,12 +186,12 @@ namespace MultiBoost {
 				// make it less flexible. Therefore, I am still undecided. This
 				// might change!
 
-				_alpha = tmpAlpha;
-				_v = tmpV;
+				_alpha = result.alpha;
+				_v = result.v;
 				_selectedColumn = _armsForPulling[i];
-				_threshold = tmpThreshold;
+				_threshold = result.threshold;
 
-				bestEnergy = tmpEnergy;
+				bestEnergy = result.energy;
 				bestReward = reward;
 			}
 		}
@@ -57,6 +57,9 @@ using namespace std;
 
 namespace MultiBoost {
 
+class BanditSparseInitialValues;
+template <typename LearnerT> class SparseColumnSearch;
+
 /**
 * A \b single threshold decision stump learner. 
 * There is ONE and ONE ONLY threshold here.
@@ -101,6 +104,8 @@ public:
 
 protected:
 
+   friend class BanditSparseInitialValues;
+   template <typename LearnerT> friend class SparseColumnSearch;
 };
 
 //////////////////////////////////////////////////////////////////////////
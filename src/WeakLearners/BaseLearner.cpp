@@ -253,12 +253,14 @@ namespace MultiBoost {
 
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
 
-			vector< Label > l = _pTrainingData->getLabels( i );
+			const vector<Label>& l = _pTrainingData->getLabels( i );
 			//cout << d->getRawIndex( i ) << " " << endl;
 
-			for( vector<Label>::iterator it = l.begin(); it !=  l.end(); it++ ) {
+			for( vector<Label>::const_iterator it = l.begin(); it !=  l.end(); it++ ) {
+				const char y = _pTrainingData->getLabelY(i, *it);
+				const AlphaReal w = _pTrainingData->getLabelWeight(i, *it);
 				AlphaReal cl = classify( _pTrainingData, i, it->idx );
-				AlphaReal tmpVal = cl * it->weight * it->y;
+				AlphaReal tmpVal = cl * w * y;
 				if ( tmpVal >= 0.0 ) sumPos += tmpVal;
 				else sumNeg -= tmpVal;
 			}
@@ -292,6 +292,17 @@ namespace MultiBoost {
 		 */
 		virtual AlphaReal classify(InputData* pData, int idx, int classIdx) = 0;		
 		
+		/**
+		 * Classify all the examples in use of the data on all the classes at once.
+		 * Learners that can share the work between the examples (see TreeLearner)
+		 * override it, the others let the caller use classify().
+		 * \param pData The pointer to the data.
+		 * \param votes The output: votes[i * numClasses + l] is classify(pData, i, l).
+		 * \return False if the learner has no batch classification, \a votes is then unchanged.
+		 * \date 19/10/2026
+		 */
+		virtual bool classifyBatch(InputData* /*pData*/, vector<AlphaReal>& /*votes*/) { return false; }
+		
 		/**
 		 * Get the value of alpha. This \b must be computed by the algorithm in run()!
 		 * \return The value of alpha.
@@ -108,12 +108,12 @@ AlphaReal ConstantLearner::finishLearning()
 // -----------------------------------------------------------------------
 AlphaReal ConstantLearner::update( int idx )
 {
-	vector<Label> labels = _pTrainingData->getLabels(idx);
-	vector<Label>::iterator lIt;
+	const vector<Label>& labels = _pTrainingData->getLabels(idx);
+	vector<Label>::const_iterator lIt;
 	
 	for ( lIt = labels.begin(); lIt != labels.end(); ++lIt )
 	{
-		_v[lIt->idx] += (lIt->weight * lIt->y);
+		_v[lIt->idx] += (_pTrainingData->getLabelWeight(idx, *lIt) * _pTrainingData->getLabelY(idx, *lIt));
 	}
 	
 	return 0.0;
@@ -0,0 +1,211 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+/**
+ * \file EnumColumnSearch.h The parallel search of the learners on nominal attributes.
+ */
+
+#ifndef __ENUM_COLUMN_SEARCH_H
+#define __ENUM_COLUMN_SEARCH_H
+
+#include "IO/InputData.h"
+#include "Utils/Utils.h"
+
+#include <vector>
+#include <cmath> // for sqrt
+#include <limits> // for numeric_limits<>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_reduce.h"
+
+using namespace std;
+using namespace tbb;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace MultiBoost {
+	
+	/**
+	 * The weights of the labels of a nominal column, by value and class. The weights
+	 * of the positive labels are summed in gammaPls, those of the negative labels in
+	 * gammaMin, both at [value*numClasses + class]. They are filled in one pass over
+	 * the examples, and everything else is computed from them.
+	 * \date 19/10/2026
+	 */
+	struct EnumGammaTable
+	{
+		int					numIdxs; //!< The number of values of the column.
+		int					numClasses; //!< The number of classes.
+		vector<AlphaReal>	gammaPls; //!< The weights of the positive labels.
+		vector<AlphaReal>	gammaMin; //!< The weights of the negative labels.
+		
+		/**
+		 * Fill the tables of a column.
+		 * \param pData The training data.
+		 * \param column The index of the nominal column.
+		 */
+		void fill( InputData* pData, int column )
+		{
+			const int numExamples = pData->getNumExamples();
+			numIdxs = pData->getEnumMap(column).getNumNames();
+			numClasses = pData->getNumClasses();
+			
+			gammaPls.assign( numIdxs * numClasses, 0.0 );
+			gammaMin.assign( numIdxs * numClasses, 0.0 );
+			
+			for (int i = 0; i < numExamples; ++i) {
+				const vector<Label>& labels = pData->getLabels(i);
+				const int offset = static_cast<int>(pData->getValue(i, column)) * numClasses;
+				
+				for (vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt) {
+					const AlphaReal entry = pData->getLabelWeight(i, *lIt) * pData->getLabelY(i, *lIt);
+					if (entry > 0)
+						gammaPls[offset + lIt->idx] += entry;
+					else if (entry < 0)
+						gammaMin[offset + lIt->idx] += -entry;
+				}
+			}
+		}
+		
+		/**
+		 * A lower bound of the energy of any learner with votes in {-1, +1} on the 
+		 * values and on the classes, without abstention and with theta = 0. Its edge
+		 * is at most the sum of |gammaPls - gammaMin| over the values and classes.
+		 * \see BaseLearner::getEnergy(AlphaReal, AlphaReal)
+		 */
+		AlphaReal getEnergyLowerBound() const
+		{
+			AlphaReal sumWeights = 0, maxEdge = 0;
+			for (int k = 0; k < (int)gammaPls.size(); ++k) {
+				sumWeights += gammaPls[k] + gammaMin[k];
+				maxEdge += fabs( gammaPls[k] - gammaMin[k] );
+			}
+			
+			// 2 * sqrt( eps_min * eps_pls ) + ( 1 - eps_min - eps_pls ) with eps_pls - eps_min = maxEdge
+			const AlphaReal eps_pls = ( sumWeights + maxEdge ) / 2;
+			const AlphaReal eps_min = max( ( sumWeights - maxEdge ) / 2, (AlphaReal)0.0 );
+			return 2 * sqrt( eps_min * eps_pls ) + ( 1 - sumWeights );
+		}
+	};
+	
+	/**
+	 * The best learner found on one nominal column (see EnumColumnSearch).
+	 * \date 19/10/2026
+	 */
+	struct EnumColumnResult
+	{
+		AlphaReal			energy; //!< The energy of the learner.
+		AlphaReal			alpha; //!< The alpha of the learner.
+		vector<AlphaReal>	v; //!< The class-wise votes/abstentions.
+		vector<AlphaReal>	u; //!< The value-wise votes (IndicatorLearner).
+		int					positiveIdx; //!< The value voting +1 (SelectorLearner).
+	};
+	
+	/**
+	 * The body of the parallel search over a list of nominal columns. Each copy of the
+	 * body fills the EnumGammaTable of its columns, and the learner searches its best 
+	 * votes on the table with searchColumn(table, position in the list, result).
+	 * Without abstention and with theta = 0, a column whose energy lower bound is above
+	 * the best energy of the body is skipped. It keeps the first column (in the list 
+	 * order) with the lowest energy and a positive alpha, as the sequential loop does.
+	 * \remark LearnerT must declare EnumColumnSearch as friend.
+	 * \see SelectorLearner
+	 * \see IndicatorLearner
+	 * \date 19/10/2026
+	 */
+	template <typename LearnerT>
+	class EnumColumnSearch {
+	public:
+		EnumColumnSearch(LearnerT* pLearner, const vector<int>& columns)
+		: _pLearner(pLearner), _pColumns(&columns)
+		{ init(); }
+		
+		EnumColumnSearch(EnumColumnSearch& other, split)
+		: _pLearner(other._pLearner), _pColumns(other._pColumns)
+		{ init(); }
+		
+		void operator()( const blocked_range<int>& range ) {
+			for( int k = range.begin(); k != range.end(); ++k ) {
+				_table.fill( _pLearner->_pTrainingData, (*_pColumns)[k] );
+				
+				// the rounding of the bound is far below the margin
+				if ( _hasEnergyBound && _bestIdx >= 0 && 
+					 _table.getEnergyLowerBound() > _best.energy + 1e-10 )
+					continue;
+				
+				_pLearner->searchColumn( _table, k, _tmpResult );
+				
+				if ( _tmpResult.energy < _best.energy && _tmpResult.alpha > 0 )
+				{
+					_bestIdx = k;
+					_best = _tmpResult;
+				}
+			}
+		}
+		
+		void join( const EnumColumnSearch& other ) {
+			if ( other._bestIdx < 0 ) return;
+			if ( _bestIdx < 0 || other._best.energy < _best.energy ||
+				( other._best.energy == _best.energy && other._bestIdx < _bestIdx ) )
+			{
+				_bestIdx = other._bestIdx;
+				_best = other._best;
+			}
+		}
+		
+		int					_bestIdx; //!< The position of the best column in the list, -1 if none.
+		EnumColumnResult	_best; //!< The best learner found.
+		
+	private:
+		void init()
+		{
+			_bestIdx = -1;
+			_best.energy = numeric_limits<AlphaReal>::max();
+			_best.alpha = 0;
+			_hasEnergyBound = _pLearner->_abstention == LearnerT::ABST_NO_ABSTENTION && 
+				nor_utils::is_zero( _pLearner->_theta );
+		}
+		
+		LearnerT*				_pLearner;
+		const vector<int>*		_pColumns;
+		bool					_hasEnergyBound; //!< Whether the columns can be skipped.
+		
+		EnumGammaTable			_table; //!< The tables of the current column.
+		EnumColumnResult		_tmpResult; //!< The best learner of the current column.
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __ENUM_COLUMN_SEARCH_H
@@ -36,6 +36,9 @@
 #include "IO/HaarData.h" // for areaWidth() and areaHeight()
 
 #include <algorithm>
+#include <cassert>
+#include <cstring> // for memcpy
+#include <stdint.h> // for uintptr_t
 
 namespace MultiBoost {
 	
@@ -57,41 +60,506 @@ namespace MultiBoost {
 	
 	// ------------------------------------------------------------------------------
 	
-	void HaarFeature::fillHaarData( const vector<Example>& intImages, // in
-								   vector< pair<int, FeatureReal> >& haarData ) // out
+	void HaarImageBlock::reset(int numPixels, eHaarValueType valueType)
 	{
-		switch (_type)
+		_valueType = valueType;
+		switch (valueType)
 		{
-			case FEATURE_2H_RECT: //!< Two horizontal.
-				_fillHaarData<HaarFeature_2H>(intImages, haarData);
+			case HVT_UINT16: _valueSize = sizeof(uint16_t); break;
+			case HVT_UINT32: _valueSize = sizeof(uint32_t); break;
+			default: _valueSize = sizeof(FeatureReal); break;
+		}
+		
+		_numColumns = 0;
+		_numImages = 0;
+		_numPixels = numPixels;
+		
+		vector< vector<unsigned char> >().swap(_tiles);
+		vector<unsigned char*>().swap(_tileValues);
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Allocate the memory of a tile of tileSize bytes set to zero, with room to
+	 * align its beginning on 64 bytes, and return the aligned beginning.
+	 */
+	static unsigned char* allocateTile( vector<unsigned char>& storage, size_t tileSize )
+	{
+		storage.assign( tileSize + 64, 0 );
+		
+		const uintptr_t address = reinterpret_cast<uintptr_t>( &storage[0] );
+		return &storage[0] + (64 - address % 64) % 64;
+	}
+	
+	void HaarImageBlock::addTile()
+	{
+		_tiles.push_back( vector<unsigned char>() );
+		_tileValues.push_back( allocateTile(_tiles.back(), getTileSize()) );
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Convert a value of an integral image to the type of a block. The values
+	 * are reduced modulo 2^16 or 2^32 (by the conversion to unsigned).
+	 */
+	static inline void convertValue( FeatureReal v, FeatureReal& value ) 
+	{ value = v; }
+	
+	static inline void convertValue( FeatureReal v, uint16_t& value ) 
+	{ value = static_cast<uint16_t>( static_cast<unsigned long long>(v) ); }
+	
+	static inline void convertValue( FeatureReal v, uint32_t& value ) 
+	{ value = static_cast<uint32_t>( static_cast<unsigned long long>(v) ); }
+	
+	/**
+	 * Copy an integral image into a lane of a tile.
+	 */
+	template <typename T>
+	static inline void copyImage( const vector<FeatureReal>& intImage, T* pLane, int numPixels )
+	{
+		for (int p = 0; p < numPixels; ++p)
+			convertValue( intImage[p], pLane[p * HAAR_BATCH_WIDTH] );
+	}
+	
+	void HaarImageBlock::addImage(const vector<FeatureReal>& intImage)
+	{
+		const int lane = _numColumns % HAAR_BATCH_WIDTH;
+		if (lane == 0)
+			addTile();
+		
+		unsigned char* pTile = _tileValues.back();
+		switch (_valueType)
+		{
+			case HVT_UINT16:
+				copyImage( intImage, reinterpret_cast<uint16_t*>(pTile) + lane, _numPixels );
 				break;
-				
-			case FEATURE_2V_RECT: //!< Two vertical. 
-				
-				_fillHaarData<HaarFeature_2V>(intImages, haarData);
+			case HVT_UINT32:
+				copyImage( intImage, reinterpret_cast<uint32_t*>(pTile) + lane, _numPixels );
 				break;
-				
-			case FEATURE_3H_RECT: //!< Three horizontal.
-				
-				_fillHaarData<HaarFeature_3H>(intImages, haarData);
+			default:
+				copyImage( intImage, reinterpret_cast<FeatureReal*>(pTile) + lane, _numPixels );
 				break;
-				
-			case FEATURE_3V_RECT: //!< Three vertical.
-				
-				_fillHaarData<HaarFeature_3V>(intImages, haarData);
+		}
+		
+		++_numColumns;
+		_numImages = _numColumns;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	template <typename T, typename U>
+	void HaarImageBlock::widenTiles(int width)
+	{
+		const int height = _numPixels / width;
+		const size_t tileSize = static_cast<size_t>(_numPixels + 1) * HAAR_BATCH_WIDTH * sizeof(U);
+		vector<long long> intImage(_numPixels);
+		
+		// one tile at a time, so that the two types are not held for the whole block
+		for (size_t t = 0; t < _tiles.size(); ++t)
+		{
+			const T* pSource = reinterpret_cast<const T*>( _tileValues[t] );
+			
+			vector<unsigned char> storage;
+			U* pDest = reinterpret_cast<U*>( allocateTile(storage, tileSize) );
+			
+			for (int l = 0; l < HAAR_BATCH_WIDTH; ++l)
+			{
+				for (int y = 0; y < height; ++y)
+				{
+					for (int x = 0; x < width; ++x)
+					{
+						const int p = y * width + x;
+						
+						// the pixel is exact modulo the size of T
+						const T left = (x > 0) ? pSource[(p - 1) * HAAR_BATCH_WIDTH + l] : 0;
+						const T up = (y > 0) ? pSource[(p - width) * HAAR_BATCH_WIDTH + l] : 0;
+						const T upLeft = (x > 0 && y > 0) ? pSource[(p - width - 1) * HAAR_BATCH_WIDTH + l] : 0;
+						const T pixel = static_cast<T>( pSource[p * HAAR_BATCH_WIDTH + l] - left - up + upLeft );
+						
+						intImage[p] = static_cast<long long>(pixel) + 
+									  ( (x > 0) ? intImage[p - 1] : 0 ) + 
+									  ( (y > 0) ? intImage[p - width] : 0 ) - 
+									  ( (x > 0 && y > 0) ? intImage[p - width - 1] : 0 );
+						
+						pDest[p * HAAR_BATCH_WIDTH + l] = static_cast<U>( intImage[p] );
+					}
+				}
+			}
+			
+			// the buffers are exchanged, so pDest is still the beginning of the tile
+			_tiles[t].swap(storage);
+			_tileValues[t] = reinterpret_cast<unsigned char*>(pDest);
+		}
+	}
+	
+	void HaarImageBlock::widen(eHaarValueType valueType, int width)
+	{
+		assert( (_valueType == HVT_UINT16 && valueType != HVT_UINT16) || 
+				(_valueType == HVT_UINT32 && valueType == HVT_REAL) );
+		
+		if (_valueType == HVT_UINT16 && valueType == HVT_UINT32)
+			widenTiles<uint16_t, uint32_t>(width);
+		else if (_valueType == HVT_UINT16)
+			widenTiles<uint16_t, FeatureReal>(width);
+		else
+			widenTiles<uint32_t, FeatureReal>(width);
+		
+		_valueType = valueType;
+		_valueSize = (valueType == HVT_UINT32) ? sizeof(uint32_t) : sizeof(FeatureReal);
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	template <typename T>
+	void HaarImageBlock::reorderTiles(const vector<int>& order)
+	{
+		const int numColumns = static_cast<int>( order.size() );
+		const int numTiles = (numColumns + HAAR_BATCH_WIDTH - 1) / HAAR_BATCH_WIDTH;
+		while ( static_cast<int>(_tiles.size()) < numTiles )
+			addTile();
+		
+		// one pixel at a time, for all the images: only the values of a pixel 
+		// are held twice
+		vector<T> pixelValues(numColumns);
+		for (int p = 0; p < _numPixels; ++p)
+		{
+			for (int c = 0; c < numColumns; ++c)
+			{
+				const T* pTile = reinterpret_cast<const T*>( _tileValues[order[c] / HAAR_BATCH_WIDTH] );
+				pixelValues[c] = pTile[p * HAAR_BATCH_WIDTH + order[c] % HAAR_BATCH_WIDTH];
+			}
+			
+			// the lanes after the last column are set to zero
+			for (int c = 0; c < numTiles * HAAR_BATCH_WIDTH; ++c)
+			{
+				T* pTile = reinterpret_cast<T*>( _tileValues[c / HAAR_BATCH_WIDTH] );
+				pTile[p * HAAR_BATCH_WIDTH + c % HAAR_BATCH_WIDTH] = (c < numColumns) ? pixelValues[c] : 0;
+			}
+		}
+		
+		_tiles.resize(numTiles);
+		_tileValues.resize(numTiles);
+	}
+	
+	void HaarImageBlock::reorder(const vector<int>& order, int numImages)
+	{
+		switch (_valueType)
+		{
+			case HVT_UINT16: reorderTiles<uint16_t>(order); break;
+			case HVT_UINT32: reorderTiles<uint32_t>(order); break;
+			default: reorderTiles<FeatureReal>(order); break;
+		}
+		
+		_numColumns = static_cast<int>( order.size() );
+		_numImages = numImages;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	void HaarImageBlock::downsample(const HaarImageBlock& source, int width, int height, int factor)
+	{
+		const int coarseWidth = width / factor;
+		const int coarseHeight = height / factor;
+		
+		reset(coarseWidth * coarseHeight, source._valueType);
+		
+		// only the tiles of the images in use
+		const int numTiles = (source._numImages + HAAR_BATCH_WIDTH - 1) / HAAR_BATCH_WIDTH;
+		
+		// the pixels of the two blocks have the same size
+		const size_t pixelSize = HAAR_BATCH_WIDTH * _valueSize;
+		for (int t = 0; t < numTiles; ++t)
+		{
+			addTile();
+			for (int y = 0; y < coarseHeight; ++y)
+			{
+				for (int x = 0; x < coarseWidth; ++x)
+				{
+					const int p = (factor * y + factor - 1) * width + factor * x + factor - 1;
+					memcpy( _tileValues[t] + static_cast<size_t>(y * coarseWidth + x) * pixelSize, 
+						   source._tileValues[t] + static_cast<size_t>(p) * pixelSize, pixelSize );
+				}
+			}
+		}
+		
+		_numColumns = min(source._numColumns, numTiles * HAAR_BATCH_WIDTH);
+		_numImages = source._numImages;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * The value of a block, given the values of the integral image at its corners 
+	 * 4, 1, 2 and 3. The integer versions use modular arithmetic, so that the result
+	 * is exact as long as the block sum fits in the type.
+	 */
+	static inline FeatureReal blockSum( FeatureReal v4, FeatureReal v1, FeatureReal v2, FeatureReal v3 )
+	{ return v4 + v1 - (v2 + v3); }
+	
+	static inline uint16_t blockSum( uint16_t v4, uint16_t v1, uint16_t v2, uint16_t v3 )
+	{ return static_cast<uint16_t>( v4 + v1 - (v2 + v3) ); }
+	
+	static inline uint32_t blockSum( uint32_t v4, uint32_t v1, uint32_t v2, uint32_t v3 )
+	{ return v4 + v1 - (v2 + v3); }
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Sum the blocks of a configuration on the HAAR_BATCH_WIDTH images of a tile.
+	 * The operations are the same (and in the same order) as in the getValue 
+	 * methods, so that the results are identical.
+	 * T is the type of the values of the block, S the type of the sums.
+	 */
+	template <typename T, typename S>
+	static inline void sumBlocks( const T* pTile, const int (*pCorners)[4], int numBlocks, S* pSum )
+	{
+		for (int b = 0; b < numBlocks; ++b)
+		{
+			const T* p4 = pTile + pCorners[b][0] * HAAR_BATCH_WIDTH;
+			const T* p1 = pTile + pCorners[b][1] * HAAR_BATCH_WIDTH;
+			const T* p2 = pTile + pCorners[b][2] * HAAR_BATCH_WIDTH;
+			const T* p3 = pTile + pCorners[b][3] * HAAR_BATCH_WIDTH;
+			
+			if (b == 0)
+			{
+				for (int l = 0; l < HAAR_BATCH_WIDTH; ++l)
+					pSum[l] = blockSum(p4[l], p1[l], p2[l], p3[l]);
+			}
+			else
+			{
+				for (int l = 0; l < HAAR_BATCH_WIDTH; ++l)
+					pSum[l] += blockSum(p4[l], p1[l], p2[l], p3[l]);
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Fill the outputs of a configuration from a block of type T, with sums of type S.
+	 */
+	template <typename T, typename S>
+	static void fillFromBlock( const HaarImageBlock& block, const HaarCorners& corners,
+							  vector< pair<int, FeatureReal> >& haarData )
+	{
+		S whiteSum[HAAR_BATCH_WIDTH];
+		S blackSum[HAAR_BATCH_WIDTH];
+		
+		const int numImages = block.getNumImages();
+		for (int first = 0, t = 0; first < numImages; first += HAAR_BATCH_WIDTH, ++t)
+		{
+			const T* pTile = block.getTile<T>(t);
+			sumBlocks(pTile, corners.white, corners.numWhite, whiteSum);
+			sumBlocks(pTile, corners.black, corners.numBlack, blackSum);
+			
+			const int last = min(first + HAAR_BATCH_WIDTH, numImages);
+			for (int i = first; i < last; ++i)
+			{
+				haarData[i].first = i;
+				haarData[i].second = static_cast<FeatureReal>( blackSum[i - first] - whiteSum[i - first] );
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	void HaarFeature::fillHaarData( const HaarImageBlock& block, // in
+								   vector< pair<int, FeatureReal> >& haarData, // out
+								   const nor_utils::Rect& config ) // in
+	{
+		HaarCorners corners;
+		getCorners(config, corners);
+		
+		switch ( block.getValueType() )
+		{
+			case HVT_UINT16:
+				fillFromBlock<uint16_t, long long>(block, corners, haarData);
+				break;
+			case HVT_UINT32:
+				fillFromBlock<uint32_t, long long>(block, corners, haarData);
+				break;
+			default:
+				fillFromBlock<FeatureReal, FeatureReal>(block, corners, haarData);
 				break;
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Move the corners of blocks from the full resolution window to a level of
+	 * the pyramid. Returns false if a corner is not on the grid of the level.
+	 */
+	static bool downsampleCorners( int (*pCorners)[4], int numBlocks, int factor )
+	{
+		const int width = HaarData::areaWidth();
+		const int outside = HaarData::areaWidth() * HaarData::areaHeight();
+		const int coarseWidth = HaarData::areaWidth() / factor;
+		const int coarseOutside = coarseWidth * (HaarData::areaHeight() / factor);
+		
+		for (int b = 0; b < numBlocks; ++b)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				if (pCorners[b][c] == outside)
+				{
+					pCorners[b][c] = coarseOutside;
+					continue;
+				}
 				
-			case FEATURE_4SQUARE_RECT: //!< Four square.
+				const int x = pCorners[b][c] % width + 1;
+				const int y = pCorners[b][c] / width + 1;
+				if (x % factor != 0 || y % factor != 0)
+					return false;
 				
-				_fillHaarData<HaarFeature_4SQ>(intImages, haarData);
+				pCorners[b][c] = (y / factor - 1) * coarseWidth + x / factor - 1;
+			}
+		}
+		
+		return true;
+	}
+	
+	bool HaarFeature::fillHaarData( const HaarImageBlock& block, // in
+								   vector< pair<int, FeatureReal> >& haarData, // out
+								   const nor_utils::Rect& config, // in
+								   int factor ) // in
+	{
+		HaarCorners corners;
+		getCorners(config, corners);
+		
+		if ( !downsampleCorners(corners.white, corners.numWhite, factor) ||
+			 !downsampleCorners(corners.black, corners.numBlack, factor) )
+			return false;
+		
+		switch ( block.getValueType() )
+		{
+			case HVT_UINT16:
+				fillFromBlock<uint16_t, long long>(block, corners, haarData);
 				break;
-				
-			case FEATURE_NO_TYPE:
-				cerr << "ERROR: fillHaarData called with no type\n";
-				exit(-1);
+			case HVT_UINT32:
+				fillFromBlock<uint32_t, long long>(block, corners, haarData);
+				break;
+			default:
+				fillFromBlock<FeatureReal, FeatureReal>(block, corners, haarData);
 				break;
 		}
 		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Round a position and a size (of numUnits blocks of unitSize pixels) to the
+	 * grid of a level of the pyramid of a window of coarseSize pixels, and return
+	 * them at full resolution. Returns false if the window is smaller than a block.
+	 */
+	static bool getCoarseRange( int pos, int size, int unitSize, int factor, int coarseSize,
+							   short& coarsePos, short& coarseSize1 )
+	{
+		const int maxUnits = coarseSize / unitSize;
+		if (maxUnits == 0)
+			return false;
+		
+		// the number of blocks of the rounded size
+		int numUnits = (size + factor * unitSize / 2) / (factor * unitSize);
+		numUnits = max(1, min(numUnits, maxUnits));
+		
+		const int coarseLength = numUnits * unitSize;
+		const int coarseStart = min(pos / factor, coarseSize - coarseLength);
+		
+		// the sizes of the configurations are given minus one (see precomputeConfigs)
+		coarsePos = static_cast<short>(coarseStart * factor);
+		coarseSize1 = static_cast<short>(coarseLength * factor - 1);
+		return true;
+	}
+	
+	bool HaarFeature::getCoarseConfig( const nor_utils::Rect& r, int factor, nor_utils::Rect& coarse ) const
+	{
+		return getCoarseRange( r.x, r.width + 1, _width, factor, HaarData::areaWidth() / factor, 
+							  coarse.x, coarse.width ) &&
+			   getCoarseRange( r.y, r.height + 1, _height, factor, HaarData::areaHeight() / factor,
+							  coarse.y, coarse.height );
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Sum the blocks of a configuration on the image of a lane of a tile, as
+	 * sumBlocks does.
+	 */
+	template <typename T, typename S>
+	static inline S sumLaneBlocks( const T* pLane, const int (*pCorners)[4], int numBlocks )
+	{
+		S sum = blockSum( pLane[pCorners[0][0] * HAAR_BATCH_WIDTH], pLane[pCorners[0][1] * HAAR_BATCH_WIDTH], 
+						  pLane[pCorners[0][2] * HAAR_BATCH_WIDTH], pLane[pCorners[0][3] * HAAR_BATCH_WIDTH] );
+		for (int b = 1; b < numBlocks; ++b)
+			sum += blockSum( pLane[pCorners[b][0] * HAAR_BATCH_WIDTH], pLane[pCorners[b][1] * HAAR_BATCH_WIDTH], 
+							 pLane[pCorners[b][2] * HAAR_BATCH_WIDTH], pLane[pCorners[b][3] * HAAR_BATCH_WIDTH] );
+		return sum;
+	}
+	
+	template <typename T, typename S>
+	static inline FeatureReal getLaneValue( const T* pLane, const HaarCorners& corners )
+	{
+		const S whiteSum = sumLaneBlocks<T, S>(pLane, corners.white, corners.numWhite);
+		const S blackSum = sumLaneBlocks<T, S>(pLane, corners.black, corners.numBlack);
+		return static_cast<FeatureReal>( blackSum - whiteSum );
+	}
+	
+	FeatureReal HaarFeature::getValue(const HaarImageBlock& block, int column, const nor_utils::Rect& r)
+	{
+		HaarCorners corners;
+		getCorners(r, corners);
+		
+		const int t = column / HAAR_BATCH_WIDTH;
+		const int lane = column % HAAR_BATCH_WIDTH;
+		
+		switch ( block.getValueType() )
+		{
+			case HVT_UINT16:
+				return getLaneValue<uint16_t, long long>( block.getTile<uint16_t>(t) + lane, corners );
+			case HVT_UINT32:
+				return getLaneValue<uint32_t, long long>( block.getTile<uint32_t>(t) + lane, corners );
+			default:
+				return getLaneValue<FeatureReal, FeatureReal>( block.getTile<FeatureReal>(t) + lane, corners );
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	int HaarFeature::getMaxBlockArea()
+	{
+		int maxArea = 0;
+		
+		const string regsString = RegisteredFeatures().getRegString();
+		for (size_t f = 0; f + 2 <= regsString.size(); f += 2)
+		{
+			HaarFeature* pFeature = RegisteredFeatures().getFeature( regsString.substr(f, 2) )->create();
+			pFeature->precomputeConfigs();
+			
+			vector<nor_utils::Rect>::const_iterator cIt;
+			for (cIt = pFeature->_precomputedConfigs.begin(); cIt != pFeature->_precomputedConfigs.end(); ++cIt)
+			{
+				HaarCorners corners;
+				pFeature->getCorners(*cIt, corners);
+				
+				for (int b = 0; b < corners.numWhite + corners.numBlack; ++b)
+				{
+					const int* pCorners = (b < corners.numWhite) ? corners.white[b] : corners.black[b - corners.numWhite];
+					
+					int left, top, right, bottom;
+					getBlockEdges(pCorners, left, top, right, bottom);
+					maxArea = max( maxArea, (right - left) * (bottom - top) );
+				}
+			}
+			
+			delete pFeature;
+		}
+		
+		return maxArea;
 	}
 	
 	// ------------------------------------------------------------------------------
@@ -158,6 +626,40 @@ namespace MultiBoost {
 	
 	// ------------------------------------------------------------------------------
 	
+	void HaarFeature::setBlock(int* corners, int x4, int y4, int x1, int y1, 
+							   int x2, int y2, int x3, int y3)
+	{
+		const int xs[4] = { x4, x1, x2, x3 };
+		const int ys[4] = { y4, y1, y2, y3 };
+		
+		// the corners outside of the image point to the row of zeros (see getSumAt)
+		for (int c = 0; c < 4; ++c)
+		{
+			if (xs[c] < 0 || ys[c] < 0)
+				corners[c] = HaarData::areaWidth() * HaarData::areaHeight();
+			else
+				corners[c] = HaarData::areaWidth() * ys[c] + xs[c];
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	void HaarFeature::getBlockEdges(const int* corners, int& left, int& top, 
+									int& right, int& bottom)
+	{
+		const int width = HaarData::areaWidth();
+		const int outside = HaarData::areaWidth() * HaarData::areaHeight();
+		
+		// corner 4 is always inside the image, while corners 1 and 2 (resp. 3) 
+		// point to the row of zeros when the block touches the top (resp. left) border
+		right = corners[0] % width + 1;
+		bottom = corners[0] / width + 1;
+		left = (corners[3] == outside) ? 0 : corners[3] % width + 1;
+		top = (corners[2] == outside) ? 0 : corners[2] / width + 1;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
 	void HaarFeature::resetConfigIterator()
 	{
 		fill(_visitedConfigs.begin(), _visitedConfigs.end(), 0);
@@ -258,6 +760,22 @@ namespace MultiBoost {
 		return blackSum - whiteSum;
 	}
 	
+	void HaarFeature_2H::getCorners(const nor_utils::Rect& r, HaarCorners& corners)
+	{
+		int xHalfPos = r.x + (r.width / 2);
+		int yEndPos = r.y + r.height;
+		
+		corners.numWhite = 1;
+		corners.numBlack = 1;
+		
+		setBlock(corners.white[0], xHalfPos, yEndPos, r.x-1, r.y-1, 
+				 xHalfPos, r.y-1, r.x-1, yEndPos);
+		
+		xHalfPos++;
+		setBlock(corners.black[0], r.x+r.width, yEndPos, xHalfPos-1, r.y-1, 
+				 r.x+r.width, r.y-1, xHalfPos-1, yEndPos);
+	}
+	
 	// ------------------------------------------------------------------------------
 	
 	
@@ -280,6 +798,22 @@ namespace MultiBoost {
 		return blackSum - whiteSum;  
 	}
 	
+	void HaarFeature_2V::getCorners(const nor_utils::Rect& r, HaarCorners& corners)
+	{
+		int yHalfPos = r.y + (r.height / 2);
+		int xEndPos = r.x + r.width;
+		
+		corners.numWhite = 1;
+		corners.numBlack = 1;
+		
+		setBlock(corners.white[0], xEndPos, yHalfPos, r.x-1, r.y-1, 
+				 xEndPos, r.y-1, r.x-1, yHalfPos);
+		
+		yHalfPos++;
+		setBlock(corners.black[0], xEndPos, r.y+r.height, r.x-1, yHalfPos-1, 
+				 xEndPos, yHalfPos-1, r.x-1, r.y+r.height);
+	}
+	
 	// ------------------------------------------------------------------------------
 	
 	FeatureReal HaarFeature_3H::getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r)
@@ -322,6 +856,29 @@ namespace MultiBoost {
 		return blackSum - whiteSum;
 	}
 	
+	void HaarFeature_3H::getCorners(const nor_utils::Rect& r, HaarCorners& corners)
+	{
+		int xOneThirdPos = r.x + ( r.width / 3);
+		int xTwoThirdPos = r.x + ( ((r.width+1) / 3) * 2 - 1);
+		
+		corners.numWhite = 2;
+		corners.numBlack = 1;
+		
+		// Left White
+		setBlock(corners.white[0], xOneThirdPos, r.y+r.height, r.x-1, r.y-1, 
+				 xOneThirdPos, r.y-1, r.x-1, r.y+r.height);
+		
+		xOneThirdPos++;
+		setBlock(corners.black[0], xTwoThirdPos, r.y+r.height, xOneThirdPos-1, r.y-1, 
+				 xTwoThirdPos, r.y-1, xOneThirdPos-1, r.y+r.height);
+		
+		xTwoThirdPos++;
+		
+		// Right White
+		setBlock(corners.white[1], r.x+r.width, r.y+r.height, xTwoThirdPos-1, r.y-1, 
+				 r.x+r.width, r.y-1, xTwoThirdPos-1, r.y+r.height);
+	}
+	
 	// ------------------------------------------------------------------------------
 	
 	FeatureReal HaarFeature_3V::getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r)
@@ -353,6 +910,29 @@ namespace MultiBoost {
 		return blackSum - whiteSum;
 	}
 	
+	void HaarFeature_3V::getCorners(const nor_utils::Rect& r, HaarCorners& corners)
+	{
+		int yOneThirdPos = r.y + ( r.height / 3);
+		int yTwoThirdPos = r.y + ( ((r.height+1) / 3) * 2 - 1);
+		
+		corners.numWhite = 2;
+		corners.numBlack = 1;
+		
+		// Top White
+		setBlock(corners.white[0], r.x+r.width, yOneThirdPos, r.x-1, r.y-1, 
+				 r.x+r.width, r.y-1, r.x-1, yOneThirdPos);
+		
+		yOneThirdPos++;
+		setBlock(corners.black[0], r.x+r.width, yTwoThirdPos, r.x-1, yOneThirdPos-1, 
+				 r.x+r.width, yOneThirdPos-1, r.x-1, yTwoThirdPos);
+		
+		yTwoThirdPos++;
+		
+		// Bottom White
+		setBlock(corners.white[1], r.x+r.width, r.y+r.height, r.x-1, yTwoThirdPos-1, 
+				 r.x+r.width, yTwoThirdPos-1, r.x-1, r.y+r.height);
+	}
+	
 	// ------------------------------------------------------------------------------
 	
 	FeatureReal HaarFeature_4SQ::getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r)
@@ -396,6 +976,40 @@ namespace MultiBoost {
 		return blackSum - whiteSum;
 	}
 	
+	void HaarFeature_4SQ::getCorners(const nor_utils::Rect& r, HaarCorners& corners)
+	{
+		int yHalfPos = r.y + (r.height / 2);
+		int yEndPos = r.y + r.height;
+		int xHalfPos = r.x + (r.width / 2);
+		int xEndPos = r.x + r.width;
+		
+		corners.numWhite = 2;
+		corners.numBlack = 2;
+		
+		// Top left
+		setBlock(corners.white[0], xHalfPos, yHalfPos, r.x-1, r.y-1, 
+				 xHalfPos, r.y-1, r.x-1, yHalfPos);
+		
+		xHalfPos++;
+		
+		// Top right
+		setBlock(corners.black[0], xEndPos, yHalfPos, xHalfPos-1, r.y-1, 
+				 xEndPos, r.y-1, xHalfPos-1, yHalfPos);
+		
+		xHalfPos--;
+		yHalfPos++;
+		
+		// Bottom left
+		setBlock(corners.black[1], xHalfPos, yEndPos, r.x-1, yHalfPos-1, 
+				 xHalfPos, yHalfPos-1, r.x-1, yEndPos);
+		
+		xHalfPos++;
+		
+		// Bottom right
+		setBlock(corners.white[1], xEndPos, yEndPos, xHalfPos-1, yHalfPos-1, 
+				 xEndPos, yHalfPos-1, xHalfPos-1, yEndPos);
+	}
+	
 	// ------------------------------------------------------------------------------
 	
 } // end of namespace MultiBoost
@@ -45,6 +45,7 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <stdint.h> // for uint16_t and uint32_t
 
 using namespace std;
 
@@ -80,9 +81,177 @@ namespace MultiBoost {
 		AT_RANDOM_SAMPLING //!< Random sampling of the configurations. 
 	};
 	
+	/**
+	 * The type of the values of the integral images held by HaarImageBlock.
+	 * \date 18/10/2026
+	 */
+	enum eHaarValueType
+	{
+		HVT_REAL, //!< FeatureReal, as loaded. 
+		HVT_UINT16, //!< Unsigned 16 bits integers, modulo 2^16.
+		HVT_UINT32 //!< Unsigned 32 bits integers, modulo 2^32.
+	};
+	
 	//////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////
 	
+	/**
+	 * The integral images of a set of examples, stored in tiles of HAAR_BATCH_WIDTH
+	 * images. Within a tile the images are transposed: the values of a pixel for 
+	 * the images of the tile are consecutive, so that a configuration can be
+	 * evaluated on HAAR_BATCH_WIDTH images at once with contiguous (vectorizable)
+	 * loads. An extra pixel of zeros after the last one stands for the corners
+	 * which are outside of the image. Each image is a column of the block, and
+	 * the images are added one by one, so that the block can be filled while
+	 * the examples are read.
+	 * The integer types keep the values modulo 2^16 (or 2^32): the sum of a block,
+	 * computed with the same modular arithmetic, is exact as long as it fits in
+	 * the type, even if the values of the integral image do not.
+	 * \see HaarFeature::fillHaarData
+	 * \see HaarData::getImageBlock
+	 * \date 18/10/2026
+	 */
+	class HaarImageBlock
+	{
+	public:
+		
+		HaarImageBlock() : _valueType(HVT_REAL), _valueSize(sizeof(FeatureReal)), 
+		                   _numColumns(0), _numImages(0), _numPixels(0) {}
+		
+		/**
+		 * Remove all the images.
+		 * \param numPixels The number of pixels of each image.
+		 * \param valueType The type of the values.
+		 * \date 19/10/2026
+		 */
+		void reset(int numPixels, eHaarValueType valueType = HVT_REAL);
+		
+		/**
+		 * Copy the integral image of an example into a new column, after the
+		 * last one. The images in use (see getNumImages) are all the columns.
+		 * \param intImage The integral image. With the integer types the values
+		 * must be non-negative integers, they are reduced modulo 2^16 or 2^32.
+		 * \date 19/10/2026
+		 */
+		void addImage(const vector<FeatureReal>& intImage);
+		
+		/**
+		 * Change the type of the values to a larger one (HVT_UINT16 to HVT_UINT32,
+		 * or an integer type to HVT_REAL). The pixels of the images are recovered
+		 * from the modular values, and the integral images are computed again, 
+		 * so that nothing is lost as long as the pixels fit in the current type 
+		 * and the integral images in the new one.
+		 * \param valueType The new type of the values.
+		 * \param width The width of the images.
+		 * \date 19/10/2026
+		 */
+		void widen(eHaarValueType valueType, int width);
+		
+		/**
+		 * Permute the columns of the block: column c takes the image of column
+		 * order[c]. A column can be repeated, and the number of columns becomes
+		 * the size of \a order.
+		 * \param order The previous columns of the images.
+		 * \param numImages The number of images in use, which are the first ones.
+		 * \date 19/10/2026
+		 */
+		void reorder(const vector<int>& order, int numImages);
+		
+		/**
+		 * Fill the block with the integral images of another block downsampled by
+		 * \a factor: pixel (x, y) is pixel (factor*x + factor-1, factor*y + factor-1)
+		 * of \a source, that is the integral image of the images binned by 
+		 * factor x factor pixels. The sums of the blocks are therefore unchanged.
+		 * \param source The block at full resolution.
+		 * \param width The width of the images of \a source.
+		 * \param height The height of the images of \a source.
+		 * \param factor The downsampling factor.
+		 * \date 19/10/2026
+		 */
+		void downsample(const HaarImageBlock& source, int width, int height, int factor);
+		
+		/**
+		 * Get the values of tile t, which holds the images of the columns from 
+		 * t*HAAR_BATCH_WIDTH to (t+1)*HAAR_BATCH_WIDTH - 1. The value of pixel p
+		 * of the image of lane l of the tile is at p*HAAR_BATCH_WIDTH + l, and 
+		 * the index _numPixels is the pixel of zeros.
+		 * \param t The index of the tile.
+		 * \remark T must match the type of the block (see getValueType).
+		 * \date 19/10/2026
+		 */
+		template <typename T>
+		const T* getTile(int t) const 
+		{ return reinterpret_cast<const T*>( _tileValues[t] ); }
+		
+		eHaarValueType getValueType() const { return _valueType; } //!< Returns the type of the values.
+		size_t getValueSize() const { return _valueSize; } //!< Returns the size of a value in bytes.
+		int getNumColumns() const { return _numColumns; } //!< Returns the number of images held.
+		int getNumImages() const { return _numImages; } //!< Returns the number of images in use.
+		int getNumPixels() const { return _numPixels; } //!< Returns the number of pixels of each image.
+		
+		/**
+		 * Returns the size of the values of the block in bytes.
+		 * \date 19/10/2026
+		 */
+		size_t getMemory() const { return _tiles.size() * getTileSize(); }
+		
+	private:
+		
+		/**
+		 * Returns the size of the values of a tile in bytes.
+		 * \date 19/10/2026
+		 */
+		size_t getTileSize() const 
+		{ return static_cast<size_t>(_numPixels + 1) * HAAR_BATCH_WIDTH * _valueSize; }
+		
+		/**
+		 * Append a tile of zeros, whose beginning is aligned on 64 bytes.
+		 * \date 19/10/2026
+		 */
+		void addTile();
+		
+		/**
+		 * The implementation of widen for the values of type T, into type U.
+		 * \date 19/10/2026
+		 */
+		template <typename T, typename U>
+		void widenTiles(int width);
+		
+		/**
+		 * The implementation of reorder for the values of type T.
+		 * \date 19/10/2026
+		 */
+		template <typename T>
+		void reorderTiles(const vector<int>& order);
+		
+		vector< vector<unsigned char> >	_tiles; //!< The memory of the tiles.
+		vector<unsigned char*>	_tileValues; //!< The (aligned) beginning of each tile within _tiles.
+		eHaarValueType		_valueType; //!< The type of the values.
+		size_t				_valueSize; //!< The size of a value in bytes.
+		int					_numColumns; //!< The number of images held.
+		int					_numImages; //!< The number of images in use, which are the first columns.
+		int					_numPixels; //!< The number of pixels of each image.
+	};
+	
+	/**
+	 * The blocks of a configuration of a Haar-like feature, given as the indices
+	 * of their corners in the integral image (in the order 4, 1, 2, 3 of the
+	 * drawings of the features). The value of a block is (4+1) - (2+3), and the
+	 * value of the feature is the sum of the black blocks minus the sum of the 
+	 * white blocks.
+	 * \see HaarFeature::getCorners
+	 * \date 18/10/2026
+	 */
+	struct HaarCorners
+	{
+		int numWhite; //!< The number of white blocks.
+		int numBlack; //!< The number of black blocks.
+		int white[2][4]; //!< The corners of the white blocks.
+		int black[2][4]; //!< The corners of the black blocks.
+	};
+	
+	// ------------------------------------------------------------------------------
+	
 	/**
 	 * This class holds a Haar-like feature type. Each type will have a set
 	 * of possible "configurations", that is its position and size
@@ -322,23 +491,80 @@ namespace MultiBoost {
 		void resetConfigIterator();
 		
 		/**
-		 * Convert the vector of all the examples (in integral image format) into
-		 * a vector of features outputs, using the current configuration.
-		 * The pair represent the original index of the example, where the second
-		 * element is the feature's output.
-		 * \remark This conversion could be done example-by-example with the 
-		 * getValue method, but a virtual call for each example would be too
-		 * slow. Instead the type of Haar-like feature is resolved within this
-		 * method, and then the filling is performed statically by _fillHaarData.
-		 * \param intImages The vector with the examples to be converted.
+		 * Convert the integral images of the examples in use of a block into a
+		 * vector of features outputs, using the configuration given explicitly.
+		 * The pair represent the index of the example, where the second element
+		 * is the feature's output. The configuration is evaluated on 
+		 * HAAR_BATCH_WIDTH images at once, and the type of the values of the 
+		 * block is resolved once for all the images. It does not depend on the
+		 * iterator over the configurations, so it can be called by several 
+		 * threads at the same time.
+		 * \param block The integral images of the examples.
 		 * \param haarData The returned vector of features outputs.
+		 * \param config The configuration of the feature.
+		 * \see HaarImageBlock
 		 * \see getValue
-		 * \see _fillHaarData
-		 * \see getCurrentConfig
-		 * \date 27/12/2005
+		 * \date 18/10/2026
+		 */
+		void fillHaarData( const HaarImageBlock& block, // in
+						  vector< pair<int, FeatureReal> >& haarData, // out
+						  const nor_utils::Rect& config ); // in
+		
+		/**
+		 * The same as fillHaarData but reading the integral images from a level of
+		 * the pyramid (see HaarImageBlock::downsample). The configuration is given
+		 * at full resolution, and all its corners must be on the grid of the level,
+		 * as for the configurations returned by getCoarseConfig. The outputs are 
+		 * then the same as on the full resolution block.
+		 * \param block The downsampled integral images of the examples.
+		 * \param haarData The returned vector of features outputs.
+		 * \param config The configuration of the feature.
+		 * \param factor The downsampling factor of the level.
+		 * \return false if a corner is not on the grid (\a haarData is not filled).
+		 * \date 19/10/2026
 		 */
-		void fillHaarData( const vector<Example>& intImages, // in
-						  vector< pair<int, FeatureReal> >& haarData ); // out
+		bool fillHaarData( const HaarImageBlock& block, // in
+						  vector< pair<int, FeatureReal> >& haarData, // out
+						  const nor_utils::Rect& config, // in
+						  int factor ); // in
+		
+		/**
+		 * Get the configuration that stands for \a r on a level of the pyramid:
+		 * its position and its size are rounded to multiples of \a factor (the size 
+		 * keeping a whole number of blocks of the feature), and it lies inside the
+		 * downsampled window. It is a configuration of the full resolution window.
+		 * \param r The configuration of the feature.
+		 * \param factor The downsampling factor of the level.
+		 * \param coarse The returned configuration.
+		 * \return false if the downsampled window is smaller than the feature.
+		 * \date 19/10/2026
+		 */
+		bool getCoarseConfig( const nor_utils::Rect& r, int factor, nor_utils::Rect& coarse ) const;
+		
+		/**
+		 * Get the blocks of a configuration. It will be overridden by the derived
+		 * classes, and must follow the same computation as getValue.
+		 * \param r The configuration of the feature.
+		 * \param corners The returned blocks.
+		 * \see HaarCorners
+		 * \date 18/10/2026
+		 */
+		virtual void getCorners(const nor_utils::Rect& r, HaarCorners& corners) = 0;
+		
+		/**
+		 * Get the pixel edges of a block returned by getCorners, so that the block
+		 * can be mapped onto a window of any size and position. The block covers
+		 * the pixels with left <= x < right and top <= y < bottom.
+		 * \param corners The corners of the block (see HaarCorners).
+		 * \param left The returned left edge.
+		 * \param top The returned top edge.
+		 * \param right The returned right edge.
+		 * \param bottom The returned bottom edge.
+		 * \see setBlock
+		 * \date 18/10/2026
+		 */
+		static void getBlockEdges(const int* corners, int& left, int& top, 
+								  int& right, int& bottom);
 		
 		/**
 		 * Get the feature output given a single example (in integral image format).
@@ -353,6 +579,33 @@ namespace MultiBoost {
 		 */
 		virtual FeatureReal getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r) = 0;
 		
+		/**
+		 * Get the feature output of an image of a block. The blocks of the 
+		 * configuration are summed as in fillHaarData, so the output is the
+		 * same, and with the integer types it is exact.
+		 * \param block The integral images.
+		 * \param column The column of the image in the block.
+		 * \param r The configuration of the feature.
+		 * \see HaarImageBlock
+		 * \date 18/10/2026
+		 */
+		FeatureReal getValue(const HaarImageBlock& block, int column, const nor_utils::Rect& r);
+		
+		/**
+		 * Get the largest area of a block among all the configurations of all the
+		 * registered feature types, in the current window (see HaarData::areaWidth).
+		 * Multiplied by the largest pixel value it bounds the sums of the blocks.
+		 * \date 18/10/2026
+		 */
+		static int getMaxBlockArea();
+		
+		/**
+		 * Get a configuration from its index in the list of pre-computed configurations.
+		 * \param idx The index of the configuration (see getLoadedConfigIndex).
+		 * \date 18/10/2026
+		 */
+		const nor_utils::Rect& getConfigByNum( int idx ) const { return _precomputedConfigs[idx]; }
+		
 		virtual int getLoadedConfigIndex() { return _loadedConfigIndex; }
 		virtual void loadConfigByNum( int idx ); 
 		
@@ -370,6 +623,16 @@ namespace MultiBoost {
 		 */
 		FeatureReal getSumAt(const vector<FeatureReal>& intImage, int x, int y);
 		
+		/**
+		 * Set the corners of a block, given the coordinates of the corners 
+		 * 4, 1, 2 and 3 as in getValue.
+		 * \param corners The returned corners.
+		 * \see getCorners
+		 * \date 18/10/2026
+		 */
+		void setBlock(int* corners, int x4, int y4, int x1, int y1, 
+					  int x2, int y2, int x3, int y3);
+		
 		string       _shortName; //!< The short name of the Haar-like feature. 
 		
 	private:
@@ -417,36 +680,6 @@ namespace MultiBoost {
 		vector<nor_utils::Rect>::const_iterator _configIt;
 		
 		int _loadedConfigIndex; 
-		
-		/**
-		 * Convert the vector of all the examples (in integral image format) into
-		 * a vector of features outputs, using the current configuration.
-		 * The pair represent the original index of the example, where the second
-		 * element is the feature's output. This method statically call the derived
-		 * method to avoid the virtual calling.
-		 * \param intImages The vector with the examples to be converted.
-		 * \param haarData The returned vector of features outputs.
-		 * \see fillHaarData.
-		 * \date 27/12/2005
-		 */
-		template <typename TDeriv>
-		void _fillHaarData( const vector<Example>& intImages, // input 
-						   vector< pair<int, FeatureReal> >& haarData ) // output
-		{
-			int i;
-			vector<Example>::const_iterator iiIt;
-			const vector<Example>::const_iterator iiEnd = intImages.end();
-			
-			vector< pair<int, FeatureReal> >::iterator hIt;
-			const nor_utils::Rect& currConfig = getCurrentConfig();
-			
-			for (iiIt = intImages.begin(), hIt = haarData.begin(), i = 0;
-				 iiIt != iiEnd; ++iiIt, ++hIt, ++i)
-			{
-				hIt->first = i;
-				hIt->second = static_cast<TDeriv&>(*this).getValue(iiIt->getValues(), currConfig);
-			}
-		}
 	};
 	
 	// ------------------------------------------------------------------------------
@@ -502,6 +735,14 @@ namespace MultiBoost {
 		 * \date 27/12/2005
 		 */
 		virtual FeatureReal getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r);
+		
+		/**
+		 * Get the blocks of the configuration.
+		 * \param r The configuration of the feature.
+		 * \param corners The returned blocks.
+		 * \date 18/10/2026
+		 */
+		virtual void getCorners(const nor_utils::Rect& r, HaarCorners& corners);
 	};
 	
 	// ------------------------------------------------------------------------------
@@ -558,6 +799,14 @@ namespace MultiBoost {
 		 * \date 27/12/2005
 		 */
 		virtual FeatureReal getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r);
+		
+		/**
+		 * Get the blocks of the configuration.
+		 * \param r The configuration of the feature.
+		 * \param corners The returned blocks.
+		 * \date 18/10/2026
+		 */
+		virtual void getCorners(const nor_utils::Rect& r, HaarCorners& corners);
 	};
 	
 	// ------------------------------------------------------------------------------
@@ -616,6 +865,14 @@ namespace MultiBoost {
 		 * \date 27/12/2005
 		 */
 		virtual FeatureReal getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r);
+		
+		/**
+		 * Get the blocks of the configuration.
+		 * \param r The configuration of the feature.
+		 * \param corners The returned blocks.
+		 * \date 18/10/2026
+		 */
+		virtual void getCorners(const nor_utils::Rect& r, HaarCorners& corners);
 	};
 	
 	// ------------------------------------------------------------------------------
@@ -668,6 +925,14 @@ namespace MultiBoost {
 		 * \date 27/12/2005
 		 */
 		virtual FeatureReal getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r);
+		
+		/**
+		 * Get the blocks of the configuration.
+		 * \param r The configuration of the feature.
+		 * \param corners The returned blocks.
+		 * \date 18/10/2026
+		 */
+		virtual void getCorners(const nor_utils::Rect& r, HaarCorners& corners);
 	};
 	
 	// ------------------------------------------------------------------------------
@@ -726,6 +991,14 @@ namespace MultiBoost {
 		 * \date 27/12/2005
 		 */
 		virtual FeatureReal getValue(const vector<FeatureReal>& intImage, const nor_utils::Rect& r);
+		
+		/**
+		 * Get the blocks of the configuration.
+		 * \param r The configuration of the feature.
+		 * \param corners The returned blocks.
+		 * \date 18/10/2026
+		 */
+		virtual void getCorners(const nor_utils::Rect& r, HaarCorners& corners);
 	};
 	
 	// ------------------------------------------------------------------------------
@@ -76,6 +76,44 @@ void HaarLearner::declareArguments(nor_utils::Args& args)
                         "Example: -iisize 128x64", 
                         1, "<width>x<height>");
 
+   args.declareArgument("haarcache", 
+                        "Keep the sorted outputs of the evaluated configurations in memory, up to "
+                        "the given size in megabytes. The least recently used configurations are "
+                        "dropped first. A configuration found in the cache only costs the threshold search.\n"
+                        "Example: -haarcache 512", 
+                        1, "<MB>");
+
+   args.declareArgument("haartopk", 
+                        "At the end of the training, save the outputs of the <K> configurations "
+                        "selected most often in <file>. The next trainings on the same data map "
+                        "this file and do not compute these configurations.\n"
+                        "Example: -haartopk 100 faces.topk", 
+                        2, "<K> <file>");
+
+   args.declareArgument("haarcompact",
+                        "Store the integral images as 16 bits integers instead of floats, "
+                        "or as 32 bits integers when the sums do not fit in 16 bits. The images must have non-negative integer pixels. "
+                        "The outputs of the features are unchanged.\n"
+                        "Not available with -bootstrap.",
+                        0, "");
+
+   args.declareArgument("hbins", 
+                        "Search the threshold of each configuration on a histogram of its outputs, "
+                        "with the given number of bins, instead of sorting the outputs. It is faster "
+                        "but the thresholds are restricted to the limits of the bins.\n"
+                        "Not available for HaarMultiStump.\n"
+                        "Example: -hbins 256", 
+                        1, "<bins>");
+
+   args.declareArgument("haarpyramid", 
+                        "Search the configurations from coarse to fine: they are first scored "
+                        "on the integral images downsampled by 2^<levels>, ..., 4 and 2, and at each "
+                        "level only the configurations of the best <fraction> are kept. The remaining "
+                        "ones are evaluated at full resolution.\n"
+                        "Not available for HaarMultiStump and UCBVHaarSingleStump, nor with -csample time.\n"
+                        "Example: -haarpyramid 2 0.1", 
+                        2, "<levels> <fraction>");
+
 }
 
 // ------------------------------------------------------------------------------
@@ -96,6 +134,34 @@ void HaarLearner::initOptions(const nor_utils::Args& args)
          _samplingType = ST_TIME;
    }
 
+   if (args.hasArgument("haarpyramid"))
+   {
+      _pyramidLevels = args.getValue<int>("haarpyramid", 0);
+      _pyramidFraction = args.getValue<double>("haarpyramid", 1);
+      if (_pyramidLevels < 1 || _pyramidFraction <= 0 || _pyramidFraction > 1)
+      {
+         cerr << "ERROR: -haarpyramid needs at least one level and a fraction in (0, 1]!" << endl;
+         exit(1);
+      }
+
+      // the time budget is spent on the drawing of the configurations
+      if (_samplingType == ST_TIME)
+      {
+         cerr << "Warning: -haarpyramid is ignored with -csample time!" << endl;
+         _pyramidLevels = 0;
+      }
+   }
+
+   if (args.hasArgument("hbins"))
+   {
+      _numHistogramBins = args.getValue<int>("hbins", 0);
+      if (_numHistogramBins < 2)
+      {
+         cerr << "ERROR: the number of bins of -hbins must be at least 2!" << endl;
+         exit(1);
+      }
+   }
+
 }
 
 // ------------------------------------------------------------------------------
@@ -143,6 +209,9 @@ void HaarLearner::subCopyState(HaarLearner *pHaarLearner)
    pHaarLearner->_selectedConfig.height = _selectedConfig.height;
    pHaarLearner->_samplingType = _samplingType;
    pHaarLearner->_samplingVal = _samplingVal;
+   pHaarLearner->_numHistogramBins = _numHistogramBins;
+   pHaarLearner->_pyramidLevels = _pyramidLevels;
+   pHaarLearner->_pyramidFraction = _pyramidFraction;
 }
 
 // ------------------------------------------------------------------------------
@@ -85,7 +85,8 @@ public:
    * \date 16/12/2005
    */
    HaarLearner() : 
-      _pSelectedFeature(NULL), _samplingType(ST_NO_SAMPLING), _samplingVal(0) {}
+      _pSelectedFeature(NULL), _samplingType(ST_NO_SAMPLING), _samplingVal(0), _numHistogramBins(0),
+      _pyramidLevels(0), _pyramidFraction(1) {}
 
    /**
    * The destructor. Must be declared (virtual) for the proper destruction of 
@@ -146,6 +147,13 @@ public:
    virtual void subCopyState(HaarLearner *pHaarLearner);
 
 	virtual nor_utils::Rect& getSelectedConfig() { return _selectedConfig; }
+
+   /**
+   * Get the selected feature type.
+   * \see _pSelectedFeature
+   * \date 18/10/2026
+   */
+   HaarFeature* getSelectedFeature() { return _pSelectedFeature; }
 protected:
 
    /**
@@ -194,6 +202,28 @@ protected:
    */
    int           _samplingVal;
 
+   /**
+   * The number of bins of the histogram used to search the threshold on the
+   * outputs of a configuration, instead of sorting them. 0 if the outputs are sorted.
+   * \see StumpAlgorithm::findSingleThresholdHistogramWithInit
+   * \date 18/10/2026
+   */
+   int           _numHistogramBins;
+
+   /**
+   * The number of downsampled levels of the coarse to fine search of the
+   * configurations, 0 if all the configurations are evaluated at full resolution.
+   * \see HaarData::getPyramidBlock
+   * \date 19/10/2026
+   */
+   int           _pyramidLevels;
+
+   /**
+   * The fraction of the configurations of the coarse to fine search kept at each level.
+   * \date 19/10/2026
+   */
+   double        _pyramidFraction;
+
 };
 
 } // end of namespace MultiBoost
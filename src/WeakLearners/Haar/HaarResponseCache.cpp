@@ -0,0 +1,315 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+
+#include "HaarResponseCache.h"
+#include "Utils/RadixSort.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring> // for memcpy, memcmp
+
+namespace MultiBoost {
+	
+	namespace {
+		
+		const char TOPK_MAGIC[8] = { 'M', 'B', 'H', 'A', 'A', 'R', 'K', '1' };
+		
+		/**
+		 * The header of the file of the most selected configurations. It is followed
+		 * by numEntries (key, count) pairs, and then by the numEntries vectors of
+		 * sorted outputs of numExamples (index, value) pairs.
+		 */
+		struct TopKHeader
+		{
+			char				magic[8];
+			int					numExamples;
+			int					numPixels;
+			int					numEntries;
+			int					entrySize;
+			unsigned long long	blockHash;
+		};
+		
+		// FNV-1a
+		inline void hashBytes( unsigned long long& hash, const void* pData, size_t size )
+		{
+			const unsigned char* pBytes = static_cast<const unsigned char*>(pData);
+			for ( size_t b = 0; b < size; ++b )
+			{
+				hash ^= pBytes[b];
+				hash *= 1099511628211ULL;
+			}
+		}
+		
+		/**
+		 * Sort the configurations by decreasing number of selections, then by key.
+		 */
+		bool moreSelected( const pair<long long, long long>& el1, const pair<long long, long long>& el2 )
+		{
+			if ( el1.second != el2.second )
+				return el1.second > el2.second;
+			return el1.first < el2.first;
+		}
+		
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarResponseCache::attach(const HaarImageBlock& block)
+	{
+		lock_guard<mutex> lock(_mutex);
+		
+		_lruList.clear();
+		_lruEntries.clear();
+		_usedMemory = 0;
+		
+		_mappedFile.close();
+		_mappedEntries.clear();
+		
+		_pBlock = &block;
+		
+		_blockHash = 14695981039346656037ULL;
+		// only the lanes of the images in use
+		const int numImages = block.getNumImages();
+		const size_t pixelSize = HAAR_BATCH_WIDTH * block.getValueSize();
+		for (int first = 0, t = 0; first < numImages; first += HAAR_BATCH_WIDTH, ++t)
+		{
+			const unsigned char* pTile = block.getTile<unsigned char>(t);
+			const size_t lanesSize = min(HAAR_BATCH_WIDTH, numImages - first) * block.getValueSize();
+			for (int p = 0; p < block.getNumPixels(); ++p)
+				hashBytes( _blockHash, pTile + p * pixelSize, lanesSize );
+		}
+		
+		if ( _topK > 0 )
+			attachTopKFile();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	bool HaarResponseCache::attachTopKFile()
+	{
+		if ( !_mappedFile.open(_topKFileName) )
+			return false;
+		
+		const int numImages = _pBlock->getNumImages();
+		
+		TopKHeader header;
+		bool isValid = _mappedFile.size() >= sizeof(header);
+		if ( isValid )
+		{
+			memcpy( &header, _mappedFile.data(), sizeof(header) );
+			isValid = memcmp( header.magic, TOPK_MAGIC, sizeof(header.magic) ) == 0 &&
+					  header.numExamples == numImages &&
+					  header.numPixels == _pBlock->getNumPixels() &&
+					  header.entrySize == (int)sizeof(Responses::value_type) &&
+					  header.blockHash == _blockHash &&
+					  header.numEntries >= 0 &&
+					  _mappedFile.size() == sizeof(header) + 
+					  header.numEntries * ( 2 * sizeof(long long) + numImages * sizeof(Responses::value_type) );
+		}
+		
+		if ( !isValid )
+		{
+			_mappedFile.close();
+			return false;
+		}
+		
+		vector<long long> keysAndCounts( 2 * header.numEntries );
+		if ( header.numEntries > 0 )
+			memcpy( &keysAndCounts[0], _mappedFile.data() + sizeof(header), keysAndCounts.size() * sizeof(long long) );
+		
+		for (int e = 0; e < header.numEntries; ++e)
+		{
+			_mappedEntries[ keysAndCounts[2 * e] ] = e;
+			
+			// the configurations selected by the previous trainings stay in the top
+			if ( !_mappedCountsLoaded )
+				_selections[ keysAndCounts[2 * e] ] += keysAndCounts[2 * e + 1];
+		}
+		
+		_mappedCountsLoaded = true;
+		_numMapped = header.numEntries;
+		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	HaarResponseCache::ResponsesPtr HaarResponseCache::find(long long key)
+	{
+		lock_guard<mutex> lock(_mutex);
+		
+		map<long long, LRUList::iterator>::iterator lruIt = _lruEntries.find(key);
+		if ( lruIt != _lruEntries.end() )
+		{
+			// now the most recently used
+			_lruList.splice( _lruList.begin(), _lruList, lruIt->second );
+			return lruIt->second->second;
+		}
+		
+		map<long long, int>::const_iterator mappedIt = _mappedEntries.find(key);
+		if ( mappedIt != _mappedEntries.end() )
+		{
+			const size_t numImages = _pBlock->getNumImages();
+			const Responses::value_type* pBegin = reinterpret_cast<const Responses::value_type*>
+				( _mappedFile.data() + sizeof(TopKHeader) + _numMapped * 2 * sizeof(long long) ) +
+				mappedIt->second * numImages;
+			
+			return ResponsesPtr( new Responses(pBegin, pBegin + numImages) );
+		}
+		
+		return ResponsesPtr();
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarResponseCache::insert(long long key, const Responses& responses)
+	{
+		const size_t entrySize = sizeof(Responses) + responses.size() * sizeof(Responses::value_type);
+		if ( entrySize > _maxMemory )
+			return;
+		
+		ResponsesPtr pResponses( new Responses(responses) );
+		
+		lock_guard<mutex> lock(_mutex);
+		
+		// another thread has been faster
+		if ( _lruEntries.find(key) != _lruEntries.end() )
+			return;
+		
+		while ( _usedMemory + entrySize > _maxMemory && !_lruList.empty() )
+		{
+			const pair<long long, ResponsesPtr>& last = _lruList.back();
+			_usedMemory -= sizeof(Responses) + last.second->size() * sizeof(Responses::value_type);
+			_lruEntries.erase( last.first );
+			_lruList.pop_back();
+		}
+		
+		_lruList.push_front( make_pair(key, pResponses) );
+		_lruEntries[key] = _lruList.begin();
+		_usedMemory += entrySize;
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	void HaarResponseCache::markSelected(long long key)
+	{
+		lock_guard<mutex> lock(_mutex);
+		++_selections[key];
+	}
+	
+	// ------------------------------------------------------------------------
+	
+	bool HaarResponseCache::saveTopK(const vector<HaarFeature*>& features)
+	{
+		if ( _topK <= 0 || _pBlock == NULL || _selections.empty() )
+			return true;
+		
+		vector< pair<long long, long long> > ranking( _selections.begin(), _selections.end() );
+		sort( ranking.begin(), ranking.end(), moreSelected );
+		
+		// keep only the configurations of the loaded feature types
+		vector< pair<long long, HaarFeature*> > topConfigs;
+		for (size_t i = 0; i < ranking.size() && (int)topConfigs.size() < _topK; ++i)
+		{
+			const eFeatureType type = static_cast<eFeatureType>( ranking[i].first >> 32 );
+			vector<HaarFeature*>::const_iterator fIt;
+			for (fIt = features.begin(); fIt != features.end(); ++fIt)
+			{
+				if ( (*fIt)->getType() == type )
+				{
+					topConfigs.push_back( make_pair(ranking[i].first, *fIt) );
+					break;
+				}
+			}
+		}
+		
+		const int numEntries = static_cast<int>( topConfigs.size() );
+		const int numImages = _pBlock->getNumImages();
+		
+		TopKHeader header;
+		memset( &header, 0, sizeof(header) );
+		memcpy( header.magic, TOPK_MAGIC, sizeof(header.magic) );
+		header.numExamples = numImages;
+		header.numPixels = _pBlock->getNumPixels();
+		header.numEntries = numEntries;
+		header.entrySize = (int)sizeof(Responses::value_type);
+		header.blockHash = _blockHash;
+		
+		vector<long long> keysAndCounts( 2 * numEntries );
+		vector<ResponsesPtr> allResponses( numEntries );
+		
+		nor_utils::PairRadixSorter sorter;
+		for (int e = 0; e < numEntries; ++e)
+		{
+			const long long key = topConfigs[e].first;
+			keysAndCounts[2 * e] = key;
+			keysAndCounts[2 * e + 1] = _selections[key];
+			
+			allResponses[e] = find(key);
+			if ( !allResponses[e] )
+			{
+				HaarFeature* pFeature = topConfigs[e].second;
+				const int configIdx = static_cast<int>( key & 0xFFFFFFFFLL );
+				
+				Responses* pResponses = new Responses(numImages);
+				pFeature->fillHaarData( *_pBlock, *pResponses, pFeature->getConfigByNum(configIdx) );
+				sorter.sort( *pResponses );
+				allResponses[e] = ResponsesPtr(pResponses);
+			}
+		}
+		
+		vector< pair<const char*, size_t> > chunks;
+		chunks.push_back( make_pair( reinterpret_cast<const char*>(&header), sizeof(header) ) );
+		if ( numEntries > 0 )
+			chunks.push_back( make_pair( reinterpret_cast<const char*>(&keysAndCounts[0]), 
+										 keysAndCounts.size() * sizeof(long long) ) );
+		for (int e = 0; e < numEntries; ++e)
+		{
+			if ( numImages > 0 )
+				chunks.push_back( make_pair( reinterpret_cast<const char*>( &(*allResponses[e])[0] ), 
+											 numImages * sizeof(Responses::value_type) ) );
+		}
+		
+		if ( !MappedFile::writeAtomically( _topKFileName, chunks ) )
+		{
+			cerr << "Warning: cannot write the Haar outputs file <" << _topKFileName << ">." << endl;
+			return false;
+		}
+		
+		return true;
+	}
+	
+} // end of namespace MultiBoost
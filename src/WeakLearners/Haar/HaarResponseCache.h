@@ -0,0 +1,194 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+
+
+
+/**
+ * \file HaarResponseCache.h The cache of the outputs of the Haar configurations.
+ */
+
+#ifndef __HAAR_RESPONSE_CACHE_H
+#define __HAAR_RESPONSE_CACHE_H
+
+#include "WeakLearners/Haar/HaarFeatures.h"
+#include "IO/MappedFile.h"
+
+#include <vector>
+#include <list>
+#include <map>
+#include <string>
+#include <memory> // for shared_ptr
+#include <mutex>
+
+using namespace std;
+
+namespace MultiBoost {
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The outputs of the Haar configurations on the training examples, sorted by value.
+	 * The outputs of a configuration never change during the training (only the
+	 * weights do), so a configuration which is evaluated again only costs the 
+	 * threshold search. The entries are identified by the type of the feature and
+	 * the index of the configuration (see HaarFeature::getLoadedConfigIndex).
+	 *
+	 * Two stores are available:
+	 * - an LRU list in memory, bounded by a number of bytes;
+	 * - a file with the outputs of the K configurations which have been selected
+	 * the most often. It is written at the end of the training and memory-mapped
+	 * by the next trainings on the same data, so that these configurations are
+	 * available from the start.
+	 *
+	 * All the methods can be called by several threads at the same time.
+	 * \see HaarData::getResponseCache
+	 * \date 18/10/2026
+	 */
+	class HaarResponseCache
+	{
+	public:
+		
+		typedef vector< pair<int, FeatureReal> > Responses;
+		typedef shared_ptr<const Responses> ResponsesPtr;
+		
+		HaarResponseCache() 
+		: _maxMemory(0), _usedMemory(0), _topK(0), _pBlock(NULL), _blockHash(0), 
+		  _numMapped(0), _mappedCountsLoaded(false) {}
+		
+		/**
+		 * Set the size of the LRU store. 0 disables it.
+		 * \param maxMemory The size in bytes.
+		 * \date 18/10/2026
+		 */
+		void setMaxMemory(size_t maxMemory) { _maxMemory = maxMemory; }
+		
+		/**
+		 * Set the file of the most selected configurations.
+		 * \param topK The number of configurations saved in the file.
+		 * \param fileName The name of the file.
+		 * \date 18/10/2026
+		 */
+		void setTopK(int topK, const string& fileName) { _topK = topK; _topKFileName = fileName; }
+		
+		/**
+		 * True if one of the stores is used.
+		 */
+		bool isEnabled() const { return _maxMemory > 0 || _topK > 0; }
+		
+		/**
+		 * Start caching the outputs computed on the given images. The entries
+		 * of the previous images are dropped, and the file of the most selected
+		 * configurations is mapped if it has been computed on the same images.
+		 * \param block The integral images.
+		 * \date 18/10/2026
+		 */
+		void attach(const HaarImageBlock& block);
+		
+		/**
+		 * Get the key of a configuration.
+		 * \param pFeature The feature type.
+		 * \param configIdx The index of the configuration.
+		 * \date 18/10/2026
+		 */
+		static long long getKey(const HaarFeature* pFeature, int configIdx)
+		{ return ( static_cast<long long>(pFeature->getType()) << 32 ) | configIdx; }
+		
+		/**
+		 * Get the sorted outputs of a configuration.
+		 * \param key The key of the configuration.
+		 * \return The outputs, or an empty pointer if they are not cached.
+		 * \date 18/10/2026
+		 */
+		ResponsesPtr find(long long key);
+		
+		/**
+		 * Add the sorted outputs of a configuration to the LRU store. The least 
+		 * recently used entries are dropped to stay within the memory limit.
+		 * \param key The key of the configuration.
+		 * \param responses The outputs. They are copied.
+		 * \date 18/10/2026
+		 */
+		void insert(long long key, const Responses& responses);
+		
+		/**
+		 * Record that a configuration has been selected by the weak learner.
+		 * \param key The key of the configuration.
+		 * \date 18/10/2026
+		 */
+		void markSelected(long long key);
+		
+		/**
+		 * Write the outputs of the most selected configurations to the file set
+		 * by setTopK. The outputs which are not cached are computed again.
+		 * \param features The loaded feature types.
+		 * \return False if the file could not be written.
+		 * \date 18/10/2026
+		 */
+		bool saveTopK(const vector<HaarFeature*>& features);
+		
+	private:
+		
+		/**
+		 * Map the file of the most selected configurations.
+		 * \return False if it does not exist or if it was computed on other images.
+		 */
+		bool attachTopKFile();
+		
+		typedef list< pair<long long, ResponsesPtr> > LRUList;
+		
+		size_t						_maxMemory; //!< The size of the LRU store.
+		size_t						_usedMemory; //!< The bytes used by the LRU store.
+		LRUList						_lruList; //!< The entries, the most recently used first.
+		map<long long, LRUList::iterator>	_lruEntries; //!< The entries by key.
+		
+		map<long long, long long>	_selections; //!< The number of times each configuration has been selected.
+		
+		int							_topK; //!< The number of configurations in the file.
+		string						_topKFileName; //!< The file of the most selected configurations.
+		
+		const HaarImageBlock*		_pBlock; //!< The images the outputs are computed on.
+		unsigned long long			_blockHash; //!< The hash of the images.
+		
+		MappedFile					_mappedFile; //!< The mapped file of the most selected configurations.
+		map<long long, int>			_mappedEntries; //!< The position of the configurations in the file.
+		int							_numMapped; //!< The number of images of the mapped entries.
+		bool						_mappedCountsLoaded; //!< The counts of the file have been added to _selections.
+		
+		mutex						_mutex; //!< Protects all the members.
+	};
+	
+} // end of namespace MultiBoost
+
+#endif // __HAAR_RESPONSE_CACHE_H
@@ -38,14 +38,117 @@
 #include "WeakLearners/Haar/HaarFeatures.h" // for shortname->type and viceversa (see serialization)
 
 #include "Algorithms/StumpAlgorithm.h"
+#include "Utils/RadixSort.h"
 
 #include <limits> // for numeric_limits
 #include <ctime> // for time
 
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 	
 	REGISTER_LEARNER_NAME(HaarMultiStump, HaarMultiStumpLearner)
 	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The body of the parallel search over a batch of configurations of a Haar
+	 * feature type. Each copy has its own scratch vectors and its own StumpAlgorithm,
+	 * and keeps the first configuration (in the batch order) with the lowest energy.
+	 * \date 19/10/2026
+	 */
+	class HaarMultiConfigSearch {
+	public:
+		HaarMultiConfigSearch(HaarMultiStumpLearner* pLearner, HaarFeature* pFeature, 
+							  const vector<nor_utils::Rect>& configs, const HaarImageBlock& intImages,
+							  const StumpAlgorithm<FeatureReal>& sAlgo)
+		: _pLearner(pLearner), _pFeature(pFeature), _pConfigs(&configs), _pIntImages(&intImages), 
+		  _sAlgo(sAlgo)
+		{ init(); }
+		
+		HaarMultiConfigSearch(HaarMultiConfigSearch& other, split)
+		: _pLearner(other._pLearner), _pFeature(other._pFeature), _pConfigs(other._pConfigs), 
+		  _pIntImages(other._pIntImages), _sAlgo(other._sAlgo)
+		{ init(); }
+		
+		void operator()( const blocked_range<int>& range ) {
+			InputData* pData = _pLearner->_pTrainingData;
+			
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				// transform the data from intImages to the feature's space
+				_pFeature->fillHaarData( *_pIntImages, _processedHaarData, (*_pConfigs)[i] );
+				// sort the examples in the new space by their coordinate
+				_sorter.sort( _processedHaarData );
+				
+				// find the optimal thresholds
+				_sAlgo.findMultiThresholdsWithInit(_processedHaarData.begin(), _processedHaarData.end(), 
+												   pData, _tmpThresholds, &_mu, &_tmpV);
+				
+				AlphaReal tmpAlpha;
+				AlphaReal tmpEnergy = _pLearner->getEnergy(_mu, tmpAlpha, _tmpV);
+				
+				if (tmpEnergy < _bestEnergy)
+				{
+					_bestIdx = i;
+					_bestEnergy = tmpEnergy;
+					_bestAlpha = tmpAlpha;
+					_bestV = _tmpV;
+					_bestThresholds = _tmpThresholds;
+				}
+			}
+		}
+		
+		void join( const HaarMultiConfigSearch& other ) {
+			if ( other._bestIdx < 0 ) return;
+			if ( _bestIdx < 0 || other._bestEnergy < _bestEnergy ||
+				( other._bestEnergy == _bestEnergy && other._bestIdx < _bestIdx ) )
+			{
+				_bestIdx = other._bestIdx;
+				_bestEnergy = other._bestEnergy;
+				_bestAlpha = other._bestAlpha;
+				_bestV = other._bestV;
+				_bestThresholds = other._bestThresholds;
+			}
+		}
+		
+		int					_bestIdx; //!< The index of the best configuration, -1 if none.
+		AlphaReal			_bestEnergy;
+		AlphaReal			_bestAlpha;
+		vector<AlphaReal>	_bestV;
+		vector<FeatureReal>	_bestThresholds;
+		
+	private:
+		
+		void init() {
+			const int numClasses = _pLearner->_pTrainingData->getNumClasses();
+			_processedHaarData.resize( _pIntImages->getNumImages() );
+			_mu.resize( numClasses );
+			_tmpV.resize( numClasses );
+			_tmpThresholds.resize( numClasses );
+			_bestIdx = -1;
+			_bestEnergy = numeric_limits<AlphaReal>::max();
+		}
+		
+		HaarMultiStumpLearner*			_pLearner;
+		HaarFeature*					_pFeature;
+		const vector<nor_utils::Rect>*	_pConfigs;
+		const HaarImageBlock*			_pIntImages;
+		
+		StumpAlgorithm<FeatureReal>		_sAlgo;
+		
+		vector< pair<int, FeatureReal> >	_processedHaarData; //!< The data transformed into the feature's space.
+		nor_utils::PairRadixSorter			_sorter; //!< Sorts _processedHaarData (its buffer is reused).
+		vector<sRates>						_mu; //!< The class-wise rates.
+		vector<AlphaReal>					_tmpV; //!< The class-wise votes/abstentions.
+		vector<FeatureReal>					_tmpThresholds; //!< The class-wise thresholds.
+	};
+	
+	// ------------------------------------------------------------------------------
+	
 	// ------------------------------------------------------------------------------
 	
 	void HaarMultiStumpLearner::declareArguments(nor_utils::Args& args)
@@ -62,6 +165,12 @@ namespace MultiBoost {
 		// call the superclasses
 		HaarLearner::initOptions(args);
 		MultiStumpLearner::initLearningOptions(args);
+		
+		if (_numHistogramBins > 0)
+		{
+			cerr << "Warning: -hbins is not available with HaarMultiStump, the outputs are sorted." << endl;
+			_numHistogramBins = 0;
+		}
 	}
 	
 	// ------------------------------------------------------------------------------
@@ -72,8 +181,8 @@ namespace MultiBoost {
 		// feature's space. This is done by getValue of the selected feature.
 		return _v[classIdx] *
 		HaarMultiStumpLearner::phi( 
-								   _pSelectedFeature->getValue( 
-															   pData->getValues(idx), _selectedConfig ),
+								   static_cast<HaarData*>(pData)->getHaarValue( 
+															   idx, _pSelectedFeature, _selectedConfig ),
 								   //static_cast<HaarData*>(pData)->getIntImage(idx), _selectedConfig ),
 								   classIdx );
 		
@@ -89,22 +198,12 @@ namespace MultiBoost {
 		// when theta=0.
 		setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
 		
-		vector<sRates> mu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-		
-		vector<FeatureReal> tmpThresholds(numClasses);
-		AlphaReal tmpAlpha;
-		
 		AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
-		AlphaReal tmpEnergy;
 		
 		HaarData* pHaarData = static_cast<HaarData*>(_pTrainingData);
 		
-		// get the whole data matrix
-		//   const vector<int*>& intImages = pHaarData->getIntImageVector();
-		
-		// The data matrix transformed into the feature's space
-		vector< pair<int, FeatureReal> > processedHaarData(_pTrainingData->getNumExamples());
+		// get the whole data matrix (once, it is shared by the threads)
+		const HaarImageBlock& intImages = pHaarData->getImageBlock();
 		
 		// I need to prepare both type of sampling
 		int numConf; // for ST_NUM
@@ -116,6 +215,10 @@ namespace MultiBoost {
 		StumpAlgorithm<FeatureReal> sAlgo(numClasses);
 		sAlgo.initSearchLoop(_pTrainingData);
 		
+		// The batch of configurations evaluated in parallel
+		vector<nor_utils::Rect> configs;
+		configs.reserve(HAAR_CONFIG_BATCH_SIZE);
+		
 		// The declared features types
 		vector<HaarFeature*>& loadedFeatures = pHaarData->getLoadedFeatures();
 		
@@ -141,70 +244,74 @@ namespace MultiBoost {
 				cout << "Learning type " << pCurrFeature->getName() << ".." << flush;
 			
 			// While there is a configuration available
-			while ( pCurrFeature->hasConfigs() ) 
+			while ( !quitConfiguration && pCurrFeature->hasConfigs() ) 
 			{
-				// transform the data from intImages to the feature's space
-				pCurrFeature->fillHaarData(_pTrainingData->getExamples(), processedHaarData);
-				// sort the examples in the new space by their coordinate
-				sort( processedHaarData.begin(), processedHaarData.end(), 
-					 nor_utils::comparePair<2, int, float, less<float> >() );
-				
-				// find the optimal threshold
-				sAlgo.findMultiThresholdsWithInit(processedHaarData.begin(), processedHaarData.end(), 
-												  _pTrainingData, tmpThresholds, &mu, &tmpV);
+				// draw the next batch of configurations, in the same order
+				// as the sequential search
+				configs.clear();
+				while ( pCurrFeature->hasConfigs() && (int)configs.size() < HAAR_CONFIG_BATCH_SIZE )
+				{
+					configs.push_back( pCurrFeature->getCurrentConfig() );
+					
+					// Move to the next configuration
+					pCurrFeature->moveToNextConfig();
+					
+					// check stopping criterion for random configurations
+					switch (_samplingType)
+					{
+						case ST_NUM:
+							++numConf;
+							if (numConf >= _samplingVal)
+								quitConfiguration = true;
+							break;
+						case ST_TIME:            
+						{
+							time( &currentTime );
+							float diff = difftime(currentTime, startTime); // difftime is in seconds
+							if (diff >= _samplingVal)
+								quitConfiguration = true;
+						}
+							break;
+						case ST_NO_SAMPLING:
+							perror("ERROR: st no sampling... not sure what this means");
+							
+							break;
+							
+					} // end switch
+					
+					if (quitConfiguration)
+						break;
+				}
 				
-				tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
-				++numProcessed;
+				HaarMultiConfigSearch search(this, pCurrFeature, configs, intImages, sAlgo);
+				parallel_reduce( blocked_range<int>( 0, (int)configs.size() ), search );
+				numProcessed += configs.size();
 				
-				if (tmpEnergy < bestEnergy)
+				// the earlier batches win the ties, as in the sequential search
+				if (search._bestIdx >= 0 && search._bestEnergy < bestEnergy)
 				{
 					// Store it in the current weak hypothesis.
-					// note: I don't really like having so many temp variables
-					// but the alternative would be a structure, which would need
-					// to be inheritable to make things more consistent. But this would
-					// make it less flexible. Therefore, I am still undecided. This
-					// might change!
-					_alpha = tmpAlpha;
-					_v = tmpV;
+					_alpha = search._bestAlpha;
+					_v = search._bestV;
 					
 					// I need to save the configuration because it changes within the object
-					_selectedConfig = pCurrFeature->getCurrentConfig();
+					_selectedConfig = configs[search._bestIdx];
 					// I save the object because it contains the informations about the type,
 					// the name, etc..
 					_pSelectedFeature = pCurrFeature;
-					_thresholds = tmpThresholds;
+					_thresholds = search._bestThresholds;
 					
-					bestEnergy = tmpEnergy;
+					bestEnergy = search._bestEnergy;
 				}
 				
-				// Move to the next configuration
-				pCurrFeature->moveToNextConfig();
-				
-				// check stopping criterion for random configurations
-				switch (_samplingType)
+				// the evaluation of the batch counts in the time budget too
+				if (_samplingType == ST_TIME)
 				{
-					case ST_NUM:
-						++numConf;
-						if (numConf >= _samplingVal)
-							quitConfiguration = true;
-						break;
-					case ST_TIME:            
-					{
-						time( &currentTime );
-						float diff = difftime(currentTime, startTime); // difftime is in seconds
-						if (diff >= _samplingVal)
-							quitConfiguration = true;
-					}
-						break;
-					case ST_NO_SAMPLING:
-						perror("ERROR: st no sampling... not sure what this means");
-						
-						break;
-						
-				} // end switch
-				
-				if (quitConfiguration)
-					break;
+					time( &currentTime );
+					float diff = difftime(currentTime, startTime); // difftime is in seconds
+					if (diff >= _samplingVal)
+						quitConfiguration = true;
+				}
 				
 			} // end while
 			
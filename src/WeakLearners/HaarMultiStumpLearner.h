@@ -53,6 +53,7 @@ using namespace std;
 namespace MultiBoost {
 
 class HaarData;
+class HaarMultiConfigSearch;
 
 /**
 * A learner that uses the Haar-like features for input and the MultiStumpLearner 
@@ -130,6 +131,9 @@ public:
 
    /**
    * Run the learner to build the classifier on the given data.
+   * The configurations are drawn in the same order as a sequential search and
+   * evaluated in parallel by batches (see HAAR_CONFIG_BATCH_SIZE); the selected
+   * one is the first configuration with the lowest energy, as in a sequential search.
    * \param pData The pointer to the data
    * \see MultiStumpLearner::run
    * \date 11/11/2005
@@ -172,6 +176,8 @@ public:
 
 private:
 
+   friend class HaarMultiConfigSearch;
+
    /**
    * A discriminative function. 
    * \remarks Positive or negative do NOT refer to positive or negative classification.
@@ -37,14 +37,326 @@
 #include "IO/Serialization.h"
 #include "WeakLearners/Haar/HaarFeatures.h" // for shortname->type and viceversa (see serialization)
 #include "Algorithms/StumpAlgorithm.h"
+#include "Utils/RadixSort.h"
 
 #include <limits> // for numeric_limits
 #include <ctime> // for time
 
+#include "tbb/parallel_reduce.h"
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+#include "tbb/tick_count.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 	
 	//REGISTER_LEARNER_NAME(HaarSingleStumpLearner, HaarSingleStumpLearner)
 	REGISTER_LEARNER(HaarSingleStumpLearner)
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The body of the parallel search over a batch of Haar configurations.
+	 * Each copy has its own scratch vectors and its own StumpAlgorithm, and keeps the
+	 * first configuration (in the batch order) with the lowest energy.
+	 * \date 18/10/2026
+	 */
+	class HaarConfigSearch {
+	public:
+		/**
+		 * A configuration of a feature type, with its index (for the cache).
+		 */
+		struct HaarConfig
+		{
+			HaarConfig(HaarFeature* pFeature, const nor_utils::Rect& config, int configIdx)
+			: pFeature(pFeature), config(config), configIdx(configIdx) {}
+			
+			HaarFeature*	pFeature;
+			nor_utils::Rect	config;
+			int				configIdx;
+		};
+		
+		HaarConfigSearch(HaarSingleStumpLearner* pLearner, const vector<HaarConfig>& configs,
+						 const HaarImageBlock& intImages, HaarResponseCache* pCache,
+						 const StumpAlgorithm<FeatureReal>& sAlgo, AlphaReal halfTheta)
+		: _pLearner(pLearner), _pConfigs(&configs), _pIntImages(&intImages), _pCache(pCache),
+		  _sAlgo(sAlgo), _halfTheta(halfTheta)
+		{ init(); }
+		
+		HaarConfigSearch(HaarConfigSearch& other, split)
+		: _pLearner(other._pLearner), _pConfigs(other._pConfigs), _pIntImages(other._pIntImages), 
+		  _pCache(other._pCache), _sAlgo(other._sAlgo), _halfTheta(other._halfTheta)
+		{ init(); }
+		
+		void operator()( const blocked_range<int>& range ) {
+			InputData* pData = _pLearner->_pTrainingData;
+			
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				const HaarConfig& config = (*_pConfigs)[i];
+				
+				// the sorted outputs of the configuration, from the cache if possible
+				HaarResponseCache::ResponsesPtr pCached;
+				long long cacheKey = 0;
+				if ( _pCache )
+				{
+					cacheKey = HaarResponseCache::getKey(config.pFeature, config.configIdx);
+					pCached = _pCache->find(cacheKey);
+				}
+				
+				if ( !pCached )
+				{
+					// transform the data from intImages to the feature's space
+					config.pFeature->fillHaarData( *_pIntImages, _processedHaarData, config.config );
+					
+					// sort the examples in the new space by their coordinate
+					// (the cache always holds sorted outputs)
+					if ( _pLearner->_numHistogramBins == 0 || _pCache )
+						_sorter.sort( _processedHaarData );
+					
+					if ( _pCache )
+						_pCache->insert( cacheKey, _processedHaarData );
+				}
+				
+				const vector< pair<int, FeatureReal> >& haarData = pCached ? *pCached : _processedHaarData;
+				
+				FeatureReal tmpThreshold;
+				if ( _pLearner->_numHistogramBins > 0 )
+				{
+					// find the optimal threshold on the histogram of the values
+					tmpThreshold = _sAlgo.findSingleThresholdHistogramWithInit(haarData.begin(), haarData.end(), 
+																			   pData, _halfTheta, 
+																			   _pLearner->_numHistogramBins,
+																			   &_mu, &_tmpV);
+				}
+				else
+				{
+					// find the optimal threshold
+					tmpThreshold = _sAlgo.findSingleThresholdWithInit(haarData.begin(), haarData.end(), 
+																	  pData, _halfTheta, &_mu, &_tmpV);
+				}
+				
+				// no threshold (all the values are equal): the rates are not set.
+				// A sequential search would see the rates of the previous configuration,
+				// which cannot improve on the best energy
+				if ( tmpThreshold != tmpThreshold )
+					continue;
+				
+				AlphaReal tmpAlpha;
+				AlphaReal tmpEnergy = _pLearner->getEnergy(_mu, tmpAlpha, _tmpV);
+				
+				if (tmpEnergy < _bestEnergy)
+				{
+					_bestIdx = i;
+					_bestEnergy = tmpEnergy;
+					_bestAlpha = tmpAlpha;
+					_bestThreshold = tmpThreshold;
+					_bestV = _tmpV;
+				}
+			}
+		}
+		
+		void join( const HaarConfigSearch& other ) {
+			if ( other._bestIdx < 0 ) return;
+			if ( _bestIdx < 0 || other._bestEnergy < _bestEnergy ||
+				( other._bestEnergy == _bestEnergy && other._bestIdx < _bestIdx ) )
+			{
+				_bestIdx = other._bestIdx;
+				_bestEnergy = other._bestEnergy;
+				_bestAlpha = other._bestAlpha;
+				_bestThreshold = other._bestThreshold;
+				_bestV = other._bestV;
+			}
+		}
+		
+		int					_bestIdx; //!< The index of the best configuration, -1 if none.
+		AlphaReal			_bestEnergy;
+		AlphaReal			_bestAlpha;
+		FeatureReal			_bestThreshold;
+		vector<AlphaReal>	_bestV;
+		
+	private:
+		
+		void init() {
+			const int numClasses = _pLearner->_pTrainingData->getNumClasses();
+			_processedHaarData.resize( _pIntImages->getNumImages() );
+			_mu.resize( numClasses );
+			_tmpV.resize( numClasses );
+			_bestIdx = -1;
+			_bestEnergy = numeric_limits<AlphaReal>::max();
+		}
+		
+		HaarSingleStumpLearner*		_pLearner;
+		const vector<HaarConfig>*	_pConfigs;
+		const HaarImageBlock*		_pIntImages;
+		HaarResponseCache*			_pCache; //!< The cache of the outputs, NULL if not used.
+		
+		StumpAlgorithm<FeatureReal>		_sAlgo;
+		AlphaReal						_halfTheta;
+		
+		vector< pair<int, FeatureReal> >	_processedHaarData; //!< The data transformed into the feature's space.
+		nor_utils::PairRadixSorter			_sorter; //!< Sorts _processedHaarData (its buffer is reused).
+		vector<sRates>						_mu; //!< The class-wise rates.
+		vector<AlphaReal>					_tmpV; //!< The class-wise votes/abstentions.
+	};
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The body of the parallel scoring of configurations on a level of the pyramid:
+	 * the energy of the best stump of each configuration on the downsampled images.
+	 * \date 19/10/2026
+	 */
+	class HaarPyramidScore {
+	public:
+		HaarPyramidScore(HaarSingleStumpLearner* pLearner, const vector<HaarConfigSearch::HaarConfig>& configs,
+						 const HaarImageBlock& coarseImages, const HaarImageBlock& intImages, int factor,
+						 const StumpAlgorithm<FeatureReal>& sAlgo, AlphaReal halfTheta, 
+						 vector<AlphaReal>& energies)
+		: _pLearner(pLearner), _pConfigs(&configs), _pCoarseImages(&coarseImages), _pIntImages(&intImages),
+		  _factor(factor), _pSAlgo(&sAlgo), _halfTheta(halfTheta), _pEnergies(&energies) {}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			InputData* pData = _pLearner->_pTrainingData;
+			const int numClasses = pData->getNumClasses();
+			
+			StumpAlgorithm<FeatureReal> sAlgo(*_pSAlgo);
+			vector< pair<int, FeatureReal> > processedHaarData( _pIntImages->getNumImages() );
+			nor_utils::PairRadixSorter sorter;
+			vector<sRates> mu(numClasses);
+			vector<AlphaReal> tmpV(numClasses);
+			
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				const HaarConfigSearch::HaarConfig& config = (*_pConfigs)[i];
+				
+				// the same outputs as at full resolution, from the smaller block
+				if ( !config.pFeature->fillHaarData( *_pCoarseImages, processedHaarData, config.config, _factor ) )
+					config.pFeature->fillHaarData( *_pIntImages, processedHaarData, config.config );
+				
+				FeatureReal tmpThreshold;
+				if ( _pLearner->_numHistogramBins > 0 )
+				{
+					tmpThreshold = sAlgo.findSingleThresholdHistogramWithInit(processedHaarData.begin(), 
+																			  processedHaarData.end(), 
+																			  pData, _halfTheta, 
+																			  _pLearner->_numHistogramBins,
+																			  &mu, &tmpV);
+				}
+				else
+				{
+					sorter.sort( processedHaarData );
+					tmpThreshold = sAlgo.findSingleThresholdWithInit(processedHaarData.begin(), 
+																	 processedHaarData.end(), 
+																	 pData, _halfTheta, &mu, &tmpV);
+				}
+				
+				// no threshold: the configuration is constant on the coarse level
+				if ( tmpThreshold != tmpThreshold )
+				{
+					(*_pEnergies)[i] = numeric_limits<AlphaReal>::max();
+					continue;
+				}
+				
+				AlphaReal tmpAlpha;
+				(*_pEnergies)[i] = _pLearner->getEnergy(mu, tmpAlpha, tmpV);
+			}
+		}
+		
+	private:
+		HaarSingleStumpLearner*						_pLearner;
+		const vector<HaarConfigSearch::HaarConfig>*	_pConfigs;
+		const HaarImageBlock*						_pCoarseImages;
+		const HaarImageBlock*						_pIntImages;
+		int											_factor; //!< The downsampling factor of the level.
+		const StumpAlgorithm<FeatureReal>*			_pSAlgo;
+		AlphaReal									_halfTheta;
+		
+		vector<AlphaReal>*							_pEnergies;
+	};
+	
+	// ------------------------------------------------------------------------------
+	
+	/**
+	 * Prune the configurations of a feature type from coarse to fine. At each level
+	 * of the pyramid (the coarsest first) the configurations are grouped by their
+	 * coarse configuration (see HaarFeature::getCoarseConfig), the coarse configurations
+	 * are scored on the downsampled images, and only the configurations of the best
+	 * \a fraction of them are kept. The order of the configurations is preserved.
+	 * \date 19/10/2026
+	 */
+	static void pruneConfigs( HaarSingleStumpLearner* pLearner, HaarData* pHaarData, 
+							 vector<HaarConfigSearch::HaarConfig>& configs,
+							 const StumpAlgorithm<FeatureReal>& sAlgo, AlphaReal halfTheta,
+							 int numLevels, double fraction )
+	{
+		const HaarImageBlock& intImages = pHaarData->getImageBlock();
+		
+		for (int l = numLevels; l >= 1 && !configs.empty(); --l)
+		{
+			const int factor = 1 << l;
+			
+			// the coarse configurations, and the one of each configuration
+			// (-1 if the feature does not fit in the downsampled window)
+			vector<HaarConfigSearch::HaarConfig> coarseConfigs;
+			vector<int> coarseIdx( configs.size() );
+			map<long long, int> coarseMap;
+			
+			for (int i = 0; i < (int)configs.size(); ++i)
+			{
+				nor_utils::Rect coarse;
+				if ( !configs[i].pFeature->getCoarseConfig(configs[i].config, factor, coarse) )
+				{
+					coarseIdx[i] = -1;
+					continue;
+				}
+				
+				const long long key = ( ( ( (long long)(unsigned short)coarse.x << 16 ) | 
+										 (unsigned short)coarse.y ) << 32 ) |
+									  ( (long long)(unsigned short)coarse.width << 16 ) | 
+									  (unsigned short)coarse.height;
+				
+				map<long long, int>::iterator it = coarseMap.find(key);
+				if ( it == coarseMap.end() )
+				{
+					it = coarseMap.insert( make_pair(key, (int)coarseConfigs.size()) ).first;
+					coarseConfigs.push_back( HaarConfigSearch::HaarConfig(configs[i].pFeature, coarse, -1) );
+				}
+				coarseIdx[i] = it->second;
+			}
+			
+			if ( coarseConfigs.empty() )
+				continue;
+			
+			vector<AlphaReal> energies( coarseConfigs.size() );
+			parallel_for( blocked_range<int>( 0, (int)coarseConfigs.size() ), 
+						  HaarPyramidScore(pLearner, coarseConfigs, pHaarData->getPyramidBlock(l), intImages, 
+										   factor, sAlgo, halfTheta, energies) );
+			
+			// keep the best fraction (the first ones win the ties)
+			vector< pair<AlphaReal, int> > ranking( coarseConfigs.size() );
+			for (int c = 0; c < (int)coarseConfigs.size(); ++c)
+				ranking[c] = make_pair( energies[c], c );
+			
+			const int numKept = max( 1, (int)ceil( fraction * coarseConfigs.size() ) );
+			partial_sort( ranking.begin(), ranking.begin() + numKept, ranking.end() );
+			
+			vector<char> isKept( coarseConfigs.size(), 0 );
+			for (int c = 0; c < numKept; ++c)
+				isKept[ ranking[c].second ] = 1;
+			
+			vector<HaarConfigSearch::HaarConfig> keptConfigs;
+			keptConfigs.reserve( configs.size() );
+			for (int i = 0; i < (int)configs.size(); ++i)
+			{
+				if ( coarseIdx[i] < 0 || isKept[ coarseIdx[i] ] )
+					keptConfigs.push_back( configs[i] );
+			}
+			configs.swap( keptConfigs );
+		}
+	}
+	
 	// ------------------------------------------------------------------------------
 	
 	void HaarSingleStumpLearner::declareArguments(nor_utils::Args& args)
@@ -71,8 +383,8 @@ namespace MultiBoost {
 		// feature's space. This is done by getValue of the selected feature.
 		return _v[classIdx] *
 		HaarSingleStumpLearner::phi( 
-									_pSelectedFeature->getValue( 
-																pData->getValues(idx), _selectedConfig ),
+									static_cast<HaarData*>(pData)->getHaarValue( 
+																idx, _pSelectedFeature, _selectedConfig ),
 									//static_cast<HaarData*>(pData)->getIntImage(idx), _selectedConfig ),
 									classIdx );
 		
@@ -81,7 +393,7 @@ namespace MultiBoost {
 	
 	AlphaReal HaarSingleStumpLearner::cut( InputData* pData, int idx ) const
 	{
-		FeatureReal val = _pSelectedFeature->getValue(pData->getValues(idx), _selectedConfig );
+		FeatureReal val = static_cast<HaarData*>(pData)->getHaarValue(idx, _pSelectedFeature, _selectedConfig );
 		return	HaarSingleStumpLearner::phi( val );	
 		
 	}
@@ -96,22 +408,16 @@ namespace MultiBoost {
 		// when theta=0.
 		setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
 		
-		vector<sRates> mu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-		
-		FeatureReal tmpThreshold;
-		AlphaReal tmpAlpha;
-		
 		AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
-		AlphaReal tmpEnergy;
 		
 		HaarData* pHaarData = static_cast<HaarData*>(_pTrainingData);
 		
-		// get the whole data matrix
-		//const vector<int*>& intImages = pHaarData->getIntImageVector();
+		// get the whole data matrix (once, it is shared by the threads)
+		const HaarImageBlock& intImages = pHaarData->getImageBlock();
 		
-		// The data matrix transformed into the feature's space
-		vector< pair<int, FeatureReal> > processedHaarData(_pTrainingData->getNumExamples());
+		// the outputs of the configurations evaluated in the previous iterations
+		HaarResponseCache* pCache = pHaarData->getResponseCache();
+		int selectedConfigIdx = -1;
 		
 		// I need to prepare both type of sampling
 		int numConf; // for ST_NUM
@@ -129,6 +435,15 @@ namespace MultiBoost {
 		else
 			halfTheta = 0;
 		
+		// The batch of configurations evaluated in parallel
+		vector<HaarConfigSearch::HaarConfig> configs;
+		configs.reserve(HAAR_CONFIG_BATCH_SIZE);
+		
+		// with the pyramid, all the configurations of a type are drawn in a single
+		// batch, which is pruned from coarse to fine before the evaluation
+		const int numPyramidLevels = min( _pyramidLevels, pHaarData->getPyramidLevels() );
+		const int batchSize = numPyramidLevels > 0 ? numeric_limits<int>::max() : HAAR_CONFIG_BATCH_SIZE;
+		
 		// The declared features types
 		vector<HaarFeature*>& loadedFeatures = pHaarData->getLoadedFeatures();
 		
@@ -149,78 +464,85 @@ namespace MultiBoost {
 			
 			numConf = 0;
 			time( &startTime );
+			tick_count startTick = tick_count::now();
 			
 			if (_verbose > 1)
 				cout << "Learning type " << pCurrFeature->getName() << ".." << flush;
 			
 			// While there is a configuration available
-			while ( pCurrFeature->hasConfigs() ) 
+			while ( !quitConfiguration && pCurrFeature->hasConfigs() ) 
 			{
-				// transform the data from intImages to the feature's space
-				pCurrFeature->fillHaarData( _pTrainingData->getExamples(), processedHaarData );
-				//pCurrFeature->fillHaarData(intImages, processedHaarData);
+				// draw the next batch of configurations, in the same order
+				// as the sequential search
+				configs.clear();
+				while ( pCurrFeature->hasConfigs() && (int)configs.size() < batchSize )
+				{
+					configs.push_back( HaarConfigSearch::HaarConfig(pCurrFeature, pCurrFeature->getCurrentConfig(),
+																	 pCurrFeature->getLoadedConfigIndex()) );
+					
+					// Move to the next configuration
+					pCurrFeature->moveToNextConfig();
+					
+					// check stopping criterion for random configurations
+					switch (_samplingType)
+					{
+						case ST_NUM:
+							++numConf;
+							if (numConf >= _samplingVal)
+								quitConfiguration = true;
+							break;
+						case ST_TIME:            
+						{
+							time( &currentTime );
+							float diff = difftime(currentTime, startTime); // difftime is in seconds
+							if (diff >= _samplingVal)
+								quitConfiguration = true;
+						}
+							break;
+							
+						case ST_NO_SAMPLING:
+							perror("ERROR: What? No sampling??");
+							break;
+							
+					} // end switch
+					
+					if (quitConfiguration)
+						break;
+				}
 				
-				// sort the examples in the new space by their coordinate
-				sort( processedHaarData.begin(), processedHaarData.end(), 
-					 nor_utils::comparePair<2, int, FeatureReal, less<FeatureReal> >() );
+				if ( numPyramidLevels > 0 )
+					pruneConfigs( this, pHaarData, configs, sAlgo, halfTheta, numPyramidLevels, _pyramidFraction );
 				
-				// find the optimal threshold
-				tmpThreshold = sAlgo.findSingleThresholdWithInit(processedHaarData.begin(), 
-																 processedHaarData.end(), 
-																 _pTrainingData, halfTheta, &mu, &tmpV);
-
-				tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
-				++numProcessed;
+				HaarConfigSearch search(this, configs, intImages, pCache, sAlgo, halfTheta);
+				parallel_reduce( blocked_range<int>( 0, (int)configs.size() ), search );
+				numProcessed += configs.size();
 				
-				if (tmpEnergy < bestEnergy)
+				// the earlier batches win the ties, as in the sequential search
+				if (search._bestIdx >= 0 && search._bestEnergy < bestEnergy)
 				{
 					// Store it in the current weak hypothesis.
-					// note: I don't really like having so many temp variables
-					// but the alternative would be a structure, which would need
-					// to be inheritable to make things more consistent. But this would
-					// make it less flexible. Therefore, I am still undecided. This
-					// might change!
-					_alpha = tmpAlpha;
-					_v = tmpV;
+					_alpha = search._bestAlpha;
+					_v = search._bestV;
 					
 					// I need to save the configuration because it changes within the object
-					_selectedConfig = pCurrFeature->getCurrentConfig();
+					_selectedConfig = configs[search._bestIdx].config;
+					selectedConfigIdx = configs[search._bestIdx].configIdx;
 					// I save the object because it contains the informations about the type,
 					// the name, etc..
 					_pSelectedFeature = pCurrFeature;
-					_threshold = tmpThreshold;
+					_threshold = search._bestThreshold;
 					
-					bestEnergy = tmpEnergy;
+					bestEnergy = search._bestEnergy;
 				}
 				
-				// Move to the next configuration
-				pCurrFeature->moveToNextConfig();
-				
-				// check stopping criterion for random configurations
-				switch (_samplingType)
+				// the evaluation of the batch counts in the time budget too
+				if (_samplingType == ST_TIME)
 				{
-					case ST_NUM:
-						++numConf;
-						if (numConf >= _samplingVal)
-							quitConfiguration = true;
-						break;
-					case ST_TIME:            
-					{
-						time( &currentTime );
-						float diff = difftime(currentTime, startTime); // difftime is in seconds
-						if (diff >= _samplingVal)
-							quitConfiguration = true;
-					}
-						break;
-						
-					case ST_NO_SAMPLING:
-						perror("ERROR: What? No sampling??");
-						break;
-						
-				} // end switch
-				
-				if (quitConfiguration)
-					break;
+					time( &currentTime );
+					float diff = difftime(currentTime, startTime); // difftime is in seconds
+					if (diff >= _samplingVal)
+						quitConfiguration = true;
+				}
 				
 			} // end while
 			
@@ -230,9 +552,12 @@ namespace MultiBoost {
 				time( &currentTime );
 				float diff = difftime(currentTime, startTime); // difftime is in seconds
 				
+				double seconds = (tick_count::now() - startTick).seconds();
+				
 				cout << "done! "
 				<< "(processed: " << numProcessed
-				<< " - elapsed: " << diff << " sec)" 
+				<< " - elapsed: " << diff << " sec"
+				<< " - " << static_cast<long>(numProcessed / max(seconds, 1e-6)) << " configs/sec)" 
 				<< endl;
 			}
 			
@@ -248,6 +573,9 @@ namespace MultiBoost {
 			if (_verbose > 1)
 				cout << "Selected type: " << _pSelectedFeature->getName() << endl;
 		}
+		
+		if ( pCache && selectedConfigIdx >= 0 )
+			pCache->markSelected( HaarResponseCache::getKey(_pSelectedFeature, selectedConfigIdx) );
 		        
 		return bestEnergy;
 	}
@@ -312,8 +640,8 @@ namespace MultiBoost {
 		for (int i = 0; i < numExamples; ++i)
 		{
 			data[pos++] = HaarSingleStumpLearner::phi( 
-													  _pSelectedFeature->getValue( 
-																				  pData->getValues(i), _selectedConfig ),
+													  static_cast<HaarData*>(pData)->getHaarValue( 
+																				  i, _pSelectedFeature, _selectedConfig ),
 													  //       static_cast<HaarData*>(pData)->getIntImage(i), _selectedConfig ), 
 													  0 );
 		}
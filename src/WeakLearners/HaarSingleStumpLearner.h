@@ -53,6 +53,7 @@ using namespace std;
 namespace MultiBoost {
 	
 	class HaarData;
+	class HaarConfigSearch;
 	
 	/**
 	 * A learner that uses the Haar-like features for input and the SingleStumpLearner 
@@ -130,6 +131,11 @@ namespace MultiBoost {
 		
 		/**
 		 * Run the learner to build the classifier on the given data.
+		 * The configurations are drawn in the same order as a sequential search and
+		 * evaluated in parallel by batches (see HAAR_CONFIG_BATCH_SIZE); the selected
+		 * one is the first configuration with the lowest energy, as in a sequential search.
+		 * With --haarpyramid the configurations of each type are first pruned on
+		 * the downsampled integral images (see pruneConfigs in the source).
 		 * \param pData The pointer to the data
 		 * \see SingleStumpLearner::run
 		 * \date 11/11/2005
@@ -176,6 +182,9 @@ namespace MultiBoost {
 		virtual AlphaReal cut( InputData* pData, int idx ) const;
 	private:
 		
+		friend class HaarConfigSearch;
+		friend class HaarPyramidScore;
+		
 		/**
 		 * A discriminative function. 
 		 * \remarks Positive or negative do NOT refer to positive or negative classification.
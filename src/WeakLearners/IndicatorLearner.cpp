@@ -36,6 +36,11 @@
 
 #include "IO/Serialization.h"
 
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 	
 	//REGISTER_LEARNER_NAME(SingleStump, IndicatorLearner)
@@ -45,21 +50,18 @@ namespace MultiBoost {
 	
 	AlphaReal IndicatorLearner::run()
 	{
-		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
 		
 		// set the smoothing value to avoid numerical problem
 		// when theta=0.
 		setSmoothingVal( 1.0 / (float)_pTrainingData->getNumExamples() * 0.01 );
 		
-		vector<sRates> vMu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-		vector<AlphaReal> previousTmpV(numClasses); // The class-wise votes/abstentions
-		
-		AlphaReal tmpAlpha,previousTmpAlpha, previousEnergy;
 		AlphaReal bestEnergy = numeric_limits<float>::max();
 		
+		// the columns to search and their initial u, drawn before the search
+		vector<int> columns;
+		_initialUs.clear();
+		
 		int numOfDimensions = _maxNumOfDimensions;
 		for (int j = 0; j < numColumns; ++j)
 		{
@@ -78,141 +80,33 @@ namespace MultiBoost {
 				
 				const int numIdxs = _pTrainingData->getEnumMap(j).getNumNames();
 				
-				// Create and initialize the numIdxs x numClasses gamma matrix
-				vector<vector<AlphaReal> > tmpGammasPls(numIdxs);
-				vector<vector<AlphaReal> > tmpGammasMin(numIdxs);
-				for (int io = 0; io < numIdxs; ++io) {
-					vector<AlphaReal> tmpGammaPls(numClasses);
-					vector<AlphaReal> tmpGammaMin(numClasses);
-					fill(tmpGammaPls.begin(), tmpGammaPls.end(), 0.0);
-					fill(tmpGammaMin.begin(), tmpGammaMin.end(), 0.0);
-					tmpGammasPls[io] = tmpGammaPls;
-					tmpGammasMin[io] = tmpGammaMin;
-				}
-				
-				// Compute the elements of the gamma plus and minus matrices
-				AlphaReal entry;
-				for (int i = 0; i < numExamples; ++i) {
-					const vector<Label>& labels = _pTrainingData->getLabels(i);
-					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
-					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
-						if (entry > 0)
-							tmpGammasPls[io][l] += entry;
-						else if (entry < 0)
-							tmpGammasMin[io][l] += -entry;
-					}
-				}
-				
 				// Initialize the u vector to random +-1
-				vector<sRates> uMu(numIdxs); // The idx-wise rates
-				vector<AlphaReal> tmpU(numIdxs);// The idx-wise votes/abstentions
-				vector<AlphaReal> previousTmpU(numIdxs);// The idx-wise votes/abstentions
+				vector<AlphaReal> tmpU(numIdxs);
 				for (int io = 0; io < numIdxs; ++io) {
-					uMu[io].classIdx = io;	    
 					if ( rand()/static_cast<AlphaReal>(RAND_MAX) > 0.5 )
 						tmpU[io] = +1;
 					else
 						tmpU[io] = -1;
 				}
 				
-				vector<sRates> vMu(numClasses); // The label-wise rates
-				for (int l = 0; l < numClasses; ++l)
-					vMu[l].classIdx = l;
-				vector<AlphaReal> tmpV(numClasses); // The label-wise votes/abstentions
-				
-				AlphaReal tmpEnergy = numeric_limits<AlphaReal>::max();
-				AlphaReal tmpVal;
-				tmpAlpha = 0.0;
-				
-				while (1) {
-					previousEnergy = tmpEnergy;
-					previousTmpV = tmpV;
-					previousTmpAlpha = tmpAlpha;
-					
-					//filling out tmpV and vMu
-					for (int l = 0; l < numClasses; ++l) {
-						vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
-						for (int io = 0; io < numIdxs; ++io) {
-							if (tmpU[io] > 0) {
-								vMu[l].rPls += tmpGammasPls[io][l];
-								vMu[l].rMin += tmpGammasMin[io][l];
-							}
-							else if (tmpU[io] < 0) {
-								vMu[l].rPls += tmpGammasMin[io][l];
-								vMu[l].rMin += tmpGammasPls[io][l];
-							}
-						}
-						if (vMu[l].rPls >= vMu[l].rMin) {
-							tmpV[l] = +1;
-						}
-						else {
-							tmpV[l] = -1;
-							tmpVal = vMu[l].rPls;
-							vMu[l].rPls = vMu[l].rMin;
-							vMu[l].rMin = tmpVal;
-						}
-					}
-					
-					tmpEnergy = AbstainableLearner::getEnergy(vMu, tmpAlpha, tmpV);
-					
-					if (_verbose > 2)
-						cout << "        --> energy V = " << tmpEnergy << "\talpha = " << tmpAlpha << endl << flush;
-					
-					if (tmpEnergy >= previousEnergy) {
-						tmpV = previousTmpV;
-						break;
-					}
-					
-					previousEnergy = tmpEnergy;
-					previousTmpU = tmpU;
-					previousTmpAlpha = tmpAlpha;
-					
-					//filling out tmpU and uMu
-					for (int io = 0; io < numIdxs; ++io) {
-						uMu[io].rPls = uMu[io].rMin = uMu[io].rZero = 0; 
-						for (int l = 0; l < numClasses; ++l) {
-							if (tmpV[l] > 0) {
-								uMu[io].rPls += tmpGammasPls[io][l];
-								uMu[io].rMin += tmpGammasMin[io][l];
-							}
-							else if (tmpV[l] < 0) {
-								uMu[io].rPls += tmpGammasMin[io][l];
-								uMu[io].rMin += tmpGammasPls[io][l];
-							}
-						}
-						if (uMu[io].rPls >= uMu[io].rMin) {
-							tmpU[io] = +1;
-						}
-						else {
-							tmpU[io] = -1;
-							tmpVal = uMu[io].rPls;
-							uMu[io].rPls = uMu[io].rMin;
-							uMu[io].rMin = tmpVal;
-						}
-					}
-					
-					tmpEnergy = AbstainableLearner::getEnergy(uMu, tmpAlpha, tmpU);
-					
-					if (_verbose > 2)
-						cout << "        --> energy U = " << tmpEnergy << "\talpha = " << tmpAlpha << endl << flush;
-					
-					if (tmpEnergy >= previousEnergy) {
-						tmpU = previousTmpU;
-						break;
-					}
-				}
-				
-				if ( previousEnergy < bestEnergy && previousTmpAlpha > 0 ) {
-					_alpha = previousTmpAlpha;
-					_v = tmpV;
-					_u = tmpU;
-					_selectedColumn = j;
-					bestEnergy = previousEnergy;
-				}
+				columns.push_back(j);
+				_initialUs.push_back(tmpU);
 			}
 		}
 		
+		// the columns are searched in parallel
+		EnumColumnSearch<IndicatorLearner> search(this, columns);
+		parallel_reduce( blocked_range<int>(0, (int)columns.size()), search );
+		
+		if ( search._bestIdx >= 0 && search._best.energy < bestEnergy )
+		{
+			_alpha = search._best.alpha;
+			_v = search._best.v;
+			_u = search._best.u;
+			_selectedColumn = columns[search._bestIdx];
+			bestEnergy = search._best.energy;
+		}
+		
 		if (_selectedColumn>-1)
 		{
 			_id = _pTrainingData->getAttributeNameMap().getNameFromIdx(_selectedColumn);
@@ -226,6 +120,116 @@ namespace MultiBoost {
 	
 	// ------------------------------------------------------------------------------
 	
+	void IndicatorLearner::searchColumn( const EnumGammaTable& table, int colPos, EnumColumnResult& result )
+	{
+		const int numClasses = table.numClasses;
+		const int numIdxs = table.numIdxs;
+		
+		vector<sRates> uMu(numIdxs); // The idx-wise rates
+		vector<AlphaReal> tmpU = _initialUs[colPos];// The idx-wise votes/abstentions
+		vector<AlphaReal> previousTmpU(numIdxs);// The idx-wise votes/abstentions
+		for (int io = 0; io < numIdxs; ++io)
+			uMu[io].classIdx = io;	    
+		
+		vector<sRates> vMu(numClasses); // The label-wise rates
+		for (int l = 0; l < numClasses; ++l)
+			vMu[l].classIdx = l;
+		vector<AlphaReal> tmpV(numClasses); // The label-wise votes/abstentions
+		vector<AlphaReal> previousTmpV(numClasses); // The class-wise votes/abstentions
+		
+		AlphaReal tmpEnergy = numeric_limits<AlphaReal>::max();
+		AlphaReal tmpAlpha = 0.0, previousTmpAlpha, previousEnergy;
+		AlphaReal tmpVal;
+		
+		while (1) {
+			previousEnergy = tmpEnergy;
+			previousTmpV = tmpV;
+			previousTmpAlpha = tmpAlpha;
+			
+			//filling out tmpV and vMu
+			for (int l = 0; l < numClasses; ++l) {
+				vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
+				for (int io = 0; io < numIdxs; ++io) {
+					if (tmpU[io] > 0) {
+						vMu[l].rPls += table.gammaPls[io * numClasses + l];
+						vMu[l].rMin += table.gammaMin[io * numClasses + l];
+					}
+					else if (tmpU[io] < 0) {
+						vMu[l].rPls += table.gammaMin[io * numClasses + l];
+						vMu[l].rMin += table.gammaPls[io * numClasses + l];
+					}
+				}
+				if (vMu[l].rPls >= vMu[l].rMin) {
+					tmpV[l] = +1;
+				}
+				else {
+					tmpV[l] = -1;
+					tmpVal = vMu[l].rPls;
+					vMu[l].rPls = vMu[l].rMin;
+					vMu[l].rMin = tmpVal;
+				}
+			}
+			
+			tmpEnergy = AbstainableLearner::getEnergy(vMu, tmpAlpha, tmpV);
+			
+			if (_verbose > 2)
+				cout << "        --> energy V = " << tmpEnergy << "\talpha = " << tmpAlpha << endl << flush;
+			
+			if (tmpEnergy >= previousEnergy) {
+				tmpV = previousTmpV;
+				break;
+			}
+			
+			previousEnergy = tmpEnergy;
+			previousTmpU = tmpU;
+			previousTmpAlpha = tmpAlpha;
+			
+			//filling out tmpU and uMu
+			for (int io = 0; io < numIdxs; ++io) {
+				const AlphaReal* pGammaPls = &table.gammaPls[io * numClasses];
+				const AlphaReal* pGammaMin = &table.gammaMin[io * numClasses];
+				
+				uMu[io].rPls = uMu[io].rMin = uMu[io].rZero = 0; 
+				for (int l = 0; l < numClasses; ++l) {
+					if (tmpV[l] > 0) {
+						uMu[io].rPls += pGammaPls[l];
+						uMu[io].rMin += pGammaMin[l];
+					}
+					else if (tmpV[l] < 0) {
+						uMu[io].rPls += pGammaMin[l];
+						uMu[io].rMin += pGammaPls[l];
+					}
+				}
+				if (uMu[io].rPls >= uMu[io].rMin) {
+					tmpU[io] = +1;
+				}
+				else {
+					tmpU[io] = -1;
+					tmpVal = uMu[io].rPls;
+					uMu[io].rPls = uMu[io].rMin;
+					uMu[io].rMin = tmpVal;
+				}
+			}
+			
+			tmpEnergy = AbstainableLearner::getEnergy(uMu, tmpAlpha, tmpU);
+			
+			if (_verbose > 2)
+				cout << "        --> energy U = " << tmpEnergy << "\talpha = " << tmpAlpha << endl << flush;
+			
+			if (tmpEnergy >= previousEnergy) {
+				tmpU = previousTmpU;
+				break;
+			}
+		}
+		
+		result.energy = previousEnergy;
+		result.alpha = previousTmpAlpha;
+		result.v = tmpV;
+		result.u = tmpU;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
 	AlphaReal IndicatorLearner::run( int colIdx )
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
@@ -274,7 +278,7 @@ namespace MultiBoost {
 			const vector<Label>& labels = _pTrainingData->getLabels(i);
 			int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
 			for (int l = 0; l < numClasses; ++l) {
-				entry = labels[l].weight * labels[l].y;
+				entry = _pTrainingData->getLabelWeight(i, labels[l]) * _pTrainingData->getLabelY(i, labels[l]);
 				if (entry > 0)
 					tmpGammasPls[io][l] += entry;
 				else if (entry < 0)
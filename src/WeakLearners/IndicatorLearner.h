@@ -40,6 +40,7 @@
 
 #include "FeaturewiseLearner.h"
 #include "ScalarLearner.h"
+#include "EnumColumnSearch.h"
 #include "Utils/Args.h"
 
 #include <vector>
@@ -161,7 +162,23 @@ namespace MultiBoost {
 		
 	protected:
 		
+		/**
+		 * Find the best indicator of a column from its tables, by optimizing the
+		 * class-wise votes and the value-wise votes in turn, starting from the random
+		 * value-wise votes drawn for the column.
+		 * \param table The weights of the column by value and class.
+		 * \param colPos The position of the column in the searched list, that is in _initialUs.
+		 * \param result The best indicator of the column, with u set.
+		 * \see EnumColumnSearch
+		 * \date 19/10/2026
+		 */
+		void searchColumn( const EnumGammaTable& table, int colPos, EnumColumnResult& result );
+		
 		vector<AlphaReal> _u;
+		
+		vector< vector<AlphaReal> > _initialUs; //!< The random initial u of the searched columns, drawn before the search.
+		
+		friend class EnumColumnSearch<IndicatorLearner>;
 	};
 	
 	//////////////////////////////////////////////////////////////////////////
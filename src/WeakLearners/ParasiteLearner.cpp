@@ -39,17 +39,139 @@
 
 #include <math.h>
 #include <limits>
+#include <algorithm> // for find
+
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
 
 namespace MultiBoost {
 
 //REGISTER_LEARNER_NAME(Parasite, ParasiteLearner)
 REGISTER_LEARNER(ParasiteLearner)
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The body of the parallel computation of the outputs of the base learners on the 
+ * training data. Each base learner writes its own block of _poolSigns, and whether 
+ * all its outputs are in {-1, 0, +1}.
+ * \date 19/10/2026
+ */
+class ParasitePoolSigns {
+public:
+   ParasitePoolSigns(ParasiteLearner* pLearner, vector<char>& isDiscrete)
+   : _pLearner(pLearner), _pIsDiscrete(&isDiscrete) {}
+
+   void operator()( const blocked_range<int>& range ) const {
+      InputData* pData = _pLearner->_pTrainingData;
+      const int numClasses = pData->getNumClasses();
+      const int numExamples = pData->getNumExamples();
+
+      for (int j = range.begin(); j != range.end(); ++j) {
+	 BaseLearner* pBaseLearner = ParasiteLearner::_baseLearners[j];
+	 signed char* pSigns = &ParasiteLearner::_poolSigns[ (size_t)j * numExamples * numClasses ];
+
+	 for (int i = 0; i < numExamples; ++i) {
+	    for (int l = 0; l < numClasses; ++l) {
+	       const AlphaReal h = pBaseLearner->classify(pData, i, l);
+	       if ( h != 1 && h != -1 && h != 0 ) {
+		  (*_pIsDiscrete)[j] = 0;
+		  break;
+	       }
+	       *pSigns++ = (signed char)h;
+	    }
+	    if ( !(*_pIsDiscrete)[j] ) break;
+	 }
+      }
+   }
+
+private:
+   ParasiteLearner* _pLearner;
+   vector<char>*    _pIsDiscrete;
+};
+
+// -----------------------------------------------------------------------
+
+/**
+ * The body of the parallel computation of the edges of the base learners. The 
+ * outputs are read from _poolSigns if it is filled, otherwise the base learners 
+ * are called. The sums run in the order of the examples and classes, as the 
+ * sequential loop did, so the selected base learner does not depend on the 
+ * number of threads.
+ * \date 19/10/2026
+ */
+class ParasitePoolEdges {
+public:
+   ParasitePoolEdges(ParasiteLearner* pLearner) : _pLearner(pLearner) {}
+
+   void operator()( const blocked_range<int>& range ) const {
+      InputData* pData = _pLearner->_pTrainingData;
+      const int numClasses = pData->getNumClasses();
+      const int numExamples = pData->getNumExamples();
+      const int numLabels = numExamples * numClasses;
+      const AlphaReal* pWeightedLabels = &_pLearner->_weightedLabels[0];
+      const bool hasSigns = !ParasiteLearner::_poolSigns.empty();
+
+      for (int j = range.begin(); j != range.end(); ++j) {
+	 float sumGamma = 0, eps_pls = 0, eps_min = 0;
+
+	 if ( hasSigns ) {
+	    const signed char* pSigns = &ParasiteLearner::_poolSigns[ (size_t)j * numLabels ];
+
+	    for (int k = 0; k < numLabels; ++k) {
+	       const AlphaReal wy = pWeightedLabels[k];
+	       if ( pSigns[k] == 0 || wy == 0 ) continue;
+
+	       const AlphaReal gamma = pSigns[k] * wy;
+	       sumGamma += gamma;
+	       if ( gamma > 0 )
+		  eps_pls += gamma;
+	       else
+		  eps_min += -gamma;
+	    }
+	 }
+	 else {
+	    BaseLearner* pBaseLearner = ParasiteLearner::_baseLearners[j];
+
+	    for (int i = 0; i < numExamples; ++i) {
+	       for (int l = 0; l < numClasses; ++l) {
+		  const AlphaReal wy = pWeightedLabels[i * numClasses + l];
+		  if ( wy == 0 ) continue;
+
+		  const AlphaReal h = pBaseLearner->classify(pData, i, l);
+		  sumGamma += wy * h;
+
+		  const float gamma = wy > 0 ? h : -h;
+		  if ( gamma > 0 )
+		     eps_pls += fabs(wy);
+		  else if ( gamma < 0 )
+		     eps_min += fabs(wy);
+	       }
+	    }
+	 }
+
+	 _pLearner->_sumGammas[j] = sumGamma;
+	 _pLearner->_epsPlss[j] = eps_pls;
+	 _pLearner->_epsMins[j] = eps_min;
+      }
+   }
+
+private:
+   ParasiteLearner* _pLearner;
+};
+
 // -----------------------------------------------------------------------
 
 int ParasiteLearner::_numBaseLearners = -1;
 string ParasiteLearner::_nameBaseLearnerFile = "";
 vector<BaseLearner*> ParasiteLearner::_baseLearners;
+vector<signed char> ParasiteLearner::_poolSigns;
+const InputData* ParasiteLearner::_pSignedData = NULL;
+int ParasiteLearner::_numSignedExamples = 0;
+int ParasiteLearner::_numSignedLearners = 0;
 
 // -----------------------------------------------------------------------
 
@@ -112,39 +234,41 @@ AlphaReal ParasiteLearner::run()
    float tmpAlpha;
    float bestE = numeric_limits<float>::max();
    float sumGamma, bestSumGamma = -numeric_limits<float>::max();
-   float tmpE, gamma;
+   float tmpE;
    float eps_min,eps_pls;
    int tmpSignOfAlpha;
 
+   // the outputs of the pool are computed only once on the training data
+   if ( _pSignedData != _pTrainingData || _numSignedExamples != numExamples || 
+        _numSignedLearners != _numBaseLearners )
+      computePoolSigns();
+
+   // the current weights times the labels
+   _weightedLabels.assign( numExamples * numClasses, 0 );
+   for (int i = 0; i < numExamples; ++i) {
+      const vector<Label>& labels = _pTrainingData->getLabels(i);
+      for (vector<Label>::const_iterator lIt = labels.begin(); lIt != labels.end(); ++lIt)
+	 _weightedLabels[i * numClasses + lIt->idx] = _pTrainingData->getLabelWeight(i, *lIt) * _pTrainingData->getLabelY(i, *lIt);
+   }
+
    // This is the bottleneck, squeeze out every microsecond
+   _sumGammas.resize(_numBaseLearners);
+   _epsPlss.resize(_numBaseLearners);
+   _epsMins.resize(_numBaseLearners);
+   parallel_for( blocked_range<int>(0, _numBaseLearners), ParasitePoolEdges(this) );
+
    if (_closed) {
       bestSumGamma = 0;
       if ( nor_utils::is_zero(_theta) ) {
 	 for (int j = 0; j < _numBaseLearners; ++j) {
-	    sumGamma = 0;
-	    for (int i = 0; i < numExamples; ++i) {
-	       vector<Label> labels = _pTrainingData->getLabels(i);
-	       for (int l = 0; l < numClasses; ++l)
-		  sumGamma += labels[l].weight * 
-		     _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
-	    }
+	    sumGamma = _sumGammas[j];
 	    if (fabs(sumGamma) > fabs(bestSumGamma)) {
 	       _selectedIdx = j;
 	       bestSumGamma = sumGamma;
 	    }
 	 }
-	 eps_pls = eps_min = 0;
-	 for (int i = 0; i < numExamples; ++i) {
-	    vector<Label> labels = _pTrainingData->getLabels(i);
-	    for (int l = 0; l < numClasses; ++l) {
-	       gamma = _baseLearners[_selectedIdx]->classify(_pTrainingData,i,l) *
-		  labels[l].y;
-	       if ( gamma > 0 )
-		  eps_pls += labels[l].weight;
-	       else if ( gamma < 0 )
-		  eps_min += labels[l].weight;
-	    }
-	 }
+	 eps_pls = _epsPlss[_selectedIdx];
+	 eps_min = _epsMins[_selectedIdx];
 	 if (eps_min > eps_pls) {
 	    float tmpSwap = eps_min;
 	    eps_min = eps_pls;
@@ -156,17 +280,8 @@ AlphaReal ParasiteLearner::run()
       }
       else {
 	 for (int j = 0; j < _numBaseLearners; ++j) {
-	    eps_pls = eps_min = 0;
-	    for (int i = 0; i < numExamples; ++i) {
-	       vector<Label> labels = _pTrainingData->getLabels(i);
-	       for (int l = 0; l < numClasses; ++l) {
-		  gamma = _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
-		  if ( gamma > 0 )
-		     eps_pls += labels[l].weight;
-		  else if ( gamma < 0 )
-		     eps_min += labels[l].weight;
-	       }
-	    }
+	    eps_pls = _epsPlss[j];
+	    eps_min = _epsMins[j];
 	    if (eps_min > eps_pls) {
 	       float tmpSwap = eps_min;
 	       eps_min = eps_pls;
@@ -189,46 +304,21 @@ AlphaReal ParasiteLearner::run()
    else {
       if ( nor_utils::is_zero(_theta) ) {
 	 for (int j = 0; j < _numBaseLearners; ++j) {
-	    sumGamma = 0;
-	    for (int i = 0; i < numExamples; ++i) {
-	       vector<Label> labels = _pTrainingData->getLabels(i);
-	       for (int l = 0; l < numClasses; ++l)
-		  sumGamma += labels[l].weight * 
-		     _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
-	    }
+	    sumGamma = _sumGammas[j];
 	    if (sumGamma > bestSumGamma) {
 	       _selectedIdx = j;
 	       bestSumGamma = sumGamma;
 	    }
 	 }
-	 eps_pls = eps_min = 0;
-	 for (int i = 0; i < numExamples; ++i) {
-	    vector<Label> labels = _pTrainingData->getLabels(i);
-	    for (int l = 0; l < numClasses; ++l) {
-	       gamma = _baseLearners[_selectedIdx]->classify(_pTrainingData,i,l) *
-		  labels[l].y;
-	       if ( gamma > 0 )
-		  eps_pls += labels[l].weight;
-	       else if ( gamma < 0 )
-		  eps_min += labels[l].weight;
-	    }
-	 }
+	 eps_pls = _epsPlss[_selectedIdx];
+	 eps_min = _epsMins[_selectedIdx];
 	 _alpha = getAlpha(eps_min, eps_pls);
 	 bestE = BaseLearner::getEnergy( eps_min, eps_pls );
       }
       else {
 	 for (int j = 0; j < _numBaseLearners; ++j) {
-	    eps_pls = eps_min = 0;
-	    for (int i = 0; i < numExamples; ++i) {
-	       vector<Label> labels = _pTrainingData->getLabels(i);
-	       for (int l = 0; l < numClasses; ++l) {
-		  gamma = _baseLearners[j]->classify(_pTrainingData,i,l) * labels[l].y;
-		  if ( gamma > 0 )
-		     eps_pls += labels[l].weight;
-		  else if ( gamma < 0 )
-		     eps_min += labels[l].weight;
-	       }
-	    }
+	    eps_pls = _epsPlss[j];
+	    eps_min = _epsMins[j];
 	    tmpAlpha = getAlpha(eps_min, eps_pls, _theta);
 	    tmpE = BaseLearner::getEnergy( eps_min, eps_pls, tmpAlpha, _theta );
 	    if (tmpE < bestE && eps_pls > eps_min + _theta) {
@@ -246,6 +336,30 @@ AlphaReal ParasiteLearner::run()
 
 // -----------------------------------------------------------------------
 
+void ParasiteLearner::computePoolSigns()
+{
+   const int numClasses = _pTrainingData->getNumClasses();
+   const int numExamples = _pTrainingData->getNumExamples();
+
+   _poolSigns.resize( (size_t)_numBaseLearners * numExamples * numClasses );
+
+   vector<char> isDiscrete( _numBaseLearners, 1 );
+   parallel_for( blocked_range<int>(0, _numBaseLearners), ParasitePoolSigns(this, isDiscrete) );
+
+   // real valued outputs are not kept, the base learners are called instead
+   if ( find( isDiscrete.begin(), isDiscrete.end(), 0 ) != isDiscrete.end() ) {
+      if (_verbose >= 2)
+	 cout << "the outputs of the pool are not all in {-1,0,+1}, they are not kept" << endl;
+      _poolSigns.clear();
+   }
+
+   _pSignedData = _pTrainingData;
+   _numSignedExamples = numExamples;
+   _numSignedLearners = _numBaseLearners;
+}
+
+// -----------------------------------------------------------------------
+
 void ParasiteLearner::save(ofstream& outputStream, int numTabs)
 {
    // Calling the super-class method
@@ -54,8 +54,13 @@ using namespace std;
 
 namespace MultiBoost {
 
+class ParasitePoolSigns;
+class ParasitePoolEdges;
+
 /**
 * A learner that loads a set of base learners, and boosts on the top of them. 
+* The outputs of the base learners on the training data are computed once, and 
+* the edges of all the base learners are computed in parallel from them.
 */
 class ParasiteLearner : public BaseLearner
 {
@@ -177,17 +182,49 @@ public:
    */
    const vector<BaseLearner*>& getBaseLearners() const { return _baseLearners; }
 
+   /**
+   * Forget the outputs of the base learners on the training data. They are 
+   * recomputed in the next run(). Must be called when the examples of the 
+   * training data change but its address and size do not (see --encode).
+   * \date 19/10/2026
+   */
+   static void clearPoolSigns() { _pSignedData = NULL; _poolSigns.clear(); }
+
 protected:
 
+   /**
+   * Compute the outputs of the first _numBaseLearners base learners on the
+   * training data, in parallel over the base learners. They are kept in 
+   * _poolSigns if they are all in {-1, 0, +1}, otherwise _poolSigns stays 
+   * empty and run() calls the base learners.
+   * \date 19/10/2026
+   */
+   void computePoolSigns();
+
    static int _numBaseLearners; //!< the user specified number of base learners
    static string _nameBaseLearnerFile; //!< the name of the shyp file with the pool
    static vector<BaseLearner*> _baseLearners; //!< the pool of base learners
 
+   /**
+   * The outputs of the base learners on _pSignedData, at 
+   * [(j*numExamples + i)*numClasses + l]. Empty if they are not all in {-1, 0, +1}.
+   */
+   static vector<signed char> _poolSigns;
+   static const InputData* _pSignedData; //!< the data _poolSigns was computed on, NULL if none
+   static int _numSignedExamples; //!< the number of examples of _pSignedData
+   static int _numSignedLearners; //!< the number of base learners in _poolSigns
+
+   vector<AlphaReal> _weightedLabels; //!< w*y of the training data, at [i*numClasses + l]
+   vector<float> _sumGammas; //!< the edge of each base learner
+   vector<float> _epsPlss; //!< the weight of the labels each base learner classifies correctly
+   vector<float> _epsMins; //!< the weight of the labels each base learner misclassifies
 
    int _selectedIdx; //!< the index of the selected base learner
    int _signOfAlpha; //!< to close the set over multiplication by -1
    int _closed; //!< to indicate whether the user wants to close the set (default = true)
 
+   friend class ParasitePoolSigns;
+   friend class ParasitePoolEdges;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -94,23 +94,31 @@ namespace MultiBoost {
 
 	AlphaReal ProductLearner::run()
 	{
-		const int numClasses = _pTrainingData->getNumClasses();
 		const int numExamples = _pTrainingData->getNumExamples();
 
+		// the base learners are trained on overlaid labels, the shared ones are not touched
+		_pTrainingData->beginLabelOverlay();
+
 		// Backup original labels
+		_labelBegins.resize(numExamples + 1);
+		_originalLabels.clear();
 		for (int i = 0; i < numExamples; ++i) {
 			const vector<Label>& labels = _pTrainingData->getLabels(i);
-			vector<char> exampleLabels;
-			for (int l = 0; l < numClasses; ++l)
-				exampleLabels.push_back(labels[l].y);
-			_savedLabels.push_back(exampleLabels);
+			_labelBegins[i] = (int)_originalLabels.size();
+			for (int l = 0; l < (int)labels.size(); ++l)
+				_originalLabels.push_back(labels[l].y);
 		}
+		_labelBegins[numExamples] = (int)_originalLabels.size();
+
+		_learnerSigns.resize(_numBaseLearners);
+		_signProducts.assign(_originalLabels.size(), 1);
+		_zeroCounts.assign(_originalLabels.size(), 0);
 
 		for(int ib = 0; ib < _numBaseLearners; ++ib)
 			_baseLearners[ib]->setTrainingData(_pTrainingData);
 
 		AlphaReal energy = numeric_limits<AlphaReal>::max();
-		AlphaReal previousEnergy, hx, previousAlpha;
+		AlphaReal previousEnergy, previousAlpha;
 		BaseLearner* pPreviousBaseLearner = 0;
 
 		bool firstLoop = true;
@@ -127,28 +135,10 @@ namespace MultiBoost {
 				delete pPreviousBaseLearner;
 			if ( !firstLoop ) {
 				// take the old learner off the labels
-				for (int i = 0; i < numExamples; ++i) {
-					vector<Label>& labels = _pTrainingData->getLabels(i);
-					for (int l = 0; l < numClasses; ++l) {
-						// Here we could have the option of using confidence rated setting so the
-						// real valued output of classify instead of its sign
-						hx = _baseLearners[ib]->classify(_pTrainingData,i,l);
-						if ( hx < 0 )
-							labels[l].y *= -1;
-						else if ( hx == 0 ) { // have to redo the multiplications, haven't been tested
-							for(int ib1 = 0; ib1 < _numBaseLearners && labels[l].y != 0; ++ib1) {
-								if (ib != ib1) {
-									hx = _baseLearners[ib1]->classify(_pTrainingData,i,l);
-									if (hx < 0)
-										labels[l].y *= -1;
-									else if (hx == 0)
-										labels[l].y = 0;
-								}
-							}
-						}
-					}
-				}
+				updateSignProducts(ib, -1);
 			}
+			updateLabels();
+
 			pPreviousBaseLearner = _baseLearners[ib]->copyState();
 			energy = _baseLearners[ib]->run();
 			_alpha = _baseLearners[ib]->getAlpha();
@@ -156,20 +146,8 @@ namespace MultiBoost {
 				cout << "E[" << (ib+1) <<  "] = " << energy << endl << flush;
 				cout << "alpha[" << (ib+1) <<  "] = " << _alpha << endl << flush;
 			}
-			for (int i = 0; i < numExamples; ++i) {
-				vector<Label>& labels = _pTrainingData->getLabels(i);
-				for (int l = 0; l < numClasses; ++l) {
-					// Here we could have the option of using confidence rated setting so the
-					// real valued output of classify instead of its sign
-					if (labels[l].y != 0) { // perhaps replace it by nor_utils::is_zero(labels[l].y)
-						hx = _baseLearners[ib]->classify(_pTrainingData,i,l);
-						if ( hx < 0 )
-							labels[l].y *= -1;
-						else if ( hx == 0 )
-							labels[l].y = 0;
-					}
-				}
-			}
+			computeLearnerSigns(ib);
+			updateSignProducts(ib, +1);
 
 			// We have to do at least one full iteration. For real it's not guaranteed
 			// Alternatively we could initialize all of them to constant
@@ -199,11 +177,7 @@ namespace MultiBoost {
 		}
 
 		// Restore original labels
-		for (int i = 0; i < numExamples; ++i) {
-			vector<Label>& labels = _pTrainingData->getLabels(i);
-			for (int l = 0; l < numClasses; ++l)
-				labels[l].y = _savedLabels[i][l];
-		}
+		_pTrainingData->endLabelOverlay();
 
 		_id = _baseLearners[0]->getId();
 		for(int ib = 1; ib < _numBaseLearners; ++ib)
@@ -213,6 +187,56 @@ namespace MultiBoost {
 
 	// -----------------------------------------------------------------------
 
+	void ProductLearner::computeLearnerSigns(int ib)
+	{
+		const int numExamples = _pTrainingData->getNumExamples();
+		vector<char>& signs = _learnerSigns[ib];
+		signs.resize(_originalLabels.size());
+
+		for (int i = 0; i < numExamples; ++i) {
+			const vector<Label>& labels = _pTrainingData->getLabels(i);
+			for (int l = 0, pos = _labelBegins[i]; pos < _labelBegins[i+1]; ++l, ++pos) {
+				// Here we could have the option of using confidence rated setting so the
+				// real valued output of classify instead of its sign
+				const AlphaReal hx = _baseLearners[ib]->classify(_pTrainingData, i, labels[l].idx);
+				signs[pos] = (hx > 0) - (hx < 0);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+	void ProductLearner::updateSignProducts(int ib, int direction)
+	{
+		const vector<char>& signs = _learnerSigns[ib];
+		const int numLabels = (int)_originalLabels.size();
+
+		// the signs are their own inverses, only the zeros are counted
+		for (int pos = 0; pos < numLabels; ++pos) {
+			if ( signs[pos] == 0 )
+				_zeroCounts[pos] += direction;
+			else
+				_signProducts[pos] *= signs[pos];
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
+	void ProductLearner::updateLabels()
+	{
+		const int numExamples = _pTrainingData->getNumExamples();
+
+		for (int i = 0; i < numExamples; ++i) {
+			const vector<Label>& labels = _pTrainingData->getLabels(i);
+			for (int l = 0, pos = _labelBegins[i]; pos < _labelBegins[i+1]; ++l, ++pos) {
+				const char y = _zeroCounts[pos] > 0 ? 0 : _originalLabels[pos] * _signProducts[pos];
+				_pTrainingData->setOverlayLabel(i, labels[l].idx, y);
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------
+
 	void ProductLearner::save(ofstream& outputStream, int numTabs)
 	{
 		// Calling the super-class method
@@ -178,9 +178,37 @@ public:
 	
 protected:
 
+   /**
+   * Store the signs (-1, 0 or +1) of the outputs of a base learner on the labels
+   * of the examples in use.
+   * \param ib The index of the base learner.
+   * \date 19/10/2026
+   */
+   void computeLearnerSigns(int ib);
+
+   /**
+   * Multiply the signs of a base learner into the running products, or take
+   * them off.
+   * \param ib The index of the base learner.
+   * \param direction +1 to add the learner to the product, -1 to remove it.
+   * \date 19/10/2026
+   */
+   void updateSignProducts(int ib, int direction);
+
+   /**
+   * Set the labels of the overlay (see InputData::beginLabelOverlay) to the original
+   * labels times the running products.
+   * \date 19/10/2026
+   */
+   void updateLabels();
+
    vector<BaseLearner*> _baseLearners; //!< the learners of the product
    int _numBaseLearners;
-   vector< vector<char> > _savedLabels; //!< original labels saved before run
+   vector<int>  _labelBegins; //!< The position of the first label of each example in the arrays below.
+   vector<char> _originalLabels; //!< original labels saved before run
+   vector< vector<char> > _learnerSigns; //!< The signs of the outputs of each base learner, label by label.
+   vector<char> _signProducts; //!< The product of the nonzero signs of the base learners in the product.
+   vector<int>  _zeroCounts; //!< The number of base learners in the product that output zero.
 
 };
 
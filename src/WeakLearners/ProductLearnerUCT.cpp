@@ -195,6 +195,7 @@ namespace MultiBoost {
 				}
 			}
 			pPreviousBaseLearner = _baseLearners[ib]->copyState();
+			_pTrainingData->syncCompactLabels();
 			energy = dynamic_cast<FeaturewiseLearner*>(_baseLearners[ib])->run( trajectory[ib] );
 			_alpha = _baseLearners[ib]->getAlpha();
 			if (_verbose > 2) {
@@ -249,6 +250,7 @@ namespace MultiBoost {
 			for (int l = 0; l < numClasses; ++l)
 				labels[l].y = _savedLabels[i][l];
 		}
+		_pTrainingData->syncCompactLabels();
 
 
 		//update the weights in the UCT tree
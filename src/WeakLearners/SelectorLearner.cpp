@@ -36,6 +36,11 @@
 
 #include "IO/Serialization.h"
 
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 	
 	//REGISTER_LEARNER_NAME(SingleStump, SelectorLearner)
@@ -45,20 +50,17 @@ namespace MultiBoost {
 	
 	AlphaReal SelectorLearner::run()
 	{
-		const int numClasses = _pTrainingData->getNumClasses();
 		const int numColumns = _pTrainingData->getNumAttributes();
-		const int numExamples = _pTrainingData->getNumExamples();
 		
 		// set the smoothing value to avoid numerical problem
 		// when theta=0.
 		setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
 		
-		vector<sRates> vMu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-		
-		AlphaReal tmpAlpha, tmpEnergy;
 		AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
 		
+		// the columns to search, drawn before the search
+		vector<int> columns;
+		
 		int numOfDimensions = _maxNumOfDimensions;
 		for (int j = 0; j < numColumns; ++j)
 		{
@@ -69,100 +71,22 @@ namespace MultiBoost {
 			if ( static_cast<float>(numOfDimensions) / rest > r ) 
 			{
 				--numOfDimensions;
-				/*
-				 if (_verbose > 2)
-				 cout << "    --> trying attribute = "
-				 <<_pTrainingData->getAttributeNameMap().getNameFromIdx(j)
-				 << endl << flush;
-				 */
-				const int numIdxs = _pTrainingData->getEnumMap(j).getNumNames();
-				
-				// Create and initialize the numIdxs x numClasses gamma matrix
-				vector<vector<AlphaReal> > tmpGammasPls(numIdxs);
-				vector<vector<AlphaReal> > tmpGammasMin(numIdxs);
-				for (int io = 0; io < numIdxs; ++io) {
-					vector<AlphaReal> tmpGammaPls(numClasses);
-					vector<AlphaReal> tmpGammaMin(numClasses);
-					fill(tmpGammaPls.begin(), tmpGammaPls.end(), 0.0);
-					fill(tmpGammaMin.begin(), tmpGammaMin.end(), 0.0);
-					tmpGammasPls[io] = tmpGammaPls;
-					tmpGammasMin[io] = tmpGammaMin;
-				}
-				
-				// Compute the elements of the gamma plus and minus matrices
-				AlphaReal entry;
-				for (int i = 0; i < numExamples; ++i) {
-					const vector<Label>& labels = _pTrainingData->getLabels(i);
-					int io = static_cast<int>(_pTrainingData->getValue(i,j));	    
-					for (int l = 0; l < numClasses; ++l) {
-						entry = labels[l].weight * labels[l].y;
-						if (entry > 0)
-							tmpGammasPls[io][l] += entry;
-						else if (entry < 0)
-							tmpGammasMin[io][l] += -entry;
-					}
-				}
-				
-				// Initialize the u vector to random +-1
-				vector<sRates> uMu(numIdxs); // The idx-wise rates
-				vector<AlphaReal> tmpU(numIdxs);// The idx-wise votes/abstentions
-				vector<AlphaReal> previousTmpU(numIdxs);// The idx-wise votes/abstentions
-				
-				for (int io = 0; io < numIdxs; ++io) {
-					uMu[io].classIdx = io;	
-				}
-				
-				for (int io = 0; io < numIdxs; ++io) {					
-					// initializing u as it has only one positive element
-					fill( tmpU.begin(), tmpU.end(), -1 );
-					tmpU[io] = +1;
-					
-					vector<sRates> vMu(numClasses); // The label-wise rates
-					for (int l = 0; l < numClasses; ++l)
-						vMu[l].classIdx = l;
-					vector<AlphaReal> tmpV(numClasses); // The label-wise votes/abstentions
-					
-					AlphaReal tmpVal;
-					tmpAlpha = 0.0;
-					
-					//filling out tmpV and vMu
-					for (int l = 0; l < numClasses; ++l) {
-						vMu[l].rPls = vMu[l].rMin = vMu[l].rZero = 0; 
-						for (int io = 0; io < numIdxs; ++io) {
-							if (tmpU[io] > 0) {
-								vMu[l].rPls += tmpGammasPls[io][l];
-								vMu[l].rMin += tmpGammasMin[io][l];
-							}
-							else if (tmpU[io] < 0) {
-								vMu[l].rPls += tmpGammasMin[io][l];
-								vMu[l].rMin += tmpGammasPls[io][l];
-							}
-						}
-						if (vMu[l].rPls >= vMu[l].rMin) {
-							tmpV[l] = +1;
-						}
-						else {
-							tmpV[l] = -1;
-							tmpVal = vMu[l].rPls;
-							vMu[l].rPls = vMu[l].rMin;
-							vMu[l].rMin = tmpVal;
-						}
-					}
-					
-					tmpEnergy = AbstainableLearner::getEnergy(vMu, tmpAlpha, tmpV);
-					
-					if ( tmpEnergy < bestEnergy && tmpAlpha > 0 ) {
-						_alpha = tmpAlpha;
-						_v = tmpV;
-						//_u = tmpU;
-						_positiveIdxOfArrayU = io;
-						_selectedColumn = j;
-						bestEnergy = tmpEnergy;
-					}
-				}
+				columns.push_back(j);
 			}
 		}
 		
+		// the columns are searched in parallel
+		EnumColumnSearch<SelectorLearner> search(this, columns);
+		parallel_reduce( blocked_range<int>(0, (int)columns.size()), search );
+		
+		if ( search._bestIdx >= 0 )
+		{
+			_alpha = search._best.alpha;
+			_v = search._best.v;
+			_positiveIdxOfArrayU = search._best.positiveIdx;
+			_selectedColumn = columns[search._bestIdx];
+			bestEnergy = search._best.energy;
+		}
 		
 		if (_selectedColumn>-1)
 		{
@@ -173,6 +97,66 @@ namespace MultiBoost {
 		}				
 	}
 	
+	// ------------------------------------------------------------------------------
+	
+	void SelectorLearner::searchColumn( const EnumGammaTable& table, int, EnumColumnResult& result )
+	{
+		const int numClasses = table.numClasses;
+		const int numIdxs = table.numIdxs;
+		
+		result.energy = numeric_limits<AlphaReal>::max();
+		result.alpha = 0;
+		
+		// the totals of the column
+		vector<AlphaReal> sumGammasPls(numClasses, 0.0);
+		vector<AlphaReal> sumGammasMin(numClasses, 0.0);
+		for (int io = 0; io < numIdxs; ++io) {
+			for (int l = 0; l < numClasses; ++l) {
+				sumGammasPls[l] += table.gammaPls[io * numClasses + l];
+				sumGammasMin[l] += table.gammaMin[io * numClasses + l];
+			}
+		}
+		
+		vector<sRates> vMu(numClasses); // The label-wise rates
+		for (int l = 0; l < numClasses; ++l)
+			vMu[l].classIdx = l;
+		vector<AlphaReal> tmpV(numClasses); // The label-wise votes/abstentions
+		
+		AlphaReal tmpAlpha, tmpEnergy, tmpVal;
+		
+		for (int io = 0; io < numIdxs; ++io) {
+			// u has only one positive element, at io
+			const AlphaReal* pGammaPls = &table.gammaPls[io * numClasses];
+			const AlphaReal* pGammaMin = &table.gammaMin[io * numClasses];
+			
+			//filling out tmpV and vMu
+			for (int l = 0; l < numClasses; ++l) {
+				vMu[l].rZero = 0;
+				vMu[l].rPls = pGammaPls[l] + ( sumGammasMin[l] - pGammaMin[l] );
+				vMu[l].rMin = pGammaMin[l] + ( sumGammasPls[l] - pGammaPls[l] );
+				
+				if (vMu[l].rPls >= vMu[l].rMin) {
+					tmpV[l] = +1;
+				}
+				else {
+					tmpV[l] = -1;
+					tmpVal = vMu[l].rPls;
+					vMu[l].rPls = vMu[l].rMin;
+					vMu[l].rMin = tmpVal;
+				}
+			}
+			
+			tmpEnergy = AbstainableLearner::getEnergy(vMu, tmpAlpha, tmpV);
+			
+			if ( tmpEnergy < result.energy && tmpAlpha > 0 ) {
+				result.alpha = tmpAlpha;
+				result.v = tmpV;
+				result.positiveIdx = io;
+				result.energy = tmpEnergy;
+			}
+		}
+	}
+	
 	// ------------------------------------------------------------------------------
 	// TODO: implementing this function
 	AlphaReal SelectorLearner::run( int colIdx )
@@ -40,6 +40,7 @@
 
 #include "FeaturewiseLearner.h"
 #include "ScalarLearner.h"
+#include "EnumColumnSearch.h"
 #include "Utils/Args.h"
 
 #include <vector>
@@ -157,8 +158,23 @@ namespace MultiBoost {
 		{
 			return phi( pData->getValue( idx, _selectedColumn) );
 		}
+		
+		/**
+		 * Find the best selector of a column from its tables. The class-wise rates of 
+		 * the selector of a value are its own weights plus the swapped weights of the 
+		 * other values, which are taken from the column totals, so each value costs
+		 * O(numClasses).
+		 * The position of the column in the searched list is not used.
+		 * \param table The weights of the column by value and class.
+		 * \param result The best selector of the column, with positiveIdx set.
+		 * \see EnumColumnSearch
+		 * \date 19/10/2026
+		 */
+		void searchColumn( const EnumGammaTable& table, int, EnumColumnResult& result );
 				
 		int			  _positiveIdxOfArrayU;		
+		
+		friend class EnumColumnSearch<SelectorLearner>;
 	};
 	
 	//////////////////////////////////////////////////////////////////////////
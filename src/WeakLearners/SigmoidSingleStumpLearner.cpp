@@ -41,10 +41,74 @@
 #include <limits> // for numeric_limits<>
 #include <sstream> // for _id
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 	
 	//REGISTER_LEARNER_NAME(SingleStump, SingleStumpLearner)
 	REGISTER_LEARNER(SigmoidSingleStumpLearner)
+	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The body of the parallel optimization of the columns in run(). The
+	 * parameters of column j are only touched by the task of column j, and
+	 * the ranges are balanced between the threads by the work stealing of TBB.
+	 * \date 19/10/2026
+	 */
+	class SigmoidColumnTraining {
+	public:
+		SigmoidColumnTraining(SigmoidSingleStumpLearner* pLearner, const vector<int>& randomPermutation,
+							  const vector<AlphaReal>& gammas, vector<FeatureReal>& sigmoidSlopes,
+							  vector<FeatureReal>& sigmoidOffSets, vector<vector<AlphaReal> >& vsArray,
+							  vector<AlphaReal>& edges)
+		: _pLearner(pLearner), _pRandomPermutation(&randomPermutation), _pGammas(&gammas),
+		  _pSigmoidSlopes(&sigmoidSlopes), _pSigmoidOffSets(&sigmoidOffSets), _pVsArray(&vsArray), _pEdges(&edges) {}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			for( int j = range.begin(); j != range.end(); ++j ) {
+				_pLearner->trainColumn( j, *_pRandomPermutation, *_pGammas, (*_pSigmoidSlopes)[j],
+										(*_pSigmoidOffSets)[j], (*_pVsArray)[j] );
+				(*_pEdges)[j] = _pLearner->getColumnEdge( j, (*_pSigmoidOffSets)[j], (*_pVsArray)[j] );
+			}
+		}
+		
+	private:
+		SigmoidSingleStumpLearner*		_pLearner;
+		const vector<int>*				_pRandomPermutation;
+		const vector<AlphaReal>*		_pGammas;
+		vector<FeatureReal>*			_pSigmoidSlopes;
+		vector<FeatureReal>*			_pSigmoidOffSets;
+		vector<vector<AlphaReal> >*		_pVsArray;
+		vector<AlphaReal>*				_pEdges;
+	};
+	
+	// -----------------------------------------------------------------------
+	
+	/**
+	 * The body of the parallel update of the columns with one example in update().
+	 * \date 19/10/2026
+	 */
+	class SigmoidColumnUpdate {
+	public:
+		SigmoidColumnUpdate(SigmoidSingleStumpLearner* pLearner, int trainingInstanceIdx)
+		: _pLearner(pLearner), _trainingInstanceIdx(trainingInstanceIdx) {}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			for( int j = range.begin(); j != range.end(); ++j )
+				_pLearner->updateColumn( j, _trainingInstanceIdx );
+		}
+		
+	private:
+		SigmoidSingleStumpLearner*		_pLearner;
+		int								_trainingInstanceIdx;
+	};
+	
+	// -----------------------------------------------------------------------
 	// ------------------------------------------------------------------------------
 	
 	void SigmoidSingleStumpLearner::declareArguments(nor_utils::Args& args)
@@ -103,200 +167,77 @@ namespace MultiBoost {
 			//fill(vsArray[i].begin(),vsArray[i].end(),0.0);
 		}
 		
+		// The columns do not share any parameter, only the learning rate, which
+		// does not depend on the data. The learning rates of the steps are computed
+		// first, then the columns are optimized in parallel.
+		vector<int> randomPermutation;
+		vector<AlphaReal> gammas;
+		AlphaReal gammaDivider = 1.0;
 		
 		if ( _gMethod == OPT_SGD )
 		{
-			vector<int> randomPermutation(numExamples);
+			randomPermutation.resize(numExamples);
 			for (int i = 0; i < numExamples; ++i ) randomPermutation[i]=i;
 			random_shuffle( randomPermutation.begin(), randomPermutation.end() );			
 			
-			AlphaReal gammaDivider = 1.0;
+			// one step per example
+			gammas.resize(numExamples);
 			for (int i = 0; i < numExamples; ++i )
 			{
 				if ((i>0)&&((i%_gammdivperiod)==0)) gammaDivider += 1.0;
-				AlphaReal stepOffSet, stepSlope, stepV;
-				//int randomTrainingInstanceIdx = (rand() % _pTrainingData->getNumExamples());
-				int randomTrainingInstanceIdx = randomPermutation[i];
-				vector<Label> labels = _pTrainingData->getLabels(randomTrainingInstanceIdx);
-				
-				for (int j = 0; j < numColumns; ++j)
-				{
-					
-					FeatureReal val = _pTrainingData->getValue(randomTrainingInstanceIdx, j);					
-					FeatureReal tmpSigVal = sigmoid(val,sigmoidSlopes[j],sigmoidOffSets[j]);
-					
-					
-					AlphaReal deltaQ = 0.0;
-					
-					switch (_tFunction) {
-						case TF_EXPLOSS:
-							for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-							{
-								deltaQ += exp( -vsArray[j][it->idx] * it->y * ( 2*tmpSigVal-1 ) ) 
-								*2.0 * it->weight*vsArray[j][it->idx]*it->y*tmpSigVal*(1.0-tmpSigVal);
-							}
-							
-							stepOffSet = -deltaQ;
-							stepSlope = -deltaQ * val;							
-							break;
-						case TF_EDGE:
-							for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-							{
-								deltaQ += 2.0 * it->weight*vsArray[j][it->idx]*it->y*tmpSigVal*(1.0-tmpSigVal);
-							}
-							// because edge should be maximized
-							stepOffSet = -deltaQ;
-							stepSlope = -deltaQ * val;
-							break;
-						default:
-							break;
-					}
-					
-					// gradient step
-					FeatureReal tmpSigmoidOffSet = sigmoidOffSets[j] - numExamples * static_cast<FeatureReal>(gammat * stepOffSet);										
-					FeatureReal tmpSigmoidSlopes = sigmoidSlopes[j] - numExamples * static_cast<FeatureReal>(gammat * stepSlope);									
-					
-					
-					// update the parameters
-					for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-					{
-						switch (_tFunction) {
-							case TF_EXPLOSS:
-								stepV = -exp( - vsArray[j][it->idx] * it->y * ( 2*tmpSigVal-1 ) )   
-								* ( it->weight * (2.0 * tmpSigVal - 1.0) * it->y);						
-								break;
-							case TF_EDGE:
-								// + gradient since it a maximization task
-								stepV =  - ( it->weight * (2.0 * tmpSigVal - 1.0) * it->y);						
-								break;
-						}
-						vsArray[j][it->idx] = vsArray[j][it->idx] - gammat * stepV;
-					}
-					normalizeLength( vsArray[j] );
-					sigmoidOffSets[j] = tmpSigmoidOffSet;
-					sigmoidSlopes[j] = tmpSigmoidSlopes;
-					
-				}	
+				gammas[i] = gammat;
 				// decrease gammat
 				gammat = gammat / gammaDivider;
 			}						
 		} else if (_gMethod == OPT_BGD )
 		{			
-			AlphaReal gammaDivider = 1.0;			
-			
+			// one step per iteration and column
+			gammas.resize(_maxIter * numColumns);
 			for (int gradi=0; gradi<_maxIter; ++gradi)
 			{
 				if ((gradi>0)&&((gradi%_gammdivperiod)==0)) gammaDivider += 1.0;
 				for (int j = 0; j < numColumns; ++j)
-				{										
-					AlphaReal slopeImporvemement = 0.0;
-					AlphaReal offsetImporvemement = 0.0;
-					vector<AlphaReal> vImprovement(numClasses);
-					fill(vImprovement.begin(),vImprovement.end(),0.0);
-					
-					
-					switch (_tFunction) {
-						case TF_EXPLOSS:							
-							for (int i = 0; i < numExamples; ++i )					
-							{
-								vector<Label> labels = _pTrainingData->getLabels(i);
-								FeatureReal val = _pTrainingData->getValue(i,j);
-								
-								
-								// update the parameters						
-								FeatureReal tmpSigVal = sigmoid(val,sigmoidSlopes[j],sigmoidOffSets[j]);
-								
-								AlphaReal deltaQ = 0.0;
-								for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-								{
-									deltaQ += exp( -vsArray[j][it->idx] * it->y * ( 2*tmpSigVal-1 ) )
-									* 2.0 * it->weight*vsArray[j][it->idx]*it->y*tmpSigVal*(1.0-tmpSigVal);
-								}
-								
-								offsetImporvemement -= deltaQ;
-								slopeImporvemement -= (deltaQ*val);
-								
-								
-								for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-								{
-									// + gradient since it a maximization task
-									vImprovement[it->idx] -= exp( -vsArray[j][it->idx] * it->y * ( 2*tmpSigVal-1 ) ) 
-									* ( it->weight * (2.0 * tmpSigVal - 1.0) * it->y);
-								}
-								
-							}								
-							break;
-						case TF_EDGE:
-							for (int i = 0; i < numExamples; ++i )					
-							{
-								vector<Label> labels = _pTrainingData->getLabels(i);
-								FeatureReal val = _pTrainingData->getValue(i,j);
-								
-								
-								// update the parameters						
-								FeatureReal tmpSigVal = sigmoid(val,sigmoidSlopes[j],sigmoidOffSets[j]);
-								
-								AlphaReal deltaQ = 0.0;
-								for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-								{
-									deltaQ += 2.0 * it->weight*vsArray[j][it->idx]*it->y*tmpSigVal*(1.0-tmpSigVal);
-								}
-								
-								offsetImporvemement -= deltaQ;
-								slopeImporvemement -= (deltaQ*val);
-								
-								
-								for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-								{
-									// + gradient since it a maximization task
-									vImprovement[it->idx] -= ( it->weight * (2.0 * tmpSigVal - 1.0) * it->y);
-								}
-								
-							}								
-							break;
-					}
-					
-					//update the current parameter vector
-					for( int iimp=0; iimp < vImprovement.size(); ++iimp )
-					{
-						// + gradient since it a maximization task						
-						vsArray[j][iimp] -= gammat * vImprovement[iimp];
-						//vsArray[j][iimp] += 100.0 * gammat * vImprovement[iimp];
-					}
-					normalizeLength( vsArray[j] );
-					sigmoidOffSets[j] -= gammat * offsetImporvemement;
-					//sigmoidOffSets[j] += 100.0 * gammat * offsetImporvemement;
-					sigmoidSlopes[j] -= gammat * slopeImporvemement;
-					//sigmoidSlopes[j] += 100.0 * gammat * slopeImporvemement;
-					
+				{
+					gammas[gradi * numColumns + j] = gammat;
 					// decrease gammat
 					gammat = gammat / gammaDivider;
-					
-				} // j 
+				}
+			}
+		} else if (_gMethod == OPT_MBGD )
+		{
+			randomPermutation.resize(numExamples);
+			for (int i = 0; i < numExamples; ++i ) randomPermutation[i]=i;
+			random_shuffle( randomPermutation.begin(), randomPermutation.end() );			
+			
+			// one step per mini-batch, the permutation is visited _maxIter times
+			const int numSteps = _maxIter * ( (numExamples + _miniBatchSize - 1) / _miniBatchSize );
+			gammas.resize(numSteps);
+			for (int step = 0; step < numSteps; ++step)
+			{
+				if ((step>0)&&((step%_gammdivperiod)==0)) gammaDivider += 1.0;
+				gammas[step] = gammat;
+				// decrease gammat
+				gammat = gammat / gammaDivider;
 			}
 		} else {
 			cout << "Unknown optimization method!" << endl;
 			exit(-1);
 		}
 		
+		vector<AlphaReal> edges(numColumns);
+		parallel_for( blocked_range<int>( 0, numColumns, 1 ), 
+					  SigmoidColumnTraining( this, randomPermutation, gammas, sigmoidSlopes, sigmoidOffSets, vsArray, edges ) );
+		
 		int bestColumn = -1;
 		
 		// find the best feature
 		for (int j = 0; j < numColumns; ++j)
 		{
-			_selectedColumn = j;
-			_sigmoidSlope = sigmoidSlopes[j];
-			_sigmoidOffset = sigmoidOffSets[j];
-			_v = vsArray[j];
-			
-			for(int k=0; k<numClasses; ++k ) _v[k]= _v[k] < 0 ? -1.0 : 1.0;
-			
-			AlphaReal tmpEdge = this->getEdge();			
+			AlphaReal tmpEdge = edges[j];
 			
 			if ((tmpEdge>0.0) && (tmpEdge>bestEdge))
 			{
 				bestEdge = tmpEdge;				
-				bestv = _v;
 				bestColumn = j;
 			}
 		}
@@ -307,6 +248,9 @@ namespace MultiBoost {
 		
 		if ( _selectedColumn != -1 )
 		{
+			_sigmoidSlope = sigmoidSlopes[_selectedColumn];
+			_sigmoidOffset = sigmoidOffSets[_selectedColumn];
+			
 			stringstream parameterString;
 			parameterString << _sigmoidSlope << "_" << _sigmoidOffset;
 			_id = _pTrainingData->getAttributeNameMap().getNameFromIdx(_selectedColumn) + _id + parameterString.str();			
@@ -314,8 +258,7 @@ namespace MultiBoost {
 			return numeric_limits<AlphaReal>::signaling_NaN();
 		}						
 		
-		_sigmoidSlope = sigmoidSlopes[_selectedColumn];
-		_sigmoidOffset = sigmoidOffSets[_selectedColumn];
+		for(int k=0; k<numClasses; ++k ) bestv[k] = vsArray[_selectedColumn][k] < 0 ? -1.0 : 1.0;
 		_v = bestv;
 		//normalizeLength( _v );
 		
@@ -332,10 +275,12 @@ namespace MultiBoost {
 		
 		//_pTrainingData->clearIndexSet();
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
-			vector< Label> l = _pTrainingData->getLabels( i );
-			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
+			const vector<Label>& l = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator it = l.begin(); it != l.end(); it++ ) {
+				const char y = _pTrainingData->getLabelY(i, *it);
+				const AlphaReal w = _pTrainingData->getLabelWeight(i, *it);
 				AlphaReal result  = this->classify( _pTrainingData, i, it->idx );
-				result *= (it->y * it->weight);
+				result *= (y * w);
 				if ( result < 0 ) eps_min -= result;
 				if ( result > 0 ) eps_pls += result;
 			}
@@ -352,6 +297,232 @@ namespace MultiBoost {
 	
 	// ------------------------------------------------------------------------------
 	
+	void SigmoidSingleStumpLearner::trainColumn( int j, const vector<int>& randomPermutation, 
+												 const vector<AlphaReal>& gammas, FeatureReal& sigmoidSlope, 
+												 FeatureReal& sigmoidOffSet, vector<AlphaReal>& vs )
+	{
+		const int numClasses = _pTrainingData->getNumClasses();
+		const int numColumns = _pTrainingData->getNumAttributes();
+		const int numExamples = _pTrainingData->getNumExamples();
+		
+		if ( _gMethod == OPT_SGD )
+		{
+			for (int i = 0; i < numExamples; ++i )
+			{
+				const AlphaReal gammat = gammas[i];
+				AlphaReal stepOffSet, stepSlope, stepV;
+				int randomTrainingInstanceIdx = randomPermutation[i];
+				const vector<Label>& labels = _pTrainingData->getLabels(randomTrainingInstanceIdx);
+				
+				FeatureReal val = _pTrainingData->getValue(randomTrainingInstanceIdx, j);					
+				FeatureReal tmpSigVal = sigmoid(val,sigmoidSlope,sigmoidOffSet);
+				
+				AlphaReal deltaQ = 0.0;
+				
+				switch (_tFunction) {
+					case TF_EXPLOSS:
+						for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+						{
+							const char y = _pTrainingData->getLabelY(randomTrainingInstanceIdx, *it);
+							const AlphaReal w = _pTrainingData->getLabelWeight(randomTrainingInstanceIdx, *it);
+							deltaQ += exp( -vs[it->idx] * y * ( 2*tmpSigVal-1 ) ) 
+							*2.0 * w*vs[it->idx]*y*tmpSigVal*(1.0-tmpSigVal);
+						}
+						
+						stepOffSet = -deltaQ;
+						stepSlope = -deltaQ * val;							
+						break;
+					case TF_EDGE:
+						for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+						{
+							const char y = _pTrainingData->getLabelY(randomTrainingInstanceIdx, *it);
+							const AlphaReal w = _pTrainingData->getLabelWeight(randomTrainingInstanceIdx, *it);
+							deltaQ += 2.0 * w*vs[it->idx]*y*tmpSigVal*(1.0-tmpSigVal);
+						}
+						// because edge should be maximized
+						stepOffSet = -deltaQ;
+						stepSlope = -deltaQ * val;
+						break;
+					default:
+						break;
+				}
+				
+				// gradient step
+				FeatureReal tmpSigmoidOffSet = sigmoidOffSet - numExamples * static_cast<FeatureReal>(gammat * stepOffSet);										
+				FeatureReal tmpSigmoidSlopes = sigmoidSlope - numExamples * static_cast<FeatureReal>(gammat * stepSlope);									
+				
+				// update the parameters
+				for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+				{
+					const char y = _pTrainingData->getLabelY(randomTrainingInstanceIdx, *it);
+					const AlphaReal w = _pTrainingData->getLabelWeight(randomTrainingInstanceIdx, *it);
+					switch (_tFunction) {
+						case TF_EXPLOSS:
+							stepV = -exp( - vs[it->idx] * y * ( 2*tmpSigVal-1 ) )   
+							* ( w * (2.0 * tmpSigVal - 1.0) * y);						
+							break;
+						case TF_EDGE:
+							// + gradient since it a maximization task
+							stepV =  - ( w * (2.0 * tmpSigVal - 1.0) * y);						
+							break;
+					}
+					vs[it->idx] = vs[it->idx] - gammat * stepV;
+				}
+				normalizeLength( vs );
+				sigmoidOffSet = tmpSigmoidOffSet;
+				sigmoidSlope = tmpSigmoidSlopes;
+			}
+			return;
+		}
+		
+		// the buffers of the (mini-)batch steps
+		vector<AlphaReal> vImprovement(numClasses);
+		vector<FeatureReal> vals;
+		vector<FeatureReal> sigVals;
+		
+		if ( _gMethod == OPT_BGD )
+		{
+			vals.resize(numExamples);
+			sigVals.resize(numExamples);
+			for (int gradi=0; gradi<_maxIter; ++gradi)
+				batchStep( j, NULL, 0, numExamples, gammas[gradi * numColumns + j], 1.0, 
+						   sigmoidSlope, sigmoidOffSet, vs, vImprovement, vals, sigVals );
+		}
+		else
+		{
+			vals.resize(_miniBatchSize);
+			sigVals.resize(_miniBatchSize);
+			int step = 0;
+			for (int gradi=0; gradi<_maxIter; ++gradi)
+			{
+				for (int begin = 0; begin < numExamples; begin += _miniBatchSize, ++step)
+				{
+					const int end = min( begin + _miniBatchSize, numExamples );
+					// the sum over the mini-batch is scaled to the whole training set
+					batchStep( j, &randomPermutation[0], begin, end, gammas[step], 
+							   (AlphaReal)numExamples / (AlphaReal)(end - begin),
+							   sigmoidSlope, sigmoidOffSet, vs, vImprovement, vals, sigVals );
+				}
+			}
+		}
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	void SigmoidSingleStumpLearner::batchStep( int j, const int* pIndices, int begin, int end, 
+											   AlphaReal gammat, AlphaReal scale,
+											   FeatureReal& sigmoidSlope, FeatureReal& sigmoidOffSet, vector<AlphaReal>& vs, 
+											   vector<AlphaReal>& vImprovement, vector<FeatureReal>& vals, 
+											   vector<FeatureReal>& sigVals )
+	{
+		const int batchSize = end - begin;
+		
+		AlphaReal slopeImporvemement = 0.0;
+		AlphaReal offsetImporvemement = 0.0;
+		fill(vImprovement.begin(),vImprovement.end(),0.0);
+		
+		// gather the values of the batch first, so the sigmoids are computed
+		// in a tight loop over contiguous arrays
+		for (int k = 0; k < batchSize; ++k)
+			vals[k] = _pTrainingData->getValue( pIndices ? pIndices[begin + k] : begin + k, j );
+		for (int k = 0; k < batchSize; ++k)
+			sigVals[k] = sigmoid( vals[k], sigmoidSlope, sigmoidOffSet );
+		
+		for (int k = 0; k < batchSize; ++k)
+		{
+			const int idx = pIndices ? pIndices[begin + k] : begin + k;
+			const vector<Label>& labels = _pTrainingData->getLabels( idx );
+			const FeatureReal val = vals[k];
+			const FeatureReal tmpSigVal = sigVals[k];
+			
+			AlphaReal deltaQ = 0.0;
+			switch (_tFunction) {
+				case TF_EXPLOSS:							
+					for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+					{
+						const char y = _pTrainingData->getLabelY(idx, *it);
+						const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
+						deltaQ += exp( -vs[it->idx] * y * ( 2*tmpSigVal-1 ) )
+						* 2.0 * w*vs[it->idx]*y*tmpSigVal*(1.0-tmpSigVal);
+					}
+					
+					offsetImporvemement -= deltaQ;
+					slopeImporvemement -= (deltaQ*val);
+					
+					for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+					{
+						const char y = _pTrainingData->getLabelY(idx, *it);
+						const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
+						// + gradient since it a maximization task
+						vImprovement[it->idx] -= exp( -vs[it->idx] * y * ( 2*tmpSigVal-1 ) ) 
+						* ( w * (2.0 * tmpSigVal - 1.0) * y);
+					}
+					break;
+				case TF_EDGE:
+					for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+					{
+						const char y = _pTrainingData->getLabelY(idx, *it);
+						const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
+						deltaQ += 2.0 * w*vs[it->idx]*y*tmpSigVal*(1.0-tmpSigVal);
+					}
+					
+					offsetImporvemement -= deltaQ;
+					slopeImporvemement -= (deltaQ*val);
+					
+					for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+					{
+						const char y = _pTrainingData->getLabelY(idx, *it);
+						const AlphaReal w = _pTrainingData->getLabelWeight(idx, *it);
+						// + gradient since it a maximization task
+						vImprovement[it->idx] -= ( w * (2.0 * tmpSigVal - 1.0) * y);
+					}
+					break;
+			}
+		}
+		
+		const AlphaReal gammaScaled = gammat * scale;
+		
+		//update the current parameter vector
+		for( int iimp=0; iimp < (int)vImprovement.size(); ++iimp )
+		{
+			// + gradient since it a maximization task						
+			vs[iimp] -= gammaScaled * vImprovement[iimp];
+		}
+		normalizeLength( vs );
+		sigmoidOffSet -= gammaScaled * offsetImporvemement;
+		sigmoidSlope -= gammaScaled * slopeImporvemement;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	AlphaReal SigmoidSingleStumpLearner::getColumnEdge( int j, FeatureReal sigmoidOffSet, const vector<AlphaReal>& vs )
+	{
+		// the same as getEdge() with the column, the offset and the signs of vs selected
+		AlphaReal sumPos = 0.0;
+		AlphaReal sumNeg = 0.0;
+		
+		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
+			const AlphaReal phiVal = _pTrainingData->getValue( i, j ) > sigmoidOffSet ? -1 : +1;
+			const vector< Label >& l = _pTrainingData->getLabels( i );
+			
+			for( vector<Label>::const_iterator it = l.begin(); it !=  l.end(); it++ ) {
+				const char y = _pTrainingData->getLabelY(i, *it);
+				const AlphaReal w = _pTrainingData->getLabelWeight(i, *it);
+				AlphaReal cl = ( vs[it->idx] < 0 ? -1.0 : 1.0 ) * phiVal;
+				AlphaReal tmpVal = cl * w * y;
+				if ( tmpVal >= 0.0 ) sumPos += tmpVal;
+				else sumNeg -= tmpVal;
+			}
+		}
+		
+		AlphaReal edge = sumPos - sumNeg;
+		AlphaReal sumEdge = sumNeg + sumPos;
+		if ( ! nor_utils::is_zero( sumEdge ) ) edge /= sumEdge; 
+		return edge;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
 	AlphaReal SigmoidSingleStumpLearner::run( int colIdx )
 	{
 		const int numClasses = _pTrainingData->getNumClasses();
@@ -508,9 +679,6 @@ namespace MultiBoost {
 		
 		AlphaReal energyForCurrentInstance = 0.0;
 		
-		AlphaReal stepOffSet, stepSlope, stepV;
-		vector<Label> labels = _pTrainingData->getLabels(trainingInstanceIdx);				
-		
 		// best column perf. before update
 		AlphaReal bestEdgeBefore = -numeric_limits<FeatureReal>::max();
 		for( int i = 0; i < _edges.size(); ++i )
@@ -524,85 +692,8 @@ namespace MultiBoost {
 		
 		
 		
-		for (int j = 0; j < numColumns; ++j)
-		{			
-			FeatureReal val = _pTrainingData->getValue(trainingInstanceIdx, j);					
-			FeatureReal tmpSigVal = sigmoid(val,_sigmoidSlopes[j],_sigmoidOffSets[j]);			
-			
-			AlphaReal sig = sigmoid(val,_sigmoidSlopes[j],_sigmoidOffSets[j]);
-			AlphaReal scaledSigmoid = 2*sig-1;
-			AlphaReal partialSigmoid = sig * (1.0 - sig);
-			
-			AlphaReal deltaQ = 0.0;
-			
-			switch (_tFunction) {
-				case TF_EXPLOSS:
-					for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-					{
-						AlphaReal expLoss = exp(-1.0 * _vsArray[j][it->idx] * scaledSigmoid * it->y);
-						deltaQ += expLoss * 2.0 * it->weight*_vsArray[j][it->idx]*it->y*partialSigmoid;
-						
-						stepV = expLoss * it->weight * scaledSigmoid * it->y;
-						_vsArray[j][it->idx] = _vsArray[j][it->idx] - _gammat * stepV;						
-						//_vsArray[j][it->idx] = (1.0 - 1.0 / _age) * _vsArray[j][it->idx] + nu * stepV; 
-					}
-					
-					stepOffSet = -deltaQ;
-					stepSlope  = -deltaQ * val;							
-					break;
-				case TF_EDGE:
-					for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-					{
-						deltaQ += 2.0 * it->weight*_vsArray[j][it->idx]*it->y*partialSigmoid;
-						
-						stepV =  - ( it->weight * scaledSigmoid * it->y);	
-						_vsArray[j][it->idx] = _vsArray[j][it->idx] + _gammat * stepV;
-					}
-					
-					// because edge should be maximized
-					stepOffSet = deltaQ;
-					stepSlope  = deltaQ * val;
-					break;
-				default:
-					break;
-			}
-			
-			normalizeLength( _vsArray[j] );
-			// gradient step
-			FeatureReal tmpSigmoidOffSet = _sigmoidOffSets[j] - static_cast<FeatureReal>(_gammat * stepOffSet);										
-			FeatureReal tmpSigmoidSlopes = _sigmoidSlopes[j] - static_cast<FeatureReal>(_gammat * stepSlope);															
-			//			FeatureReal tmpSigmoidOffSet = (1.0 - 1.0 / _age) * _sigmoidOffSets[j] + static_cast<FeatureReal>(nu * stepOffSet);										
-			//			FeatureReal tmpSigmoidSlopes = (1.0 - 1.0 / _age) * _sigmoidSlopes[j] + static_cast<FeatureReal>(nu * stepSlope);															
-			
-			
-			_sigmoidOffSets[j] = tmpSigmoidOffSet;
-			_sigmoidSlopes[j] = tmpSigmoidSlopes;
-			
-		}					
-
-		// calculate the edges before update the parameters
-		for (int j = 0; j < numColumns; ++j)
-		{
-			FeatureReal val = _pTrainingData->getValue(trainingInstanceIdx, j);
-			FeatureReal sig = sigmoid(val,_sigmoidSlopes[j],_sigmoidOffSets[j]);
-			
-			
-			for( vector< Label >::iterator it = labels.begin(); it != labels.end(); it++ )
-			{
-				AlphaReal delta = 0.0;
-//				switch (_tFunction) {
-//					case TF_EXPLOSS:
-//						delta = it->weight * exp( it->y * sig * _vsArray[j][it->idx]);
-//					case TF_EDGE:
-//						delta = it->weight * it->y * sig * _vsArray[j][it->idx];
-//					default:
-//						break;
-//				}
-				delta = it->weight * it->y * sig * _vsArray[j][it->idx];
-				_edges[j] += delta;
-				_sumEdges[j] += (delta>0) ? delta : -delta;
-			}
-		}
+		// the columns are updated independently
+		parallel_for( blocked_range<int>( 0, numColumns, 64 ), SigmoidColumnUpdate( this, trainingInstanceIdx ) );
 		
 		// best column perf. after update
 		AlphaReal bestEdgeAfter = -numeric_limits<FeatureReal>::max();
@@ -633,6 +724,73 @@ namespace MultiBoost {
 		
 		return energyForCurrentInstance;							
 	}
+	// -----------------------------------------------------------------------	
+	
+	void SigmoidSingleStumpLearner::updateColumn( int j, int trainingInstanceIdx )
+	{
+		AlphaReal stepOffSet, stepSlope, stepV;
+		const vector<Label>& labels = _pTrainingData->getLabels(trainingInstanceIdx);
+		
+		FeatureReal val = _pTrainingData->getValue(trainingInstanceIdx, j);					
+		
+		AlphaReal sig = sigmoid(val,_sigmoidSlopes[j],_sigmoidOffSets[j]);
+		AlphaReal scaledSigmoid = 2*sig-1;
+		AlphaReal partialSigmoid = sig * (1.0 - sig);
+		
+		AlphaReal deltaQ = 0.0;
+		
+		switch (_tFunction) {
+			case TF_EXPLOSS:
+				for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+				{
+					const char y = _pTrainingData->getLabelY(trainingInstanceIdx, *it);
+					const AlphaReal w = _pTrainingData->getLabelWeight(trainingInstanceIdx, *it);
+					AlphaReal expLoss = exp(-1.0 * _vsArray[j][it->idx] * scaledSigmoid * y);
+					deltaQ += expLoss * 2.0 * w*_vsArray[j][it->idx]*y*partialSigmoid;
+					
+					stepV = expLoss * w * scaledSigmoid * y;
+					_vsArray[j][it->idx] = _vsArray[j][it->idx] - _gammat * stepV;						
+				}
+				
+				stepOffSet = -deltaQ;
+				stepSlope  = -deltaQ * val;							
+				break;
+			case TF_EDGE:
+				for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+				{
+					const char y = _pTrainingData->getLabelY(trainingInstanceIdx, *it);
+					const AlphaReal w = _pTrainingData->getLabelWeight(trainingInstanceIdx, *it);
+					deltaQ += 2.0 * w*_vsArray[j][it->idx]*y*partialSigmoid;
+					
+					stepV =  - ( w * scaledSigmoid * y);	
+					_vsArray[j][it->idx] = _vsArray[j][it->idx] + _gammat * stepV;
+				}
+				
+				// because edge should be maximized
+				stepOffSet = deltaQ;
+				stepSlope  = deltaQ * val;
+				break;
+			default:
+				break;
+		}
+		
+		normalizeLength( _vsArray[j] );
+		// gradient step
+		_sigmoidOffSets[j] = _sigmoidOffSets[j] - static_cast<FeatureReal>(_gammat * stepOffSet);										
+		_sigmoidSlopes[j] = _sigmoidSlopes[j] - static_cast<FeatureReal>(_gammat * stepSlope);															
+		
+		// the edge of the column with the updated parameters
+		sig = sigmoid(val,_sigmoidSlopes[j],_sigmoidOffSets[j]);
+		for( vector< Label >::const_iterator it = labels.begin(); it != labels.end(); it++ )
+		{
+			const char y = _pTrainingData->getLabelY(trainingInstanceIdx, *it);
+			const AlphaReal w = _pTrainingData->getLabelWeight(trainingInstanceIdx, *it);
+			AlphaReal delta = w * y * sig * _vsArray[j][it->idx];
+			_edges[j] += delta;
+			_sumEdges[j] += (delta>0) ? delta : -delta;
+		}
+	}
+	
 	// -----------------------------------------------------------------------	
 	void SigmoidSingleStumpLearner::initLearning()
 	{
@@ -57,6 +57,9 @@ using namespace std;
 
 namespace MultiBoost {
 	
+	class SigmoidColumnTraining;
+	class SigmoidColumnUpdate;
+	
 	/**
 	 * A \b single threshold decision stump learner. 
 	 * There is ONE and ONE ONLY threshold here.
@@ -140,6 +143,8 @@ namespace MultiBoost {
 		
 		/**
 		 * Run the learner to build the classifier on the given data.
+		 * The columns are optimized in parallel, each one with its own parameters,
+		 * and the column of the best edge is selected.
 		 * \param pData The pointer to the data.
 		 * \see BaseLearner::run
 		 * \date 11/11/2005
@@ -206,6 +211,45 @@ namespace MultiBoost {
 		
 		void normalizeLength( vector<AlphaReal>& vec );
 		
+		/**
+		 * Optimize the parameters of one column with the gradient method of the learner.
+		 * \param j The column.
+		 * \param randomPermutation The order of the examples (OPT_SGD and OPT_MBGD).
+		 * \param gammas The learning rates of the steps.
+		 * \param sigmoidSlope The slope of the column, updated.
+		 * \param sigmoidOffSet The offset of the column, updated.
+		 * \param vs The vote vector of the column, updated.
+		 * \date 19/10/2026
+		 */
+		void trainColumn( int j, const vector<int>& randomPermutation, const vector<AlphaReal>& gammas,
+						  FeatureReal& sigmoidSlope, FeatureReal& sigmoidOffSet, vector<AlphaReal>& vs );
+		
+		/**
+		 * One gradient step of a column on the examples [begin, end) of a batch.
+		 * The values and the sigmoids of the batch are computed first in the
+		 * buffers \a vals and \a sigVals.
+		 * \param pIndices The indices of the examples, NULL for the identity.
+		 * \param scale The factor of the sum of the gradients over the batch.
+		 * \date 19/10/2026
+		 */
+		void batchStep( int j, const int* pIndices, int begin, int end, AlphaReal gammat, AlphaReal scale,
+						FeatureReal& sigmoidSlope, FeatureReal& sigmoidOffSet, vector<AlphaReal>& vs,
+						vector<AlphaReal>& vImprovement, vector<FeatureReal>& vals, vector<FeatureReal>& sigVals );
+		
+		/**
+		 * The normalized edge of the stump on column \a j, with the given offset and
+		 * the signs of \a vs as votes. It is equal to getEdge() of the stump.
+		 * \date 19/10/2026
+		 */
+		AlphaReal getColumnEdge( int j, FeatureReal sigmoidOffSet, const vector<AlphaReal>& vs );
+		
+		/**
+		 * Update the parameters and the running edge of column \a j with one example.
+		 * \see update
+		 * \date 19/10/2026
+		 */
+		void updateColumn( int j, int trainingInstanceIdx );
+		
 		/**
 		 * A discriminative function. 
 		 * \remarks Positive or negative do NOT refer to positive or negative classification.
@@ -252,6 +296,9 @@ namespace MultiBoost {
 		vector<vector<AlphaReal> >	_vsArray;
 		vector<AlphaReal>			_edges;
 		vector<AlphaReal>			_sumEdges;
+		
+		friend class SigmoidColumnTraining;
+		friend class SigmoidColumnUpdate;
 	};
 	
 	//////////////////////////////////////////////////////////////////////////
@@ -41,11 +41,113 @@
 #include <limits> // for numeric_limits<>
 #include <sstream> // for _id
 
+#include "tbb/parallel_reduce.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 
 //REGISTER_LEARNER_NAME(SingleStump, SingleSparseStump)
 REGISTER_LEARNER(SingleSparseStump)
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The body of the parallel search of the two thresholds over a list of columns.
+ * Each copy filters the columns in its own view of the training data and has its
+ * own SparseStumpAlgorithm, and keeps the first column (in the list order) with 
+ * the lowest energy and a positive alpha.
+ * \see SparseColumnSearch
+ * \date 19/10/2026
+ */
+class SparseStumpColumnSearch {
+public:
+   SparseStumpColumnSearch(SingleSparseStump* pLearner, const vector<int>& columns, 
+                           const SparseStumpAlgorithm<FeatureReal>& sAlgo)
+   : _pLearner(pLearner), _pColumns(&columns), _sAlgo(sAlgo), _pView(NULL)
+   { init(); }
+
+   SparseStumpColumnSearch(SparseStumpColumnSearch& other, split)
+   : _pLearner(other._pLearner), _pColumns(other._pColumns), _sAlgo(other._sAlgo), _pView(NULL)
+   { init(); }
+
+   ~SparseStumpColumnSearch() { delete _pView; }
+
+   void operator()( const blocked_range<int>& range ) {
+      if ( _pView == NULL )
+         _pView = _pLearner->_pTrainingData->createView();
+      SortedData* pView = static_cast<SortedData*>(_pView);
+
+      for( int i = range.begin(); i != range.end(); ++i ) {
+         const pair<vpIterator,vpIterator> dataBeginEnd = 
+            pView->getFileteredBeginEnd( (*_pColumns)[i] );
+
+         // there is no cut
+         if ( pView->isFilteredAttributeEmpty() ) continue;
+         if ( pView->isFilteredAttributeHasOneValue() ) continue;
+
+         // also sets mu, tmpV, and bestHalfEdge
+         _sAlgo.findSingleThresholdWithInit(dataBeginEnd.first, dataBeginEnd.second, _pView, 
+                                            _tmpThresholds, _pLearner->_theta, &_mu, &_tmpV);
+
+         if (_tmpThresholds[0] == _tmpThresholds[0]) // tricky way to test Nan
+         {
+            AlphaReal tmpAlpha;
+            AlphaReal tmpEnergy = _pLearner->getEnergy(_mu, tmpAlpha, _tmpV);
+
+            if (tmpEnergy < _bestEnergy && tmpAlpha > 0)
+            {
+               _bestIdx = i;
+               _bestEnergy = tmpEnergy;
+               _bestAlpha = tmpAlpha;
+               _bestV = _tmpV;
+               _bestThresholds = _tmpThresholds;
+            }
+         }
+      }
+   }
+
+   void join( const SparseStumpColumnSearch& other ) {
+      if ( other._bestIdx < 0 ) return;
+      if ( _bestIdx < 0 || other._bestEnergy < _bestEnergy ||
+         ( other._bestEnergy == _bestEnergy && other._bestIdx < _bestIdx ) )
+      {
+         _bestIdx = other._bestIdx;
+         _bestEnergy = other._bestEnergy;
+         _bestAlpha = other._bestAlpha;
+         _bestV = other._bestV;
+         _bestThresholds = other._bestThresholds;
+      }
+   }
+
+   int                  _bestIdx; //!< The position of the best column in the list, -1 if none.
+   AlphaReal            _bestEnergy;
+   AlphaReal            _bestAlpha;
+   vector<AlphaReal>    _bestV;
+   vector<FeatureReal>  _bestThresholds;
+
+private:
+
+   void init() {
+      const int numClasses = _pLearner->_pTrainingData->getNumClasses();
+      _mu.resize( numClasses );
+      _tmpV.resize( numClasses );
+      _bestIdx = -1;
+      _bestEnergy = numeric_limits<AlphaReal>::max();
+   }
+
+   SingleSparseStump*                  _pLearner;
+   const vector<int>*                  _pColumns;
+   SparseStumpAlgorithm<FeatureReal>   _sAlgo;
+
+   InputData*           _pView; //!< The view of the training data in which the columns are filtered.
+   vector<sRates>       _mu; //!< The class-wise rates.
+   vector<AlphaReal>    _tmpV; //!< The class-wise votes/abstentions.
+   vector<FeatureReal>  _tmpThresholds; //!< The two thresholds.
+};
+
 // ------------------------------------------------------------------------------
 
 AlphaReal SingleSparseStump::run()
@@ -57,26 +159,16 @@ AlphaReal SingleSparseStump::run()
    // when theta=0.
    setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
 
-   vector<sRates> mu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-   vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-   
-   vector<FeatureReal> tmpThresholds;
    _threshold.resize(2);
 
-   AlphaReal tmpAlpha;
-
    AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
-   AlphaReal tmpEnergy;
 
    SparseStumpAlgorithm<FeatureReal> sAlgo(numClasses);
    sAlgo.initSearchLoop(_pTrainingData);
    
-   AlphaReal halfTheta;
-   if ( _abstention == ABST_REAL || _abstention == ABST_CLASSWISE )
-      halfTheta = _theta/2.0;
-   else
-      halfTheta = 0;
-
+   // the columns are drawn first, so that the random sequence does not
+   // depend on the search
+   vector<int> columns;
    int numOfDimensions = _maxNumOfDimensions;
    for (int j = 0; j < numColumns; ++j)
    {
@@ -87,45 +179,24 @@ AlphaReal SingleSparseStump::run()
       if ( static_cast<float>(numOfDimensions) / rest > r ) 
       {
          --numOfDimensions;
-         const pair<vpIterator,vpIterator> dataBeginEnd = 
-			 static_cast<SortedData*>(_pTrainingData)->getFileteredBeginEnd(j);
-		 
+         columns.push_back( j );
+      }
+   }
 
-         const vpIterator dataBegin = dataBeginEnd.first;
-         const vpIterator dataEnd = dataBeginEnd.second;
-		 
-		 // there is no cut
-		 if ( static_cast<SortedData*>(_pTrainingData)->isFilteredAttributeEmpty() ) continue;
-		 if ( static_cast<SortedData*>(_pTrainingData)->isFilteredAttributeHasOneValue() ) continue;
+   // small inconsistency compared to the standard algo (but a good
+   // trade-off): in findThreshold we maximize the edge (suboptimal but
+   // fast) but here (among dimensions) we minimize the energy.
+   SparseStumpColumnSearch search(this, columns, sAlgo);
+   parallel_reduce( blocked_range<int>( 0, (int)columns.size() ), search );
 
-         // also sets mu, tmpV, and bestHalfEdge
-		 sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, tmpThresholds, _theta, &mu, &tmpV);
-		 
-         if (tmpThresholds[0] == tmpThresholds[0]) // tricky way to test Nan
-         { 
-            // small inconsistency compared to the standard algo (but a good
-            // trade-off): in findThreshold we maximize the edge (suboptimal but
-            // fast) but here (among dimensions) we minimize the energy.
-            tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
-
-            if (tmpEnergy < bestEnergy && tmpAlpha > 0)
-            {
-               // Store it in the current weak hypothesis.
-               // note: I don't really like having so many temp variables
-               // but the alternative would be a structure, which would need
-               // to be inheritable to make things more consistent. But this would
-               // make it less flexible. Therefore, I am still undecided. This
-               // might change!
-
-               _alpha = tmpAlpha;
-               _v = tmpV;
-               _selectedColumn = j;
-			   copy( tmpThresholds.begin(), tmpThresholds.end(), _threshold.begin() );
-
-               bestEnergy = tmpEnergy;
-            }
-         } // tmpThreshold == tmpThreshold
-      }
+   if ( search._bestIdx >= 0 )
+   {
+      _alpha = search._bestAlpha;
+      _v = search._bestV;
+      _selectedColumn = columns[search._bestIdx];
+      copy( search._bestThresholds.begin(), search._bestThresholds.end(), _threshold.begin() );
+
+      bestEnergy = search._bestEnergy;
    }
 
 	if ( _selectedColumn != -1 )
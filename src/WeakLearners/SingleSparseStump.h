@@ -56,6 +56,8 @@ using namespace std;
 
 namespace MultiBoost {
 	
+	class SparseStumpColumnSearch;
+	
 	/**
 	 * A \b double thresholds decision stump learner. 
 	 * There are TWO thresholds, between the thresholds it returns with 0.
@@ -212,6 +214,8 @@ namespace MultiBoost {
 		
 		
 		vector<FeatureReal> _threshold; //!< for both thresholds of the decision stump, agnostic case
+		
+		friend class SparseStumpColumnSearch;
 	};
 	
 	//////////////////////////////////////////////////////////////////////////
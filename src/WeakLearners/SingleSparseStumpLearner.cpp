@@ -37,6 +37,7 @@
 #include "IO/SortedData.h"
 #include "Algorithms/StumpAlgorithmLSHTC.h"
 #include "Algorithms/ConstantAlgorithmLSHTC.h"
+#include "WeakLearners/SparseColumnSearch.h"
 
 #include <limits> // for numeric_limits<>
 #include <sstream> // for _id
@@ -57,14 +58,7 @@ namespace MultiBoost {
 		// when theta=0.
 		setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
 		
-		vector<sRates> mu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-		
-		FeatureReal tmpThreshold;
-		AlphaReal tmpAlpha;
-		
 		AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
-		AlphaReal tmpEnergy;
 		
 		StumpAlgorithmLSHTC<FeatureReal> sAlgo(numClasses);
 		sAlgo.initSearchLoop(_pTrainingData);
@@ -75,6 +69,9 @@ namespace MultiBoost {
 		else
 			halfTheta = 0;
 		
+		// the columns are drawn first, so that the random sequence does not
+		// depend on the search
+		vector<int> columns;
 		int numOfDimensions = _maxNumOfDimensions;
 		for (int j = 0; j < numColumns; ++j)
 		{
@@ -85,51 +82,26 @@ namespace MultiBoost {
 			if ( static_cast<float>(numOfDimensions) / rest > r ) 
 			{
 				--numOfDimensions;
-				
-				//if ( static_cast<SortedData*>(_pTrainingData)->isAttributeEmpty( j ) ) continue;
-				
-				const pair<vpReverseIterator,vpReverseIterator> dataBeginEnd = 
-				static_cast<SortedData*>(_pTrainingData)->getFileteredReverseBeginEnd(j);
-				
-				//if ( static_cast<SortedData*>(_pTrainingData)->isFilteredAttributeEmpty() ) continue;
-				//if ( static_cast<SortedData*>(_pTrainingData)->isFilteredAttributeHasOneValue() ) continue;
-				
-				const vpReverseIterator dataBegin = dataBeginEnd.first;
-				const vpReverseIterator dataEnd = dataBeginEnd.second;
-				
-				
-				
-				// also sets mu, tmpV, and bestHalfEdge
-				tmpThreshold = sAlgo.findSingleThresholdWithInit(dataBegin, dataEnd, _pTrainingData, 
-																 halfTheta, &mu, &tmpV);
-				
-				if (tmpThreshold == tmpThreshold) // tricky way to test Nan
-				{ 
-					// small inconsistency compared to the standard algo (but a good
-					// trade-off): in findThreshold we maximize the edge (suboptimal but
-					// fast) but here (among dimensions) we minimize the energy.
-					tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
-					
-					if (tmpEnergy < bestEnergy && tmpAlpha > 0)
-					{
-						// Store it in the current weak hypothesis.
-						// note: I don't really like having so many temp variables
-						// but the alternative would be a structure, which would need
-						// to be inheritable to make things more consistent. But this would
-						// make it less flexible. Therefore, I am still undecided. This
-						// might change!
-						
-						_alpha = tmpAlpha;
-						_v = tmpV;
-						_selectedColumn = j;
-						_threshold = tmpThreshold;
-						
-						bestEnergy = tmpEnergy;
-					}
-				} // tmpThreshold == tmpThreshold
+				columns.push_back( j );
 			}
 		}
 		
+		// small inconsistency compared to the standard algo (but a good
+		// trade-off): in findThreshold we maximize the edge (suboptimal but
+		// fast) but here (among dimensions) we minimize the energy.
+		SparseColumnSearch<SingleSparseStumpLearner> search(this, columns, sAlgo, halfTheta);
+		parallel_reduce( blocked_range<int>( 0, (int)columns.size() ), search );
+		
+		if ( search._bestIdx >= 0 )
+		{
+			_alpha = search._bestAlpha;
+			_v = search._bestV;
+			_selectedColumn = columns[search._bestIdx];
+			_threshold = search._bestThreshold;
+			
+			bestEnergy = search._bestEnergy;
+		}
+		
 		if ( _selectedColumn != -1 )
 		{
 			stringstream thresholdString;
@@ -56,6 +56,8 @@ using namespace std;
 
 namespace MultiBoost {
 	
+	template <typename LearnerT> class SparseColumnSearch;
+	
 	/**
 	 * A \b single threshold decision stump learner. 
 	 * There is ONE and ONE ONLY threshold here. It works on sparse features.
@@ -92,6 +94,8 @@ namespace MultiBoost {
 		virtual AlphaReal run( int colIdx );
 		
 	protected:
+		
+		template <typename LearnerT> friend class SparseColumnSearch;
 	};
 	
 	//////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,195 @@
+/*
+ *
+ *    MultiBoost - Multi-purpose boosting package
+ *
+ *    Copyright (C)        AppStat group
+ *                         Laboratoire de l'Accelerateur Lineaire
+ *                         Universite Paris-Sud, 11, CNRS
+ *
+ *    This file is part of the MultiBoost library
+ *
+ *    This library is free software; you can redistribute it 
+ *    and/or modify it under the terms of the GNU General Public
+ *    License as published by the Free Software Foundation
+ *    version 2.1 of the License.
+ *
+ *    This library is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *    General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public
+ *    License along with this library; if not, write to the Free Software
+ *    Foundation, Inc., 51 Franklin St, 5th Floor, Boston, MA 02110-1301 USA
+ *
+ *    Contact: multiboost@googlegroups.com 
+ * 
+ *    For more information and up-to-date version, please visit
+ *        
+ *                       http://www.multiboost.org/
+ *
+ */
+
+
+/**
+ * \file SparseColumnSearch.h The parallel threshold search of the sparse stump learners.
+ */
+
+#ifndef __SPARSE_COLUMN_SEARCH_H
+#define __SPARSE_COLUMN_SEARCH_H
+
+#include "IO/InputData.h"
+#include "IO/SortedData.h"
+#include "Algorithms/StumpAlgorithmLSHTC.h"
+
+#include <vector>
+#include <limits> // for numeric_limits<>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_reduce.h"
+
+using namespace std;
+using namespace tbb;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace MultiBoost {
+	
+	/**
+	 * The result of the threshold search on one column (see SparseColumnSearch).
+	 * \date 19/10/2026
+	 */
+	struct SparseColumnResult
+	{
+		FeatureReal			threshold; //!< The threshold found, NaN if there is none.
+		AlphaReal			energy; //!< The energy of the stump.
+		AlphaReal			alpha; //!< The alpha of the stump.
+		AlphaReal			edge; //!< The sum of rPls - rMin over the classes.
+		vector<AlphaReal>	v; //!< The class-wise votes/abstentions.
+	};
+	
+	/**
+	 * The body of the parallel threshold search over a list of columns of sparse data.
+	 * The sorted columns hold the non-zero values only, and StumpAlgorithmLSHTC starts
+	 * from the edges of the constant learner, so that the zeros are never visited.
+	 * Each copy of the body filters the columns in its own view of the training data
+	 * (see InputData::createView) and has its own copy of the StumpAlgorithmLSHTC, so 
+	 * initSearchLoop() is called once, before the search. It keeps the first column 
+	 * (in the list order) with the lowest energy and a positive alpha, as the sequential 
+	 * loop does.
+	 * \remark LearnerT must declare SparseColumnSearch as friend, for getEnergy().
+	 * \date 19/10/2026
+	 */
+	template <typename LearnerT>
+	class SparseColumnSearch {
+	public:
+		/**
+		 * The constructor.
+		 * \param pLearner The learner, its training data is searched.
+		 * \param columns The indices of the columns to search.
+		 * \param sAlgo The stump algorithm, initSearchLoop() already called.
+		 * \param halfTheta The half of the edge offset theta.
+		 * \param pResults If not NULL, the result of each column is stored at the position
+		 * of the column in \a columns (it must have the same size).
+		 * \date 19/10/2026
+		 */
+		SparseColumnSearch(LearnerT* pLearner, const vector<int>& columns, 
+						   const StumpAlgorithmLSHTC<FeatureReal>& sAlgo, AlphaReal halfTheta,
+						   vector<SparseColumnResult>* pResults = NULL)
+		: _pLearner(pLearner), _pColumns(&columns), _sAlgo(sAlgo), _halfTheta(halfTheta), 
+		  _pResults(pResults), _pView(NULL)
+		{ init(); }
+		
+		SparseColumnSearch(SparseColumnSearch& other, split)
+		: _pLearner(other._pLearner), _pColumns(other._pColumns), _sAlgo(other._sAlgo), 
+		  _halfTheta(other._halfTheta), _pResults(other._pResults), _pView(NULL)
+		{ init(); }
+		
+		~SparseColumnSearch() { delete _pView; }
+		
+		void operator()( const blocked_range<int>& range ) {
+			if ( _pView == NULL )
+				_pView = _pLearner->_pTrainingData->createView();
+			
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				const int colIdx = (*_pColumns)[i];
+				
+				const pair<vpReverseIterator,vpReverseIterator> dataBeginEnd = 
+					static_cast<SortedData*>(_pView)->getFileteredReverseBeginEnd( colIdx );
+				
+				// also sets mu and tmpV
+				FeatureReal tmpThreshold = _sAlgo.findSingleThresholdWithInit(dataBeginEnd.first, dataBeginEnd.second, 
+																			 _pView, _halfTheta, &_mu, &_tmpV);
+				
+				AlphaReal tmpAlpha = 0;
+				AlphaReal tmpEnergy = _pLearner->getEnergy(_mu, tmpAlpha, _tmpV);
+				
+				if ( _pResults ) {
+					SparseColumnResult& result = (*_pResults)[i];
+					result.threshold = tmpThreshold;
+					result.energy = tmpEnergy;
+					result.alpha = tmpAlpha;
+					result.edge = 0.0;
+					for ( vector<sRates>::iterator itR = _mu.begin(); itR != _mu.end(); ++itR ) 
+						result.edge += ( itR->rPls - itR->rMin );
+					result.v = _tmpV;
+				}
+				
+				if ( tmpThreshold == tmpThreshold && // tricky way to test Nan
+					 tmpEnergy < _bestEnergy && tmpAlpha > 0 )
+				{
+					_bestIdx = i;
+					_bestEnergy = tmpEnergy;
+					_bestAlpha = tmpAlpha;
+					_bestThreshold = tmpThreshold;
+					_bestV = _tmpV;
+				}
+			}
+		}
+		
+		void join( const SparseColumnSearch& other ) {
+			if ( other._bestIdx < 0 ) return;
+			if ( _bestIdx < 0 || other._bestEnergy < _bestEnergy ||
+				( other._bestEnergy == _bestEnergy && other._bestIdx < _bestIdx ) )
+			{
+				_bestIdx = other._bestIdx;
+				_bestEnergy = other._bestEnergy;
+				_bestAlpha = other._bestAlpha;
+				_bestThreshold = other._bestThreshold;
+				_bestV = other._bestV;
+			}
+		}
+		
+		int					_bestIdx; //!< The position of the best column in the list, -1 if none.
+		AlphaReal			_bestEnergy;
+		AlphaReal			_bestAlpha;
+		FeatureReal			_bestThreshold;
+		vector<AlphaReal>	_bestV;
+		
+	private:
+		
+		void init() {
+			const int numClasses = _pLearner->_pTrainingData->getNumClasses();
+			_mu.resize( numClasses );
+			_tmpV.resize( numClasses );
+			_bestIdx = -1;
+			_bestEnergy = numeric_limits<AlphaReal>::max();
+		}
+		
+		LearnerT*							_pLearner;
+		const vector<int>*					_pColumns;
+		StumpAlgorithmLSHTC<FeatureReal>	_sAlgo;
+		AlphaReal							_halfTheta;
+		vector<SparseColumnResult>*			_pResults;
+		
+		InputData*				_pView; //!< The view of the training data in which the columns are filtered.
+		vector<sRates>			_mu; //!< The class-wise rates.
+		vector<AlphaReal>		_tmpV; //!< The class-wise votes/abstentions.
+	};
+	
+	//////////////////////////////////////////////////////////////////////////
+	
+} // end of namespace MultiBoost
+
+#endif // __SPARSE_COLUMN_SEARCH_H
@@ -49,10 +49,16 @@ namespace MultiBoost {
 		
 		args.declareArgument("gradmethod",
 							 "Declares the gradient method: "
-							 " (sgd) Stochastic Gradient Descent, (bgd) Batch Gradient Descent"
+							 " (sgd) Stochastic Gradient Descent, (bgd) Batch Gradient Descent,"
+							 " (mbgd) Mini-Batch Gradient Descent "
 							 "Example: --gradmethod sgd -> Uses stochastic gradient method",
 							 1, "<method>");
 		
+		args.declareArgument("minibatch",
+							 "The number of examples of a step of the mini-batch gradient descent"
+							 " (--gradmethod mbgd). Default value is 100",
+							 1, "<size>");
+		
 		args.declareArgument("tfunc",
 							 "Target function: "
 							 "exploss: Exponential Loss, edge: max. edge"
@@ -88,6 +94,15 @@ namespace MultiBoost {
 		if (args.hasArgument("graditer"))
 			args.getValue("graditer", 0, _maxIter);   		
 		
+		if (args.hasArgument("minibatch"))
+		{
+			args.getValue("minibatch", 0, _miniBatchSize);
+			if ( _miniBatchSize < 1 ) {
+				cerr << "ERROR: the size of the mini-batches must be at least 1!" << endl;
+				exit(1);
+			}
+		}
+		
 		if (args.hasArgument("gradmethod"))
 		{
 			string gradMethod;
@@ -97,6 +112,8 @@ namespace MultiBoost {
 				_gMethod = OPT_SGD;
 			else if ( gradMethod.compare( "bgd" ) == 0 )
 				_gMethod = OPT_BGD;
+			else if ( gradMethod.compare( "mbgd" ) == 0 )
+				_gMethod = OPT_MBGD;
 			else {
 				cerr << "SigmoidSingleStumpLearner::Unknown update gradient method" << endl;
 				exit( -1 );
@@ -144,6 +161,7 @@ namespace MultiBoost {
 		pStochasticLearner->_nu			  = _nu;
 		pStochasticLearner->_lambda		  = _lambda;		
 		pStochasticLearner->_gammdivperiod= _gammdivperiod;		
+		pStochasticLearner->_miniBatchSize= _miniBatchSize;
 		
 	}
 		
@@ -44,7 +44,8 @@ using namespace std;
 namespace MultiBoost {
 	enum GradientMethods {
 		OPT_SGD, // stochastic descend
-		OPT_BGD  // batch gradient descend
+		OPT_BGD, // batch gradient descend
+		OPT_MBGD // mini-batch gradient descend
 	};
 	
 	enum TargetFunctions {
@@ -68,7 +69,8 @@ namespace MultiBoost {
 		                      _gammaDivider(1.0),
 		                      _initialGammat(10.0),
 							  _lambda(0.001),
-							  _gammdivperiod(1)
+							  _gammdivperiod(1),
+							  _miniBatchSize(100)
 		
 		{}
 		/**
@@ -145,6 +147,7 @@ namespace MultiBoost {
 		AlphaReal					_nu;
 		AlphaReal					_lambda;		
 		int							_gammdivperiod;		
+		int							_miniBatchSize; //!< The number of examples of a step of OPT_MBGD.
 	};
 	
 }
@@ -34,20 +34,53 @@
 #include "TreeLearner.h"
 
 #include "IO/Serialization.h"
+#include "IO/SortedData.h"
 #include "Others/Example.h"
 #include "Utils/StreamTokenizer.h"
 #include "Utils/Utils.h"
+#include "WeakLearners/SingleStumpLearner.h"
+#include "WeakLearners/ConstantLearner.h"
 
 #include <cmath>
 #include <limits>
 #include <queue>
 #include <typeinfo>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 	
 	//REGISTER_LEARNER_NAME(Product, TreeLearner)
 	REGISTER_LEARNER(TreeLearner)
 	
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * The body of the parallel training of the nodes of a tree: node i is
+	 * trained on the i-th view of the training data.
+	 * \date 19/10/2026
+	 */
+	class TreeNodeEvaluation {
+	public:
+		TreeNodeEvaluation(TreeLearner* pLearner, vector<NodePoint>& nodes)
+		: _pLearner(pLearner), _pNodes(&nodes) {}
+		
+		void operator()( const blocked_range<int>& range ) const {
+			for( int i = range.begin(); i != range.end(); ++i )
+				_pLearner->calculateEdgeImprovement( (*_pNodes)[i], _pLearner->_dataViews[i] );
+		}
+		
+	private:
+		TreeLearner*		_pLearner;
+		vector<NodePoint>*	_pNodes;
+	};
+	
+	// -----------------------------------------------------------------------
+	
 	// -----------------------------------------------------------------------
 	
 	void TreeLearner::declareArguments(nor_utils::Args& args)
@@ -60,6 +93,13 @@ namespace MultiBoost {
 							 "  Don't forget to add its parameters\n",
 							 2, "<baseLearnerType> <numBaseLearners>");
 		
+		args.declareArgument("treefrontier", 
+							 "The number of nodes of the tree that are expanded together: the children\n"
+							 "  of the <k> best nodes are trained in parallel. With <k> = 1 (default) the\n"
+							 "  two children of the best node are trained in parallel, and the tree is the\n"
+							 "  same as with a sequential expansion.\n",
+							 1, "<k>");
+		
 	}
 	
 	// ------------------------------------------------------------------------------
@@ -86,6 +126,14 @@ namespace MultiBoost {
 		
 		_pScalaWeakHypothesisSource->initLearningOptions(args);
 		
+		if ( args.hasArgument("treefrontier") ) {
+			args.getValue("treefrontier", 0, _frontierSize);
+			if ( _frontierSize < 1 ) {
+				cerr << "ERROR: the frontier of -treefrontier must contain at least one node!" << endl;
+				exit(1);
+			}
+		}
+		
 		/*
 		 for( int ib = 0; ib < _numBaseLearners; ++ib ) {			
 		 vector< int > tmpVector( 2, -1 );
@@ -98,6 +146,15 @@ namespace MultiBoost {
 	
 	AlphaReal TreeLearner::classify(InputData* pData, int idx, int classIdx)
 	{		
+		if ( ! _flatNodes.empty() ) {
+			int next = 0;
+			do {
+				const FlatTreeNode& node = _flatNodes[next];
+				next = node._next[ pData->getValue( idx, node._column ) > node._threshold ];
+			} while ( next >= 0 );
+			return _flatLeafVotes[ (size_t)(~next) * _numFlatClasses + classIdx ];
+		}
+		
 		int ib = 0;
 		while ( 1 ) {
 			AlphaReal phix = _baseLearners[ib]->cut(pData,idx);
@@ -122,16 +179,115 @@ namespace MultiBoost {
 	
 	// ------------------------------------------------------------------------------
 	
+	bool TreeLearner::classifyBatch(InputData* pData, vector<AlphaReal>& votes)
+	{
+		if ( _flatNodes.empty() ) return false;
+		
+		const int numExamples = pData->getNumExamples();
+		vector<int> nodes( numExamples, 0 );
+		vector<int> active( numExamples );
+		for (int i = 0; i < numExamples; ++i)
+			active[i] = i;
+		
+		// one level of the tree per pass, the examples that reached a leaf are dropped
+		int numActive = numExamples;
+		while ( numActive > 0 ) {
+			int numNext = 0;
+			for (int a = 0; a < numActive; ++a) {
+				const int i = active[a];
+				const FlatTreeNode& node = _flatNodes[ nodes[i] ];
+				const int next = node._next[ pData->getValue( i, node._column ) > node._threshold ];
+				nodes[i] = next;
+				active[numNext] = i;
+				numNext += ( next >= 0 );
+			}
+			numActive = numNext;
+		}
+		
+		votes.resize( (size_t)numExamples * _numFlatClasses );
+		for (int i = 0; i < numExamples; ++i)
+			copy( _flatLeafVotes.begin() + (size_t)(~nodes[i]) * _numFlatClasses,
+				  _flatLeafVotes.begin() + (size_t)(~nodes[i] + 1) * _numFlatClasses,
+				  votes.begin() + (size_t)i * _numFlatClasses );
+		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
+	bool TreeLearner::buildFlatTree()
+	{
+		_flatNodes.clear();
+		_flatLeafVotes.clear();
+		
+		// the cut of these is a threshold on a single feature (or always positive)
+		for (int ib = 0; ib < (int)_baseLearners.size(); ++ib) {
+			const type_info& type = typeid( *_baseLearners[ib] );
+			if ( type != typeid(SingleStumpLearner) && type != typeid(ConstantLearner) )
+				return false;
+		}
+		if ( _baseLearners.empty() ) return false;
+		
+		_numFlatClasses = (int)dynamic_cast<AbstainableLearner*>( _baseLearners[0] )->_v.size();
+		
+		// breadth-first order of the nodes
+		vector<int> order( 1, 0 );
+		vector<int> flatIdx( _baseLearners.size(), -1 );
+		flatIdx[0] = 0;
+		for (int k = 0; k < (int)order.size(); ++k) {
+			for (int side = 0; side < 2; ++side) {
+				const int child = _idxPairs[ order[k] ][ side ];
+				if ( child > 0 && flatIdx[child] < 0 ) {
+					flatIdx[child] = (int)order.size();
+					order.push_back( child );
+				}
+			}
+		}
+		
+		_flatNodes.resize( order.size() );
+		for (int k = 0; k < (int)order.size(); ++k) {
+			const int ib = order[k];
+			FlatTreeNode& node = _flatNodes[k];
+			SingleStumpLearner* pStump = dynamic_cast<SingleStumpLearner*>( _baseLearners[ib] );
+			const vector<AlphaReal>& v = dynamic_cast<AbstainableLearner*>( _baseLearners[ib] )->_v;
+			
+			node._column = pStump ? pStump->getSelectedColumn() : 0;
+			node._threshold = pStump ? (FeatureReal)pStump->getThreshold() : 0;
+			
+			// _idxPairs[ib][0] is the child on the positive side of the cut
+			for (int side = 1; side >= 0; --side) {
+				const int child = _idxPairs[ib][ 1 - side ];
+				if ( child > 0 ) {
+					node._next[side] = flatIdx[child];
+				} else if ( !pStump && side == 0 ) {
+					// the cut of a constant is always positive
+					node._next[0] = node._next[1];
+				} else {
+					node._next[side] = ~(int)( _flatLeafVotes.size() / _numFlatClasses );
+					for (int l = 0; l < _numFlatClasses; ++l)
+						_flatLeafVotes.push_back( side ? v[l] : -v[l] );
+				}
+			}
+		}
+		
+		return true;
+	}
+	
+	// ------------------------------------------------------------------------------
+	
 	AlphaReal TreeLearner::run()
 	{		
-		set< int > tmpIdx, idxPos, idxNeg, origIdx;
+		IndexView origIdx;
 		//ScalarLearner* pCurrentBaseLearner = 0;
 		ScalarLearner* pTmpBaseLearner = 0;		
 		int ib = 0;
 		vector< int > tmpVector( 2, -1 );
 		
-		_pTrainingData->getIndexSet( origIdx );
+		_pTrainingData->getIndexView( origIdx );
 		
+		// with dense sorted data the nodes are the ranges of a partition of the data
+		SortedData* pSortedData = dynamic_cast<SortedData*>(_pTrainingData);
+		_pPartitionData = ( pSortedData && pSortedData->initPartition() ) ? pSortedData : NULL;
 		
 		_pScalaWeakHypothesisSource->setTrainingData(_pTrainingData);
 		
@@ -139,9 +295,10 @@ namespace MultiBoost {
 		NodePoint parentNode, nodeLeft, nodeRight;								
 		parentNode._idx = 0;
 		parentNode._parentIdx = -1;
-		parentNode._learnerIdxSet = origIdx;
+		parentNode._learnerIdxView = origIdx;
+		parentNode._partitionIdx = 0; // the root of the partition
 		
-		calculateEdgeImprovement( parentNode );		
+		calculateEdgeImprovement( parentNode, _pTrainingData );		
 		
 		// insert the root
 		if ( parentNode._edgeImprovement <= 0.0 ) // the constant is the best, in this case the treelearner is equivalent to the constant learner
@@ -151,6 +308,8 @@ namespace MultiBoost {
 			this->_alpha = parentNode._constantLearner->getAlpha();
 			ib++;			
 			delete parentNode._learner;
+			if ( _pPartitionData ) _pPartitionData->clearPartition();
+			buildFlatTree();
 			return parentNode._constantEnergy;
 		}
 		
@@ -159,53 +318,65 @@ namespace MultiBoost {
 		ib++;
 		
 		// put the first two children into the priority queue								
-		extendNode( parentNode, nodeLeft, nodeRight );
+		vector<NodePoint> children(2);
+		extendNode( parentNode, children[0], children[1] );
 		
-		calculateEdgeImprovement( nodeLeft );
-		calculateEdgeImprovement( nodeRight );
+		calculateEdgeImprovements( children );
 		
 		priority_queue< NodePoint, vector<NodePoint>, greater_first_tree<NodePoint> > pq;
 		
-		pq.push(nodeLeft);
-		pq.push(nodeRight);
+		pq.push(children[0]);
+		pq.push(children[1]);
 		
+		vector<NodePoint> frontier;
 		
 		while ( ! pq.empty() )
 		{
-			NodePoint currentNode = pq.top();
-			pq.pop();
-			
-			
-			if ( _verbose > 3 ) {
-				cout << "Current edge imporvement: " << currentNode._edgeImprovement << endl;
-			}
-			
-			if (currentNode._edgeImprovement>0)
+			// the best nodes are expanded together, the first one alone if its
+			// improvement is not positive
+			frontier.clear();
+			while ( ! pq.empty() && (int)frontier.size() < min( _frontierSize, _numBaseLearners - ib ) )
 			{
-				_baseLearners.push_back( currentNode._learner );
-				_idxPairs.push_back( tmpVector );
-				//_baseLearners[ib] = currentNode._learner;
-				delete currentNode._constantLearner;				
-			} else {
-				_baseLearners.push_back(currentNode._constantLearner);
-				_idxPairs.push_back( tmpVector );
-				//_baseLearners[ib] = currentNode._constantLearner;
-				delete currentNode._learner;		
-				continue;
+				if ( ! frontier.empty() && pq.top()._edgeImprovement <= 0 ) break;
+				
+				NodePoint currentNode = pq.top();
+				pq.pop();
+				
+				if ( _verbose > 3 ) {
+					cout << "Current edge imporvement: " << currentNode._edgeImprovement << endl;
+				}
+				
+				if (currentNode._edgeImprovement>0)
+				{
+					_baseLearners.push_back( currentNode._learner );
+					_idxPairs.push_back( tmpVector );
+					//_baseLearners[ib] = currentNode._learner;
+					delete currentNode._constantLearner;				
+				} else {
+					_baseLearners.push_back(currentNode._constantLearner);
+					_idxPairs.push_back( tmpVector );
+					//_baseLearners[ib] = currentNode._constantLearner;
+					delete currentNode._learner;		
+					break;
+				}
+				
+				_idxPairs[ currentNode._parentIdx ][ currentNode._leftOrRightChild ] = ib;
+				currentNode._idx = ib;
+				ib++;
+				frontier.push_back( currentNode );
 			}
 			
-			_idxPairs[ currentNode._parentIdx ][ currentNode._leftOrRightChild ] = ib;
-			currentNode._idx = ib;
-			ib++;																		
 			if (ib >= _numBaseLearners) break;
+			if ( frontier.empty() ) continue;
 			
-			extendNode( currentNode, nodeLeft, nodeRight );
+			children.resize( 2 * frontier.size() );
+			for (int i = 0; i < (int)frontier.size(); ++i)
+				extendNode( frontier[i], children[2*i], children[2*i+1] );
 			
-			calculateEdgeImprovement( nodeLeft );
-			calculateEdgeImprovement( nodeRight );						
+			calculateEdgeImprovements( children );
 			
-			pq.push(nodeLeft);
-			pq.push(nodeRight);						
+			for (int i = 0; i < (int)children.size(); ++i)
+				pq.push(children[i]);
 		}
 		
 		while ( ! pq.empty() )
@@ -219,6 +390,12 @@ namespace MultiBoost {
 			delete currentNode._constantLearner;
 		}
 		
+		// the views are not needed anymore
+		for (int i = 0; i < (int)_dataViews.size(); ++i)
+			delete _dataViews[i];
+		_dataViews.clear();
+		setTrainingData( _pTrainingData );
+		
 		_id = _baseLearners[0]->getId();
 		for(int ib = 1; ib < _baseLearners.size(); ++ib)
 			_id += "_x_" + _baseLearners[ib]->getId();
@@ -228,14 +405,25 @@ namespace MultiBoost {
 		AlphaReal eps_min = 0.0, eps_pls = 0.0;
 		
 		//_pTrainingData->clearIndexSet();
-		_pTrainingData->loadIndexSet( origIdx );
+		_pTrainingData->loadIndexView( origIdx );
+		if ( _pPartitionData ) {
+			_pPartitionData->clearPartition();
+			_pPartitionData = NULL;
+		}
+		vector<AlphaReal> votes;
+		const bool hasVotes = buildFlatTree() && classifyBatch( _pTrainingData, votes );
+		const int numClasses = _pTrainingData->getNumClasses();
+		
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
-			vector< Label> l = _pTrainingData->getLabels( i );
-			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
-				AlphaReal result  = this->classify( _pTrainingData, i, it->idx );
+			const vector< Label>& l = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator it = l.begin(); it != l.end(); it++ ) {
+				const char y = _pTrainingData->getLabelY(i, *it);
+				const AlphaReal w = _pTrainingData->getLabelWeight(i, *it);
+				AlphaReal result  = hasVotes ? votes[ (size_t)i * numClasses + it->idx ] :
+											   this->classify( _pTrainingData, i, it->idx );
 				
-				if ( ( result * it->y ) < 0 ) eps_min += it->weight;
-				if ( ( result * it->y ) > 0 ) eps_pls += it->weight;
+				if ( ( result * y ) < 0 ) eps_min += w;
+				if ( ( result * y ) > 0 ) eps_pls += w;
 			}
 			
 		}
@@ -255,20 +443,38 @@ namespace MultiBoost {
 	// -----------------------------------------------------------------------
 	void TreeLearner::extendNode( const NodePoint& parentNode, NodePoint& nodeLeft, NodePoint& nodeRight )
 	{
-		_pTrainingData->loadIndexSet( parentNode._learnerIdxSet );
-		
-		nodeLeft._learnerIdxSet.clear();
-		nodeRight._learnerIdxSet.clear();
-		
-		//cut the dataset		
-		for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
-			// this returns the phi value of classifier
-			AlphaReal phix = parentNode._learner->cut(_pTrainingData,i);
-			if ( phix <  0 )
-				nodeLeft._learnerIdxSet.insert( _pTrainingData->getRawIndex( i ) );
-			else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
-				nodeRight._learnerIdxSet.insert( _pTrainingData->getRawIndex( i ) );
+		nodeLeft._learnerIdxView.clear();
+		nodeRight._learnerIdxView.clear();
+		
+		if ( _pPartitionData ) {
+			// the children are split from the parent in place
+			_pPartitionData->loadPartitionNode( parentNode._partitionIdx );
+			
+			vector<char> sides( _pTrainingData->getNumExamples() );
+			for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
+				AlphaReal phix = parentNode._learner->cut(_pTrainingData,i);
+				sides[i] = phix < 0 ? -1 : ( phix > 0 ? 1 : 0 );
 			}
+			
+			_pPartitionData->splitPartitionNode( parentNode._partitionIdx, sides, 
+												 nodeLeft._partitionIdx, nodeRight._partitionIdx );
+		}
+		else {
+			_pTrainingData->loadIndexView( parentNode._learnerIdxView );
+			
+			// the children are sub-views of the parent, built in a single pass
+			//cut the dataset		
+			for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
+				// this returns the phi value of classifier
+				AlphaReal phix = parentNode._learner->cut(_pTrainingData,i);
+				if ( phix <  0 )
+					nodeLeft._learnerIdxView.addExample( _pTrainingData, i );
+				else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
+					nodeRight._learnerIdxView.addExample( _pTrainingData, i );
+				}
+			}
+			
+			nodeLeft._partitionIdx = nodeRight._partitionIdx = -1;
 		}
 		
 		nodeLeft._parentIdx = parentNode._idx;
@@ -283,30 +489,57 @@ namespace MultiBoost {
 		nodeLeft._learner = nodeLeft._constantLearner = NULL;
 		nodeRight._learner = nodeRight._constantLearner = NULL;
 		
-		nodeLeft._size = nodeLeft._learnerIdxSet.size();
-		nodeRight._size = nodeRight._learnerIdxSet.size();
+		if ( _pPartitionData ) {
+			nodeLeft._size = _pPartitionData->getPartitionNodeSize( nodeLeft._partitionIdx );
+			nodeRight._size = _pPartitionData->getPartitionNodeSize( nodeRight._partitionIdx );
+		} else {
+			nodeLeft._size = nodeLeft._learnerIdxView.size();
+			nodeRight._size = nodeRight._learnerIdxView.size();
+		}
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void TreeLearner::calculateEdgeImprovements( vector<NodePoint>& nodes ) {
+		// one view of the data per node
+		while ( _dataViews.size() < nodes.size() ) {
+			InputData* pView = _pTrainingData->createView();
+			if ( ! pView ) break;
+			_dataViews.push_back( pView );
+		}
+		
+		if ( nodes.size() > 1 && _dataViews.size() >= nodes.size() )
+			parallel_for( blocked_range<int>( 0, (int)nodes.size(), 1 ), TreeNodeEvaluation(this, nodes) );
+		else {
+			for (int i = 0; i < (int)nodes.size(); ++i)
+				calculateEdgeImprovement( nodes[i], _pTrainingData );
+		}
 	}
 	
 	// -----------------------------------------------------------------------
-	void TreeLearner::calculateEdgeImprovement( NodePoint& node ) {
+	
+	void TreeLearner::calculateEdgeImprovement( NodePoint& node, InputData* pData ) {
 		node._extended = true;
-		_pTrainingData->loadIndexSet( node._learnerIdxSet );
+		if ( _pPartitionData )
+			static_cast<SortedData*>(pData)->loadPartitionNode( node._partitionIdx );
+		else
+			pData->loadIndexView( node._learnerIdxView );
 		
 		// run constant
 		BaseLearner* pConstantWeakHypothesisSource =
 		BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
 		
 		node._constantLearner = dynamic_cast<ScalarLearner*>( pConstantWeakHypothesisSource->create());
-		node._constantLearner->setTrainingData(_pTrainingData);
+		node._constantLearner->setTrainingData(pData);
 		node._constantEnergy = node._constantLearner->run();
 		
 		node._constantEdge = node._constantLearner->getEdge(false);
 		node._learner = NULL;
 		
-		if ( ! _pTrainingData->isSamplesFromOneClass() ) {
+		if ( ! pData->isSamplesFromOneClass() ) {
 			node._learner = dynamic_cast<ScalarLearner*>(_pScalaWeakHypothesisSource->create());
 			_pScalaWeakHypothesisSource->subCopyState(node._learner);
-			node._learner->setTrainingData(_pTrainingData);
+			node._learner->setTrainingData(pData);
 			
 			node._learnerEnergy = node._learner->run();
 			if ( node._learnerEnergy == node._learnerEnergy ) { // isnan
@@ -331,8 +564,33 @@ namespace MultiBoost {
 		// Calling the super-class method
 		BaseLearner::save(outputStream, numTabs);
 		
-		// save numBaseLearners
-		outputStream << Serialization::standardTag("numBaseLearners",  _baseLearners.size(), numTabs) << endl;
+		// save numBaseLearners (a tree loaded from its array encoding has no base
+		// learners, its number of nodes is the one that was loaded)
+		const int numBaseLearners = ( _baseLearners.empty() && ! _flatNodes.empty() ) ? 
+			_numBaseLearners : (int)_baseLearners.size();
+		outputStream << Serialization::standardTag("numBaseLearners", numBaseLearners, numTabs) << endl;
+		
+		if ( ! _flatNodes.empty() ) {
+			// the array encoding replaces the nodes, with more digits than the
+			// default ones, which are restored for the next learners
+			const streamsize oldPrecision = outputStream.precision();
+			outputStream << Serialization::getTabs(numTabs) << "<flatTree>" << endl;
+			outputStream << Serialization::standardTag("numClasses", _numFlatClasses, numTabs + 1) << endl;
+			outputStream << Serialization::standardTag("numNodes", _flatNodes.size(), numTabs + 1) << endl;
+			for( int k = 0; k < (int)_flatNodes.size(); ++k ) {
+				const FlatTreeNode& node = _flatNodes[k];
+				outputStream << Serialization::getTabs(numTabs + 1) << "<node>" << setprecision(12)
+							 << node._column << " " << node._threshold << " " 
+							 << node._next[0] << " " << node._next[1] << "</node>" << endl;
+			}
+			outputStream << Serialization::getTabs(numTabs + 1) << "<leafVotes>" << setprecision(12);
+			for( int j = 0; j < (int)_flatLeafVotes.size(); ++j )
+				outputStream << ( j ? " " : "" ) << _flatLeafVotes[j];
+			outputStream << "</leafVotes>" << endl;
+			outputStream << Serialization::getTabs(numTabs) << "</flatTree>" << endl;
+			outputStream.precision( oldPrecision );
+			return;
+		}
 		
 		for( int ib = 0; ib <  _baseLearners.size(); ++ib ) {
 			outputStream << Serialization::standardTag("leftChild", _idxPairs[ib][0], numTabs) << endl;
@@ -353,9 +611,25 @@ namespace MultiBoost {
 		
 		_numBaseLearners = UnSerialization::seekAndParseEnclosedValue<int>(st, "numBaseLearners");
 		//   _numBaseLearners = 2;
+		
+		// a tree of stumps is saved in its array encoding, the other trees node by node
+		st.next_token(); // the closing numBaseLearners tag
+		string tag = st.next_token();
+		if ( nor_utils::cmp_nocase( tag, "flatTree" ) ) {
+			loadFlatTree( st );
+			return;
+		}
+		
+		_flatNodes.clear();
+		_flatLeafVotes.clear();
 		_idxPairs.clear();
 		for(int ib = 0; ib < _numBaseLearners; ++ib) {
-			int leftChild = UnSerialization::seekAndParseEnclosedValue<int>(st, "leftChild");
+			// the first tag has already been read
+			int leftChild;
+			if ( ib == 0 && nor_utils::cmp_nocase( tag, "leftChild" ) )
+				istringstream( st.next_token() ) >> leftChild;
+			else
+				leftChild = UnSerialization::seekAndParseEnclosedValue<int>(st, "leftChild");
 			int rightChild = UnSerialization::seekAndParseEnclosedValue<int>(st, "rightChild");
 			vector< int > p( 2, -1 );
 			p[0] = leftChild;
@@ -376,6 +650,30 @@ namespace MultiBoost {
 			}
 		}
 		
+		buildFlatTree();
+	}
+	
+	// -----------------------------------------------------------------------
+	
+	void TreeLearner::loadFlatTree(nor_utils::StreamTokenizer& st)
+	{
+		_numFlatClasses = UnSerialization::seekAndParseEnclosedValue<int>(st, "numClasses");
+		const int numNodes = UnSerialization::seekAndParseEnclosedValue<int>(st, "numNodes");
+		
+		_flatNodes.resize( numNodes );
+		int numLeaves = 0;
+		for( int k = 0; k < numNodes; ++k ) {
+			UnSerialization::seekSimpleTag( st, "node" );
+			FlatTreeNode& node = _flatNodes[k];
+			istringstream( st.next_token() ) >> node._column >> node._threshold >> node._next[0] >> node._next[1];
+			numLeaves = max( numLeaves, max( ~node._next[0], ~node._next[1] ) + 1 );
+		}
+		
+		UnSerialization::seekSimpleTag( st, "leafVotes" );
+		istringstream ss( st.next_token() );
+		_flatLeafVotes.resize( (size_t)numLeaves * _numFlatClasses );
+		for( int j = 0; j < (int)_flatLeafVotes.size(); ++j )
+			ss >> _flatLeafVotes[j];
 	}
 	
 	// -----------------------------------------------------------------------
@@ -390,8 +688,13 @@ namespace MultiBoost {
 		pTreeLearner->_numBaseLearners = _numBaseLearners;
 		
 		// deep copy
-		for(int ib = 0; ib < _numBaseLearners; ++ib)
+		for(int ib = 0; ib < (int)_baseLearners.size(); ++ib)
 			pTreeLearner->_baseLearners.push_back(dynamic_cast<ScalarLearner*>(_baseLearners[ib]->copyState()));
+		pTreeLearner->_idxPairs = _idxPairs;
+		
+		pTreeLearner->_flatNodes = _flatNodes;
+		pTreeLearner->_flatLeafVotes = _flatLeafVotes;
+		pTreeLearner->_numFlatClasses = _numFlatClasses;
 	}
 	
 	// -----------------------------------------------------------------------
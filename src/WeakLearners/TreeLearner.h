@@ -56,6 +56,9 @@ using namespace std;
 
 namespace MultiBoost {
 	
+	class SortedData;
+	class TreeNodeEvaluation;
+	
 	//////////////////////////////////////////////////////////////////////////
 	
 	template<class T>
@@ -70,7 +73,8 @@ namespace MultiBoost {
 	struct NodePoint {
 		ScalarLearner*	_learner;
 		ScalarLearner*	_constantLearner;
-		set< int >		_learnerIdxSet;
+		IndexView		_learnerIdxView;
+		int				_partitionIdx; //!< The node of the partition of the data, if any (see SortedData::initPartition).
 		AlphaReal		_edge;
 		AlphaReal		_edgeImprovement;
 		AlphaReal		_constantEdge;		
@@ -85,6 +89,16 @@ namespace MultiBoost {
 		size_t		_size;
 	};
 	
+	/**
+	 * A node of the array encoding of a tree of stumps (see TreeLearner::buildFlatTree).
+	 * \date 19/10/2026
+	 */
+	struct FlatTreeNode {
+		int			_column; //!< The feature of the cut.
+		FeatureReal	_threshold; //!< The threshold of the cut.
+		int			_next[2]; //!< The next node if the value is below (0) or above (1) the threshold; ~leafIdx for a leaf.
+	};
+	
 	/**
 	 * A learner that loads a set of base learners, and boosts on the top of them. 
 	 */
@@ -97,7 +111,8 @@ namespace MultiBoost {
 		 * The constructor. It initializes _numBaseLearners to -1
 		 * \date 26/05/2007
 		 */
-		TreeLearner() : _numBaseLearners(-1), _pScalaWeakHypothesisSource( NULL ) { }
+		TreeLearner() : _pScalaWeakHypothesisSource( NULL ), _pPartitionData( NULL ), _frontierSize(1), 
+						_numBaseLearners(-1), _numFlatClasses(0) { }
 		
 		/**
 		 * The destructor. Must be declared (virtual) for the proper destruction of 
@@ -142,6 +157,13 @@ namespace MultiBoost {
 		
 		/**
 		 * Run the learner to build the classifier on the given data.
+		 * With dense sorted data the nodes are grown on a partition of the data
+		 * (see SortedData::initPartition): the examples and the sorted columns of a node
+		 * are split in place between its children, so the base learners of the children
+		 * do not filter the columns of the whole data again.
+		 * The children of the expanded nodes are trained in parallel, each one on its own
+		 * view of the data (see InputData::createView). With --treefrontier the best
+		 * nodes are expanded by groups, so that more children are trained at once.
 		 * \see BaseLearner::run
 		 * \date 24/04/2007
 		 */
@@ -160,9 +182,19 @@ namespace MultiBoost {
 		 */
 		virtual AlphaReal classify(InputData* pData, int idx, int classIdx);
 		
+		/**
+		 * Classify all the examples in use at once with the array encoding of the tree 
+		 * (see buildFlatTree): the examples go down the tree level by level, and those
+		 * that reached a leaf are dropped from the next level.
+		 * \see BaseLearner::classifyBatch
+		 * \date 19/10/2026
+		 */
+		virtual bool classifyBatch(InputData* pData, vector<AlphaReal>& votes);
+		
 		/**
 		 * Save the current object information needed for classification,
-		 * that is the single threshold.
+		 * that is the single threshold. A tree of stumps is saved in its array
+		 * encoding (see buildFlatTree), the other trees node by node.
 		 * \param outputStream The stream where the data will be saved
 		 * \param numTabs The number of tabs before the tag. Useful for indentation
 		 * \remark To fully save the object it is \b very \b important to call
@@ -216,9 +248,45 @@ namespace MultiBoost {
 	protected:
 		
 		void extendNode( const NodePoint& parentNode, NodePoint& nodeLeft, NodePoint& nodeRight );
-		void calculateEdgeImprovement( NodePoint& node );
+		
+		/**
+		 * Encode a tree of SingleStumpLearner and ConstantLearner nodes in _flatNodes, in
+		 * breadth-first order, and the votes of its leaves in _flatLeafVotes. A leaf is a
+		 * side of a node without a child, its votes are the ones of the node on that side.
+		 * \return False if a node is of another type, the tree is then not encoded.
+		 * \date 19/10/2026
+		 */
+		bool buildFlatTree();
+		
+		/**
+		 * Load the array encoding written by save().
+		 * \param st The stream tokenizer, after the flatTree tag.
+		 * \date 19/10/2026
+		 */
+		void loadFlatTree(nor_utils::StreamTokenizer& st);
+		
+		/**
+		 * Train the base learner and the constant learner of a node.
+		 * \param node The node.
+		 * \param pData The data used for the training: the training data or one of its views.
+		 * \date 19/10/2026
+		 */
+		void calculateEdgeImprovement( NodePoint& node, InputData* pData );
+		
+		/**
+		 * Train the nodes (see calculateEdgeImprovement), in parallel if the 
+		 * training data has views.
+		 * \param nodes The nodes.
+		 * \date 19/10/2026
+		 */
+		void calculateEdgeImprovements( vector<NodePoint>& nodes );
+		
+		friend class TreeNodeEvaluation;
 		
 		ScalarLearner* _pScalaWeakHypothesisSource;
+		SortedData* _pPartitionData; //!< The partitioned training data during run(), NULL if it is not partitioned.
+		vector<InputData*> _dataViews; //!< The views of the training data used by the threads during run().
+		int _frontierSize; //!< The number of nodes expanded together (--treefrontier).
 		
 		vector<ScalarLearner*> _baseLearners; //!< the learners of the product
 		/*
@@ -226,6 +294,10 @@ namespace MultiBoost {
 		 */
 		vector< vector<int> > _idxPairs; //! The tree structure.
 		int                   _numBaseLearners; //! Number of leaves in the tree structure.
+		
+		vector<FlatTreeNode>  _flatNodes; //!< The array encoding of the tree, empty if it is not a tree of stumps.
+		vector<AlphaReal>     _flatLeafVotes; //!< The votes of the leaves, leaf by leaf.
+		int                   _numFlatClasses; //!< The number of votes per leaf.
 	};
 	
 	
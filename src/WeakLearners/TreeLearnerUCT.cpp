@@ -41,10 +41,46 @@
 #include <limits>
 #include <queue>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 
 	//REGISTER_LEARNER_NAME(Product, TreeLearnerUCT)
 	REGISTER_LEARNER(TreeLearnerUCT)
+
+	// -----------------------------------------------------------------------
+
+	/**
+	 * The body of the parallel training of the two children of a node: the
+	 * i-th child is trained on the i-th view of the training data.
+	 * \date 19/10/2026
+	 */
+	class TreeUCTChildTraining {
+	public:
+		TreeUCTChildTraining(TreeLearnerUCT* pLearner, IndexView** idxViews, int depthIndex,
+							 BaseLearner** children, AlphaReal* edges, bool* isConstant)
+		: _pLearner(pLearner), _idxViews(idxViews), _depthIndex(depthIndex),
+		  _children(children), _edges(edges), _isConstant(isConstant) {}
+
+		void operator()( const blocked_range<int>& range ) const {
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				InputData* pView = _pLearner->_dataViews[i];
+				pView->loadIndexView( *_idxViews[i] );
+				_children[i] = _pLearner->trainChild( pView, _depthIndex, _edges[i], _isConstant[i] );
+			}
+		}
+
+	private:
+		TreeLearnerUCT*	_pLearner;
+		IndexView**		_idxViews;
+		int				_depthIndex;
+		BaseLearner**	_children;
+		AlphaReal*		_edges;
+		bool*			_isConstant;
+	};
 	int TreeLearnerUCT::_numOfCalling = 0; //number of the single stump learner have been called
 	InnerNodeUCTSparse TreeLearnerUCT::_root;
 
@@ -148,10 +184,10 @@ namespace MultiBoost {
 		}
 		_numOfCalling++;
 
-		set< int > tmpIdx, idxPos, idxNeg;
+		IndexView tmpIdx;
 		
 		_pTrainingData->clearIndexSet();
-		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) tmpIdx.insert( i );
+		_pTrainingData->getIndexView( tmpIdx );
 
 
 		vector< int > trajectory(0);
@@ -205,7 +241,7 @@ namespace MultiBoost {
 		tmpNodePoint._learner = pPreviousBaseLearner;
 		tmpNodePoint._idx = 0;
 		tmpNodePoint._depth = 0;
-		tmpNodePoint._learnerIdxSet = tmpIdx;
+		tmpNodePoint._learnerIdxView = tmpIdx;
 		calculateChildrenAndEnergies( tmpNodePoint, trajectory[1] );
 
 		////////////////////////////////////////////////////////
@@ -266,12 +302,12 @@ namespace MultiBoost {
 
 			nodeLeft._edge = tmpNodePoint._leftEdge;
 			nodeLeft._learner = tmpNodePoint._leftChild;
-			nodeLeft._learnerIdxSet = tmpNodePoint._leftChildIdxSet;
+			nodeLeft._learnerIdxView = tmpNodePoint._leftChildIdxView;
 
 
 			nodeRight._edge = tmpNodePoint._rightEdge;
 			nodeRight._learner = tmpNodePoint._rightChild;
-			nodeRight._learnerIdxSet = tmpNodePoint._rightChildIdxSet;
+			nodeRight._learnerIdxView = tmpNodePoint._rightChildIdxView;
 
 
 			//store the baselearner if the deltaenrgy will be higher
@@ -416,6 +452,13 @@ namespace MultiBoost {
 			delete tmpNodePoint._rightChild;
 		}
 
+		// the views are not needed anymore
+		for (int i = 0; i < (int)_dataViews.size(); ++i)
+			delete _dataViews[i];
+		_dataViews.clear();
+		for(int ib = 0; ib < _numBaseLearners; ++ib)
+			_baseLearners[ib]->setTrainingData(_pTrainingData);
+
 		_id = _baseLearners[0]->getId();
 		for(int ib = 0; ib < _numBaseLearners; ++ib)
 			_id += "_x_" + _baseLearners[ib]->getId();
@@ -426,12 +469,14 @@ namespace MultiBoost {
 
 		_pTrainingData->clearIndexSet();
 		for( int i = 0; i < _pTrainingData->getNumExamples(); i++ ) {
-			vector< Label> l = _pTrainingData->getLabels( i );
-			for( vector< Label >::iterator it = l.begin(); it != l.end(); it++ ) {
+			const vector<Label>& l = _pTrainingData->getLabels( i );
+			for( vector< Label >::const_iterator it = l.begin(); it != l.end(); it++ ) {
+				const char y = _pTrainingData->getLabelY(i, *it);
+				const AlphaReal w = _pTrainingData->getLabelWeight(i, *it);
 				float result  = this->classify( _pTrainingData, i, it->idx );
 
-				if ( ( result * it->y ) < 0 ) eps_min += it->weight;
-				if ( ( result * it->y ) > 0 ) eps_pls += it->weight;
+				if ( ( result * y ) < 0 ) eps_min += w;
+				if ( ( result * y ) > 0 ) eps_pls += w;
 			}
 
 		}
@@ -477,126 +522,82 @@ namespace MultiBoost {
 
 void TreeLearnerUCT::calculateChildrenAndEnergies( NodePointUCT& bLearner, int depthIndex ) {
 	bLearner._extended = true;
-	_pTrainingData->loadIndexSet( bLearner._learnerIdxSet );
+	_pTrainingData->loadIndexView( bLearner._learnerIdxView );
 	
 	//separate the dataset
-	set< int > idxPos, idxNeg;
-	idxPos.clear();
-	idxNeg.clear();
+	IndexView idxPos, idxNeg;
 	float phix;
 
 	for (int i = 0; i < _pTrainingData->getNumExamples(); ++i) {
 		// this returns the phi value of classifier
 		phix = bLearner._learner->classify(_pTrainingData,i,0);
 		if ( phix <  0 )
-			idxNeg.insert( _pTrainingData->getRawIndex( i ) );
+			idxNeg.addExample( _pTrainingData, i );
 		else if ( phix > 0 ) { // have to redo the multiplications, haven't been tested
-			idxPos.insert( _pTrainingData->getRawIndex( i ) );
+			idxPos.addExample( _pTrainingData, i );
 		}
 	}
 
 	if ( (idxPos.size() < 1 ) || (idxNeg.size() < 1 ) ) {
-		//retval.clear();
 		bLearner._extended = false;
-		//return retval;
 	}
-	
-	_pTrainingData->loadIndexSet( idxPos );
-	
-	if ( ! _pTrainingData->isSamplesFromOneClass() ) {
-		BaseLearner* posLearner = _baseLearners[0]->copyState();
-
-		//posLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(posLearner)->run( depthIndex );
-		//
-		//float posEdge = getEdge( posLearner, _pTrainingData );
-		posLearner->setTrainingData( _pTrainingData );
-		bLearner._leftEdge = posLearner->getEdge();
-
-		//tmpPair.first = posEdge;
-		//tmpPair.second.first.first = posLearner;
-		bLearner._leftChild = posLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a left child in the tree
-		//tmpPair.second.first.second.second = 0;
-		//tmpPair.second.second = idxPos;
-		bLearner._leftChildIdxSet = idxPos;
-	} else {
-		BaseLearner* pConstantWeakHypothesisSource = 
-			BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
 
-		BaseLearner* posLearner = pConstantWeakHypothesisSource->create();
-		posLearner->setTrainingData(_pTrainingData);
-		//float constantEnergy = posLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(posLearner)->run( depthIndex );
+	// one view of the data per child
+	while ( _dataViews.size() < 2 ) {
+		InputData* pView = _pTrainingData->createView();
+		if ( ! pView ) break;
+		_dataViews.push_back( pView );
+	}
 
-		//BaseLearner* posLearner = _baseLearners[0]->copyState();
-		//float posEdge = getEdge( posLearner, _pTrainingData );
-		posLearner->setTrainingData( _pTrainingData );
-		bLearner._leftEdge = posLearner->getEdge();
+	BaseLearner* children[2];
+	AlphaReal edges[2];
+	bool isConstant[2];
+	IndexView* childIdxViews[2] = { &idxPos, &idxNeg };
 
-		//tmpPair.first = posEdge;
-		//tmpPair.second.first.first = posLearner;
-		bLearner._leftChild = posLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a left child in the tree
-		//tmpPair.second.first.second.second = 0;
-		//tmpPair.second.second = idxPos;
-		bLearner._leftChildIdxSet = idxPos;
+	if ( _dataViews.size() >= 2 ) {
+		parallel_for( blocked_range<int>( 0, 2, 1 ), 
+			TreeUCTChildTraining(this, childIdxViews, depthIndex, children, edges, isConstant) );
+	} else {
+		for (int i = 0; i < 2; ++i) {
+			_pTrainingData->loadIndexView( *childIdxViews[i] );
+			children[i] = trainChild( _pTrainingData, depthIndex, edges[i], isConstant[i] );
+		}
 	}
 
-	//retval.push_back( tmpPair );
+	bLearner._leftChild = children[0];
+	bLearner._leftEdge = edges[0];
+	bLearner._leftChildIdxView = idxPos;
+
+	bLearner._rightChild = children[1];
+	// the edge of a constant right child has never been set
+	if ( ! isConstant[1] )
+		bLearner._rightEdge = edges[1];
+	bLearner._rightChildIdxView = idxNeg;
+}
 
-	_pTrainingData->loadIndexSet( idxNeg );
+// -----------------------------------------------------------------------
 
-	if ( ! _pTrainingData->isSamplesFromOneClass() ) {
-		BaseLearner* negLearner = _baseLearners[0]->copyState();
+BaseLearner* TreeLearnerUCT::trainChild( InputData* pData, int depthIndex, AlphaReal& edge, bool& isConstant ) {
+	BaseLearner* pChild;
+	isConstant = pData->isSamplesFromOneClass();
 
-		
-		//negLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(negLearner)->run( depthIndex );
-		//float negEdge = getEdge( negLearner, _pTrainingData );
-
-		negLearner->setTrainingData( _pTrainingData );
-		bLearner._rightEdge = negLearner->getEdge();
-		//tmpPair.first = negEdge;
-		//tmpPair.second.first.first = negLearner;
-		bLearner._rightChild = negLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a right child in the tree
-		//tmpPair.second.first.second.second = 1;
-		//tmpPair.second.second = idxNeg;
-		bLearner._rightChildIdxSet = idxNeg;
+	if ( ! isConstant ) {
+		pChild = _baseLearners[0]->copyState();
+		pChild->setTrainingData( pData );
+		dynamic_cast<FeaturewiseLearner*>(pChild)->run( depthIndex );
 	} else {
 		BaseLearner* pConstantWeakHypothesisSource = 
 			BaseLearner::RegisteredLearners().getLearner("ConstantLearner");
-
-		BaseLearner* negLearner =  pConstantWeakHypothesisSource->create();
-		negLearner->setTrainingData(_pTrainingData);
-		//float constantEnergy = negLearner->run();
-		dynamic_cast<FeaturewiseLearner*>(negLearner)->run( depthIndex );
-
-		//tmpPair.first = getEdge( negLearner, _pTrainingData );;
-		bLearner._rightChild = negLearner;
-		bLearner._rightChild = negLearner;
-		//tmpPair.second.first.first = negLearner;
-		//set the parent idx to zero
-		//tmpPair.second.first.second.first = 0;
-		//this means that it will be a right child in the tree
-		//tmpPair.second.first.second.second = 1;
-		//tmpPair.second.second = idxNeg;
-		bLearner._rightChildIdxSet = idxNeg;
+		pChild = pConstantWeakHypothesisSource->create();
+		pChild->setTrainingData( pData );
+		// the constant learner is not a FeaturewiseLearner
+		pChild->run();
 	}
 
-	//retval.push_back( tmpPair );
-
-	//return retval;
+	edge = pChild->getEdge();
+	return pChild;
 }
 
-
 // -----------------------------------------------------------------------
 
 void TreeLearnerUCT::save(ofstream& outputStream, int numTabs)
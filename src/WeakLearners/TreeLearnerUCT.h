@@ -86,9 +86,9 @@ namespace MultiBoost {
 		BaseLearner* _rightChild;
 		BaseLearner* _leftChild;
 		
-		set< int >   _rightChildIdxSet;
-		set< int >   _leftChildIdxSet;
-		set< int >   _learnerIdxSet;
+		IndexView   _rightChildIdxView;
+		IndexView   _leftChildIdxView;
+		IndexView   _learnerIdxView;
 
 		AlphaReal	_rightEdge;
 		AlphaReal	_leftEdge;
@@ -104,6 +104,8 @@ namespace MultiBoost {
 	};
 	typedef pair< AlphaReal, NodePointUCT > InnerNodeType;
 
+	class TreeUCTChildTraining;
+
 	/**
 	* A learner that loads a set of base learners, and boosts on the top of them. 
 	*/
@@ -221,8 +223,32 @@ namespace MultiBoost {
 		//virtual double getEdge();
 
 	protected:
+		/**
+		* Split the examples of the node \a bLearner and train its two children. The 
+		* children are trained in parallel, each on its own view of the training data
+		* (see InputData::createView), or one after the other if the data has no views.
+		* \param bLearner The node to extend.
+		* \param depthIndex The column chosen by the UCT for the depth of the children.
+		* \date 19/10/2026
+		*/
 		void calculateChildrenAndEnergies( NodePointUCT& bLearner, int depthIndex );
 
+		/**
+		* Train one child on the loaded examples of \a pData: a copy of the base learner,
+		* or a constant learner if the examples are all from the same class.
+		* \param pData The data the child is trained on.
+		* \param depthIndex The column chosen by the UCT.
+		* \param edge The edge of the child.
+		* \param isConstant True if the child is a constant learner.
+		* \return The trained child.
+		* \date 19/10/2026
+		*/
+		BaseLearner* trainChild( InputData* pData, int depthIndex, AlphaReal& edge, bool& isConstant );
+
+		friend class TreeUCTChildTraining;
+
+		vector<InputData*> _dataViews; //!< The views of the training data used by the threads during run().
+
 
 		vector<BaseLearner*> _baseLearners; //!< the learners of the product
 		/*
@@ -37,11 +37,25 @@
 #include "IO/Serialization.h"
 #include "WeakLearners/Haar/HaarFeatures.h" // for shortname->type and viceversa (see serialization)
 #include "Algorithms/StumpAlgorithm.h"
+#include "Utils/RadixSort.h"
+
+#include "Bandits/Random.h"
+#include "Bandits/UCBK.h"
+#include "Bandits/UCBKV.h"
+#include "Bandits/UCBKRandomized.h"
+#include "Bandits/Exp3.h"
+#include "Bandits/Exp3G.h"
+#include "Bandits/Exp3P.h"
 
 #include <limits> // for numeric_limits
 #include <ctime> // for time
 #include <math.h>
 
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
+
+using namespace tbb;
+
 namespace MultiBoost {
 
 	REGISTER_LEARNER_NAME(UCBVHaarSingleStump, UCBVHaarSingleStumpLearner)
@@ -49,6 +63,82 @@ namespace MultiBoost {
 
 	map<int,FeatureDataUCBV> UCBVHaarSingleStumpLearner::_featuresData;
 	int UCBVHaarSingleStumpLearner::_numOfCalling = 0;
+	GenericBanditAlgorithm* UCBVHaarSingleStumpLearner::_banditAlgo = NULL;
+	vector<int> UCBVHaarSingleStumpLearner::_armKeys;
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////////
+
+	/**
+	* The body of the parallel evaluation of the arms pulled in one round.
+	* Each task has its own scratch vectors and StumpAlgorithm, and the result of
+	* each arm is stored at its index.
+	* \date 18/10/2026
+	*/
+	class UCBVHaarArmEvaluation {
+	public:
+		UCBVHaarArmEvaluation(UCBVHaarSingleStumpLearner* pLearner, const vector<HaarFeature*>& features,
+							  const vector<nor_utils::Rect>& configs, const HaarImageBlock& intImages,
+							  const StumpAlgorithm<FeatureReal>& sAlgo, AlphaReal halfTheta,
+							  vector<UCBVHaarSingleStumpLearner::ArmResult>& results)
+		: _pLearner(pLearner), _pFeatures(&features), _pConfigs(&configs), _pIntImages(&intImages),
+		  _pSAlgo(&sAlgo), _halfTheta(halfTheta), _pResults(&results) {}
+
+		void operator()( const blocked_range<int>& range ) const {
+			InputData* pData = _pLearner->_pTrainingData;
+			const int numClasses = pData->getNumClasses();
+
+			StumpAlgorithm<FeatureReal> sAlgo(*_pSAlgo);
+			vector< pair<int, FeatureReal> > processedHaarData( _pIntImages->getNumImages() );
+			nor_utils::PairRadixSorter sorter;
+
+			for( int i = range.begin(); i != range.end(); ++i ) {
+				HaarFeature* pFeature = (*_pFeatures)[i];
+				UCBVHaarSingleStumpLearner::ArmResult& result = (*_pResults)[i];
+
+				// the rates are not set if there is no threshold
+				vector<sRates> mu(numClasses);
+				result.v.resize(numClasses);
+
+				// transform the data from intImages to the feature's space
+				pFeature->fillHaarData( *_pIntImages, processedHaarData, (*_pConfigs)[i] );
+
+				if ( _pLearner->_numHistogramBins > 0 )
+				{
+					// find the optimal threshold on the histogram of the values
+					result.threshold = sAlgo.findSingleThresholdHistogramWithInit(processedHaarData.begin(), 
+						processedHaarData.end(), 
+						pData, _halfTheta, _pLearner->_numHistogramBins, &mu, &result.v);
+				}
+				else
+				{
+					// sort the examples in the new space by their coordinate
+					sorter.sort( processedHaarData );
+
+					// find the optimal threshold
+					result.threshold = sAlgo.findSingleThresholdWithInit(processedHaarData.begin(), 
+						processedHaarData.end(), 
+						pData, _halfTheta, &mu, &result.v);
+				}
+
+				result.energy = _pLearner->getEnergy(mu, result.alpha, result.v);
+
+				AlphaReal edge = 0.0;
+				for( vector<sRates>::iterator itR = mu.begin(); itR != mu.end(); itR++ ) edge += ( itR->rPls - itR->rMin ); 
+				result.reward = edge * edge;
+			}
+		}
+
+	private:
+		UCBVHaarSingleStumpLearner*			_pLearner;
+		const vector<HaarFeature*>*			_pFeatures;
+		const vector<nor_utils::Rect>*		_pConfigs;
+		const HaarImageBlock*				_pIntImages;
+		const StumpAlgorithm<FeatureReal>*	_pSAlgo;
+		AlphaReal							_halfTheta;
+
+		vector<UCBVHaarSingleStumpLearner::ArmResult>*	_pResults;
+	};
 
 	//-------------------------------------------------------------------------------
 	void UCBVHaarSingleStumpLearner::init() {
@@ -120,6 +210,27 @@ namespace MultiBoost {
 		}
 
 		cout << "The number of the randomly chosen features:\t" << UCBVHaarSingleStumpLearner::_featuresData.size() << endl;
+
+		if ( _banditAlgo )
+		{
+			// the arms of the bandit algorithm are the chosen configurations,
+			// and they are all pulled once (in parallel) to initialize it
+			_armKeys.clear();
+			map<int,FeatureDataUCBV>::const_iterator itUCBV;
+			for( itUCBV = _featuresData.begin(); itUCBV != _featuresData.end(); ++itUCBV )
+				_armKeys.push_back( itUCBV->first );
+
+			vector<nor_utils::Rect> configs;
+			vector<ArmResult> results;
+			evaluateArms( _armKeys, configs, results );
+
+			vector<AlphaReal> initialValues( _armKeys.size() );
+			for( int i = 0; i < (int)_armKeys.size(); ++i )
+				initialValues[i] = results[i].reward;
+
+			_banditAlgo->setArmNumber( (int)_armKeys.size() );
+			_banditAlgo->initialize( initialValues );
+		}
 	}
 	// ------------------------------------------------------------------------------
 
@@ -136,6 +247,16 @@ namespace MultiBoost {
 		// call the superclasses
 		HaarLearner::declareArguments(args);
 		SingleStumpLearner::declareArguments(args);
+
+		args.declareArgument("rsample", 
+			"Number of features to be considered\n"
+			"  Default is one\n",
+			1, "<K>");
+
+		args.declareArgument("banditalgo", 
+			"The bandit algorithm (UCBK, UCBKRandomized, EXP3 )\n"
+			"Default is UCBK\n",
+			1, "<algoname>");
 	}
 
 	// ------------------------------------------------------------------------------
@@ -145,6 +266,45 @@ namespace MultiBoost {
 		// call the superclasses
 		HaarLearner::initOptions(args);
 		SingleStumpLearner::initLearningOptions(args);
+
+		// the arms pulled in each iteration are evaluated in parallel
+		if ( args.hasArgument( "rsample" ) )
+			_K = args.getValue<int>("rsample", 0);
+
+		if ( _K < 1 )
+		{
+			cerr << "ERROR: the number of arms (--rsample) must be positive!" << endl;
+			exit(1);
+		}
+
+		// without --banditalgo the built-in UCBV is used
+		if ( args.hasArgument( "banditalgo" ) && _banditAlgo == NULL )
+		{
+			string banditAlgoName;
+			args.getValue("banditalgo", 0, banditAlgoName ); 
+
+			if ( banditAlgoName.compare( "Random" ) == 0 )
+				_banditAlgo = new Random();
+			else if ( banditAlgoName.compare( "UCBK" ) == 0 )
+				_banditAlgo = new UCBK();
+			else if ( banditAlgoName.compare( "UCBKR" ) == 0 )
+				_banditAlgo = new UCBKRandomized();
+			else if ( banditAlgoName.compare( "UCBKV" ) == 0 )
+				_banditAlgo = new UCBKV();
+			else if ( banditAlgoName.compare( "EXP3" ) == 0 )
+				_banditAlgo = new Exp3();
+			else if ( banditAlgoName.compare( "EXP3G" ) == 0 )
+				_banditAlgo = new Exp3G();
+			else if ( banditAlgoName.compare( "EXP3P" ) == 0 )
+				_banditAlgo = new Exp3P();
+			else {
+				cerr << "ERROR: Unknown bandit algorithm <" << banditAlgoName << "> (UCBVHaarSingleStumpLearner)!" << endl;
+				exit(1);
+			}
+
+			// the bandit algorithm object must be initilaized once only
+			_banditAlgo->initLearningOptions( args );
+		}
 	}
 
 	// ------------------------------------------------------------------------------
@@ -155,8 +315,8 @@ namespace MultiBoost {
 		// feature's space. This is done by getValue of the selected feature.
 		return _v[classIdx] *
 			UCBVHaarSingleStumpLearner::phi( 
-			_pSelectedFeature->getValue( 
-			pData->getValues(idx), _selectedConfig ),
+			static_cast<HaarData*>(pData)->getHaarValue( 
+			idx, _pSelectedFeature, _selectedConfig ),
 			//static_cast<HaarData*>(pData)->getIntImage(idx), _selectedConfig ),
 			classIdx );
 
@@ -203,94 +363,47 @@ namespace MultiBoost {
 
 	AlphaReal UCBVHaarSingleStumpLearner::run()
 	{
+		// set the smoothing value to avoid numerical problem
+		// when theta=0.
+		setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
+
  	   if ( UCBVHaarSingleStumpLearner::_numOfCalling == 0 ) {
  			init();
  	   }
 
 		UCBVHaarSingleStumpLearner::_numOfCalling++;
 		//cout << "Num of iter:\t" << UCBVHaarSingleStumpLearner::_numOfCalling << " " << this->getTthSeriesElement( UCBVHaarSingleStumpLearner::_numOfCalling ) << flush << endl;
-		const int numClasses = _pTrainingData->getNumClasses();
-
-		// set the smoothing value to avoid numerical problem
-		// when theta=0.
-		setSmoothingVal( 1.0 / (AlphaReal)_pTrainingData->getNumExamples() * 0.01 );
-
-		vector<sRates> mu(numClasses); // The class-wise rates. See BaseLearner::sRates for more info.
-		vector<AlphaReal> tmpV(numClasses); // The class-wise votes/abstentions
-
-		AlphaReal tmpThreshold;
-		AlphaReal tmpAlpha;
-
-		AlphaReal bestEnergy = numeric_limits<AlphaReal>::max();
-		AlphaReal tmpEnergy;
 
 		HaarData* pHaarData = static_cast<HaarData*>(_pTrainingData);
 
-		// get the whole data matrix
-		//const vector<int*>& intImages = pHaarData->getIntImageVector();
-
-		// The data matrix transformed into the feature's space
-		vector< pair<int, FeatureReal> > processedHaarData(_pTrainingData->getNumExamples());
-
-		// I need to prepare both type of sampling
-
-		StumpAlgorithm<FeatureReal> sAlgo(numClasses);
-		sAlgo.initSearchLoop(_pTrainingData);
-
-		AlphaReal halfTheta;
-		if ( _abstention == ABST_REAL || _abstention == ABST_CLASSWISE )
-			halfTheta = _theta/2.0;
-		else
-			halfTheta = 0;
-
 		// The declared features types
 		vector<HaarFeature*>& loadedFeatures = pHaarData->getLoadedFeatures();
 
-		// for every feature type
-		vector<HaarFeature*>::iterator ftIt;
-		//vector<HaarFeature*>::iterator maxftIt;
-
-		vector<AlphaReal> maxV( loadedFeatures.size() ); 
-		vector<int> maxKey( loadedFeatures.size() );
-		vector<int> maxNum( loadedFeatures.size() );
-		
-		//claculate the Bk,s,t of the randomly chosen features
-		int key = getKeyOfMaximalElement();
-		int featureIdx = (int) (key / 10);
-		int featureType = (key % 10);
-
-		//for (i = 0, ftIt = loadedFeatures.begin(); ftIt != loadedFeatures.end(); i++ ++ftIt)
-		//*ftIt = loadedFeatures[ featureType ];
-
-		// just for readability
-		//HaarFeature* pCurrFeature = *ftIt;
-		HaarFeature* pCurrFeature = loadedFeatures[ featureType ];
-		if (_samplingType != ST_NO_SAMPLING)
-			pCurrFeature->setAccessType(AT_RANDOM_SAMPLING);
-
-		// Reset the iterator on the configurations. For random sampling
-		// this clear the visited list
-		pCurrFeature->loadConfigByNum( featureIdx );
-
-
-		if (_verbose > 1)
-			cout << "Learning type " << pCurrFeature->getName() << ".." << flush;
-
-		// transform the data from intImages to the feature's space
-		pCurrFeature->fillHaarData( _pTrainingData->getExamples(), processedHaarData );
-		//pCurrFeature->fillHaarData(intImages, processedHaarData);
-
-		// sort the examples in the new space by their coordinate
-		sort( processedHaarData.begin(), processedHaarData.end(), 
-			nor_utils::comparePair<2, int, float, less<float> >() );
+		// the arms (configurations) pulled in this iteration
+		vector<int> arms;
+		vector<int> keys;
+		if ( _banditAlgo )
+		{
+			_banditAlgo->getKNextActions( _K, arms );
+			keys.resize( arms.size() );
+			for( int i = 0; i < (int)arms.size(); ++i )
+				keys[i] = _armKeys[ arms[i] ];
+		}
+		else
+			getKeysOfMaximalElements( _K, keys );
 
-		// find the optimal threshold
-		tmpThreshold = sAlgo.findSingleThresholdWithInit(processedHaarData.begin(), 
-			processedHaarData.end(), 
-			_pTrainingData, halfTheta, &mu, &tmpV);
+		// evaluate them in parallel
+		vector<nor_utils::Rect> configs;
+		vector<ArmResult> results;
+		evaluateArms( keys, configs, results );
 
-		tmpEnergy = getEnergy(mu, tmpAlpha, tmpV);
-		
+		// select the one with the lowest energy (the first one wins the ties)
+		int bestArm = 0;
+		for( int i = 1; i < (int)results.size(); ++i )
+		{
+			if ( results[i].energy < results[bestArm].energy )
+				bestArm = i;
+		}
 
 		// Store it in the current weak hypothesis.
 		// note: I don't really like having so many temp variables
@@ -298,22 +411,31 @@ namespace MultiBoost {
 		// to be inheritable to make things more consistent. But this would
 		// make it less flexible. Therefore, I am still undecided. This
 		// might change!
-		_alpha = tmpAlpha;
-		_v = tmpV;
+		_alpha = results[bestArm].alpha;
+		_v = results[bestArm].v;
 
 		// I need to save the configuration because it changes within the object
-		_selectedConfig = pCurrFeature->getCurrentConfig();
+		_selectedConfig = configs[bestArm];
 		// I save the object because it contains the informations about the type,
 		// the name, etc..
-		_pSelectedFeature = pCurrFeature;
-		_threshold = tmpThreshold;
+		_pSelectedFeature = loadedFeatures[ keys[bestArm] % 10 ];
+		_threshold = results[bestArm].threshold;
 
-		bestEnergy = tmpEnergy;
+		AlphaReal bestEnergy = results[bestArm].energy;
 
-		AlphaReal edge = 0.0;
-		for( vector<sRates>::iterator itR = mu.begin(); itR != mu.end(); itR++ ) edge += ( itR->rPls - itR->rMin ); 
-		//need to set the X value
-		updateKeys( key, edge * edge );
+		// give back the rewards (the squared edges) of all the pulled arms in one step
+		if ( _banditAlgo )
+		{
+			vector<AlphaReal> rewards( results.size() );
+			for( int i = 0; i < (int)results.size(); ++i )
+				rewards[i] = results[i].reward;
+			_banditAlgo->receiveRewards( arms, rewards );
+		}
+		else
+		{
+			for( int i = 0; i < (int)results.size(); ++i )
+				updateKeys( keys[i], results[i].reward );
+		}
 		
 		if (!_pSelectedFeature)
 		{
@@ -328,7 +450,82 @@ namespace MultiBoost {
 
 		return bestEnergy;
 	}
+
+	// ------------------------------------------------------------------------------
+
+	void UCBVHaarSingleStumpLearner::evaluateArms( const vector<int>& keys, vector<nor_utils::Rect>& configs, 
+												   vector<ArmResult>& results )
+	{
+		const int numClasses = _pTrainingData->getNumClasses();
+		const int numArms = (int)keys.size();
+
+		HaarData* pHaarData = static_cast<HaarData*>(_pTrainingData);
+
+		// get the whole data matrix (once, it is shared by the threads)
+		const HaarImageBlock& intImages = pHaarData->getImageBlock();
+
+		// The declared features types
+		vector<HaarFeature*>& loadedFeatures = pHaarData->getLoadedFeatures();
+
+		StumpAlgorithm<FeatureReal> sAlgo(numClasses);
+		sAlgo.initSearchLoop(_pTrainingData);
+
+		AlphaReal halfTheta;
+		if ( _abstention == ABST_REAL || _abstention == ABST_CLASSWISE )
+			halfTheta = _theta/2.0;
+		else
+			halfTheta = 0;
+
+		// the configurations are loaded sequentially, as they change the features
+		vector<HaarFeature*> features( numArms );
+		configs.resize( numArms );
+		for( int i = 0; i < numArms; ++i )
+		{
+			int featureIdx = (int) (keys[i] / 10);
+			int featureType = (keys[i] % 10);
+
+			HaarFeature* pCurrFeature = loadedFeatures[ featureType ];
+			if (_samplingType != ST_NO_SAMPLING)
+				pCurrFeature->setAccessType(AT_RANDOM_SAMPLING);
+
+			pCurrFeature->loadConfigByNum( featureIdx );
+
+			if (_verbose > 1)
+				cout << "Learning type " << pCurrFeature->getName() << ".." << flush;
+
+			features[i] = pCurrFeature;
+			configs[i] = pCurrFeature->getCurrentConfig();
+		}
+
+		results.resize( numArms );
+		parallel_for( blocked_range<int>( 0, numArms ), 
+					  UCBVHaarArmEvaluation(this, features, configs, intImages, sAlgo, halfTheta, results) );
+	}
+
+	// ------------------------------------------------------------------------------
+
+	void UCBVHaarSingleStumpLearner::getKeysOfMaximalElements( int k, vector<int>& keys )
+	{
+		// the B-values are compared as floats, as in getKeyOfMaximalElement()
+		vector< pair<float,int> > values;
+		values.reserve( _featuresData.size() );
+
+		map<int,FeatureDataUCBV>::iterator itUCBV;
+		for( itUCBV = UCBVHaarSingleStumpLearner::_featuresData.begin(); itUCBV != _featuresData.end(); itUCBV++ )
+			values.push_back( make_pair( (float)getBValue( itUCBV->first ), itUCBV->first ) );
+
+		k = min( k, (int)values.size() );
+		stable_sort( values.begin(), values.end(), 
+					 nor_utils::comparePair< 1, float, int, greater<float> >() );
+
+		keys.resize( k );
+		for( int i = 0; i < k; ++i )
+			keys[i] = values[i].second;
+	}
+
+	// ------------------------------------------------------------------------------
 	
+
 	int UCBVHaarSingleStumpLearner::getKeyOfMaximalElement()
 	{
 		int key;
@@ -417,8 +614,8 @@ namespace MultiBoost {
 	   for (int i = 0; i < numExamples; ++i)
 	   {
 		  data[pos++] = UCBVHaarSingleStumpLearner::phi( 
-							_pSelectedFeature->getValue( 
-							   pData->getValues(i), _selectedConfig ),
+							static_cast<HaarData*>(pData)->getHaarValue( 
+							   i, _pSelectedFeature, _selectedConfig ),
 						//       static_cast<HaarData*>(pData)->getIntImage(i), _selectedConfig ), 
 						0 );
 	   }
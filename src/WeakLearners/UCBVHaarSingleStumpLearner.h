@@ -59,6 +59,8 @@ namespace MultiBoost {
 	};
 
 	class HaarData;
+	class GenericBanditAlgorithm;
+	class UCBVHaarArmEvaluation;
 
 	/**
 	* A learner that uses the Haar-like features for input and the SingleStumpLearner 
@@ -77,6 +79,11 @@ namespace MultiBoost {
 		*/
 		virtual ~UCBVHaarSingleStumpLearner() {}
 
+		/**
+		* The constructor. One arm is pulled in each iteration by default.
+		*/
+		UCBVHaarSingleStumpLearner() : _K( 1 ) {}
+
 		virtual void init();
 		
 		/**
@@ -204,10 +211,52 @@ namespace MultiBoost {
 		virtual AlphaReal getBValue( int key );
 		virtual void updateKeys( int key, float val );
 		virtual int getKeyOfMaximalElement();
+
+		/**
+		* Get the keys of the k configurations with the largest B-values, in decreasing
+		* order of the B-values (the first key wins the ties, as in getKeyOfMaximalElement()).
+		* \param k The number of keys.
+		* \param keys The keys of the configurations.
+		* \date 18/10/2026
+		*/
+		virtual void getKeysOfMaximalElements( int k, vector<int>& keys );
+
+	protected:
+
+		/**
+		* The result of the evaluation of an arm (a configuration).
+		*/
+		struct ArmResult
+		{
+			AlphaReal			energy;
+			AlphaReal			alpha;
+			AlphaReal			reward; //!< The squared edge of the stump.
+			FeatureReal			threshold;
+			vector<AlphaReal>	v;
+		};
+
+		/**
+		* Evaluate the configurations with the given keys concurrently: find the
+		* best stump of each one on the training data.
+		* \param keys The keys of the configurations.
+		* \param configs Returns the configurations of the keys.
+		* \param results Returns the results, in the order of the keys.
+		* \date 18/10/2026
+		*/
+		void evaluateArms( const vector<int>& keys, vector<nor_utils::Rect>& configs, 
+						   vector<ArmResult>& results );
+
+		int _K; //!< The number of arms pulled in each iteration.
+
 	private:
 
+		friend class UCBVHaarArmEvaluation;
+
 		static map<int,FeatureDataUCBV> _featuresData;
 		static int _numOfCalling; //number of the single stump learner have been called
+
+		static GenericBanditAlgorithm*	_banditAlgo; //!< The bandit algorithm, NULL for the built-in UCBV.
+		static vector<int>				_armKeys; //!< The keys of the arms of _banditAlgo.
 	};
 
 } // end of namespace MultiBoost
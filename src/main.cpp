@@ -151,6 +151,7 @@
 #include "StrongLearners/AdaBoostMHLearner.h" // for --encode
 #include "StrongLearners/SoftCascadeLearner.h" // for declareBaseArguments
 #include "StrongLearners/VJCascadeLearner.h" // for declareBaseArguments
+#include "Classifiers/HaarCascadeDetector.h" // for --detect
 
 #include "IO/OutputInfo.h" // for --encode
 #include "Bandits/GenericBanditAlgorithm.h" 
@@ -339,6 +340,13 @@ int main(int argc, const char* argv[])
 	args.declareArgument("posteriors", "Output the posteriors for each class, that is the vector-valued discriminant function for the given dataset and model.", 4, "<dataFile> <shypFile> <outFile> <numIters>");
 	args.declareArgument("posteriors", "Output the posteriors for each class, that is the vector-valued discriminant function for the given dataset and model periodically.", 5, "<dataFile> <shypFile> <outFile> <numIters> <period>");	
 		
+	args.declareArgument("detect", "Detect the objects in whole images with a Haar-like cascade (VJcascade, SoftCascade or AdaBoost). "
+						 "The data file is only used for the class names, the image file is a PGM image or a list of PGM images, "
+						 "and each detection is written as <image> <x> <y> <width> <height> <score>.", 4, "<dataFile> <imageFile> <shypFile> <outFile>");
+	args.declareArgument("detectscale", "The ratio between two consecutive scales of the detection windows (default 1.25).", 1, "<factor>");
+	args.declareArgument("detectstep", "The step in pixels between two detection windows at the first scale (default 1).", 1, "<pixels>");
+	args.declareArgument("detectoverlap", "The maximum overlap (intersection over union) between two detections (default 0.3).", 1, "<ratio>");
+	
 	args.declareArgument("encode", "Save the coefficient vector of boosting individually on each point using ParasiteLearner", 6, "<inputDataFile> <autoassociativeDataFile> <outputDataFile> <nIterations> <poolFile> <nBaseLearners>");	
 	args.declareArgument("ssfeatures", "Print matrix data for SingleStump-Based weak learners (if numIters=0 it means all of them).", 4, "<dataFile> <shypFile> <outFile> <numIters>");
 	
@@ -407,6 +415,11 @@ int main(int argc, const char* argv[])
 						 "* sharepoints Share the weight equally among data points and between positiv and negative labels (DEFAULT)\n"
 						 "* sharelabels Share the weight equally among data points\n"
 						 "* proportional Share the weights freely", 1, "<weightType>");
+	args.declareArgument("compactlabels", "Store the labels and the weights of the training data in contiguous matrices (faster stump search and re-weighting).", 0, "");
+	args.declareArgument("compactlabels", "The same, with the weights stored in <precision> (float or double, default: double).", 1, "<precision>");
+	args.declareArgument("shareddata", "Share the sorted columns and the values of the training data with the other processes through a file in directory <dir>, found from the identity of the training file (device, inode, size and modification time). The first process publishes the file, the others map it read-only.", 1, "<dir>");
+	args.declareArgument("hierarchy", "Classify top-down along the class hierarchy in <file> (one path of categories from the root per line, the classes are named after the categories). At each level only the children of the <beam> best scored classes are scored, the classes of the pruned subtrees get the lowest vote.", 2, "<file> <beam>");
+	args.declareArgument("hierarchytrain", "Restrict the training to the relevant subtrees of the class hierarchy in <file>: the labels of an example other than the ancestors of its positive classes and their siblings get zero weight.", 1, "<file>");
 	
 	
 	args.setGroup("General Options");
@@ -414,6 +427,8 @@ int main(int argc, const char* argv[])
 	args.declareArgument("verbose", "Set the verbose level 0, 1 or 2 (0=no messages, 1=default, 2=all messages).", 1, "<val>");
 	args.declareArgument("outputinfo", "Output informations on the algorithm performances during training, on file <filename>.", 1, "<filename>");
 	args.declareArgument("outputinfo", "Output specific informations on the algorithm performances during training, on file <filename> <outputlist>. <outputlist> must be a concatenated list of three characters abreviation (ex: err for error, fpr for false positive rate)", 2, "<filename> <outputlist>");
+	args.declareArgument("outputinfoperiod", "Compute the outputs of --outputinfo only every <period> iterations (the last value is repeated in between).", 1, "<period>");
+	args.declareArgument("outputinfoperiod", "Compute the outputs of <outputlist> (ex: aucber) only every <period> iterations, the others at each iteration.", 2, "<period> <outputlist>");
 
 	args.declareArgument("seed", "Defines the seed for the random operations.", 1, "<seedval>");
 	
@@ -589,6 +604,19 @@ int main(int argc, const char* argv[])
 	}   
 	//////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////////////////////////////////////////////////////////
+	else if ( args.hasArgument("detect") )
+	{
+		// --detect <dataFile> <imageFile> <shypFile> <outFile>
+		string dataFileName = args.getValue<string>("detect", 0);
+		string imageFileName = args.getValue<string>("detect", 1);
+		string shypFileName = args.getValue<string>("detect", 2);
+		string outFileName = args.getValue<string>("detect", 3);
+		
+		HaarCascadeDetector detector(args, verbose);
+		detector.run(dataFileName, imageFileName, shypFileName, outFileName);
+	}
+	//////////////////////////////////////////////////////////////////////////////////////////
+	//////////////////////////////////////////////////////////////////////////////////////////
 	else if ( args.hasArgument("ssfeatures") )
 	{
 		// ONLY for AdaBoostMH classifiers
@@ -662,6 +690,8 @@ int main(int argc, const char* argv[])
 				cout << "--> Encoding example no " << (i+1) << endl;
 			pOnePoint->resetData();
 			pOnePoint->addExample( pAutoassociativeData->getExample(i) );
+			// the outputs of the pool are computed on the new point
+			ParasiteLearner::clearPoolSigns();
 			AlphaReal energy = 1;
 			
 			OutputInfo* pOutInfo = NULL;